@@ -4,6 +4,8 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 
+#include <algorithm>
+#include <cstring>
 #include <future>
 #include <memory>
 #include <string>
@@ -86,19 +88,30 @@ bool PersistentCache::Purge() {
 
   std::promise<bool> removed;
   GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+                                   cache_directory = cache_directory_,
+                                   cache_file = cache_file_,
+                                   sksl_cache_file = sksl_cache_file_]() {
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
       fml::FileVisitor delete_file = [](const fml::UniqueFD& directory,
                                         const std::string& filename) {
-        // Do not delete directories. Return true to continue with other files.
-        if (fml::IsDirectory(directory, filename.c_str())) {
+        // Do not delete directories or the cache files, which are cleared
+        // below. Return true to continue with other files.
+        if (fml::IsDirectory(directory, filename.c_str()) ||
+            filename == kCacheFileName ||
+            filename == PersistentCacheFile::LockFileName(kCacheFileName)) {
           return true;
         }
         return fml::UnlinkFile(directory, filename.c_str());
       };
-      removed.set_value(VisitFilesRecursively(*cache_directory, delete_file));
+      bool success = VisitFilesRecursively(*cache_directory, delete_file);
+      for (const auto& file : {cache_file, sksl_cache_file}) {
+        if (file && !file->Clear()) {
+          success = false;
+        }
+      }
+      removed.set_value(success);
     } else {
       removed.set_value(false);
     }
@@ -129,17 +142,20 @@ static void FreeOldCacheDirectory(const fml::UniqueFD& cache_base_dir) {
   });
 }
 
+static fml::UniqueFD OpenCacheBaseDirectory(
+    const std::string& global_cache_base_path) {
+  if (global_cache_base_path.length()) {
+    return fml::OpenDirectory(global_cache_base_path.c_str(), false,
+                              fml::FilePermission::kRead);
+  }
+  return fml::paths::GetCachesDirectory();
+}
+
 static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
     const std::string& global_cache_base_path,
     bool read_only,
     bool cache_sksl) {
-  fml::UniqueFD cache_base_dir;
-  if (global_cache_base_path.length()) {
-    cache_base_dir = fml::OpenDirectory(global_cache_base_path.c_str(), false,
-                                        fml::FilePermission::kRead);
-  } else {
-    cache_base_dir = fml::paths::GetCachesDirectory();
-  }
+  fml::UniqueFD cache_base_dir = OpenCacheBaseDirectory(global_cache_base_path);
 
   if (cache_base_dir.is_valid()) {
     FreeOldCacheDirectory(cache_base_dir);
@@ -158,6 +174,18 @@ static std::shared_ptr<fml::UniqueFD> MakeCacheDirectory(
 }
 }  // namespace
 
+fml::UniqueFD PersistentCache::CreateEngineCacheDirectory(
+    const std::string& name) {
+  fml::UniqueFD cache_base_dir = OpenCacheBaseDirectory(cache_base_path_);
+  if (!cache_base_dir.is_valid()) {
+    return {};
+  }
+  return CreateDirectory(cache_base_dir,
+                         {kEngineComponent, GetFlutterEngineVersion(), name},
+                         gIsReadOnly ? fml::FilePermission::kRead
+                                     : fml::FilePermission::kReadWrite);
+}
+
 sk_sp<SkData> ParseBase32(const std::string& input) {
   std::pair<bool, std::string> decode_result = fml::Base32Decode(input);
   if (!decode_result.first) {
@@ -214,11 +242,36 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() {
     // opened directory (https://github.com/flutter/flutter/issues/65258).
     fml::UniqueFD fresh_dir =
         fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
-    if (fresh_dir.is_valid()) {
+    if (sksl_cache_file_) {
+      std::set<std::string> keys;
+      for (auto& entry : sksl_cache_file_->LoadAll()) {
+        keys.emplace(static_cast<const char*>(entry.first->data()),
+                     entry.first->size());
+        result.push_back(std::move(entry));
+      }
+      // The legacy files that were not migrated yet hold SkSLs too.
+      if (!*legacy_files_migrated_ && fresh_dir.is_valid()) {
+        fml::VisitFiles(fresh_dir, [&](const fml::UniqueFD& directory,
+                                       const std::string& filename) {
+          if (filename == kCacheFileName ||
+              filename == PersistentCacheFile::LockFileName(kCacheFileName)) {
+            return true;
+          }
+          sk_sp<SkData> key = ParseBase32(filename);
+          if (key != nullptr &&
+              keys.count({static_cast<const char*>(key->data()),
+                          key->size()}) > 0) {
+            return true;
+          }
+          return visitor(directory, filename);
+        });
+      }
+    } else if (fresh_dir.is_valid()) {
       fml::VisitFiles(fresh_dir, visitor);
     }
   }
 
+  std::set<std::string> asset_sksl_keys;
   std::unique_ptr<fml::Mapping> mapping = nullptr;
   if (asset_manager_ != nullptr) {
     mapping = asset_manager_->GetAsMapping(kAssetFileName);
@@ -238,6 +291,8 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() {
         sk_sp<SkData> key = ParseBase32(item.name.GetString());
         sk_sp<SkData> sksl = ParseBase64(item.value.GetString());
         if (key != nullptr && sksl != nullptr) {
+          asset_sksl_keys.emplace(static_cast<const char*>(key->data()),
+                                  key->size());
           result.push_back({key, sksl});
         } else {
           FML_LOG(ERROR) << "Failed to load: " << item.name.GetString();
@@ -246,6 +301,11 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() {
     }
   }
 
+  {
+    std::scoped_lock lock(asset_sksl_keys_mutex_);
+    asset_sksl_keys_ = std::move(asset_sksl_keys);
+  }
+
   return result;
 }
 
@@ -253,7 +313,10 @@ PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
       cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, true)),
+      cache_file_(OpenCacheFile(cache_directory_, read_only)),
+      sksl_cache_file_(OpenCacheFile(sksl_cache_directory_, read_only)),
+      legacy_files_migrated_(std::make_shared<std::atomic<bool>>(read_only)) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
@@ -279,23 +342,90 @@ sk_sp<SkData> PersistentCache::LoadFile(const fml::UniqueFD& dir,
   return SkData::MakeWithCopy(mapping->GetMapping(), mapping->GetSize());
 }
 
+std::shared_ptr<PersistentCacheFile> PersistentCache::OpenCacheFile(
+    std::shared_ptr<fml::UniqueFD> directory,
+    bool read_only) {
+  return PersistentCacheFile::Open(directory, kCacheFileName, read_only);
+}
+
+void PersistentCache::MigrateLegacyFiles(const fml::UniqueFD& directory,
+                                         PersistentCacheFile& cache_file) {
+  std::vector<std::string> migrated_files;
+  fml::VisitFiles(directory, [&](const fml::UniqueFD& dir,
+                                 const std::string& filename) {
+    if (filename == kCacheFileName ||
+        filename == PersistentCacheFile::LockFileName(kCacheFileName) ||
+        fml::IsDirectory(dir, filename.c_str())) {
+      return true;
+    }
+    // Legacy entries are named after their Base32 encoded key. This skips
+    // SKP dumps and temporary files.
+    auto decode_result = fml::Base32Decode(filename);
+    if (!decode_result.first || decode_result.second.empty()) {
+      return true;
+    }
+    sk_sp<SkData> key = SkData::MakeWithCopy(decode_result.second.data(),
+                                             decode_result.second.size());
+    sk_sp<SkData> value = LoadFile(dir, filename);
+    if (value != nullptr && cache_file.Store(*key, *value)) {
+      migrated_files.push_back(filename);
+    }
+    return true;
+  });
+
+  if (migrated_files.empty()) {
+    return;
+  }
+  FML_LOG(INFO) << "Migrated " << migrated_files.size()
+                << " entries into the persistent cache file.";
+  for (const auto& filename : migrated_files) {
+    fml::UnlinkFile(directory, filename.c_str());
+  }
+  cache_file.Compact();
+}
+
 // |GrContextOptions::PersistentCache|
 sk_sp<SkData> PersistentCache::load(const SkData& key) {
   TRACE_EVENT0("flutter", "PersistentCacheLoad");
   if (!IsValid()) {
     return nullptr;
   }
-  auto file_name = SkKeyToFilePath(key);
-  if (file_name.size() == 0) {
-    return nullptr;
+  sk_sp<SkData> result;
+  if (cache_file_) {
+    result = cache_file_->Load(key);
+    if (result == nullptr && !*legacy_files_migrated_) {
+      auto file_name = SkKeyToFilePath(key);
+      if (file_name.size() > 0) {
+        result = PersistentCache::LoadFile(*cache_directory_, file_name);
+      }
+    }
+  } else {
+    auto file_name = SkKeyToFilePath(key);
+    if (file_name.size() == 0) {
+      return nullptr;
+    }
+    result = PersistentCache::LoadFile(*cache_directory_, file_name);
   }
-  auto result = PersistentCache::LoadFile(*cache_directory_, file_name);
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
+    RecordFirstFrameShader(key);
   }
   return result;
 }
 
+static void PostPersistentCacheTask(fml::RefPtr<fml::TaskRunner> worker,
+                                    fml::closure task) {
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(std::move(task));
+  }
+}
+
 static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
                                  std::shared_ptr<fml::UniqueFD> cache_directory,
                                  std::string key,
@@ -312,21 +442,30 @@ static void PersistentCacheStore(fml::RefPtr<fml::TaskRunner> worker,
       FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
     }
   });
+  PostPersistentCacheTask(std::move(worker), std::move(task));
+}
 
-  if (!worker) {
-    FML_LOG(WARNING)
-        << "The persistent cache has no available workers. Performing the task "
-           "on the current thread. This slow operation is going to occur on a "
-           "frame workload.";
-    task();
-  } else {
-    worker->PostTask(std::move(task));
-  }
+static void PersistentCacheStore(
+    fml::RefPtr<fml::TaskRunner> worker,
+    std::shared_ptr<PersistentCacheFile> cache_file,
+    sk_sp<SkData> key,
+    sk_sp<SkData> value) {
+  PostPersistentCacheTask(std::move(worker), [cache_file, key, value]() {
+    TRACE_EVENT0("flutter", "PersistentCacheStore");
+    if (!cache_file->Store(*key, *value)) {
+      FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
+      return;
+    }
+    if (cache_file->NeedsCompaction()) {
+      cache_file->Compact();
+    }
+  });
 }
 
 // |GrContextOptions::PersistentCache|
 void PersistentCache::store(const SkData& key, const SkData& data) {
   stored_new_shaders_ = true;
+  RecordFirstFrameShader(key);
 
   if (is_read_only_) {
     return;
@@ -336,8 +475,20 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  auto file_name = SkKeyToFilePath(key);
+  if (key.size() == 0 || data.size() == 0) {
+    return;
+  }
+
+  auto cache_file = cache_sksl_ ? sksl_cache_file_ : cache_file_;
+  if (cache_file) {
+    PersistentCacheStore(GetWorkerTaskRunner(), std::move(cache_file),
+                         SkData::MakeWithCopy(key.data(), key.size()),
+                         SkData::MakeWithCopy(data.data(), data.size()));
+    return;
+  }
 
+  // The cache file could not be opened. Fall back to one file per entry.
+  auto file_name = SkKeyToFilePath(key);
   if (file_name.size() == 0) {
     return;
   }
@@ -345,10 +496,6 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
   auto mapping = std::make_unique<fml::DataMapping>(
       std::vector<uint8_t>{data.bytes(), data.bytes() + data.size()});
 
-  if (mapping == nullptr || mapping->GetSize() == 0) {
-    return;
-  }
-
   PersistentCacheStore(GetWorkerTaskRunner(),
                        cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
                        std::move(file_name), std::move(mapping));
@@ -372,10 +519,128 @@ void PersistentCache::DumpSkp(const SkData& data) {
                        std::move(file_name), std::move(mapping));
 }
 
+// Returns false if no run recorded the shaders of its first frame yet.
+static bool LoadFirstFrameShaders(const fml::UniqueFD& directory,
+                                  std::set<std::string>& keys) {
+  auto mapping = fml::FileMapping::CreateReadOnly(
+      directory, PersistentCache::kFirstFrameShadersFileName);
+  if (mapping == nullptr) {
+    return false;
+  }
+  // The file holds each key prefixed with its 32-bit size.
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+  size_t offset = 0;
+  while (size - offset >= sizeof(uint32_t)) {
+    uint32_t key_size;
+    std::memcpy(&key_size, data + offset, sizeof(uint32_t));
+    offset += sizeof(uint32_t);
+    if (key_size > size - offset) {
+      break;
+    }
+    keys.emplace(reinterpret_cast<const char*>(data + offset), key_size);
+    offset += key_size;
+  }
+  return true;
+}
+
+size_t PersistentCache::PrioritizeFirstFrameSkSLs(
+    std::vector<SkSLCache>& sksls) const {
+  // Without a record, such as on the first run after an install, every SkSL
+  // may be needed by the first frame.
+  std::set<std::string> first_frame_shaders;
+  if (!IsValid() ||
+      !LoadFirstFrameShaders(*cache_directory_, first_frame_shaders)) {
+    return sksls.size();
+  }
+  // The SkSLs bundled with the app exist to avoid jank on the first run, so
+  // they are never deferred.
+  {
+    std::scoped_lock lock(asset_sksl_keys_mutex_);
+    first_frame_shaders.insert(asset_sksl_keys_.begin(),
+                               asset_sksl_keys_.end());
+  }
+  auto first_frame_end = std::stable_partition(
+      sksls.begin(), sksls.end(), [&](const SkSLCache& sksl) {
+        return first_frame_shaders.count(
+                   std::string(static_cast<const char*>(sksl.first->data()),
+                               sksl.first->size())) > 0;
+      });
+  return first_frame_end - sksls.begin();
+}
+
+void PersistentCache::RecordFirstFrameShader(const SkData& key) {
+  if (!is_recording_first_frame_shaders_) {
+    return;
+  }
+  std::scoped_lock lock(first_frame_shaders_mutex_);
+  first_frame_shaders_.emplace(static_cast<const char*>(key.data()),
+                               key.size());
+}
+
+void PersistentCache::MarkFirstFrameRasterized() {
+  // This is called for every frame, avoid the atomic write when possible.
+  if (!is_recording_first_frame_shaders_ ||
+      !is_recording_first_frame_shaders_.exchange(false)) {
+    return;
+  }
+
+  std::set<std::string> shaders;
+  {
+    std::scoped_lock lock(first_frame_shaders_mutex_);
+    shaders.swap(first_frame_shaders_);
+  }
+  if (shaders.empty() || is_read_only_ || !IsValid()) {
+    return;
+  }
+
+  auto task = [cache_directory = cache_directory_,
+               shaders = std::move(shaders)]() {
+    TRACE_EVENT0("flutter", "PersistentCacheStoreFirstFrameShaders");
+    // Shaders that were precompiled are not looked up by Skia anymore, so
+    // keep the ones recorded by previous runs.
+    std::set<std::string> keys;
+    LoadFirstFrameShaders(*cache_directory, keys);
+    keys.insert(shaders.begin(), shaders.end());
+    std::vector<uint8_t> contents;
+    for (const auto& key : keys) {
+      const uint32_t key_size = key.size();
+      const uint8_t* size_bytes = reinterpret_cast<const uint8_t*>(&key_size);
+      contents.insert(contents.end(), size_bytes,
+                      size_bytes + sizeof(uint32_t));
+      contents.insert(contents.end(), key.begin(), key.end());
+    }
+    fml::DataMapping mapping(std::move(contents));
+    if (!fml::WriteAtomically(*cache_directory, kFirstFrameShadersFileName,
+                              mapping)) {
+      FML_LOG(WARNING) << "Could not write the first frame shaders.";
+    }
+  };
+  PostPersistentCacheTask(GetWorkerTaskRunner(), std::move(task));
+}
+
 void PersistentCache::AddWorkerTaskRunner(
     fml::RefPtr<fml::TaskRunner> task_runner) {
   std::scoped_lock lock(worker_task_runners_mutex_);
   worker_task_runners_.insert(task_runner);
+  if (legacy_files_migration_posted_ || *legacy_files_migrated_) {
+    return;
+  }
+  legacy_files_migration_posted_ = true;
+  task_runner->PostTask([migrated = legacy_files_migrated_,
+                         cache_directory = cache_directory_,
+                         cache_file = cache_file_,
+                         sksl_cache_directory = sksl_cache_directory_,
+                         sksl_cache_file = sksl_cache_file_]() {
+    TRACE_EVENT0("flutter", "PersistentCache::MigrateLegacyFiles");
+    if (cache_file) {
+      MigrateLegacyFiles(*cache_directory, *cache_file);
+    }
+    if (sksl_cache_file) {
+      MigrateLegacyFiles(*sksl_cache_directory, *sksl_cache_file);
+    }
+    *migrated = true;
+  });
 }
 
 void PersistentCache::RemoveWorkerTaskRunner(
@@ -10,6 +10,7 @@
 #include <set>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/common/graphics/persistent_cache_file.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
 #include "flutter/fml/unique_fd.h"
@@ -25,6 +26,11 @@ class ShellTest;
 ///
 /// This is mainly used for Shaders but is also written to by Dart.  It is
 /// thread-safe for reading and writing from multiple threads.
+///
+/// The entries of each cache directory are kept in a single
+/// |PersistentCacheFile|. Entries that older engines stored in one file per
+/// key are moved into it on the first worker task runner that is added, and
+/// are read from their own files until then.
 class PersistentCache : public GrContextOptions::PersistentCache {
  public:
   // Mutable static switch that can be set before GetCacheForProcess. If true,
@@ -41,10 +47,15 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   // affect the cache directory returned by |GetCacheForProcess|.
   static void SetCacheDirectoryPath(std::string path);
 
+  // Opens, creating it if needed, a directory named |name| for another cache
+  // of this engine version. It is next to the shader cache, and is removed
+  // with it when the engine version changes.
+  static fml::UniqueFD CreateEngineCacheDirectory(const std::string& name);
+
   // Convert a binary SkData key into a Base32 encoded string.
   //
-  // This is used to specify persistent cache filenames and service protocol
-  // json keys.
+  // This is used to specify legacy persistent cache filenames and service
+  // protocol json keys.
   static std::string SkKeyToFilePath(const SkData& data);
 
   ~PersistentCache() override;
@@ -62,7 +73,7 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   bool IsDumpingSkp() const { return is_dumping_skp_; }
   void SetIsDumpingSkp(bool value) { is_dumping_skp_ = value; }
 
-  // Remove all files inside the persistent cache directory.
+  // Remove all entries and files inside the persistent cache directory.
   // Return whether the purge is successful.
   bool Purge();
 
@@ -74,6 +85,18 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   /// Load all the SkSL shader caches in the right directory.
   std::vector<SkSLCache> LoadSkSLs();
 
+  /// Move the SkSLs that previous runs needed to render their first frame,
+  /// and the ones bundled in |kAssetFileName| by the last |LoadSkSLs|, to the
+  /// front of |sksls|, keeping the relative order of the others. Returns how
+  /// many SkSLs were moved. Until a run recorded its first frame, all SkSLs
+  /// are considered to be needed and |sksls| is left as is.
+  size_t PrioritizeFirstFrameSkSLs(std::vector<SkSLCache>& sksls) const;
+
+  /// Stop recording the shaders Skia loads and stores, and persist the ones
+  /// recorded so far as the shaders needed by the first frame. Only the first
+  /// call has an effect.
+  void MarkFirstFrameRasterized();
+
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
 
@@ -87,6 +110,9 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   static constexpr char kSkSLSubdirName[] = "sksl";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
+  static constexpr char kCacheFileName[] = "io.flutter.shader_cache";
+  static constexpr char kFirstFrameShadersFileName[] =
+      "io.flutter.first_frame_shaders";
 
  private:
   static std::string cache_base_path_;
@@ -109,17 +135,44 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  // Null if the cache is read-only and the directory only holds legacy files.
+  const std::shared_ptr<PersistentCacheFile> cache_file_;
+  const std::shared_ptr<PersistentCacheFile> sksl_cache_file_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
+  // Whether the migration of the legacy files was posted to a worker. Guarded
+  // by worker_task_runners_mutex_.
+  bool legacy_files_migration_posted_ = false;
+  // Set once the legacy files were migrated. Shared with the migration task,
+  // which may outlive this cache.
+  const std::shared_ptr<std::atomic<bool>> legacy_files_migrated_;
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
 
+  std::atomic<bool> is_recording_first_frame_shaders_ = true;
+  std::mutex first_frame_shaders_mutex_;
+  std::set<std::string> first_frame_shaders_;
+  // The keys of the SkSLs that the last LoadSkSLs found in the asset.
+  mutable std::mutex asset_sksl_keys_mutex_;
+  std::set<std::string> asset_sksl_keys_;
+
   static sk_sp<SkData> LoadFile(const fml::UniqueFD& dir,
                                 const std::string& filen_ame);
 
+  static std::shared_ptr<PersistentCacheFile> OpenCacheFile(
+      std::shared_ptr<fml::UniqueFD> directory,
+      bool read_only);
+
+  // Moves the entries stored one per file by older engines in |directory|
+  // into |cache_file|.
+  static void MigrateLegacyFiles(const fml::UniqueFD& directory,
+                                 PersistentCacheFile& cache_file);
+
   bool IsValid() const;
 
+  void RecordFirstFrameShader(const SkData& key);
+
   PersistentCache(bool read_only = false);
 
   // |GrContextOptions::PersistentCache|
@@ -0,0 +1,738 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/persistent_cache_file.h"
+
+#include "flutter/fml/build_config.h"
+
+#if OS_WIN
+#include <windows.h>
+#else
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // OS_WIN
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "flutter/fml/eintr_wrapper.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+constexpr uint8_t kFileMagic[8] = {'F', 'L', 'T', 'C', 'A', 'C', 'H', 'E'};
+constexpr uint32_t kFileVersion = 1;
+constexpr uint32_t kRecordMagic = 0x52435046;  // "FPCR"
+constexpr size_t kAlignment = 8;
+
+// Past this many records appended after the index, opening the file spends
+// noticeable time rebuilding the in-memory index of those records.
+constexpr size_t kMaxUnindexedRecords = 256;
+
+// The file grows at least by this much, and otherwise doubles, whenever a
+// store runs out of reserved space.
+constexpr size_t kMinCapacity = 64 * 1024;
+
+constexpr char kReplacementSuffix[] = ".replacement";
+constexpr char kLockSuffix[] = ".lock";
+
+struct FileHeader {
+  uint8_t magic[8];
+  uint32_t version;
+  uint32_t reserved;
+  uint64_t index_offset;
+  uint64_t index_count;
+  uint64_t index_checksum;
+  // Covers all the fields above.
+  uint64_t header_checksum;
+};
+
+struct RecordHeader {
+  uint32_t magic;
+  uint32_t key_size;
+  uint64_t value_size;
+  uint64_t key_hash;
+  // Covers all the fields above, the key and the value.
+  uint64_t checksum;
+};
+
+struct IndexEntry {
+  uint64_t key_hash;
+  uint64_t offset;
+};
+
+static_assert(sizeof(FileHeader) % kAlignment == 0, "");
+static_assert(sizeof(RecordHeader) % kAlignment == 0, "");
+static_assert(sizeof(IndexEntry) % kAlignment == 0, "");
+
+constexpr uint64_t kHashOffsetBasis = 0xcbf29ce484222325ull;
+constexpr uint64_t kHashPrime = 0x100000001b3ull;
+
+// 64-bit FNV-1a.
+uint64_t Hash(const void* data, size_t size, uint64_t hash = kHashOffsetBasis) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; i++) {
+    hash ^= bytes[i];
+    hash *= kHashPrime;
+  }
+  return hash;
+}
+
+size_t AlignUp(size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+uint64_t ComputeChecksum(const RecordHeader& header,
+                         const uint8_t* key,
+                         const uint8_t* value) {
+  uint64_t checksum = Hash(&header, offsetof(RecordHeader, checksum));
+  checksum = Hash(key, header.key_size, checksum);
+  return Hash(value, header.value_size, checksum);
+}
+
+FileHeader MakeFileHeader(size_t index_offset,
+                          const std::vector<IndexEntry>& index) {
+  FileHeader header = {};
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kFileVersion;
+  header.index_offset = index_offset;
+  header.index_count = index.size();
+  header.index_checksum =
+      Hash(index.data(), index.size() * sizeof(IndexEntry));
+  header.header_checksum = Hash(&header, offsetof(FileHeader, header_checksum));
+  return header;
+}
+
+std::vector<uint8_t> MakeEmptyFile() {
+  FileHeader header = MakeFileHeader(sizeof(FileHeader), {});
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&header);
+  return {bytes, bytes + sizeof(header)};
+}
+
+std::optional<size_t> FileSize(const fml::UniqueFD& file) {
+#if OS_WIN
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file.get(), &size)) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(size.QuadPart);
+#else
+  struct stat buffer;
+  if (::fstat(file.get(), &buffer) != 0) {
+    return std::nullopt;
+  }
+  return static_cast<size_t>(buffer.st_size);
+#endif  // OS_WIN
+}
+
+bool WriteAt(const fml::UniqueFD& file,
+             const uint8_t* data,
+             size_t size,
+             size_t offset) {
+  while (size > 0) {
+#if OS_WIN
+    OVERLAPPED overlapped = {};
+    overlapped.Offset = static_cast<DWORD>(offset);
+    overlapped.OffsetHigh =
+        static_cast<DWORD>(static_cast<uint64_t>(offset) >> 32);
+    DWORD written = 0;
+    const DWORD chunk = static_cast<DWORD>(std::min<size_t>(size, MAXDWORD));
+    if (!::WriteFile(file.get(), data, chunk, &written, &overlapped)) {
+      return false;
+    }
+#else
+    const ssize_t written =
+        FML_HANDLE_EINTR(::pwrite(file.get(), data, size, offset));
+    if (written < 0) {
+      return false;
+    }
+#endif  // OS_WIN
+    if (written == 0) {
+      return false;
+    }
+    data += written;
+    size -= written;
+    offset += written;
+  }
+  return true;
+}
+
+bool AcquireFileLock(const fml::UniqueFD& file) {
+#if OS_WIN
+  OVERLAPPED overlapped = {};
+  return ::LockFileEx(file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD,
+                      MAXDWORD, &overlapped);
+#else
+  return FML_HANDLE_EINTR(::flock(file.get(), LOCK_EX)) == 0;
+#endif  // OS_WIN
+}
+
+void ReleaseFileLock(const fml::UniqueFD& file) {
+#if OS_WIN
+  OVERLAPPED overlapped = {};
+  ::UnlockFileEx(file.get(), 0, MAXDWORD, MAXDWORD, &overlapped);
+#else
+  ::flock(file.get(), LOCK_UN);
+#endif  // OS_WIN
+}
+
+// Holds |mutex| and, if |lock_file| is valid, an exclusive advisory lock on
+// it.
+class ScopedFileLock {
+ public:
+  ScopedFileLock(std::mutex& mutex, const fml::UniqueFD& lock_file)
+      : lock_(mutex),
+        lock_file_(lock_file),
+        locked_(lock_file.is_valid() && AcquireFileLock(lock_file)) {}
+
+  ~ScopedFileLock() {
+    if (locked_) {
+      ReleaseFileLock(lock_file_);
+    }
+  }
+
+ private:
+  std::scoped_lock<std::mutex> lock_;
+  const fml::UniqueFD& lock_file_;
+  const bool locked_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ScopedFileLock);
+};
+
+#if !OS_WIN
+void ReleaseMapping(const void* ptr, void* context) {
+  delete static_cast<std::shared_ptr<fml::FileMapping>*>(context);
+}
+#endif  // !OS_WIN
+
+}  // namespace
+
+std::unique_ptr<PersistentCacheFile> PersistentCacheFile::Open(
+    std::shared_ptr<fml::UniqueFD> directory,
+    std::string file_name,
+    bool read_only) {
+  if (!directory || !directory->is_valid()) {
+    return nullptr;
+  }
+  std::unique_ptr<PersistentCacheFile> cache_file(new PersistentCacheFile(
+      std::move(directory), std::move(file_name), read_only));
+  {
+    ScopedFileLock file_lock(cache_file->file_lock_mutex_,
+                             cache_file->lock_file_);
+    std::scoped_lock lock(cache_file->mutex_);
+    if (!cache_file->OpenLocked()) {
+      return nullptr;
+    }
+  }
+  return cache_file;
+}
+
+std::string PersistentCacheFile::LockFileName(const std::string& file_name) {
+  return file_name + kLockSuffix;
+}
+
+PersistentCacheFile::PersistentCacheFile(
+    std::shared_ptr<fml::UniqueFD> directory,
+    std::string file_name,
+    bool read_only)
+    : directory_(std::move(directory)),
+      file_name_(std::move(file_name)),
+      read_only_(read_only) {
+  if (!read_only_) {
+    lock_file_ = fml::OpenFile(*directory_, LockFileName(file_name_).c_str(),
+                               true, fml::FilePermission::kReadWrite);
+  }
+}
+
+PersistentCacheFile::~PersistentCacheFile() = default;
+
+sk_sp<SkData> PersistentCacheFile::Load(const SkData& key) {
+  std::scoped_lock lock(mutex_);
+  auto record = FindLocked(key.bytes(), key.size());
+  if (!record) {
+    return nullptr;
+  }
+  return WrapLocked(record->value, record->value_size);
+}
+
+bool PersistentCacheFile::Store(const SkData& key, const SkData& value) {
+  if (read_only_ || key.size() == 0) {
+    return false;
+  }
+
+  ScopedFileLock file_lock(file_lock_mutex_, lock_file_);
+  std::scoped_lock lock(mutex_);
+  CatchUpLocked();
+  auto previous = FindLocked(key.bytes(), key.size());
+
+  RecordHeader header = {};
+  header.magic = kRecordMagic;
+  header.key_size = key.size();
+  header.value_size = value.size();
+  header.key_hash = Hash(key.data(), key.size());
+  header.checksum = ComputeChecksum(header, key.bytes(), value.bytes());
+
+  const size_t offset = end_offset_;
+  const size_t record_size =
+      AlignUp(sizeof(RecordHeader) + key.size() + value.size());
+  const size_t previous_size = previous ? previous->size : 0;
+
+  std::vector<uint8_t> record(record_size);
+  uint8_t* destination = record.data();
+  std::memcpy(destination, &header, sizeof(RecordHeader));
+  destination += sizeof(RecordHeader);
+  std::memcpy(destination, key.data(), key.size());
+  destination += key.size();
+  std::memcpy(destination, value.data(), value.size());
+
+  // A failed write leaves |end_offset_| where it was, so the next store
+  // overwrites whatever part of the record made it to the file.
+  if (!ReserveLocked(offset + record_size) ||
+      !WriteAt(file_, record.data(), record.size(), offset)) {
+    return false;
+  }
+
+  end_offset_ = offset + record_size;
+  unindexed_records_[header.key_hash].push_back(offset);
+  unindexed_record_count_++;
+  superseded_bytes_ += previous_size;
+  generation_++;
+  return true;
+}
+
+std::vector<PersistentCacheFile::Entry> PersistentCacheFile::LoadAll() {
+  std::scoped_lock lock(mutex_);
+  std::vector<Entry> entries;
+  for (const auto& record : LiveRecordsLocked()) {
+    entries.push_back({SkData::MakeWithCopy(record.key, record.key_size),
+                       WrapLocked(record.value, record.value_size)});
+  }
+  return entries;
+}
+
+bool PersistentCacheFile::NeedsCompaction() const {
+  std::scoped_lock lock(mutex_);
+  return !read_only_ && (has_corrupt_records_ ||
+                         unindexed_record_count_ > kMaxUnindexedRecords ||
+                         superseded_bytes_ > end_offset_ / 2);
+}
+
+bool PersistentCacheFile::Compact() {
+  if (read_only_) {
+    return false;
+  }
+
+  TRACE_EVENT0("flutter", "PersistentCacheFile::Compact");
+  // The records point into |mapping|, which stays valid after the lock is
+  // released even if the file is remapped. On Windows, where a mapped file
+  // can't grow, a store made while the records are copied fails.
+  std::shared_ptr<fml::FileMapping> mapping;
+  std::vector<Record> records;
+  uint64_t generation = 0;
+  {
+    std::scoped_lock lock(mutex_);
+    if (!mapping_) {
+      return false;
+    }
+    mapping = mapping_;
+    records = LiveRecordsLocked();
+    generation = generation_;
+  }
+
+  size_t records_size = 0;
+  for (const auto& record : records) {
+    records_size += record.size;
+  }
+  std::vector<uint8_t> contents(sizeof(FileHeader) + records_size +
+                                records.size() * sizeof(IndexEntry));
+
+  std::vector<IndexEntry> index;
+  index.reserve(records.size());
+  size_t offset = sizeof(FileHeader);
+  for (const auto& record : records) {
+    std::memcpy(contents.data() + offset, mapping->GetMapping() + record.offset,
+                record.size);
+    index.push_back({record.key_hash, offset});
+    offset += record.size;
+  }
+  std::sort(index.begin(), index.end(),
+            [](const IndexEntry& a, const IndexEntry& b) {
+              return a.key_hash < b.key_hash ||
+                     (a.key_hash == b.key_hash && a.offset < b.offset);
+            });
+  std::memcpy(contents.data() + offset, index.data(),
+              index.size() * sizeof(IndexEntry));
+
+  FileHeader header = MakeFileHeader(offset, index);
+  std::memcpy(contents.data(), &header, sizeof(FileHeader));
+
+  mapping.reset();
+  return Replace(std::move(contents), generation);
+}
+
+bool PersistentCacheFile::Clear() {
+  if (read_only_) {
+    return false;
+  }
+  return Replace(MakeEmptyFile(), std::nullopt);
+}
+
+bool PersistentCacheFile::OpenLocked() {
+  index_offset_ = 0;
+  index_count_ = 0;
+  unindexed_offset_ = 0;
+  end_offset_ = 0;
+  unindexed_records_.clear();
+  unindexed_record_count_ = 0;
+  superseded_bytes_ = 0;
+  has_corrupt_records_ = false;
+  generation_++;
+
+  mapping_.reset();
+  file_ = read_only_ ? fml::OpenFileReadOnly(*directory_, file_name_.c_str())
+                     : fml::OpenFile(*directory_, file_name_.c_str(), true,
+                                     fml::FilePermission::kReadWrite);
+  if (!file_.is_valid() || !MapLocked()) {
+    return false;
+  }
+
+  if (!ReadHeaderLocked()) {
+    if (mapping_->GetSize() > 0) {
+      FML_LOG(WARNING) << "Discarding the corrupt persistent cache file "
+                       << file_name_;
+    }
+    // A read-only file that can't be used is treated as an empty one.
+    return read_only_ || WriteLocked(MakeEmptyFile());
+  }
+
+  ScanRecordsLocked(unindexed_offset_);
+  return true;
+}
+
+bool PersistentCacheFile::MapLocked() {
+  std::shared_ptr<fml::FileMapping> mapping;
+  if (read_only_) {
+    mapping = std::make_shared<fml::FileMapping>(file_);
+  } else {
+    // Unlike a private one, a shared mapping is guaranteed to see the records
+    // written to the file after it was mapped.
+    mapping = std::make_shared<fml::FileMapping>(
+        file_, std::initializer_list<fml::FileMapping::Protection>{
+                   fml::FileMapping::Protection::kRead,
+                   fml::FileMapping::Protection::kWrite});
+  }
+  if (!mapping->IsValid()) {
+    return false;
+  }
+  mapping_ = std::move(mapping);
+  return true;
+}
+
+bool PersistentCacheFile::ReadHeaderLocked() {
+  const size_t size = mapping_->GetSize();
+  if (size < sizeof(FileHeader)) {
+    return false;
+  }
+
+  FileHeader header;
+  std::memcpy(&header, mapping_->GetMapping(), sizeof(FileHeader));
+  if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0 ||
+      header.version != kFileVersion ||
+      header.header_checksum !=
+          Hash(&header, offsetof(FileHeader, header_checksum))) {
+    return false;
+  }
+
+  if (header.index_offset < sizeof(FileHeader) ||
+      header.index_offset % kAlignment != 0 || header.index_offset > size ||
+      header.index_count >
+          (size - header.index_offset) / sizeof(IndexEntry)) {
+    return false;
+  }
+
+  const size_t index_size = header.index_count * sizeof(IndexEntry);
+  if (Hash(mapping_->GetMapping() + header.index_offset, index_size) !=
+      header.index_checksum) {
+    return false;
+  }
+
+  index_offset_ = header.index_offset;
+  index_count_ = header.index_count;
+  unindexed_offset_ = index_offset_ + index_size;
+  end_offset_ = size;
+  return true;
+}
+
+void PersistentCacheFile::ScanRecordsLocked(size_t offset) {
+  end_offset_ = mapping_ ? mapping_->GetSize() : offset;
+  while (offset < end_offset_) {
+    auto record = ReadRecordLocked(offset);
+    if (!record) {
+      break;
+    }
+    auto previous = FindLocked(record->key, record->key_size);
+    if (previous) {
+      superseded_bytes_ += previous->size;
+    }
+    unindexed_records_[record->key_hash].push_back(offset);
+    unindexed_record_count_++;
+    offset += record->size;
+  }
+
+  // The space reserved for future records starts with a zeroed header.
+  const size_t remaining = std::min(end_offset_ - offset, sizeof(RecordHeader));
+  const uint8_t* rest = mapping_ ? mapping_->GetMapping() + offset : nullptr;
+  if (remaining > 0 &&
+      std::any_of(rest, rest + remaining, [](uint8_t b) { return b != 0; })) {
+    // Most likely a write that was interrupted.
+    FML_LOG(WARNING) << "Dropping the invalid records at the end of the "
+                        "persistent cache file "
+                     << file_name_;
+    if (!read_only_) {
+      // Mark the space as free rather than truncating the file, which could
+      // pull pages out from under the mappings of other processes.
+      const std::vector<uint8_t> zeros(remaining);
+      WriteAt(file_, zeros.data(), zeros.size(), offset);
+    }
+  }
+  end_offset_ = offset;
+}
+
+void PersistentCacheFile::CatchUpLocked() {
+  auto size = FileSize(file_);
+  if (!size || !mapping_) {
+    return;
+  }
+  if (*size > mapping_->GetSize() && !MapLocked()) {
+    return;
+  }
+  const size_t record_count = unindexed_record_count_;
+  ScanRecordsLocked(end_offset_);
+  if (unindexed_record_count_ != record_count) {
+    generation_++;
+  }
+}
+
+bool PersistentCacheFile::ReserveLocked(size_t size) {
+  const size_t mapped_size = mapping_ ? mapping_->GetSize() : 0;
+  if (mapped_size >= size) {
+    return true;
+  }
+  size_t capacity = std::max({size, kMinCapacity, mapped_size * 2});
+  if (auto file_size = FileSize(file_)) {
+    capacity = std::max(capacity, *file_size);
+  }
+  TRACE_EVENT0("flutter", "PersistentCacheFile::Grow");
+  // Windows can't resize a file while a view of it is mapped.
+  mapping_.reset();
+  const bool resized = fml::TruncateFile(file_, capacity);
+  return MapLocked() && resized;
+}
+
+bool PersistentCacheFile::WriteLocked(std::vector<uint8_t> contents) {
+  // Windows can't replace a file that is open or mapped.
+  mapping_.reset();
+  file_.reset();
+  fml::DataMapping mapping(std::move(contents));
+  if (!fml::WriteAtomically(*directory_, file_name_.c_str(), mapping)) {
+    FML_LOG(WARNING) << "Could not write the persistent cache file "
+                     << file_name_;
+    return false;
+  }
+  return OpenLocked();
+}
+
+bool PersistentCacheFile::Replace(std::vector<uint8_t> contents,
+                                  std::optional<uint64_t> generation) {
+  // Stores wait for the lock, so nothing changes until the file is swapped.
+  ScopedFileLock file_lock(file_lock_mutex_, lock_file_);
+  {
+    std::scoped_lock lock(mutex_);
+    CatchUpLocked();
+    if (generation && *generation != generation_) {
+      return false;
+    }
+  }
+
+  const std::string replacement_name = file_name_ + kReplacementSuffix;
+  fml::DataMapping mapping(std::move(contents));
+  if (!fml::WriteAtomically(*directory_, replacement_name.c_str(), mapping)) {
+    FML_LOG(WARNING) << "Could not write the persistent cache file "
+                     << replacement_name;
+    return false;
+  }
+
+  std::scoped_lock lock(mutex_);
+
+  // Windows can't replace a file that is open or mapped.
+  mapping_.reset();
+  file_.reset();
+  const bool renamed = fml::RenameFile(*directory_, replacement_name.c_str(),
+                                       file_name_.c_str());
+  if (!renamed) {
+    FML_LOG(WARNING) << "Could not replace the persistent cache file "
+                     << file_name_;
+    fml::UnlinkFile(*directory_, replacement_name.c_str());
+  }
+  // Reopens the previous file if the rename failed.
+  return OpenLocked() && renamed;
+}
+
+std::optional<PersistentCacheFile::Record>
+PersistentCacheFile::ReadRecordLocked(size_t offset) const {
+  if (!mapping_ || offset % kAlignment != 0 || offset > end_offset_ ||
+      end_offset_ - offset < sizeof(RecordHeader)) {
+    return std::nullopt;
+  }
+
+  const uint8_t* bytes = mapping_->GetMapping() + offset;
+  RecordHeader header;
+  std::memcpy(&header, bytes, sizeof(RecordHeader));
+  if (header.magic != kRecordMagic) {
+    return std::nullopt;
+  }
+
+  const size_t available = end_offset_ - offset - sizeof(RecordHeader);
+  if (header.key_size > available ||
+      header.value_size > available - header.key_size) {
+    return std::nullopt;
+  }
+  const size_t size =
+      AlignUp(sizeof(RecordHeader) + header.key_size + header.value_size);
+  if (size > end_offset_ - offset) {
+    return std::nullopt;
+  }
+
+  const uint8_t* key = bytes + sizeof(RecordHeader);
+  const uint8_t* value = key + header.key_size;
+  if (ComputeChecksum(header, key, value) != header.checksum) {
+    return std::nullopt;
+  }
+
+  return Record{offset, size,  header.key_hash,   key,
+                header.key_size, value, header.value_size};
+}
+
+std::optional<PersistentCacheFile::Record> PersistentCacheFile::FindLocked(
+    const uint8_t* key,
+    size_t key_size) {
+  const uint64_t key_hash = Hash(key, key_size);
+  auto matches = [&](const std::optional<Record>& record) {
+    return record && record->key_hash == key_hash &&
+           record->key_size == key_size &&
+           std::memcmp(record->key, key, key_size) == 0;
+  };
+
+  // Records appended since the last compaction supersede the indexed ones.
+  auto found = unindexed_records_.find(key_hash);
+  if (found != unindexed_records_.end()) {
+    for (auto it = found->second.rbegin(); it != found->second.rend(); ++it) {
+      auto record = ReadRecordLocked(*it);
+      if (matches(record)) {
+        return record;
+      }
+    }
+  }
+
+  if (!mapping_ || index_count_ == 0) {
+    return std::nullopt;
+  }
+  const uint8_t* index = mapping_->GetMapping() + index_offset_;
+  auto entry_at = [index](size_t i) {
+    IndexEntry entry;
+    std::memcpy(&entry, index + i * sizeof(IndexEntry), sizeof(IndexEntry));
+    return entry;
+  };
+
+  size_t low = 0;
+  size_t high = index_count_;
+  while (low < high) {
+    const size_t middle = low + (high - low) / 2;
+    if (entry_at(middle).key_hash < key_hash) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  for (size_t i = low; i < index_count_; i++) {
+    const IndexEntry entry = entry_at(i);
+    if (entry.key_hash != key_hash) {
+      break;
+    }
+    auto record = ReadRecordLocked(entry.offset);
+    if (!record) {
+      FML_LOG(WARNING) << "Skipping a corrupt record in the persistent cache "
+                          "file "
+                       << file_name_;
+      has_corrupt_records_ = true;
+      continue;
+    }
+    if (matches(record)) {
+      return record;
+    }
+  }
+
+  return std::nullopt;
+}
+
+std::vector<PersistentCacheFile::Record>
+PersistentCacheFile::LiveRecordsLocked() {
+  std::vector<Record> records;
+  auto add_if_latest = [&](const std::optional<Record>& record) {
+    auto latest = FindLocked(record->key, record->key_size);
+    if (latest && latest->offset == record->offset) {
+      records.push_back(*record);
+    }
+  };
+
+  if (!mapping_) {
+    return records;
+  }
+  const uint8_t* index = mapping_->GetMapping() + index_offset_;
+  for (size_t i = 0; i < index_count_; i++) {
+    IndexEntry entry;
+    std::memcpy(&entry, index + i * sizeof(IndexEntry), sizeof(IndexEntry));
+    auto record = ReadRecordLocked(entry.offset);
+    if (!record) {
+      has_corrupt_records_ = true;
+      continue;
+    }
+    add_if_latest(record);
+  }
+
+  size_t offset = unindexed_offset_;
+  while (offset < end_offset_) {
+    auto record = ReadRecordLocked(offset);
+    if (!record) {
+      break;
+    }
+    add_if_latest(record);
+    offset += record->size;
+  }
+
+  return records;
+}
+
+sk_sp<SkData> PersistentCacheFile::WrapLocked(const uint8_t* data,
+                                              size_t size) const {
+#if OS_WIN
+  // A mapped view would keep the file from being resized or replaced.
+  return SkData::MakeWithCopy(data, size);
+#else
+  // The data stays valid for as long as the mapping it was read from, even if
+  // the file is compacted or cleared in the meantime.
+  return SkData::MakeWithProc(
+      data, size, &ReleaseMapping,
+      new std::shared_ptr<fml::FileMapping>(mapping_));
+#endif  // OS_WIN
+}
+
+}  // namespace flutter
@@ -0,0 +1,162 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_FILE_H_
+#define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_FILE_H_
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+/// A key-value store of SkData kept in a single memory-mapped file.
+///
+/// The file starts with a header that points at an index of the records
+/// sorted by key hash. The index covers the records written by the last
+/// compaction. Records stored since then are appended to the end of the file
+/// and indexed in memory when the file is opened. A lookup only touches the
+/// pages of the index and of the records it hits, so opening a large cache is
+/// cheap.
+///
+/// Stores write their record with a single positioned write into space that
+/// is reserved ahead of time. The file and its mapping grow geometrically, so
+/// the records are followed by zeros up to the end of the file.
+///
+/// Every record carries a checksum. A file with a damaged header or index is
+/// discarded, and a damaged or torn record at the end of the file is dropped
+/// along with everything after it.
+///
+/// This class is thread-safe. Writes are also serialized with other processes
+/// that use the same file, through an advisory lock on a file next to it.
+class PersistentCacheFile {
+ public:
+  using Entry = std::pair<sk_sp<SkData>, sk_sp<SkData>>;
+
+  /// Opens the cache file |file_name| in |directory|. Unless |read_only| is
+  /// set, the file is created if it doesn't exist yet and a corrupt file is
+  /// replaced by an empty one. Returns nullptr if the file could not be
+  /// opened.
+  static std::unique_ptr<PersistentCacheFile> Open(
+      std::shared_ptr<fml::UniqueFD> directory,
+      std::string file_name,
+      bool read_only);
+
+  ~PersistentCacheFile();
+
+  /// Returns the value most recently stored for |key|, or nullptr if there is
+  /// none. The returned data references the file mapping without copying it.
+  sk_sp<SkData> Load(const SkData& key);
+
+  /// Appends a record for |key| to the file. The record supersedes any value
+  /// previously stored for the same key.
+  bool Store(const SkData& key, const SkData& value);
+
+  /// Returns the latest value of every key in the file.
+  std::vector<Entry> LoadAll();
+
+  /// Whether enough records were appended or superseded since the last
+  /// compaction to make |Compact| worth its cost.
+  bool NeedsCompaction() const;
+
+  /// Atomically rewrites the file with only the latest valid record of each
+  /// key, followed by a fresh index. The new file is written without holding
+  /// up lookups. Returns false without changing anything if a record was
+  /// stored in the meantime.
+  bool Compact();
+
+  /// Removes all the records from the file.
+  bool Clear();
+
+  /// The name of the lock file kept next to the cache file |file_name|.
+  static std::string LockFileName(const std::string& file_name);
+
+ private:
+  struct Record {
+    size_t offset;
+    size_t size;
+    uint64_t key_hash;
+    const uint8_t* key;
+    size_t key_size;
+    const uint8_t* value;
+    size_t value_size;
+  };
+
+  const std::shared_ptr<fml::UniqueFD> directory_;
+  const std::string file_name_;
+  const bool read_only_;
+
+  // Serializes the writes of this process. Taken before |mutex_|, along with
+  // the advisory lock on |lock_file_| that serializes them across processes.
+  std::mutex file_lock_mutex_;
+  // Invalid if the file is read-only or the lock file could not be opened.
+  fml::UniqueFD lock_file_;
+  mutable std::mutex mutex_;
+  fml::UniqueFD file_;
+  // Null if the file could not be mapped. Covers the whole file, including
+  // the space reserved for future records.
+  std::shared_ptr<fml::FileMapping> mapping_;
+  size_t index_offset_ = 0;
+  size_t index_count_ = 0;
+  size_t unindexed_offset_ = 0;
+  size_t end_offset_ = 0;
+  // Key hashes of the records appended after the index, mapped to their
+  // offsets from the oldest to the newest.
+  std::unordered_map<uint64_t, std::vector<size_t>> unindexed_records_;
+  size_t unindexed_record_count_ = 0;
+  size_t superseded_bytes_ = 0;
+  bool has_corrupt_records_ = false;
+  // Bumped whenever the contents of the file change.
+  uint64_t generation_ = 0;
+
+  PersistentCacheFile(std::shared_ptr<fml::UniqueFD> directory,
+                      std::string file_name,
+                      bool read_only);
+
+  bool OpenLocked();
+
+  bool MapLocked();
+
+  bool ReadHeaderLocked();
+
+  /// Indexes the records from |offset| on, and sets |end_offset_| past the
+  /// last valid one.
+  void ScanRecordsLocked(size_t offset);
+
+  /// Picks up the records other processes appended since the last write.
+  void CatchUpLocked();
+
+  /// Grows the file, if needed, so that it holds at least |size| bytes.
+  bool ReserveLocked(size_t size);
+
+  bool WriteLocked(std::vector<uint8_t> contents);
+
+  /// Writes |contents| next to the file and then swaps it in, unless
+  /// |generation| is set and no longer matches |generation_|.
+  bool Replace(std::vector<uint8_t> contents,
+               std::optional<uint64_t> generation);
+
+  std::optional<Record> ReadRecordLocked(size_t offset) const;
+
+  std::optional<Record> FindLocked(const uint8_t* key, size_t key_size);
+
+  std::vector<Record> LiveRecordsLocked();
+
+  sk_sp<SkData> WrapLocked(const uint8_t* data, size_t size) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PersistentCacheFile);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_FILE_H_
@@ -62,6 +62,22 @@ std::string Settings::ToString() const {
   stream << "frame_rasterized_callback set: " << !!frame_rasterized_callback
          << std::endl;
   stream << "old_gen_heap_size: " << old_gen_heap_size << std::endl;
+  stream << "raster_cache_max_bytes: " << raster_cache_max_bytes << std::endl;
+  stream << "raster_cache_max_unused_frames: "
+         << raster_cache_max_unused_frames << std::endl;
+  stream << "enable_async_raster_cache: " << enable_async_raster_cache
+         << std::endl;
+  stream << "resample_pointer_events: " << resample_pointer_events
+         << std::endl;
+  stream << "pack_pointer_data: " << pack_pointer_data << std::endl;
+  stream << "defer_offscreen_semantics: " << defer_offscreen_semantics
+         << std::endl;
+  stream << "frame_latency_mode: " << static_cast<int>(frame_latency_mode)
+         << std::endl;
+  stream << "text_layout_cache_max_bytes: " << text_layout_cache_max_bytes
+         << std::endl;
+  stream << "enable_parallel_text_shaping: " << enable_parallel_text_shaping
+         << std::endl;
   return stream.str();
 }
 
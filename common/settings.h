@@ -44,6 +44,19 @@ class FrameTiming {
   fml::TimePoint data_[kCount];
 };
 
+// How the engine trades the latency of frames for their throughput.
+enum class FrameLatencyMode {
+  // The pipeline depth suited to the threading configuration of the platform.
+  kDefault,
+  // Only one frame is in flight at a time, and frames are begun as late in
+  // the vsync interval as recent build and raster times allow, so that they
+  // reflect the most recent input.
+  kLowLatency,
+  // More frames are in flight at a time, so that the UI thread can build the
+  // next frames while the raster thread is still busy.
+  kThroughput,
+};
+
 using TaskObserverAdd =
     std::function<void(intptr_t /* key */, fml::closure /* callback */)>;
 using TaskObserverRemove = std::function<void(intptr_t /* key */)>;
@@ -219,6 +232,47 @@ struct Settings {
       fml::UniqueFD::traits_type::InvalidValue();
   std::string assets_path;
 
+  // The maximum number of bytes of images the raster cache may hold. When 0,
+  // the raster cache evicts every entry that was not used in the last frame
+  // instead of enforcing a byte budget.
+  size_t raster_cache_max_bytes = 0;
+
+  // The number of frames a raster cache entry may go unused before it is
+  // evicted. Only used when raster_cache_max_bytes is non-zero.
+  size_t raster_cache_max_unused_frames = 120;
+
+  // Whether the raster cache rasterizes pictures on the IO thread with the
+  // shared resource context instead of inline on the raster thread.
+  bool enable_async_raster_cache = false;
+
+  // Whether pointer events are dispatched once per vsync with the moves of
+  // each device merged and resampled to the frame time, instead of by the
+  // dispatcher of the platform view. See `ResamplingPointerDataDispatcher`.
+  bool resample_pointer_events = false;
+
+  // Whether pointer events are handed to the framework in the packed layout of
+  // `PointerDataPacketConverter::Pack` instead of as `PointerData` structs.
+  bool pack_pointer_data = false;
+
+  // Whether semantics nodes far outside of the viewport are held back from the
+  // platform view until they are needed. See `SemanticsViewportFilter`.
+  bool defer_offscreen_semantics = false;
+
+  // The initial frame latency mode. It may be changed at runtime with
+  // `Shell::SetFrameLatencyMode`.
+  FrameLatencyMode frame_latency_mode = FrameLatencyMode::kDefault;
+
+  // The maximum number of bytes of shaped words the text layout cache may
+  // hold. The cache is shared by all engines in the process. When 0, the
+  // default budget of the cache is kept.
+  size_t text_layout_cache_max_bytes = 0;
+
+  // Whether the text runs of long paragraphs are measured in parallel on the
+  // concurrent worker threads before they are broken into lines. Spawned
+  // engines share the font collection of the engine they were spawned from,
+  // and keep its setting.
+  bool enable_parallel_text_shaping = false;
+
   // Callback to handle the timings of a rasterized frame. This is called as
   // soon as a frame is rasterized.
   FrameRasterizedCallback frame_rasterized_callback;
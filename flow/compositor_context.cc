@@ -4,6 +4,8 @@
 
 #include "flutter/flow/compositor_context.h"
 
+#include <optional>
+
 #include "flutter/flow/layers/layer_tree.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
@@ -67,10 +69,72 @@ CompositorContext::ScopedFrame::~ScopedFrame() {
   context_.EndFrame(*this, instrumentation_enabled_);
 }
 
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+
+SkRect FrameDamage::ComputeClipRect(flutter::LayerTree& layer_tree,
+                                    DiffHistory* history) {
+  TRACE_EVENT0("flutter", "FrameDamage::ComputeClipRect");
+  const SkISize& frame_size = layer_tree.frame_size();
+  const SkRect frame_rect = SkRect::Make(frame_size);
+  if (!layer_tree.root_layer()) {
+    damage_ = Damage{SkIRect::MakeSize(frame_size),
+                     SkIRect::MakeSize(frame_size)};
+    return frame_rect;
+  }
+
+  // Diffing a layer tree against itself (e.g. when redrawing the last layer
+  // tree after the surface was recreated) would read and write the same paint
+  // region map, so treat it like a missing previous tree.
+  const bool has_previous = prev_layer_tree_ &&
+                            prev_layer_tree_ != &layer_tree &&
+                            prev_layer_tree_->root_layer() &&
+                            prev_layer_tree_->frame_size() == frame_size;
+
+  static const PaintRegionMap kEmptyPaintRegionMap;
+  DiffContext context(
+      frame_size, layer_tree.device_pixel_ratio(),
+      layer_tree.paint_region_map(),
+      has_previous ? prev_layer_tree_->paint_region_map()
+                   : kEmptyPaintRegionMap,
+      history);
+  context.PushCullRect(frame_rect);
+  {
+    DiffContext::AutoSubtreeRestore subtree(&context);
+    if (!has_previous) {
+      context.MarkSubtreeDirty();
+    }
+    layer_tree.root_layer()->Diff(
+        &context, has_previous ? prev_layer_tree_->root_layer() : nullptr);
+  }
+  context.statistics().LogStatistics();
+  if (history) {
+    history->EndFrame();
+  }
+
+  if (has_previous) {
+    damage_ = context.ComputeDamage(additional_damage_);
+  } else {
+    damage_ = Damage{SkIRect::MakeSize(frame_size),
+                     SkIRect::MakeSize(frame_size)};
+  }
+  return SkRect::Make(damage_->buffer_damage);
+}
+
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
 RasterStatus CompositorContext::ScopedFrame::Raster(
     flutter::LayerTree& layer_tree,
-    bool ignore_raster_cache) {
+    bool ignore_raster_cache,
+    FrameDamage* frame_damage) {
   TRACE_EVENT0("flutter", "CompositorContext::ScopedFrame::Raster");
+  std::optional<SkRect> clip_rect;
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  if (frame_damage) {
+    clip_rect =
+        frame_damage->ComputeClipRect(layer_tree, &context_.diff_history());
+  }
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
   bool root_needs_readback = layer_tree.Preroll(*this, ignore_raster_cache);
   bool needs_save_layer = root_needs_readback && !surface_supports_readback();
   PostPrerollResult post_preroll_result = PostPrerollResult::kSuccess;
@@ -85,9 +149,15 @@ RasterStatus CompositorContext::ScopedFrame::Raster(
   if (post_preroll_result == PostPrerollResult::kSkipAndRetryFrame) {
     return RasterStatus::kSkipAndRetry;
   }
+  // Restores the clip of the canvas, which may outlive this frame.
+  std::optional<SkAutoCanvasRestore> clip_restore;
   // Clearing canvas after preroll reduces one render target switch when preroll
   // paints some raster cache.
   if (canvas()) {
+    if (clip_rect) {
+      clip_restore.emplace(canvas(), true);
+      canvas()->clipRect(*clip_rect);
+    }
     if (needs_save_layer) {
       FML_LOG(INFO) << "Using SaveLayer to protect non-readback surface";
       SkRect bounds = SkRect::Make(layer_tree.frame_size());
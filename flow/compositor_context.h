@@ -6,9 +6,11 @@
 #define FLUTTER_FLOW_COMPOSITOR_CONTEXT_H_
 
 #include <memory>
+#include <optional>
 #include <string>
 
 #include "flutter/common/graphics/texture.h"
+#include "flutter/flow/diff_context.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/instrumentation.h"
 #include "flutter/flow/raster_cache.h"
@@ -20,6 +22,7 @@
 namespace flutter {
 
 class LayerTree;
+class FrameDamage;
 
 enum class RasterStatus {
   // Frame has successfully rasterized.
@@ -50,6 +53,44 @@ enum class RasterStatus {
   kDiscarded
 };
 
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+
+// Computes the area of a frame that needs to be repainted for surfaces that
+// support partial repaint, by diffing the layer tree against the layer tree
+// that was last rasterized into the same framebuffer.
+class FrameDamage {
+ public:
+  // The layer tree that was last rasterized. If there is none, or if its
+  // frame size differs, the whole frame is damaged.
+  void SetPreviousLayerTree(const LayerTree* prev_layer_tree) {
+    prev_layer_tree_ = prev_layer_tree;
+  }
+
+  // Adds damage accumulated in the target framebuffer since it last held the
+  // previous layer tree (e.g. computed from the buffer age). Must be called
+  // before ComputeClipRect.
+  void AddAdditionalDamage(const SkIRect& damage) {
+    additional_damage_.join(damage);
+  }
+
+  // Diffs the layer tree against the previous one and returns the rect in
+  // frame coordinates that painting must be clipped to. This also records
+  // the paint regions of the layer tree so that it can serve as the previous
+  // layer tree of the next frame. The optional |history| carries picture
+  // comparison outcomes across frames.
+  SkRect ComputeClipRect(LayerTree& layer_tree, DiffHistory* history);
+
+  // The damage computed by ComputeClipRect.
+  const std::optional<Damage>& GetDamage() const { return damage_; }
+
+ private:
+  const LayerTree* prev_layer_tree_ = nullptr;
+  SkIRect additional_damage_ = SkIRect::MakeEmpty();
+  std::optional<Damage> damage_;
+};
+
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
 class CompositorContext {
  public:
   class ScopedFrame {
@@ -79,8 +120,11 @@ class CompositorContext {
 
     GrDirectContext* gr_context() const { return gr_context_; }
 
+    // If |frame_damage| is given, painting is clipped to the area of the
+    // frame that changed compared to the previous layer tree in it.
     virtual RasterStatus Raster(LayerTree& layer_tree,
-                                bool ignore_raster_cache);
+                                bool ignore_raster_cache,
+                                FrameDamage* frame_damage);
 
    private:
     CompositorContext& context_;
@@ -114,6 +158,10 @@ class CompositorContext {
 
   RasterCache& raster_cache() { return raster_cache_; }
 
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  DiffHistory& diff_history() { return diff_history_; }
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
   TextureRegistry& texture_registry() { return texture_registry_; }
 
   const Counter& frame_count() const { return frame_count_; }
@@ -124,6 +172,9 @@ class CompositorContext {
 
  private:
   RasterCache raster_cache_;
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  DiffHistory diff_history_;
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
   TextureRegistry texture_registry_;
   Counter frame_count_;
   Stopwatch raster_time_;
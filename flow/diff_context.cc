@@ -8,12 +8,14 @@ namespace flutter {
 DiffContext::DiffContext(SkISize frame_size,
                          double frame_device_pixel_ratio,
                          PaintRegionMap& this_frame_paint_region_map,
-                         const PaintRegionMap& last_frame_paint_region_map)
+                         const PaintRegionMap& last_frame_paint_region_map,
+                         DiffHistory* history)
     : rects_(std::make_shared<std::vector<SkRect>>()),
       frame_size_(frame_size),
       frame_device_pixel_ratio_(frame_device_pixel_ratio),
       this_frame_paint_region_map_(this_frame_paint_region_map),
-      last_frame_paint_region_map_(last_frame_paint_region_map) {}
+      last_frame_paint_region_map_(last_frame_paint_region_map),
+      history_(history) {}
 
 void DiffContext::BeginSubtree() {
   state_stack_.push_back(state_);
@@ -27,7 +29,10 @@ void DiffContext::EndSubtree() {
 }
 
 DiffContext::State::State()
-    : dirty(false), cull_rect(kGiantRect), rect_index_(0) {}
+    : dirty(false),
+      cull_rect(kGiantRect),
+      rect_index_(0),
+      container_layer_id(0) {}
 
 void DiffContext::PushTransform(const SkMatrix& transform) {
   state_.transform.preConcat(transform);
@@ -152,7 +157,64 @@ void DiffContext::Statistics::LogStatistics() {
                     deep_compare_pictures_, "SameInstancePictures",
                     same_instance_pictures_,
                     "DifferentInstanceButEqualPictures",
-                    different_instance_but_equal_pictures_);
+                    different_instance_but_equal_pictures_,
+                    "SkippedDeepComparePictures",
+                    skipped_deep_compare_pictures_);
+#endif  // !FLUTTER_RELEASE
+}
+
+DiffHistory::DiffHistory(size_t max_unequal_frames)
+    : max_unequal_frames_(max_unequal_frames) {}
+
+bool DiffHistory::ShouldDeepCompare(uint64_t key) const {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    return true;
+  }
+  const Entry& entry = it->second;
+  return frame_ - entry.last_equal_frame < max_unequal_frames_ ||
+         frame_ - entry.last_compare_frame >= max_unequal_frames_;
+}
+
+void DiffHistory::RecordDeepCompare(uint64_t key, bool equal) {
+  ++deep_compare_count_;
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    it = entries_.emplace(key, Entry{frame_, frame_, frame_}).first;
+  }
+  Entry& entry = it->second;
+  if (equal) {
+    ++deep_compare_equal_count_;
+    entry.last_equal_frame = frame_;
+  }
+  entry.last_compare_frame = frame_;
+  entry.last_seen_frame = frame_;
+}
+
+void DiffHistory::RecordSkippedDeepCompare(uint64_t key) {
+  ++skipped_deep_compare_count_;
+  auto it = entries_.find(key);
+  FML_DCHECK(it != entries_.end());
+  if (it != entries_.end()) {
+    it->second.last_seen_frame = frame_;
+  }
+}
+
+void DiffHistory::EndFrame() {
+  for (auto it = entries_.begin(); it != entries_.end();) {
+    if (frame_ - it->second.last_seen_frame >= max_unequal_frames_) {
+      it = entries_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ++frame_;
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "DiffHistory", reinterpret_cast<int64_t>(this),
+                    "TrackedLayers", entries_.size(), "DeepCompares",
+                    deep_compare_count_, "DeepCompareEqual",
+                    deep_compare_equal_count_, "SkippedDeepCompares",
+                    skipped_deep_compare_count_);
 #endif  // !FLUTTER_RELEASE
 }
 
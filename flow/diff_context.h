@@ -2,6 +2,7 @@
 #define FLUTTER_FLOW_DIFF_CONTEXT_H_
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include "flutter/flow/paint_region.h"
 #include "flutter/fml/logging.h"
@@ -35,13 +36,71 @@ struct Damage {
 // Layer Unique Id to PaintRegion
 using PaintRegionMap = std::map<uint64_t, PaintRegion>;
 
+// Remembers the outcome of deep picture comparisons across frames so that
+// layers whose pictures keep changing (e.g. animations) do not pay for
+// serializing their pictures every frame.
+//
+// Entries are keyed by a hash of the original_layer_id of the container
+// holding the picture layer and the picture's position, which stays stable
+// across frames even though picture layers themselves are recreated.
+class DiffHistory {
+ public:
+  static constexpr size_t kDefaultMaxUnequalFrames = 30;
+
+  // Deep comparisons are skipped for pictures that did not compare equal
+  // in the last |max_unequal_frames| frames. Every |max_unequal_frames|
+  // frames such a picture is compared again, in case it stopped changing.
+  explicit DiffHistory(size_t max_unequal_frames = kDefaultMaxUnequalFrames);
+
+  // Whether a picture with the given key is worth comparing by content.
+  bool ShouldDeepCompare(uint64_t key) const;
+
+  // Records the outcome of a deep comparison of a picture with given key.
+  void RecordDeepCompare(uint64_t key, bool equal);
+
+  // Records that the deep comparison of picture with given key was skipped.
+  void RecordSkippedDeepCompare(uint64_t key);
+
+  // Advances to next frame, forgets pictures that were not seen recently and
+  // logs the counters to the timeline.
+  void EndFrame();
+
+  size_t tracked_layer_count() const { return entries_.size(); }
+  uint64_t deep_compare_count() const { return deep_compare_count_; }
+  uint64_t deep_compare_equal_count() const {
+    return deep_compare_equal_count_;
+  }
+  uint64_t skipped_deep_compare_count() const {
+    return skipped_deep_compare_count_;
+  }
+
+ private:
+  struct Entry {
+    // Frame in which the picture was first compared or, if it ever compared
+    // equal, the last frame in which it did.
+    uint64_t last_equal_frame;
+    uint64_t last_compare_frame;
+    uint64_t last_seen_frame;
+  };
+
+  const size_t max_unequal_frames_;
+  uint64_t frame_ = 0;
+  std::unordered_map<uint64_t, Entry> entries_;
+  uint64_t deep_compare_count_ = 0;
+  uint64_t deep_compare_equal_count_ = 0;
+  uint64_t skipped_deep_compare_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DiffHistory);
+};
+
 // Tracks state during tree diffing process and computes resulting damage
 class DiffContext {
  public:
   explicit DiffContext(SkISize frame_size,
                        double device_pixel_aspect_ratio,
                        PaintRegionMap& this_frame_paint_region_map,
-                       const PaintRegionMap& last_frame_paint_region_map);
+                       const PaintRegionMap& last_frame_paint_region_map,
+                       DiffHistory* history = nullptr);
 
   // Starts a new subtree.
   void BeginSubtree();
@@ -76,6 +135,17 @@ class DiffContext {
   // Return cull rect for current subtree (in local coordinates)
   const SkRect& GetCullRect() const { return state_.cull_rect; }
 
+  // Sets the original_layer_id of the container whose children are being
+  // diffed in current subtree. Used to key the diff history.
+  void SetContainerLayerId(uint64_t id) { state_.container_layer_id = id; }
+
+  // Returns the original_layer_id of the container whose children are being
+  // diffed.
+  uint64_t GetContainerLayerId() const { return state_.container_layer_id; }
+
+  // Cross-frame history of picture comparisons; May be null.
+  DiffHistory* history() const { return history_; }
+
   // Sets the dirty flag on current subtree;
   //
   // previous_paint_region, which should represent region of previous subtree
@@ -152,6 +222,10 @@ class DiffContext {
       ++different_instance_but_equal_pictures_;
     };
 
+    // Picture that would require deep comparison but was treated as new
+    // picture because it did not compare equal in recent frames
+    void AddSkippedDeepComparePicture() { ++skipped_deep_compare_pictures_; }
+
     // Logs the statistics to trace counter
     void LogStatistics();
 
@@ -161,6 +235,7 @@ class DiffContext {
     int same_instance_pictures_ = 0;
     int deep_compare_pictures_ = 0;
     int different_instance_but_equal_pictures_ = 0;
+    int skipped_deep_compare_pictures_ = 0;
   };
 
   Statistics& statistics() { return statistics_; }
@@ -173,6 +248,7 @@ class DiffContext {
     SkRect cull_rect;
     SkMatrix transform;
     size_t rect_index_;
+    uint64_t container_layer_id;
   };
 
   std::shared_ptr<std::vector<SkRect>> rects_;
@@ -185,6 +261,7 @@ class DiffContext {
 
   PaintRegionMap& this_frame_paint_region_map_;
   const PaintRegionMap& last_frame_paint_region_map_;
+  DiffHistory* history_;
 
   void AddDamage(const SkRect& rect);
 
@@ -28,6 +28,7 @@ void ContainerLayer::PreservePaintRegion(DiffContext* context) {
 
 void ContainerLayer::DiffChildren(DiffContext* context,
                                   const ContainerLayer* old_layer) {
+  context->SetContainerLayerId(original_layer_id());
   if (context->IsSubtreeDirty()) {
     for (auto& layer : layers_) {
       layer->Diff(context, nullptr);
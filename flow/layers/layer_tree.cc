@@ -4,6 +4,8 @@
 
 #include "flutter/flow/layers/layer_tree.h"
 
+#include <atomic>
+
 #include "flutter/flow/layers/layer.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
@@ -12,7 +14,8 @@
 namespace flutter {
 
 LayerTree::LayerTree(const SkISize& frame_size, float device_pixel_ratio)
-    : frame_size_(frame_size),
+    : unique_id_(NextUniqueID()),
+      frame_size_(frame_size),
       device_pixel_ratio_(device_pixel_ratio),
       rasterizer_tracing_threshold_(0),
       checkerboard_raster_cache_images_(false),
@@ -20,6 +23,15 @@ LayerTree::LayerTree(const SkISize& frame_size, float device_pixel_ratio)
   FML_CHECK(device_pixel_ratio_ != 0.0f);
 }
 
+uint64_t LayerTree::NextUniqueID() {
+  static std::atomic<uint64_t> nextID(1);
+  uint64_t id;
+  do {
+    id = nextID.fetch_add(1);
+  } while (id == 0);  // 0 is reserved for an invalid id.
+  return id;
+}
+
 void LayerTree::RecordBuildTime(fml::TimePoint vsync_start,
                                 fml::TimePoint build_start,
                                 fml::TimePoint target_time) {
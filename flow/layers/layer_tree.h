@@ -46,6 +46,10 @@ class LayerTree {
     root_layer_ = std::move(root_layer);
   }
 
+  // An id that no other layer tree created by this process has. Unlike the
+  // address of the tree, it is never reused.
+  uint64_t unique_id() const { return unique_id_; }
+
   const SkISize& frame_size() const { return frame_size_; }
   float device_pixel_ratio() const { return device_pixel_ratio_; }
 
@@ -86,6 +90,7 @@ class LayerTree {
   }
 
  private:
+  const uint64_t unique_id_;
   std::shared_ptr<Layer> root_layer_;
   fml::TimePoint vsync_start_;
   fml::TimePoint build_start_;
@@ -101,6 +106,8 @@ class LayerTree {
   PaintRegionMap paint_region_map_;
 #endif  //  FLUTTER_ENABLE_DIFF_CONTEXT
 
+  static uint64_t NextUniqueID();
+
   FML_DISALLOW_COPY_AND_ASSIGN(LayerTree);
 };
 
@@ -203,5 +203,84 @@ TEST_F(LayerTreeTest, NeedsSystemComposite) {
                                                child_path2, child_paint2}}}));
 }
 
+TEST_F(LayerTreeTest, UniqueIdsAreNotReused) {
+  const uint64_t first_id =
+      std::make_unique<LayerTree>(SkISize::Make(64, 64), 1.0f)->unique_id();
+  const uint64_t second_id =
+      std::make_unique<LayerTree>(SkISize::Make(64, 64), 1.0f)->unique_id();
+  EXPECT_NE(first_id, 0u);
+  EXPECT_NE(second_id, 0u);
+  EXPECT_NE(first_id, second_id);
+}
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+
+TEST_F(LayerTreeTest, FrameDamageWithoutPreviousTreeIsFullFrame) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeLTRB(5, 6, 20, 21));
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(std::make_shared<MockLayer>(child_path));
+  layer_tree().set_root_layer(layer);
+
+  FrameDamage frame_damage;
+  frame_damage.AddAdditionalDamage(SkIRect::MakeEmpty());
+  EXPECT_EQ(frame_damage.ComputeClipRect(layer_tree(), nullptr),
+            SkRect::MakeWH(64, 64));
+  ASSERT_TRUE(frame_damage.GetDamage().has_value());
+  EXPECT_EQ(frame_damage.GetDamage()->frame_damage, SkIRect::MakeWH(64, 64));
+  EXPECT_EQ(frame_damage.GetDamage()->buffer_damage, SkIRect::MakeWH(64, 64));
+}
+
+TEST_F(LayerTreeTest, FrameDamageOfRetainedLayerIsEmpty) {
+  const SkPath child_path = SkPath().addRect(SkRect::MakeLTRB(5, 6, 20, 21));
+  auto mock_layer = std::make_shared<MockLayer>(child_path);
+
+  LayerTree previous_tree(SkISize::Make(64, 64), 1.0f);
+  auto previous_root = std::make_shared<ContainerLayer>();
+  previous_root->Add(mock_layer);
+  previous_tree.set_root_layer(previous_root);
+  FrameDamage previous_damage;
+  previous_damage.ComputeClipRect(previous_tree, nullptr);
+
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(mock_layer);
+  layer_tree().set_root_layer(layer);
+
+  FrameDamage frame_damage;
+  frame_damage.SetPreviousLayerTree(&previous_tree);
+  frame_damage.AddAdditionalDamage(SkIRect::MakeEmpty());
+  EXPECT_TRUE(frame_damage.ComputeClipRect(layer_tree(), nullptr).isEmpty());
+  ASSERT_TRUE(frame_damage.GetDamage().has_value());
+  EXPECT_TRUE(frame_damage.GetDamage()->frame_damage.isEmpty());
+}
+
+TEST_F(LayerTreeTest, FrameDamageCoversReplacedLayerAndExistingDamage) {
+  const SkPath old_path = SkPath().addRect(SkRect::MakeLTRB(5, 6, 20, 21));
+  const SkPath new_path = SkPath().addRect(SkRect::MakeLTRB(30, 30, 40, 40));
+
+  LayerTree previous_tree(SkISize::Make(64, 64), 1.0f);
+  auto previous_root = std::make_shared<ContainerLayer>();
+  previous_root->Add(std::make_shared<MockLayer>(old_path));
+  previous_tree.set_root_layer(previous_root);
+  FrameDamage previous_damage;
+  previous_damage.ComputeClipRect(previous_tree, nullptr);
+
+  auto layer = std::make_shared<ContainerLayer>();
+  layer->Add(std::make_shared<MockLayer>(new_path));
+  layer_tree().set_root_layer(layer);
+
+  FrameDamage frame_damage;
+  frame_damage.SetPreviousLayerTree(&previous_tree);
+  frame_damage.AddAdditionalDamage(SkIRect::MakeLTRB(50, 50, 60, 60));
+  EXPECT_EQ(frame_damage.ComputeClipRect(layer_tree(), nullptr),
+            SkRect::MakeLTRB(5, 6, 60, 60));
+  ASSERT_TRUE(frame_damage.GetDamage().has_value());
+  EXPECT_EQ(frame_damage.GetDamage()->frame_damage,
+            SkIRect::MakeLTRB(5, 6, 40, 40));
+  EXPECT_EQ(frame_damage.GetDamage()->buffer_damage,
+            SkIRect::MakeLTRB(5, 6, 60, 60));
+}
+
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
 }  // namespace testing
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/fml/hash_combine.h"
 #include "flutter/fml/logging.h"
 #include "third_party/skia/include/core/SkSerialProcs.h"
 
@@ -25,8 +26,23 @@ bool PictureLayer::IsReplacing(DiffContext* context, const Layer* layer) const {
   // ContainerLayer::DiffChildren can detect when a picture layer got inserted
   // between other picture layers
   auto picture_layer = layer->as_picture_layer();
-  return picture_layer != nullptr && offset_ == picture_layer->offset_ &&
-         Compare(context->statistics(), this, picture_layer);
+  if (picture_layer == nullptr || offset_ != picture_layer->offset_) {
+    return false;
+  }
+  // Like RasterCacheKey, the history key includes the matrix the picture is
+  // drawn with, so that a retained container drawn under several transforms
+  // keeps a history for each of them.
+  SkMatrix matrix = context->GetTransform();
+  matrix.preTranslate(offset_.x(), offset_.y());
+  const SkRect& cull_rect = picture()->cullRect();
+  uint64_t history_key =
+      fml::HashCombine(context->GetContainerLayerId(), cull_rect.left(),
+                       cull_rect.top(), cull_rect.right(), cull_rect.bottom());
+  for (int i = 0; i < 9; ++i) {
+    history_key = fml::HashCombine(history_key, matrix[i]);
+  }
+  return Compare(context->statistics(), this, picture_layer, context->history(),
+                 history_key);
 }
 
 void PictureLayer::Diff(DiffContext* context, const Layer* old_layer) {
@@ -48,7 +64,9 @@ void PictureLayer::Diff(DiffContext* context, const Layer* old_layer) {
 
 bool PictureLayer::Compare(DiffContext::Statistics& statistics,
                            const PictureLayer* l1,
-                           const PictureLayer* l2) {
+                           const PictureLayer* l2,
+                           DiffHistory* history,
+                           uint64_t history_key) {
   const auto& pic1 = l1->picture_.get();
   const auto& pic2 = l2->picture_.get();
   if (pic1.get() == pic2.get()) {
@@ -67,6 +85,12 @@ bool PictureLayer::Compare(DiffContext::Statistics& statistics,
     return false;
   }
 
+  if (history && !history->ShouldDeepCompare(history_key)) {
+    history->RecordSkippedDeepCompare(history_key);
+    statistics.AddSkippedDeepComparePicture();
+    return false;
+  }
+
   statistics.AddDeepComparePicture();
 
   // TODO(knopp) we don't actually need the data; this could be done without
@@ -80,6 +104,9 @@ bool PictureLayer::Compare(DiffContext::Statistics& statistics,
   } else {
     statistics.AddNewPicture();
   }
+  if (history) {
+    history->RecordDeepCompare(history_key, res);
+  }
   return res;
 }
 
@@ -48,9 +48,14 @@ class PictureLayer : public Layer {
 
   sk_sp<SkData> SerializedPicture() const;
   mutable sk_sp<SkData> cached_serialized_picture_;
+  // Compares the pictures of both layers. If |history| is provided, the deep
+  // comparison is skipped for pictures that have kept changing in recent
+  // frames, in which case the pictures are considered different.
   static bool Compare(DiffContext::Statistics& statistics,
                       const PictureLayer* l1,
-                      const PictureLayer* l2);
+                      const PictureLayer* l2,
+                      DiffHistory* history = nullptr,
+                      uint64_t history_key = 0);
 
 #endif  // FLUTTER_ENABLE_DIFF_CONTEXT
 
@@ -6,6 +6,7 @@
 
 #include "flutter/flow/layers/picture_layer.h"
 
+#include "flutter/flow/layers/transform_layer.h"
 #include "flutter/flow/testing/diff_context_test.h"
 #include "flutter/flow/testing/skia_gpu_object_layer_test.h"
 #include "flutter/fml/macros.h"
@@ -155,6 +156,102 @@ TEST_F(PictureLayerDiffTest, PictureCompare) {
   EXPECT_EQ(damage.frame_damage, SkIRect::MakeLTRB(20, 20, 70, 70));
 }
 
+TEST_F(PictureLayerDiffTest, HistorySkipsDeepCompareOfChangingPicture) {
+  DiffHistory history(2);
+  const SkRect bounds = SkRect::MakeLTRB(10, 10, 60, 60);
+  std::vector<std::unique_ptr<MockLayerTree>> trees;
+  auto diff_frame = [&](uint32_t color) {
+    auto tree = std::make_unique<MockLayerTree>();
+    tree->root()->Add(CreatePictureLayer(CreatePicture(bounds, color)));
+    Damage damage;
+    if (trees.empty()) {
+      damage = DiffLayerTree(*tree, MockLayerTree(), SkIRect::MakeEmpty(),
+                             &history);
+    } else {
+      // Keep the container identity stable across frames, like retained
+      // engine layers do.
+      tree->root()->AssignOldLayer(trees.back()->root());
+      damage = DiffLayerTree(*tree, *trees.back(), SkIRect::MakeEmpty(),
+                             &history);
+    }
+    history.EndFrame();
+    trees.push_back(std::move(tree));
+    return damage.frame_damage;
+  };
+
+  // First frame has nothing to compare against.
+  EXPECT_EQ(diff_frame(1), SkIRect::MakeLTRB(10, 10, 60, 60));
+  EXPECT_EQ(history.deep_compare_count(), 0u);
+
+  // The picture changes every frame; Deep compares stop after two frames.
+  EXPECT_EQ(diff_frame(2), SkIRect::MakeLTRB(10, 10, 60, 60));
+  EXPECT_EQ(diff_frame(3), SkIRect::MakeLTRB(10, 10, 60, 60));
+  EXPECT_EQ(history.deep_compare_count(), 2u);
+  EXPECT_EQ(diff_frame(4), SkIRect::MakeLTRB(10, 10, 60, 60));
+  EXPECT_EQ(history.deep_compare_count(), 2u);
+  EXPECT_EQ(history.skipped_deep_compare_count(), 1u);
+  EXPECT_EQ(history.tracked_layer_count(), 1u);
+
+  // The picture is periodically compared again.
+  EXPECT_EQ(diff_frame(5), SkIRect::MakeLTRB(10, 10, 60, 60));
+  EXPECT_EQ(history.deep_compare_count(), 3u);
+  EXPECT_EQ(diff_frame(6), SkIRect::MakeLTRB(10, 10, 60, 60));
+  EXPECT_EQ(history.skipped_deep_compare_count(), 2u);
+
+  // Once it stops changing, the next probe finds it equal.
+  EXPECT_TRUE(diff_frame(6).isEmpty());
+  EXPECT_EQ(history.deep_compare_count(), 4u);
+  EXPECT_EQ(history.deep_compare_equal_count(), 1u);
+  EXPECT_TRUE(diff_frame(6).isEmpty());
+  EXPECT_EQ(history.deep_compare_count(), 5u);
+}
+
+TEST_F(PictureLayerDiffTest, HistoryIsKeptPerTransform) {
+  DiffHistory history(2);
+  const SkRect bounds = SkRect::MakeLTRB(10, 10, 60, 60);
+  std::vector<std::unique_ptr<MockLayerTree>> trees;
+  // The containers under both transform layers share their identity, like a
+  // retained layer that is added twice, and their pictures change every frame.
+  auto diff_frame = [&](uint32_t color) {
+    auto tree = std::make_unique<MockLayerTree>();
+    auto container1 =
+        CreateContainerLayer(CreatePictureLayer(CreatePicture(bounds, color)));
+    auto container2 =
+        CreateContainerLayer(CreatePictureLayer(CreatePicture(bounds, color)));
+    auto transform1 = std::make_shared<TransformLayer>(SkMatrix::I());
+    auto transform2 =
+        std::make_shared<TransformLayer>(SkMatrix::Translate(100, 0));
+    transform1->Add(container1);
+    transform2->Add(container2);
+    tree->root()->Add(transform1);
+    tree->root()->Add(transform2);
+    if (trees.empty()) {
+      container2->AssignOldLayer(container1.get());
+      DiffLayerTree(*tree, MockLayerTree(), SkIRect::MakeEmpty(), &history);
+    } else {
+      const auto& old_layers = trees.back()->root()->layers();
+      tree->root()->AssignOldLayer(trees.back()->root());
+      for (size_t i = 0; i < old_layers.size(); ++i) {
+        auto* old_transform =
+            static_cast<ContainerLayer*>(old_layers[i].get());
+        auto* transform =
+            static_cast<ContainerLayer*>(tree->root()->layers()[i].get());
+        transform->AssignOldLayer(old_transform);
+        transform->layers()[0]->AssignOldLayer(
+            old_transform->layers()[0].get());
+      }
+      DiffLayerTree(*tree, *trees.back(), SkIRect::MakeEmpty(), &history);
+    }
+    history.EndFrame();
+    trees.push_back(std::move(tree));
+  };
+
+  diff_frame(1);
+  diff_frame(2);
+  EXPECT_EQ(history.deep_compare_count(), 2u);
+  EXPECT_EQ(history.tracked_layer_count(), 2u);
+}
+
 #endif
 
 }  // namespace testing
@@ -4,18 +4,24 @@
 
 #include "flutter/flow/raster_cache.h"
 
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include "flutter/common/constants.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/paint_utils.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
+#include "third_party/skia/include/utils/SkNoDrawCanvas.h"
+#include "third_party/skia/include/utils/SkPaintFilterCanvas.h"
 
 namespace flutter {
 
@@ -39,6 +45,7 @@ void RasterCacheResult::draw(SkCanvas& canvas, const SkPaint* paint) const {
 RasterCache::RasterCache(size_t access_threshold,
                          size_t picture_cache_limit_per_frame)
     : access_threshold_(access_threshold),
+      sync_picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
       picture_cache_limit_per_frame_(picture_cache_limit_per_frame),
       checkerboard_images_(false) {}
 
@@ -88,15 +95,23 @@ static bool IsPictureWorthRasterizing(SkPicture* picture,
   return picture->approximateOpCount() > 5;
 }
 
+// Estimates the size of the image that Rasterize would produce for the given
+// logical rect, without actually rasterizing it.
+static size_t EstimateRasterizedByteSize(const SkRect& logical_rect,
+                                         const SkMatrix& ctm) {
+  SkIRect cache_rect = RasterCache::GetDeviceBounds(logical_rect, ctm);
+  return SkImageInfo::MakeN32Premul(cache_rect.width(), cache_rect.height())
+      .computeMinByteSize();
+}
+
 /// @note Procedure doesn't copy all closures.
-static std::unique_ptr<RasterCacheResult> Rasterize(
+static sk_sp<SkImage> RasterizeToImage(
     GrDirectContext* context,
     const SkMatrix& ctm,
     SkColorSpace* dst_color_space,
     bool checkerboard,
     const SkRect& logical_rect,
     const std::function<void(SkCanvas*)>& draw_function) {
-  TRACE_EVENT0("flutter", "RasterCachePopulate");
   SkIRect cache_rect = RasterCache::GetDeviceBounds(logical_rect, ctm);
 
   const SkImageInfo image_info = SkImageInfo::MakeN32Premul(
@@ -121,8 +136,169 @@ static std::unique_ptr<RasterCacheResult> Rasterize(
     DrawCheckerboard(canvas, logical_rect);
   }
 
-  return std::make_unique<RasterCacheResult>(surface->makeImageSnapshot(),
-                                             logical_rect);
+  return surface->makeImageSnapshot();
+}
+
+/// @note Procedure doesn't copy all closures.
+static std::unique_ptr<RasterCacheResult> Rasterize(
+    GrDirectContext* context,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard,
+    const SkRect& logical_rect,
+    const std::function<void(SkCanvas*)>& draw_function) {
+  TRACE_EVENT0("flutter", "RasterCachePopulate");
+  sk_sp<SkImage> image = RasterizeToImage(context, ctm, dst_color_space,
+                                          checkerboard, logical_rect,
+                                          draw_function);
+  if (!image) {
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(std::move(image), logical_rect);
+}
+
+// Plays back a picture without drawing anything to find out whether it draws
+// texture-backed images, either directly or through an image shader.
+class TextureImageDetector final : public SkPaintFilterCanvas {
+ public:
+  explicit TextureImageDetector(SkCanvas* canvas)
+      : SkPaintFilterCanvas(canvas) {}
+
+  bool found() const { return found_; }
+
+ protected:
+  bool onFilter(SkPaint& paint) const override {
+    if (SkShader* shader = paint.getShader()) {
+      SkImage* image = shader->isAImage(nullptr, nullptr);
+      CheckImage(image);
+    }
+    return !found_;
+  }
+
+  void onDrawImage2(const SkImage* image,
+                    SkScalar left,
+                    SkScalar top,
+                    const SkSamplingOptions& sampling,
+                    const SkPaint* paint) override {
+    CheckImage(image);
+    SkPaintFilterCanvas::onDrawImage2(image, left, top, sampling, paint);
+  }
+
+  void onDrawImageRect2(const SkImage* image,
+                        const SkRect& src,
+                        const SkRect& dst,
+                        const SkSamplingOptions& sampling,
+                        const SkPaint* paint,
+                        SrcRectConstraint constraint) override {
+    CheckImage(image);
+    SkPaintFilterCanvas::onDrawImageRect2(image, src, dst, sampling, paint,
+                                          constraint);
+  }
+
+  void onDrawImageLattice2(const SkImage* image,
+                           const Lattice& lattice,
+                           const SkRect& dst,
+                           SkFilterMode filter,
+                           const SkPaint* paint) override {
+    CheckImage(image);
+    SkPaintFilterCanvas::onDrawImageLattice2(image, lattice, dst, filter,
+                                             paint);
+  }
+
+  void onDrawAtlas2(const SkImage* image,
+                    const SkRSXform xform[],
+                    const SkRect tex[],
+                    const SkColor colors[],
+                    int count,
+                    SkBlendMode mode,
+                    const SkSamplingOptions& sampling,
+                    const SkRect* cull,
+                    const SkPaint* paint) override {
+    CheckImage(image);
+    SkPaintFilterCanvas::onDrawAtlas2(image, xform, tex, colors, count, mode,
+                                      sampling, cull, paint);
+  }
+
+  void onDrawEdgeAAImageSet2(const ImageSetEntry set[],
+                             int count,
+                             const SkPoint dst_clips[],
+                             const SkMatrix pre_view_matrices[],
+                             const SkSamplingOptions& sampling,
+                             const SkPaint* paint,
+                             SrcRectConstraint constraint) override {
+    for (int i = 0; i < count; i++) {
+      CheckImage(set[i].fImage.get());
+    }
+    SkPaintFilterCanvas::onDrawEdgeAAImageSet2(
+        set, count, dst_clips, pre_view_matrices, sampling, paint, constraint);
+  }
+
+  void onDrawPicture(const SkPicture* picture,
+                     const SkMatrix* matrix,
+                     const SkPaint* paint) override {
+    // The filter canvas would hand nested pictures to the no-draw canvas as a
+    // whole, so play them back here instead.
+    picture->playback(this);
+  }
+
+  void onDrawDrawable(SkDrawable* drawable, const SkMatrix* matrix) override {
+    // What a drawable draws is not known up front.
+    found_ = true;
+  }
+
+ private:
+  void CheckImage(const SkImage* image) const {
+    if (image && image->isTextureBacked()) {
+      found_ = true;
+    }
+  }
+
+  mutable bool found_ = false;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(TextureImageDetector);
+};
+
+// Whether |picture| draws images that only exist on the GPU. Those can only be
+// drawn with a context of the share group they were uploaded in, so such
+// pictures are never rasterized into memory by RasterizeCrossContext.
+static bool DrawsTextureBackedImages(SkPicture* picture) {
+  SkNoDrawCanvas no_draw_canvas(picture->cullRect().roundOut());
+  TextureImageDetector detector(&no_draw_canvas);
+  picture->playback(&detector);
+  return detector.found();
+}
+
+// Rasterizes |picture| into memory and uploads the result with a context
+// other than the one of the raster thread, as an image that any context in the
+// share group can draw. |picture| must not draw texture-backed images (see
+// DrawsTextureBackedImages).
+static std::unique_ptr<RasterCacheResult> RasterizeCrossContext(
+    GrDirectContext* context,
+    SkPicture* picture,
+    const SkMatrix& ctm,
+    SkColorSpace* dst_color_space,
+    bool checkerboard) {
+  TRACE_EVENT0("flutter", "RasterCachePopulateAsync");
+  sk_sp<SkImage> image = RasterizeToImage(
+      nullptr, ctm, dst_color_space, checkerboard, picture->cullRect(),
+      [picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+  SkPixmap pixmap;
+  if (!image || !image->peekPixels(&pixmap)) {
+    return nullptr;
+  }
+
+  sk_sp<SkImage> cross_context_image =
+      SkImage::MakeCrossContextFromPixmap(context,  // context
+                                          pixmap,   // pixmap
+                                          false,    // buildMips
+                                          true      // limitToMaxTextureSize
+      );
+  if (!cross_context_image) {
+    FML_LOG(ERROR) << "Could not make x-context raster cache image.";
+    return nullptr;
+  }
+  return std::make_unique<RasterCacheResult>(std::move(cross_context_image),
+                                             picture->cullRect());
 }
 
 std::unique_ptr<RasterCacheResult> RasterCache::RasterizePicture(
@@ -144,7 +320,14 @@ void RasterCache::Prepare(PrerollContext* context,
   entry.access_count++;
   entry.used_this_frame = true;
   if (!entry.image) {
+    if (!Admit(entry,
+               EstimateRasterizedByteSize(layer->paint_bounds(), ctm))) {
+      return;
+    }
+    const fml::TimePoint start = fml::TimePoint::Now();
     entry.image = RasterizeLayer(context, layer, ctm, checkerboard_images_);
+    entry.rasterize_time = fml::TimePoint::Now() - start;
+    entry.last_used_frame = frame_count_;
   }
 }
 
@@ -216,8 +399,31 @@ bool RasterCache::Prepare(GrDirectContext* context,
   }
 
   if (!entry.image) {
+    if (entry.async_pending) {
+      // Keep drawing the picture uncached until the result is collected.
+      return false;
+    }
+    const size_t bytes =
+        EstimateRasterizedByteSize(picture->cullRect(), transformation_matrix);
+    if (!Admit(entry, bytes)) {
+      return false;
+    }
+    if (async_dispatcher_ && !entry.async_failed &&
+        !DrawsTextureBackedImages(picture)) {
+      entry.async_pending = true;
+      DispatchAsyncRasterization(cache_key, picture, transformation_matrix,
+                                 dst_color_space, bytes);
+      picture_cached_this_frame_++;
+      return false;
+    }
+    // A failed asynchronous rasterization only falls back once, so that the
+    // entry is handed off again if its image is evicted later.
+    entry.async_failed = false;
+    const fml::TimePoint start = fml::TimePoint::Now();
     entry.image = RasterizePicture(picture, context, transformation_matrix,
                                    dst_color_space, checkerboard_images_);
+    entry.rasterize_time = fml::TimePoint::Now() - start;
+    entry.last_used_frame = frame_count_;
     picture_cached_this_frame_++;
   }
   return true;
@@ -264,15 +470,214 @@ bool RasterCache::Draw(const Layer* layer,
 }
 
 void RasterCache::SweepAfterFrame() {
+  CollectAsyncResults();
   SweepOneCacheAfterFrame(picture_cache_);
   SweepOneCacheAfterFrame(layer_cache_);
   picture_cached_this_frame_ = 0;
   TraceStatsToTimeline();
+  frame_count_++;
+  evicted_this_frame_ = 0;
+  rejected_this_frame_ = 0;
 }
 
 void RasterCache::Clear() {
   picture_cache_.clear();
   layer_cache_.clear();
+  async_generation_++;
+}
+
+void RasterCache::SetAsyncRasterizationDispatcher(
+    AsyncRasterizationDispatcher dispatcher,
+    size_t picture_cache_limit_per_frame) {
+  async_dispatcher_ = std::move(dispatcher);
+  if (async_dispatcher_) {
+    picture_cache_limit_per_frame_ = picture_cache_limit_per_frame;
+    if (!async_results_) {
+      async_results_ = std::make_shared<AsyncResults>();
+    }
+  } else {
+    picture_cache_limit_per_frame_ = sync_picture_cache_limit_per_frame_;
+  }
+}
+
+void RasterCache::DispatchAsyncRasterization(
+    const PictureRasterCacheKey& cache_key,
+    SkPicture* picture,
+    const SkMatrix& transformation_matrix,
+    SkColorSpace* dst_color_space,
+    size_t reserved_bytes) {
+  TRACE_EVENT0("flutter", "RasterCache::DispatchAsyncRasterization");
+  async_reserved_bytes_ += reserved_bytes;
+  auto task = [results = async_results_, cache_key,
+               generation = async_generation_, picture = sk_ref_sp(picture),
+               transformation_matrix,
+               dst_color_space = sk_ref_sp(dst_color_space),
+               checkerboard = checkerboard_images_,
+               reserved_bytes](GrDirectContext* context) {
+    AsyncResult result{cache_key, generation, reserved_bytes, nullptr, {}};
+    if (context) {
+      const fml::TimePoint start = fml::TimePoint::Now();
+      result.image =
+          RasterizeCrossContext(context, picture.get(), transformation_matrix,
+                                dst_color_space.get(), checkerboard);
+      result.rasterize_time = fml::TimePoint::Now() - start;
+    }
+    std::scoped_lock lock(results->mutex);
+    results->results.push_back(std::move(result));
+  };
+  async_dispatcher_(std::move(task));
+}
+
+void RasterCache::CollectAsyncResults() {
+  if (!async_results_) {
+    return;
+  }
+
+  std::vector<AsyncResult> results;
+  {
+    std::scoped_lock lock(async_results_->mutex);
+    results.swap(async_results_->results);
+  }
+  if (results.empty()) {
+    return;
+  }
+
+  for (auto& result : results) {
+    // The result replaces its reservation, whether it is kept or not.
+    async_reserved_bytes_ -= result.reserved_bytes;
+    if (result.generation != async_generation_) {
+      continue;
+    }
+    auto it = picture_cache_.find(result.key);
+    if (it == picture_cache_.end()) {
+      // The entry was swept while the rasterization was in flight.
+      continue;
+    }
+    Entry& entry = it->second;
+    entry.async_pending = false;
+    if (!result.image) {
+      entry.async_failed = true;
+      continue;
+    }
+    entry.image = std::move(result.image);
+    entry.rasterize_time = result.rasterize_time;
+    entry.last_used_frame = frame_count_;
+  }
+  EnforceMaxBytes();
+}
+
+void RasterCache::SetMaxBytes(size_t max_bytes, size_t max_unused_frames) {
+  max_bytes_ = max_bytes;
+  max_unused_frames_ = max_unused_frames;
+  EnforceMaxBytes();
+}
+
+double RasterCache::RetentionScore(const Entry& entry, size_t bytes) const {
+  const double cost_us = entry.rasterize_time.ToMicrosecondsF() + 1;
+  const double kilobytes = bytes / 1024.0 + 1;
+  const size_t age = frame_count_ > entry.last_used_frame
+                         ? frame_count_ - entry.last_used_frame
+                         : 1;
+  return cost_us / kilobytes / age;
+}
+
+bool RasterCache::MakeRoom(size_t bytes, double candidate_score) {
+  const size_t used_bytes = EstimatePictureCacheByteSize() +
+                            EstimateLayerCacheByteSize() +
+                            async_reserved_bytes_;
+  if (used_bytes + bytes <= max_bytes_) {
+    return true;
+  }
+  if (bytes > max_bytes_) {
+    return false;
+  }
+
+  // Only entries that were not drawn in the previous or the current frame are
+  // eviction candidates, the others are most likely still on screen.
+  std::vector<std::pair<double, Entry*>> candidates;
+  auto collect = [&](auto& cache) {
+    for (auto& item : cache) {
+      Entry& entry = item.second;
+      if (!entry.image || entry.used_this_frame ||
+          frame_count_ - entry.last_used_frame < 2) {
+        continue;
+      }
+      double score = RetentionScore(entry, entry.image->image_bytes());
+      if (score <= candidate_score) {
+        candidates.emplace_back(score, &entry);
+      }
+    }
+  };
+  collect(picture_cache_);
+  collect(layer_cache_);
+  std::sort(candidates.begin(), candidates.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  const size_t needed = used_bytes + bytes - max_bytes_;
+  size_t freed = 0;
+  size_t victims = 0;
+  while (victims < candidates.size() && freed < needed) {
+    freed += candidates[victims++].second->image->image_bytes();
+  }
+  if (freed < needed) {
+    return false;
+  }
+
+  for (size_t i = 0; i < victims; i++) {
+    candidates[i].second->image.reset();
+  }
+  evicted_this_frame_ += victims;
+  return true;
+}
+
+bool RasterCache::Admit(const Entry& entry, size_t bytes) {
+  if (max_bytes_ == 0) {
+    return true;
+  }
+  // An entry that has never been rasterized has no measured cost yet; give it
+  // the benefit of the doubt against any stale entry.
+  const double candidate_score =
+      entry.rasterize_time == fml::TimeDelta::Zero()
+          ? std::numeric_limits<double>::infinity()
+          : RetentionScore(entry, bytes);
+  if (MakeRoom(bytes, candidate_score)) {
+    return true;
+  }
+  rejected_this_frame_++;
+  return false;
+}
+
+void RasterCache::EnforceMaxBytes() {
+  if (max_bytes_ == 0) {
+    return;
+  }
+  size_t used_bytes = EstimatePictureCacheByteSize() +
+                      EstimateLayerCacheByteSize() + async_reserved_bytes_;
+  while (used_bytes > max_bytes_) {
+    Entry* victim = nullptr;
+    double victim_score = std::numeric_limits<double>::infinity();
+    auto find_victim = [&](auto& cache) {
+      for (auto& item : cache) {
+        Entry& entry = item.second;
+        if (!entry.image) {
+          continue;
+        }
+        double score = RetentionScore(entry, entry.image->image_bytes());
+        if (!victim || score < victim_score) {
+          victim = &entry;
+          victim_score = score;
+        }
+      }
+    };
+    find_victim(picture_cache_);
+    find_victim(layer_cache_);
+    if (!victim) {
+      break;
+    }
+    used_bytes -= victim->image->image_bytes();
+    victim->image.reset();
+    evicted_this_frame_++;
+  }
 }
 
 size_t RasterCache::GetCachedEntriesCount() const {
@@ -305,7 +710,10 @@ void RasterCache::TraceStatsToTimeline() const {
                     "LayerCount", layer_cache_.size(), "LayerMBytes",
                     EstimateLayerCacheByteSize() / kMegaByteSizeInBytes,
                     "PictureCount", picture_cache_.size(), "PictureMBytes",
-                    EstimatePictureCacheByteSize() / kMegaByteSizeInBytes);
+                    EstimatePictureCacheByteSize() / kMegaByteSizeInBytes,
+                    "BudgetMBytes", max_bytes_ / kMegaByteSizeInBytes,
+                    "Evicted", evicted_this_frame_, "Rejected",
+                    rejected_this_frame_);
 
 #endif  // !FLUTTER_RELEASE
 }
@@ -5,12 +5,16 @@
 #ifndef FLUTTER_FLOW_RASTER_CACHE_H_
 #define FLUTTER_FLOW_RASTER_CACHE_H_
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/flow/raster_cache_key.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/weak_ptr.h"
+#include "flutter/fml/time/time_delta.h"
 #include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkSize.h"
 
@@ -47,6 +51,16 @@ class RasterCache {
   // multiple frames.
   static constexpr int kDefaultPictureCacheLimitPerFrame = 3;
 
+  // The default max number of picture rasterizations to be handed off per
+  // frame when asynchronous rasterization is enabled. Handing off a picture is
+  // cheap for the raster thread, so this is much higher than the synchronous
+  // limit. (See also SetAsyncRasterizationDispatcher.)
+  static constexpr int kDefaultAsyncPictureCacheLimitPerFrame = 16;
+
+  // The default number of frames an entry may go unused before it is evicted
+  // when the cache is byte-budgeted. (See also SetMaxBytes.)
+  static constexpr size_t kDefaultMaxUnusedFrames = 120;
+
   explicit RasterCache(
       size_t access_threshold = 3,
       size_t picture_cache_limit_per_frame = kDefaultPictureCacheLimitPerFrame);
@@ -160,6 +174,62 @@ class RasterCache {
 
   void Clear();
 
+  /**
+   * @brief Runs |task| on a thread other than the raster thread. The task
+   * must be passed the GrDirectContext to rasterize with on that thread, or
+   * nullptr if no context is usable there, in which case the picture is
+   * rasterized synchronously in a later frame instead.
+   */
+  using AsyncRasterizationDispatcher =
+      std::function<void(std::function<void(GrDirectContext*)> task)>;
+
+  /**
+   * @brief Rasterize pictures that cross the access threshold away from the
+   * raster thread.
+   *
+   * Instead of rasterizing inside Prepare, the picture is handed to
+   * |dispatcher| and keeps being drawn uncached until the result is
+   * collected at the end of a later frame. The produced image is uploaded as
+   * a cross-context image so that it can be drawn with the raster thread's
+   * context. Pictures that draw texture-backed images cannot be rasterized
+   * into memory on the worker and are always rasterized in Prepare. The
+   * estimated size of a handed off picture counts against the byte budget
+   * (see SetMaxBytes) until its result is collected.
+   *
+   * @param dispatcher runs rasterization tasks on a worker thread, or nullptr
+   *        to go back to synchronous rasterization with the per-frame limit
+   *        the cache was created with.
+   * @param picture_cache_limit_per_frame the max number of pictures to hand
+   *        off per frame.
+   */
+  void SetAsyncRasterizationDispatcher(
+      AsyncRasterizationDispatcher dispatcher,
+      size_t picture_cache_limit_per_frame =
+          kDefaultAsyncPictureCacheLimitPerFrame);
+
+  /**
+   * @brief Switch the cache to byte-budgeted eviction.
+   *
+   * By default (max_bytes of 0) every entry that was not used during a frame
+   * is evicted at the end of that frame. With a non-zero budget, entries
+   * instead survive until they have been unused for max_unused_frames frames,
+   * and whenever the images held by the cache would exceed max_bytes the
+   * least valuable entries are evicted first. An entry's value grows with
+   * the measured time it took to rasterize and shrinks with its age, so
+   * expensive pictures that blink out of view for a few frames are retained
+   * over cheap ones. A new entry is only admitted if room can be made for it
+   * without evicting entries that are more valuable than itself.
+   *
+   * @param max_bytes the maximum number of bytes of cached images, or 0 to
+   *        disable the budget.
+   * @param max_unused_frames the number of frames an entry may go unused
+   *        before it is evicted regardless of the budget.
+   */
+  void SetMaxBytes(size_t max_bytes,
+                   size_t max_unused_frames = kDefaultMaxUnusedFrames);
+
+  size_t max_bytes() const { return max_bytes_; }
+
   void SetCheckboardCacheImages(bool checkerboard);
 
   size_t GetCachedEntriesCount() const;
@@ -192,16 +262,48 @@ class RasterCache {
   struct Entry {
     bool used_this_frame = false;
     size_t access_count = 0;
+    // The frame (see frame_count_) in which this entry was last drawn.
+    size_t last_used_frame = 0;
+    // The time RasterizePicture/RasterizeLayer took the last time this entry
+    // was populated. Kept after the image is evicted under a byte budget so
+    // that the entry can compete for readmission with its measured cost.
+    fml::TimeDelta rasterize_time;
+    // Whether an asynchronous rasterization of this entry is in flight.
+    bool async_pending = false;
+    // Set when this entry could not be rasterized asynchronously, in which
+    // case the next Prepare rasterizes it synchronously instead.
+    bool async_failed = false;
     std::unique_ptr<RasterCacheResult> image;
   };
 
+  // The outcome of an asynchronous rasterization. A null image means the
+  // picture could not be rasterized on the worker.
+  struct AsyncResult {
+    PictureRasterCacheKey key;
+    size_t generation;
+    // The estimated size that was reserved in the budget for this result.
+    size_t reserved_bytes;
+    std::unique_ptr<RasterCacheResult> image;
+    fml::TimeDelta rasterize_time;
+  };
+
+  // Shared with the tasks handed to the dispatcher so that they can outlive
+  // the cache.
+  struct AsyncResults {
+    std::mutex mutex;
+    std::vector<AsyncResult> results;
+  };
+
   template <class Cache>
-  static void SweepOneCacheAfterFrame(Cache& cache) {
+  void SweepOneCacheAfterFrame(Cache& cache) {
     std::vector<typename Cache::iterator> dead;
 
     for (auto it = cache.begin(); it != cache.end(); ++it) {
       Entry& entry = it->second;
-      if (!entry.used_this_frame) {
+      if (entry.used_this_frame) {
+        entry.last_used_frame = frame_count_;
+      } else if (max_bytes_ == 0 ||
+                 frame_count_ - entry.last_used_frame >= max_unused_frames_) {
         dead.push_back(it);
       }
       entry.used_this_frame = false;
@@ -212,9 +314,54 @@ class RasterCache {
     }
   }
 
+  // Returns how valuable it is to keep the image of the given entry around.
+  // Entries with lower scores are evicted first.
+  double RetentionScore(const Entry& entry, size_t bytes) const;
+
+  // Evicts images of entries that were not used in the current frame until
+  // |bytes| more fit in the budget, without evicting any entry whose
+  // retention score is higher than |candidate_score|. Returns false (and
+  // evicts nothing) if that is not possible.
+  bool MakeRoom(size_t bytes, double candidate_score);
+
+  // Returns true if an image of |bytes| may be added for |entry|, evicting
+  // other entries if the cache is byte-budgeted.
+  bool Admit(const Entry& entry, size_t bytes);
+
+  // Evicts images, least valuable first, until the cache fits in its budget.
+  void EnforceMaxBytes();
+
+  // Hands the rasterization of |picture| to the async dispatcher, keeping
+  // |reserved_bytes| of the budget for it until the result is collected.
+  void DispatchAsyncRasterization(const PictureRasterCacheKey& cache_key,
+                                  SkPicture* picture,
+                                  const SkMatrix& transformation_matrix,
+                                  SkColorSpace* dst_color_space,
+                                  size_t reserved_bytes);
+
+  // Moves the results of finished asynchronous rasterizations into their
+  // entries.
+  void CollectAsyncResults();
+
   const size_t access_threshold_;
-  const size_t picture_cache_limit_per_frame_;
+  // The per-frame limit the cache was created with, used again when
+  // asynchronous rasterization is turned off.
+  const size_t sync_picture_cache_limit_per_frame_;
+  size_t picture_cache_limit_per_frame_;
   size_t picture_cached_this_frame_ = 0;
+  size_t max_bytes_ = 0;
+  size_t max_unused_frames_ = kDefaultMaxUnusedFrames;
+  size_t frame_count_ = 0;
+  size_t evicted_this_frame_ = 0;
+  size_t rejected_this_frame_ = 0;
+  AsyncRasterizationDispatcher async_dispatcher_;
+  std::shared_ptr<AsyncResults> async_results_;
+  // Bumped by Clear so that results of rasterizations started before it are
+  // discarded.
+  size_t async_generation_ = 0;
+  // The estimated bytes of rasterizations that are in flight. Counted against
+  // max_bytes_ so that admitted entries cannot exceed it once collected.
+  size_t async_reserved_bytes_ = 0;
   mutable PictureRasterCacheKey::Map<Entry> picture_cache_;
   mutable LayerRasterCacheKey::Map<Entry> layer_cache_;
   bool checkerboard_images_;
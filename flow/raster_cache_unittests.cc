@@ -5,10 +5,12 @@
 #include "flutter/flow/raster_cache.h"
 
 #include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPaint.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
+#include "third_party/skia/include/gpu/GrDirectContext.h"
 
 namespace flutter {
 namespace testing {
@@ -132,6 +134,332 @@ TEST(RasterCache, SweepsRemoveUnusedFrames) {
   ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
 }
 
+TEST(RasterCache, ByteBudgetKeepsEntriesUnusedForAFrame) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+  cache.SetMaxBytes(1024 * 1024);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                             false));  // 1
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true,
+                            false));  // 2
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+  cache.SweepAfterFrame();  // Extra frame without a Get image access.
+
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+}
+
+TEST(RasterCache, ByteBudgetEvictsStaleEntriesToAdmitNewOnes) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture_a = GetSamplePicture();
+  auto picture_b = GetSamplePicture();
+
+  // Room for exactly one 150x100 N32 image.
+  cache.SetMaxBytes(150 * 100 * 4);
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture_a, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture_b, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  // Both pictures are on screen, only the first one fits in the budget.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture_a, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture_b, dummy_canvas));
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 150u * 100u * 4u);
+
+  cache.SweepAfterFrame();
+
+  // The first picture was drawn in the previous frame and may come back.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture_b, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  // Now the first picture is stale and makes room for the second one.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture_b, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture_a, dummy_canvas));
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 150u * 100u * 4u);
+}
+
+TEST(RasterCache, AsyncRasterizationIsDispatchedOnce) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  std::vector<std::function<void(GrDirectContext*)>> tasks;
+  cache.SetAsyncRasterizationDispatcher(
+      [&tasks](std::function<void(GrDirectContext*)> task) {
+        tasks.push_back(std::move(task));
+      });
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  // The picture is handed off and drawn uncached in the meantime.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(tasks.size(), 1u);
+
+  cache.SweepAfterFrame();
+
+  // Still in flight, no new task.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(tasks.size(), 1u);
+}
+
+TEST(RasterCache, AsyncRasterizationFallsBackToSyncWithoutContext) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  std::vector<std::function<void(GrDirectContext*)>> tasks;
+  cache.SetAsyncRasterizationDispatcher(
+      [&tasks](std::function<void(GrDirectContext*)> task) {
+        tasks.push_back(std::move(task));
+      });
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(tasks.size(), 1u);
+
+  // The worker has no usable context.
+  tasks[0](nullptr);
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(tasks.size(), 1u);
+}
+
+TEST(RasterCache, AsyncRasterizationResultIsDrawnOnceCollected) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  std::vector<std::function<void(GrDirectContext*)>> tasks;
+  cache.SetAsyncRasterizationDispatcher(
+      [&tasks](std::function<void(GrDirectContext*)> task) {
+        tasks.push_back(std::move(task));
+      });
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_EQ(tasks.size(), 1u);
+
+  sk_sp<GrDirectContext> context = GrDirectContext::MakeMock(nullptr);
+  ASSERT_TRUE(context);
+  tasks[0](context.get());
+
+  // The result is only collected at the end of the frame.
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_EQ(tasks.size(), 1u);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 150u * 100u * 4u);
+}
+
+TEST(RasterCache, AsyncRasterizationReservesBytesInBudget) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  std::vector<std::function<void(GrDirectContext*)>> tasks;
+  cache.SetAsyncRasterizationDispatcher(
+      [&tasks](std::function<void(GrDirectContext*)> task) {
+        tasks.push_back(std::move(task));
+      });
+
+  // Room for exactly one 150x100 N32 image.
+  cache.SetMaxBytes(150 * 100 * 4);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture_a = GetSamplePicture();
+  auto picture_b = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+
+  cache.SweepAfterFrame();
+
+  // The first picture takes the whole budget while it is in flight.
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_EQ(tasks.size(), 1u);
+
+  sk_sp<GrDirectContext> context = GrDirectContext::MakeMock(nullptr);
+  ASSERT_TRUE(context);
+  tasks[0](context.get());
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture_a.get(), matrix, srgb.get(), true, false));
+  ASSERT_TRUE(cache.Draw(*picture_a, dummy_canvas));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture_b.get(), matrix, srgb.get(), true, false));
+  ASSERT_EQ(tasks.size(), 1u);
+  ASSERT_EQ(cache.EstimatePictureCacheByteSize(), 150u * 100u * 4u);
+}
+
+TEST(RasterCache, PicturesWithTextureImagesAreRasterizedSynchronously) {
+  size_t threshold = 1;
+  flutter::RasterCache cache(threshold);
+
+  std::vector<std::function<void(GrDirectContext*)>> tasks;
+  cache.SetAsyncRasterizationDispatcher(
+      [&tasks](std::function<void(GrDirectContext*)> task) {
+        tasks.push_back(std::move(task));
+      });
+
+  sk_sp<GrDirectContext> context = GrDirectContext::MakeMock(nullptr);
+  ASSERT_TRUE(context);
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(10, 10);
+  bitmap.eraseColor(SK_ColorRED);
+  sk_sp<SkImage> image =
+      SkImage::MakeFromBitmap(bitmap)->makeTextureImage(context.get());
+  ASSERT_TRUE(image && image->isTextureBacked());
+
+  SkPictureRecorder recorder;
+  recorder.beginRecording(SkRect::MakeWH(150, 100));
+  SkPaint paint;
+  paint.setColor(SK_ColorRED);
+  recorder.getRecordingCanvas()->drawRect(SkRect::MakeXYWH(10, 10, 80, 80),
+                                          paint);
+  recorder.getRecordingCanvas()->drawImage(image, 20, 20);
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  SkMatrix matrix = SkMatrix::I();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(cache.Prepare(context.get(), picture.get(), matrix, srgb.get(),
+                             true, false));
+  ASSERT_FALSE(cache.Draw(*picture, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  ASSERT_TRUE(cache.Prepare(context.get(), picture.get(), matrix, srgb.get(),
+                            true, false));
+  ASSERT_TRUE(cache.Draw(*picture, dummy_canvas));
+  ASSERT_TRUE(tasks.empty());
+}
+
+TEST(RasterCache, ClearingAsyncDispatcherRestoresPictureCacheLimit) {
+  size_t threshold = 1;
+  size_t picture_cache_limit_per_frame = 1;
+  flutter::RasterCache cache(threshold, picture_cache_limit_per_frame);
+
+  cache.SetAsyncRasterizationDispatcher(
+      [](std::function<void(GrDirectContext*)> task) {});
+  cache.SetAsyncRasterizationDispatcher(nullptr);
+
+  SkMatrix matrix = SkMatrix::I();
+
+  auto picture1 = GetSamplePicture();
+  auto picture2 = GetSamplePicture();
+
+  SkCanvas dummy_canvas;
+
+  sk_sp<SkColorSpace> srgb = SkColorSpace::MakeSRGB();
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(cache.Draw(*picture1, dummy_canvas));
+  ASSERT_FALSE(cache.Draw(*picture2, dummy_canvas));
+
+  cache.SweepAfterFrame();
+
+  // Only one picture is rasterized per frame.
+  ASSERT_TRUE(
+      cache.Prepare(NULL, picture1.get(), matrix, srgb.get(), true, false));
+  ASSERT_FALSE(
+      cache.Prepare(NULL, picture2.get(), matrix, srgb.get(), true, false));
+}
+
 // Construct a cache result whose device target rectangle rounds out to be one
 // pixel wider than the cached image.  Verify that it can be drawn without
 // triggering any assertions.
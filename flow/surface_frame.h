@@ -6,6 +6,7 @@
 #define FLUTTER_FLOW_SURFACE_FRAME_H_
 
 #include <memory>
+#include <optional>
 
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/fml/macros.h"
@@ -42,10 +43,46 @@ class SurfaceFrame {
 
   bool supports_readback() { return supports_readback_; }
 
+  struct FramebufferInfo {
+    // Whether the surface can present a frame in which only the damaged area
+    // was repainted.
+    bool supports_partial_repaint = false;
+
+    // The area of the framebuffer, in frame coordinates, that does not hold
+    // the content of the previously presented frame (e.g. because the
+    // framebuffer was last used a few frames ago). An empty rect means that
+    // the framebuffer holds the previous frame. If absent, the content of
+    // the framebuffer is unknown and the whole frame is repainted.
+    std::optional<SkIRect> existing_damage;
+  };
+
+  void set_framebuffer_info(const FramebufferInfo& framebuffer_info) {
+    framebuffer_info_ = framebuffer_info;
+  }
+  const FramebufferInfo& framebuffer_info() const { return framebuffer_info_; }
+
+  struct SubmitInfo {
+    // The area of the frame that changed compared to the previously presented
+    // frame. Surfaces may present only this area (e.g. through
+    // eglSwapBuffersWithDamageKHR). If absent, the whole frame changed.
+    std::optional<SkIRect> frame_damage;
+
+    // The area of the framebuffer that was repainted. This is the frame damage
+    // joined with the existing damage of the framebuffer.
+    std::optional<SkIRect> buffer_damage;
+  };
+
+  void set_submit_info(const SubmitInfo& submit_info) {
+    submit_info_ = submit_info;
+  }
+  const SubmitInfo& submit_info() const { return submit_info_; }
+
  private:
   bool submitted_ = false;
   sk_sp<SkSurface> surface_;
   bool supports_readback_;
+  FramebufferInfo framebuffer_info_;
+  SubmitInfo submit_info_;
   SubmitCallback submit_callback_;
   std::unique_ptr<GLContextResult> context_result_;
 
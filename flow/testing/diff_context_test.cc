@@ -12,11 +12,12 @@ DiffContextTest::DiffContextTest()
 
 Damage DiffContextTest::DiffLayerTree(MockLayerTree& layer_tree,
                                       const MockLayerTree& old_layer_tree,
-                                      const SkIRect& additional_damage) {
+                                      const SkIRect& additional_damage,
+                                      DiffHistory* history) {
   FML_CHECK(layer_tree.size() == old_layer_tree.size());
 
   DiffContext dc(layer_tree.size(), 1, layer_tree.paint_region_map(),
-                 old_layer_tree.paint_region_map());
+                 old_layer_tree.paint_region_map(), history);
   dc.PushCullRect(
       SkRect::MakeIWH(layer_tree.size().width(), layer_tree.size().height()));
   layer_tree.root()->Diff(&dc, old_layer_tree.root());
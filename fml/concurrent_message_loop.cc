@@ -11,6 +11,18 @@
 
 namespace fml {
 
+namespace {
+
+// The worker, if any, that the current thread is running.
+struct CurrentWorker {
+  const ConcurrentMessageLoop* loop = nullptr;
+  size_t index = 0;
+};
+
+thread_local CurrentWorker tCurrentWorker;
+
+}  // namespace
+
 std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
     size_t worker_count) {
   return std::shared_ptr<ConcurrentMessageLoop>{
@@ -19,17 +31,17 @@ std::shared_ptr<ConcurrentMessageLoop> ConcurrentMessageLoop::Create(
 
 ConcurrentMessageLoop::ConcurrentMessageLoop(size_t worker_count)
     : worker_count_(std::max<size_t>(worker_count, 1ul)) {
+  for (size_t i = 0; i < worker_count_; ++i) {
+    worker_queues_.emplace_back(std::make_unique<WorkerQueue>());
+  }
+
   for (size_t i = 0; i < worker_count_; ++i) {
     workers_.emplace_back([i, this]() {
       fml::Thread::SetCurrentThreadName(
           std::string{"io.worker." + std::to_string(i + 1)});
-      WorkerMain();
+      WorkerMain(i);
     });
   }
-
-  for (const auto& worker : workers_) {
-    worker_thread_ids_.emplace_back(worker.get_id());
-  }
 }
 
 ConcurrentMessageLoop::~ConcurrentMessageLoop() {
@@ -47,59 +59,56 @@ std::shared_ptr<ConcurrentTaskRunner> ConcurrentMessageLoop::GetTaskRunner() {
   return std::make_shared<ConcurrentTaskRunner>(weak_from_this());
 }
 
-void ConcurrentMessageLoop::PostTask(const fml::closure& task) {
+void ConcurrentMessageLoop::PostTask(const fml::closure& task,
+                                     ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
-  std::unique_lock lock(tasks_mutex_);
-
   // Don't just drop tasks on the floor in case of shutdown.
   if (shutdown_) {
     FML_DLOG(WARNING)
         << "Tried to post a task to shutdown concurrent message "
            "loop. The task will be executed on the callers thread.";
-    lock.unlock();
     task();
     return;
   }
 
-  tasks_.push(task);
-
-  // Unlock the mutex before notifying the condition variable because that mutex
-  // has to be acquired on the other thread anyway. Waiting in this scope till
-  // it is acquired there is a pessimization.
-  lock.unlock();
+  // Workers keep the tasks they post for themselves; Other workers steal them
+  // if they are idle.
+  const size_t worker_index = tCurrentWorker.loop == this
+                                  ? tCurrentWorker.index
+                                  : next_worker_index_++ % worker_count_;
+  auto& queue = worker_queues_[worker_index];
+  {
+    std::scoped_lock lock(queue->mutex);
+    queue->lanes[static_cast<size_t>(priority)].push_back(task);
+  }
+  ++pending_task_count_;
 
-  tasks_condition_.notify_one();
+  WakeUpIdleWorkers(false);
 }
 
-void ConcurrentMessageLoop::WorkerMain() {
-  while (true) {
-    std::unique_lock lock(tasks_mutex_);
-    tasks_condition_.wait(lock, [&]() {
-      return tasks_.size() > 0 || shutdown_ || HasThreadTasksLocked();
-    });
-
-    // Shutdown cannot be read with the task mutex unlocked.
-    bool shutdown_now = shutdown_;
-    fml::closure task;
-    std::vector<fml::closure> thread_tasks;
-
-    if (tasks_.size() != 0) {
-      task = tasks_.front();
-      tasks_.pop();
-    }
-
-    if (HasThreadTasksLocked()) {
-      thread_tasks = GetThreadTasksLocked();
-      FML_DCHECK(!HasThreadTasksLocked());
+void ConcurrentMessageLoop::WorkerMain(size_t worker_index) {
+  tCurrentWorker = {this, worker_index};
+
+  while (!shutdown_) {
+    std::vector<fml::closure> thread_tasks = TakeThreadTasks(worker_index);
+    fml::closure task = TakeTask(worker_index);
+
+    if (!task && thread_tasks.empty()) {
+      std::unique_lock lock(idle_mutex_);
+      // The idle count is incremented before checking for work, so that
+      // producers adding work after the check see this worker as idle and
+      // notify it.
+      ++idle_worker_count_;
+      idle_condition_.wait(lock, [&]() {
+        return shutdown_ || HasWorkForWorker(worker_index);
+      });
+      --idle_worker_count_;
+      continue;
     }
 
-    // Don't hold onto the mutex while tasks are being executed as they could
-    // themselves try to post more tasks to the message loop.
-    lock.unlock();
-
     TRACE_EVENT0("flutter", "ConcurrentWorkerWake");
     // Execute the primary task we woke up for.
     if (task) {
@@ -110,17 +119,69 @@ void ConcurrentMessageLoop::WorkerMain() {
     for (const auto& thread_task : thread_tasks) {
       thread_task();
     }
+  }
+
+  tCurrentWorker = {};
+}
+
+fml::closure ConcurrentMessageLoop::TakeTask(size_t worker_index) {
+  if (pending_task_count_ == 0) {
+    return nullptr;
+  }
 
-    if (shutdown_now) {
-      break;
+  for (size_t lane = 0; lane < kPriorityCount; ++lane) {
+    // Check the own queue first, then steal from the other workers.
+    for (size_t offset = 0; offset < worker_count_; ++offset) {
+      auto& queue = worker_queues_[(worker_index + offset) % worker_count_];
+      std::scoped_lock lock(queue->mutex);
+      auto& tasks = queue->lanes[lane];
+      if (!tasks.empty()) {
+        fml::closure task = std::move(tasks.front());
+        tasks.pop_front();
+        --pending_task_count_;
+        return task;
+      }
     }
   }
+  return nullptr;
+}
+
+std::vector<fml::closure> ConcurrentMessageLoop::TakeThreadTasks(
+    size_t worker_index) {
+  auto& queue = worker_queues_[worker_index];
+  std::vector<fml::closure> pending_tasks;
+  if (!queue->has_thread_tasks) {
+    return pending_tasks;
+  }
+  std::scoped_lock lock(queue->mutex);
+  std::swap(pending_tasks, queue->thread_tasks);
+  queue->has_thread_tasks = false;
+  return pending_tasks;
+}
+
+bool ConcurrentMessageLoop::HasWorkForWorker(size_t worker_index) const {
+  return pending_task_count_ > 0 ||
+         worker_queues_[worker_index]->has_thread_tasks;
+}
+
+void ConcurrentMessageLoop::WakeUpIdleWorkers(bool all) {
+  if (!all && idle_worker_count_ == 0) {
+    return;
+  }
+  {
+    // Synchronizes with idle workers checking for work before they wait.
+    std::scoped_lock lock(idle_mutex_);
+  }
+  if (all) {
+    idle_condition_.notify_all();
+  } else {
+    idle_condition_.notify_one();
+  }
 }
 
 void ConcurrentMessageLoop::Terminate() {
-  std::scoped_lock lock(tasks_mutex_);
   shutdown_ = true;
-  tasks_condition_.notify_all();
+  WakeUpIdleWorkers(true);
 }
 
 void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
@@ -128,24 +189,12 @@ void ConcurrentMessageLoop::PostTaskToAllWorkers(fml::closure task) {
     return;
   }
 
-  std::scoped_lock lock(tasks_mutex_);
-  for (const auto& worker_thread_id : worker_thread_ids_) {
-    thread_tasks_[worker_thread_id].emplace_back(task);
+  for (auto& queue : worker_queues_) {
+    std::scoped_lock lock(queue->mutex);
+    queue->thread_tasks.emplace_back(task);
+    queue->has_thread_tasks = true;
   }
-  tasks_condition_.notify_all();
-}
-
-bool ConcurrentMessageLoop::HasThreadTasksLocked() const {
-  return thread_tasks_.count(std::this_thread::get_id()) > 0;
-}
-
-std::vector<fml::closure> ConcurrentMessageLoop::GetThreadTasksLocked() {
-  auto found = thread_tasks_.find(std::this_thread::get_id());
-  FML_DCHECK(found != thread_tasks_.end());
-  std::vector<fml::closure> pending_tasks;
-  std::swap(pending_tasks, found->second);
-  thread_tasks_.erase(found);
-  return pending_tasks;
+  WakeUpIdleWorkers(true);
 }
 
 ConcurrentTaskRunner::ConcurrentTaskRunner(
@@ -155,12 +204,18 @@ ConcurrentTaskRunner::ConcurrentTaskRunner(
 ConcurrentTaskRunner::~ConcurrentTaskRunner() = default;
 
 void ConcurrentTaskRunner::PostTask(const fml::closure& task) {
+  PostTaskWithPriority(task, ConcurrentTaskPriority::kNormal);
+}
+
+void ConcurrentTaskRunner::PostTaskWithPriority(
+    const fml::closure& task,
+    ConcurrentTaskPriority priority) {
   if (!task) {
     return;
   }
 
   if (auto loop = weak_loop_.lock()) {
-    loop->PostTask(task);
+    loop->PostTask(task, priority);
     return;
   }
 
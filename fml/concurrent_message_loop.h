@@ -5,10 +5,13 @@
 #ifndef FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 #define FLUTTER_FML_CONCURRENT_MESSAGE_LOOP_H_
 
+#include <atomic>
 #include <condition_variable>
-#include <map>
-#include <queue>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/closure.h"
 #include "flutter/fml/macros.h"
@@ -18,6 +21,21 @@ namespace fml {
 
 class ConcurrentTaskRunner;
 
+// The order in which idle workers pick up tasks. Workers run all pending tasks
+// of a higher priority, including ones stolen from other workers, before
+// tasks of a lower priority.
+enum class ConcurrentTaskPriority {
+  // Work that the next frame is waiting on.
+  kHigh,
+  kNormal,
+  // Speculative work, e.g. warming up caches.
+  kLow,
+};
+
+// A pool of worker threads. Each worker has its own task queue; Tasks posted
+// from a worker go to its own queue and tasks posted from other threads are
+// distributed round robin. Idle workers steal tasks from the queues of other
+// workers, so producers and workers rarely contend on the same lock.
 class ConcurrentMessageLoop
     : public std::enable_shared_from_this<ConcurrentMessageLoop> {
  public:
@@ -37,24 +55,42 @@ class ConcurrentMessageLoop
  private:
   friend ConcurrentTaskRunner;
 
+  static constexpr size_t kPriorityCount =
+      static_cast<size_t>(ConcurrentTaskPriority::kLow) + 1;
+
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<fml::closure> lanes[kPriorityCount];
+    std::vector<fml::closure> thread_tasks;
+    std::atomic_bool has_thread_tasks = false;
+  };
+
   size_t worker_count_ = 0;
   std::vector<std::thread> workers_;
-  std::mutex tasks_mutex_;
-  std::condition_variable tasks_condition_;
-  std::queue<fml::closure> tasks_;
-  std::vector<std::thread::id> worker_thread_ids_;
-  std::map<std::thread::id, std::vector<fml::closure>> thread_tasks_;
-  bool shutdown_ = false;
+  std::vector<std::unique_ptr<WorkerQueue>> worker_queues_;
+  // The number of tasks in the lanes of all worker queues.
+  std::atomic_size_t pending_task_count_ = 0;
+  std::atomic_size_t next_worker_index_ = 0;
+  // Idle workers wait on |idle_condition_|. Producers only acquire
+  // |idle_mutex_| when there is an idle worker to wake up.
+  std::mutex idle_mutex_;
+  std::condition_variable idle_condition_;
+  std::atomic_size_t idle_worker_count_ = 0;
+  std::atomic_bool shutdown_ = false;
 
   ConcurrentMessageLoop(size_t worker_count);
 
-  void WorkerMain();
+  void WorkerMain(size_t worker_index);
 
-  void PostTask(const fml::closure& task);
+  void PostTask(const fml::closure& task, ConcurrentTaskPriority priority);
 
-  bool HasThreadTasksLocked() const;
+  fml::closure TakeTask(size_t worker_index);
 
-  std::vector<fml::closure> GetThreadTasksLocked();
+  std::vector<fml::closure> TakeThreadTasks(size_t worker_index);
+
+  bool HasWorkForWorker(size_t worker_index) const;
+
+  void WakeUpIdleWorkers(bool all);
 
   FML_DISALLOW_COPY_AND_ASSIGN(ConcurrentMessageLoop);
 };
@@ -67,6 +103,9 @@ class ConcurrentTaskRunner : public BasicTaskRunner {
 
   void PostTask(const fml::closure& task) override;
 
+  void PostTaskWithPriority(const fml::closure& task,
+                            ConcurrentTaskPriority priority);
+
  private:
   friend ConcurrentMessageLoop;
 
@@ -0,0 +1,108 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/concurrent_message_loop.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
+
+namespace fml {
+namespace benchmarking {
+
+static constexpr size_t kWorkerCount = 4;
+
+// Several producer threads post many tiny tasks, as the image decoder and the
+// Skia executor do.
+static void BM_ConcurrentMessageLoopThroughput(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  const int num_producers = state.range(0);
+  const int num_tasks_per_producer = 10000;
+
+  while (state.KeepRunning()) {
+    CountDownLatch tasks_done(num_producers * num_tasks_per_producer);
+    std::vector<std::thread> producers;
+    for (int i = 0; i < num_producers; i++) {
+      producers.emplace_back([&]() {
+        for (int j = 0; j < num_tasks_per_producer; j++) {
+          task_runner->PostTask([&tasks_done]() { tasks_done.CountDown(); });
+        }
+      });
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    tasks_done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * num_producers *
+                          num_tasks_per_producer);
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopThroughput)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->UseRealTime();
+
+// Measures the time from posting a high priority task until it runs, while
+// the workers are saturated with low priority background tasks. Reports the
+// median and the tail of the latency.
+static void BM_ConcurrentMessageLoopLatencyUnderLoad(
+    benchmark::State& state) {  // NOLINT
+  auto loop = ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+  const int num_background_tasks = state.range(0);
+  const int num_measured_tasks = 100;
+
+  std::vector<double> latencies_us;
+  while (state.KeepRunning()) {
+    CountDownLatch tasks_done(num_background_tasks + num_measured_tasks);
+    for (int i = 0; i < num_background_tasks; i++) {
+      task_runner->PostTaskWithPriority(
+          [&tasks_done]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            tasks_done.CountDown();
+          },
+          ConcurrentTaskPriority::kLow);
+    }
+
+    std::mutex latencies_mutex;
+    for (int i = 0; i < num_measured_tasks; i++) {
+      const auto posted = TimePoint::Now();
+      task_runner->PostTaskWithPriority(
+          [&, posted]() {
+            const auto latency = TimePoint::Now() - posted;
+            {
+              std::scoped_lock lock(latencies_mutex);
+              latencies_us.push_back(latency.ToMicrosecondsF());
+            }
+            tasks_done.CountDown();
+          },
+          ConcurrentTaskPriority::kHigh);
+    }
+    tasks_done.Wait();
+  }
+
+  std::sort(latencies_us.begin(), latencies_us.end());
+  if (!latencies_us.empty()) {
+    state.counters["p50_us"] = latencies_us[latencies_us.size() / 2];
+    state.counters["p99_us"] = latencies_us[latencies_us.size() * 99 / 100];
+  }
+}
+
+BENCHMARK(BM_ConcurrentMessageLoopLatencyUnderLoad)
+    ->Arg(0)
+    ->Arg(1000)
+    ->UseRealTime();
+
+}  // namespace benchmarking
+}  // namespace fml
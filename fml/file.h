@@ -90,6 +90,12 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
                      const char* file_name,
                      const Mapping& mapping);
 
+/// Renames `old_name` to `new_name` in `base_directory`, replacing any file
+/// already at `new_name`.
+bool RenameFile(const fml::UniqueFD& base_directory,
+                const char* old_name,
+                const char* new_name);
+
 /// Signature of a callback on a file in `directory` with `filename` (relative
 /// to `directory`). The returned bool should be false if and only if further
 /// traversal should be stopped. For example, a file-search visitor may return
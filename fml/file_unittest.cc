@@ -253,6 +253,40 @@ TEST(FileTest, AtomicWriteTest) {
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "precious_data"));
 }
 
+TEST(FileTest, AtomicWriteReplacesExistingFile) {
+  fml::ScopedTemporaryDirectory dir;
+
+  fml::DataMapping old_contents(std::string("old"));
+  fml::DataMapping new_contents(std::string("new contents"));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "data", old_contents));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "data", new_contents));
+
+  ASSERT_EQ("new contents",
+            ReadStringFromFile(fml::OpenFile(dir.fd(), "data", false,
+                                             fml::FilePermission::kRead)));
+
+  // Cleanup.
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "data"));
+}
+
+TEST(FileTest, RenameFileReplacesExistingFile) {
+  fml::ScopedTemporaryDirectory dir;
+
+  fml::DataMapping source(std::string("source"));
+  fml::DataMapping target(std::string("target"));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "source", source));
+  ASSERT_TRUE(fml::WriteAtomically(dir.fd(), "target", target));
+
+  ASSERT_TRUE(fml::RenameFile(dir.fd(), "source", "target"));
+  ASSERT_FALSE(fml::FileExists(dir.fd(), "source"));
+  ASSERT_EQ("source",
+            ReadStringFromFile(fml::OpenFile(dir.fd(), "target", false,
+                                             fml::FilePermission::kRead)));
+
+  // Cleanup.
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "target"));
+}
+
 TEST(FileTest, EmptyMappingTest) {
   fml::ScopedTemporaryDirectory dir;
 
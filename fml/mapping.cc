@@ -9,6 +9,12 @@
 
 namespace fml {
 
+// Mapping
+
+uint8_t* Mapping::GetMutableMapping() {
+  return nullptr;
+}
+
 // FileMapping
 
 uint8_t* FileMapping::GetMutableMapping() {
@@ -81,12 +87,20 @@ const uint8_t* DataMapping::GetMapping() const {
   return data_.data();
 }
 
+uint8_t* DataMapping::GetMutableMapping() {
+  return data_.data();
+}
+
 // NonOwnedMapping
 
 NonOwnedMapping::NonOwnedMapping(const uint8_t* data,
                                  size_t size,
-                                 const ReleaseProc& release_proc)
-    : data_(data), size_(size), release_proc_(release_proc) {}
+                                 const ReleaseProc& release_proc,
+                                 bool is_mutable)
+    : data_(data),
+      size_(size),
+      release_proc_(release_proc),
+      is_mutable_(is_mutable) {}
 
 NonOwnedMapping::~NonOwnedMapping() {
   if (release_proc_) {
@@ -102,6 +116,10 @@ const uint8_t* NonOwnedMapping::GetMapping() const {
   return data_;
 }
 
+uint8_t* NonOwnedMapping::GetMutableMapping() {
+  return is_mutable_ ? const_cast<uint8_t*>(data_) : nullptr;
+}
+
 // Symbol Mapping
 
 SymbolMapping::SymbolMapping(fml::RefPtr<fml::NativeLibrary> native_library,
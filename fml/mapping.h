@@ -28,6 +28,12 @@ class Mapping {
 
   virtual const uint8_t* GetMapping() const = 0;
 
+  // The same bytes as |GetMapping| if callers are allowed to write to them, or
+  // nullptr if the mapping is read-only. Consumers that cannot express
+  // read-only access to a buffer, such as Dart external typed data, may only
+  // borrow the bytes of a mutable mapping and must copy them otherwise.
+  virtual uint8_t* GetMutableMapping();
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Mapping);
 };
@@ -65,7 +71,8 @@ class FileMapping final : public Mapping {
   // |Mapping|
   const uint8_t* GetMapping() const override;
 
-  uint8_t* GetMutableMapping();
+  // |Mapping|
+  uint8_t* GetMutableMapping() override;
 
   bool IsValid() const;
 
@@ -96,6 +103,9 @@ class DataMapping final : public Mapping {
   // |Mapping|
   const uint8_t* GetMapping() const override;
 
+  // |Mapping|
+  uint8_t* GetMutableMapping() override;
+
  private:
   std::vector<uint8_t> data_;
 
@@ -105,9 +115,13 @@ class DataMapping final : public Mapping {
 class NonOwnedMapping final : public Mapping {
  public:
   using ReleaseProc = std::function<void(const uint8_t* data, size_t size)>;
+
+  // If |is_mutable| is true, the owner of |data| allows the holders of this
+  // mapping to write to it until the release proc is invoked.
   NonOwnedMapping(const uint8_t* data,
                   size_t size,
-                  const ReleaseProc& release_proc = nullptr);
+                  const ReleaseProc& release_proc = nullptr,
+                  bool is_mutable = false);
 
   ~NonOwnedMapping() override;
 
@@ -117,10 +131,14 @@ class NonOwnedMapping final : public Mapping {
   // |Mapping|
   const uint8_t* GetMapping() const override;
 
+  // |Mapping|
+  uint8_t* GetMutableMapping() override;
+
  private:
   const uint8_t* const data_;
   const size_t size_;
   const ReleaseProc release_proc_;
+  const bool is_mutable_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(NonOwnedMapping);
 };
@@ -37,6 +37,12 @@ static const TaskQueueId _kUnmerged = TaskQueueId(TaskQueueId::kUnmerged);
 class TaskQueueEntry {
  public:
   using TaskObservers = std::map<intptr_t, fml::closure>;
+
+  // Guards the wakeable, the task observers and the delayed tasks. The merge
+  // state below is instead guarded by the queue meta mutex of
+  // |MessageLoopTaskQueues|, and is stable while that is held in shared mode.
+  std::mutex mutex;
+
   Wakeable* wakeable;
   TaskObservers task_observers;
   DelayedTaskQueue delayed_tasks;
@@ -111,6 +117,12 @@ class MessageLoopTaskQueues
   //
   //  Methods currently aware of the merged state of the queues:
   //  HasPendingTasks, GetNextTaskToRun, GetNumPendingTasks
+  //
+  // Locking: Creating, disposing, merging and unmerging queues holds the
+  // queue meta mutex exclusively. Everything else holds it in shared mode and
+  // additionally locks the mutex of the task queues involved, i.e. the queue
+  // and the queue merged with it, if any. Threads working on unrelated queues
+  // therefore do not contend with each other.
 
   // This method returns false if either the owner or subsumed has already been
   // merged with something else.
@@ -133,6 +145,16 @@ class MessageLoopTaskQueues
 
   ~MessageLoopTaskQueues();
 
+  // Holds the mutexes of a task queue and of the queue merged with it.
+  struct TaskQueueGroupLock {
+    std::unique_lock<std::mutex> first;
+    std::unique_lock<std::mutex> second;
+  };
+
+  // Locks the task queue along with the queue merged with it, if any. The
+  // queue meta mutex must be held.
+  TaskQueueGroupLock LockTaskQueueGroup(TaskQueueId queue_id) const;
+
   void WakeUpUnlocked(TaskQueueId queue_id, fml::TimePoint time) const;
 
   bool HasPendingTasksUnlocked(TaskQueueId queue_id) const;
@@ -145,7 +167,9 @@ class MessageLoopTaskQueues
   static std::mutex creation_mutex_;
   static fml::RefPtr<MessageLoopTaskQueues> instance_;
 
-  mutable std::mutex queue_mutex_;
+  // Guards |queue_entries_| and the merge state of the entries. See the
+  // locking notes above.
+  std::unique_ptr<fml::SharedMutex> queue_meta_mutex_;
   std::map<TaskQueueId, std::unique_ptr<TaskQueueEntry>> queue_entries_;
 
   size_t task_queue_id_counter_;
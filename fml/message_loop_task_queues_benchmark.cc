@@ -66,5 +66,73 @@ static void BM_RegisterAndGetTasks(benchmark::State& state) {  // NOLINT
 
 BENCHMARK(BM_RegisterAndGetTasks);
 
+// Each thread keeps posting to and draining its own task queue, like the
+// threads of several engines running side by side. With per-queue locking
+// the throughput per thread should stay flat as threads are added.
+static void BM_RegisterAndGetTasksPerThreadQueues(
+    benchmark::State& state) {  // NOLINT
+  auto task_queues = fml::MessageLoopTaskQueues::GetInstance();
+  const int num_threads = state.range(0);
+  const bool merge_pairs = state.range(1);
+  const int num_tasks_per_thread = 1000;
+
+  while (state.KeepRunning()) {
+    std::vector<TaskQueueId> queue_ids;
+    for (int i = 0; i < num_threads; i++) {
+      queue_ids.push_back(task_queues->CreateTaskQueue());
+    }
+    // Merging pairs of queues mimics the raster thread merger, where the
+    // owner drains tasks posted to both queues.
+    if (merge_pairs) {
+      for (int i = 0; i + 1 < num_threads; i += 2) {
+        task_queues->Merge(queue_ids[i], queue_ids[i + 1]);
+      }
+    }
+
+    const fml::TimePoint past = fml::TimePoint::Now();
+    CountDownLatch threads_ready(num_threads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+      threads.emplace_back([&, queue_id = queue_ids[i]]() {
+        threads_ready.CountDown();
+        threads_ready.Wait();
+        for (int j = 0; j < num_tasks_per_thread; j++) {
+          task_queues->RegisterTask(
+              queue_id, [] {}, past);
+          // Subsumed queues never yield tasks; Their owner drains them.
+          task_queues->GetNextTaskToRun(queue_id, fml::TimePoint::Now());
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    if (merge_pairs) {
+      for (int i = 0; i + 1 < num_threads; i += 2) {
+        task_queues->Unmerge(queue_ids[i]);
+      }
+    }
+    for (auto queue_id : queue_ids) {
+      task_queues->Dispose(queue_id);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_threads *
+                          num_tasks_per_thread);
+}
+
+static void PerThreadQueuesArguments(
+    benchmark::internal::Benchmark* benchmark) {
+  for (int merge_pairs = 0; merge_pairs <= 1; merge_pairs++) {
+    for (int num_threads = 1; num_threads <= 16; num_threads *= 2) {
+      benchmark->Args({num_threads, merge_pairs});
+    }
+  }
+}
+
+BENCHMARK(BM_RegisterAndGetTasksPerThreadQueues)
+    ->Apply(PerThreadQueuesArguments)
+    ->UseRealTime();
+
 }  // namespace benchmarking
 }  // namespace fml
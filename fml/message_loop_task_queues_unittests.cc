@@ -6,7 +6,9 @@
 
 #include "flutter/fml/message_loop_task_queues.h"
 
+#include <atomic>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/synchronization/count_down_latch.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -290,5 +292,44 @@ TEST(MessageLoopTaskQueue, RegisterTaskWakesUpOwnerQueue) {
   ASSERT_EQ(time1, wakes[2]);
 }
 
+TEST(MessageLoopTaskQueue, ConcurrentRegisterWhileMergingAndUnmerging) {
+  auto task_queue = fml::MessageLoopTaskQueues::GetInstance();
+  auto owner = task_queue->CreateTaskQueue();
+  auto subsumed = task_queue->CreateTaskQueue();
+
+  const int num_tasks_per_queue = 1000;
+  std::atomic_bool done = false;
+  std::thread merger([&]() {
+    while (!done) {
+      task_queue->Merge(owner, subsumed);
+      task_queue->Unmerge(owner);
+    }
+  });
+
+  std::vector<std::thread> posters;
+  for (auto queue_id : {owner, subsumed}) {
+    posters.emplace_back([&, queue_id]() {
+      for (int i = 0; i < num_tasks_per_queue; i++) {
+        task_queue->RegisterTask(
+            queue_id, [] {}, fml::TimePoint::Max());
+        task_queue->HasPendingTasks(queue_id);
+      }
+    });
+  }
+  for (auto& poster : posters) {
+    poster.join();
+  }
+  done = true;
+  merger.join();
+
+  ASSERT_EQ(task_queue->GetNumPendingTasks(owner),
+            static_cast<size_t>(num_tasks_per_queue));
+  ASSERT_TRUE(task_queue->Merge(owner, subsumed));
+  ASSERT_EQ(task_queue->GetNumPendingTasks(owner),
+            static_cast<size_t>(2 * num_tasks_per_queue));
+  ASSERT_EQ(task_queue->GetNumPendingTasks(subsumed), 0u);
+  ASSERT_TRUE(task_queue->Unmerge(owner));
+}
+
 }  // namespace testing
 }  // namespace fml
@@ -8,6 +8,7 @@
 
 #include <iostream>
 #include <thread>
+#include <vector>
 
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/concurrent_message_loop.h"
@@ -316,3 +317,54 @@ TEST(MessageLoop, CanCreateConcurrentMessageLoop) {
   latch.Wait();
   ASSERT_GE(thread_ids.size(), 1u);
 }
+
+TEST(MessageLoop, ConcurrentMessageLoopRunsHigherPriorityTasksFirst) {
+  auto loop = fml::ConcurrentMessageLoop::Create(1u);
+  auto task_runner = loop->GetTaskRunner();
+  fml::AutoResetWaitableEvent started;
+  fml::AutoResetWaitableEvent release;
+  task_runner->PostTask([&]() {
+    started.Signal();
+    release.Wait();
+  });
+  started.Wait();
+
+  // The only worker is busy, so all of these are queued.
+  fml::CountDownLatch latch(3);
+  std::vector<fml::ConcurrentTaskPriority> order;
+  auto record = [&](fml::ConcurrentTaskPriority priority) {
+    return [&, priority]() {
+      order.push_back(priority);
+      latch.CountDown();
+    };
+  };
+  task_runner->PostTaskWithPriority(record(fml::ConcurrentTaskPriority::kLow),
+                                    fml::ConcurrentTaskPriority::kLow);
+  task_runner->PostTask(record(fml::ConcurrentTaskPriority::kNormal));
+  task_runner->PostTaskWithPriority(record(fml::ConcurrentTaskPriority::kHigh),
+                                    fml::ConcurrentTaskPriority::kHigh);
+  release.Signal();
+  latch.Wait();
+
+  ASSERT_EQ(order, std::vector<fml::ConcurrentTaskPriority>(
+                       {fml::ConcurrentTaskPriority::kHigh,
+                        fml::ConcurrentTaskPriority::kNormal,
+                        fml::ConcurrentTaskPriority::kLow}));
+}
+
+TEST(MessageLoop, ConcurrentMessageLoopWorkersStealTasks) {
+  const size_t kWorkerCount = 4;
+  auto loop = fml::ConcurrentMessageLoop::Create(kWorkerCount);
+  auto task_runner = loop->GetTaskRunner();
+
+  // A single task fans out more tasks from a worker. They are queued on that
+  // worker, which blocks until all of them ran elsewhere.
+  fml::CountDownLatch latch(kWorkerCount - 1);
+  task_runner->PostTask([&]() {
+    for (size_t i = 0; i < kWorkerCount - 1; ++i) {
+      task_runner->PostTask([&]() { latch.CountDown(); });
+    }
+    latch.Wait();
+  });
+  latch.Wait();
+}
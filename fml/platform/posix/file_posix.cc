@@ -230,6 +230,21 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
                     base_directory.get(), file_name) == 0;
 }
 
+bool RenameFile(const fml::UniqueFD& base_directory,
+                const char* old_name,
+                const char* new_name) {
+  if (old_name == nullptr || new_name == nullptr) {
+    return false;
+  }
+
+  int code = ::renameat(base_directory.get(), old_name, base_directory.get(),
+                        new_name);
+  if (code != 0) {
+    FML_DLOG(ERROR) << strerror(errno);
+  }
+  return code == 0;
+}
+
 bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor) {
   fml::UniqueFD dup_fd(dup(directory.get()));
   if (!dup_fd.is_valid()) {
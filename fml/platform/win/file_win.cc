@@ -150,8 +150,10 @@ fml::UniqueFD OpenFile(const char* path,
     return {};
   }
 
+  // Like O_CREAT without O_EXCL, an existing file is opened rather than
+  // treated as an error.
   const DWORD creation_disposition =
-      create_if_necessary ? CREATE_NEW : OPEN_EXISTING;
+      create_if_necessary ? OPEN_ALWAYS : OPEN_EXISTING;
 
   const DWORD flags = FILE_ATTRIBUTE_NORMAL;
 
@@ -395,8 +397,9 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
 
   temp_file.reset();
 
-  if (!::MoveFile(StringToWideString(temp_file_path).c_str(),
-                  StringToWideString(file_path).c_str())) {
+  if (!::MoveFileEx(StringToWideString(temp_file_path).c_str(),
+                    StringToWideString(file_path).c_str(),
+                    MOVEFILE_REPLACE_EXISTING)) {
     FML_DLOG(ERROR)
         << "Could not replace temp file at correct path. File path: "
         << file_path << ". Temp file path: " << temp_file_path << " "
@@ -407,6 +410,25 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
   return true;
 }
 
+bool RenameFile(const fml::UniqueFD& base_directory,
+                const char* old_name,
+                const char* new_name) {
+  if (old_name == nullptr || new_name == nullptr) {
+    return false;
+  }
+
+  auto old_path = GetAbsolutePath(base_directory, old_name);
+  auto new_path = GetAbsolutePath(base_directory, new_name);
+  if (!::MoveFileEx(StringToWideString(old_path).c_str(),
+                    StringToWideString(new_path).c_str(),
+                    MOVEFILE_REPLACE_EXISTING)) {
+    FML_DLOG(ERROR) << "Could not rename file: '" << old_path << "' to '"
+                    << new_path << "'. " << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
 bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor) {
   std::string search_pattern = GetFullHandlePath(directory) + "\\*";
   WIN32_FIND_DATA find_file_data;
@@ -90,12 +90,24 @@ void _dispatchPlatformMessage(String name, ByteData? data, int responseId) {
   PlatformDispatcher.instance._dispatchPlatformMessage(name, data, responseId);
 }
 
+@pragma('vm:entry-point')
+// ignore: unused_element
+void _dispatchPlatformMessages(List<Object?> messages) {
+  PlatformDispatcher.instance._dispatchPlatformMessages(messages);
+}
+
 @pragma('vm:entry-point')
 // ignore: unused_element
 void _dispatchPointerDataPacket(ByteData packet) {
   PlatformDispatcher.instance._dispatchPointerDataPacket(packet);
 }
 
+@pragma('vm:entry-point')
+// ignore: unused_element
+void _dispatchPackedPointerDataPacket(ByteData packet) {
+  PlatformDispatcher.instance._dispatchPackedPointerDataPacket(packet);
+}
+
 @pragma('vm:entry-point')
 // ignore: unused_element
 void _dispatchKeyData(ByteData packet, int responseId) {
@@ -287,6 +287,17 @@ class PlatformDispatcher {
     }
   }
 
+  // Called from the engine, via hooks.dart
+  void _dispatchPackedPointerDataPacket(ByteData packet) {
+    if (onPointerDataPacket != null) {
+      _invoke1<PointerDataPacket>(
+        onPointerDataPacket,
+        _onPointerDataPacketZone,
+        _unpackPackedPointerDataPacket(packet),
+      );
+    }
+  }
+
   // If this value changes, update the encoding code in the following files:
   //
   //  * pointer_data.cc
@@ -338,6 +349,78 @@ class PlatformDispatcher {
     return PointerDataPacket(data: data);
   }
 
+  // The fields of the pointer data, indexed by their position in the layout
+  // above, that hold a double rather than an integer. Must match kDoubleFields
+  // in pointer_data_packet_converter.cc.
+  static const int _kPointerDataDoubleFields = 0x1BFFC780;
+  static const int _kPointerDataTimeStampField = 1;
+
+  // Decodes the layout of PointerDataPacketConverter::Pack, in which each
+  // pointer data only holds the fields that changed since the previous one.
+  static PointerDataPacket _unpackPackedPointerDataPacket(ByteData packet) {
+    final Int64List ints = Int64List(_kPointerDataFieldCount);
+    final Float64List doubles = Float64List(_kPointerDataFieldCount);
+    int offset = 0;
+    final int length = packet.getUint32(offset, _kFakeHostEndian);
+    offset += 4;
+    final List<PointerData> data = <PointerData>[];
+    for (int i = 0; i < length; ++i) {
+      final int presentFields = packet.getUint32(offset, _kFakeHostEndian);
+      final int wideFields = packet.getUint32(offset + 4, _kFakeHostEndian);
+      offset += 8;
+      for (int field = 0; field < _kPointerDataFieldCount; ++field) {
+        final int bit = 1 << field;
+        if (presentFields & bit == 0)
+          continue;
+        final bool wide = wideFields & bit != 0;
+        if (_kPointerDataDoubleFields & bit != 0) {
+          doubles[field] = wide
+              ? packet.getFloat64(offset, _kFakeHostEndian)
+              : packet.getFloat32(offset, _kFakeHostEndian);
+        } else {
+          final int value = wide
+              ? packet.getInt64(offset, _kFakeHostEndian)
+              : packet.getInt32(offset, _kFakeHostEndian);
+          ints[field] = field == _kPointerDataTimeStampField ? ints[field] + value : value;
+        }
+        offset += wide ? 8 : 4;
+      }
+      data.add(PointerData(
+        embedderId: ints[0],
+        timeStamp: Duration(microseconds: ints[1]),
+        change: PointerChange.values[ints[2]],
+        kind: PointerDeviceKind.values[ints[3]],
+        signalKind: PointerSignalKind.values[ints[4]],
+        device: ints[5],
+        pointerIdentifier: ints[6],
+        physicalX: doubles[7],
+        physicalY: doubles[8],
+        physicalDeltaX: doubles[9],
+        physicalDeltaY: doubles[10],
+        buttons: ints[11],
+        obscured: ints[12] != 0,
+        synthesized: ints[13] != 0,
+        pressure: doubles[14],
+        pressureMin: doubles[15],
+        pressureMax: doubles[16],
+        distance: doubles[17],
+        distanceMax: doubles[18],
+        size: doubles[19],
+        radiusMajor: doubles[20],
+        radiusMinor: doubles[21],
+        radiusMin: doubles[22],
+        radiusMax: doubles[23],
+        orientation: doubles[24],
+        tilt: doubles[25],
+        platformData: ints[26],
+        scrollDeltaX: doubles[27],
+        scrollDeltaY: doubles[28],
+      ));
+    }
+    assert(offset == packet.lengthInBytes);
+    return PointerDataPacket(data: data);
+  }
+
   /// Called by [_dispatchKeyData].
   void _respondToKeyData(int responseId, bool handled)
       native 'PlatformConfiguration_respondToKeyData';
@@ -533,6 +616,24 @@ class PlatformDispatcher {
     }
   }
 
+  // Called from the engine, via hooks.dart, with a batch of messages sent by
+  // the embedder. Every message occupies three consecutive entries: the channel
+  // name, the data and the response id. A handler that throws does not prevent
+  // the delivery of the remaining messages.
+  void _dispatchPlatformMessages(List<Object?> messages) {
+    for (int i = 0; i + 2 < messages.length; i += 3) {
+      try {
+        _dispatchPlatformMessage(
+          messages[i]! as String,
+          messages[i + 1] as ByteData?,
+          messages[i + 2]! as int,
+        );
+      } catch (error, stackTrace) {
+        Zone.current.handleUncaughtError(error, stackTrace);
+      }
+    }
+  }
+
   /// Set the debug name associated with this platform dispatcher's root
   /// isolate.
   ///
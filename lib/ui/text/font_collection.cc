@@ -6,10 +6,12 @@
 
 #include <mutex>
 
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/text/asset_manager_font_provider.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
 #include "flutter/runtime/test_font_data.h"
+#include "minikin/Layout.h"
 #include "rapidjson/document.h"
 #include "rapidjson/rapidjson.h"
 #include "third_party/skia/include/core/SkFontMgr.h"
@@ -64,6 +66,19 @@ void FontCollection::RegisterNatives(tonic::DartLibraryNatives* natives) {
   });
 }
 
+void FontCollection::SetLayoutCacheMaxBytes(size_t max_bytes) {
+  minikin::Layout::setCacheMaxBytes(max_bytes);
+}
+
+void FontCollection::TraceLayoutCacheStatsToTimeline() {
+#if !FLUTTER_RELEASE
+  const minikin::LayoutCacheStats stats = minikin::Layout::getCacheStats();
+  FML_TRACE_COUNTER("flutter", "TextLayoutCache", 0, "HitCount",
+                    stats.hitCount, "MissCount", stats.missCount,
+                    "EvictionCount", stats.evictionCount, "Bytes", stats.bytes);
+#endif  // !FLUTTER_RELEASE
+}
+
 std::shared_ptr<txt::FontCollection> FontCollection::GetFontCollection() const {
   return collection_;
 }
@@ -72,6 +87,11 @@ void FontCollection::SetupDefaultFontManager() {
   collection_->SetupDefaultFontManager();
 }
 
+void FontCollection::SetParallelShapingTaskRunner(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner) {
+  collection_->SetParallelShapingTaskRunner(std::move(task_runner));
+}
+
 void FontCollection::RegisterFonts(
     std::shared_ptr<AssetManager> asset_manager) {
   std::unique_ptr<fml::Mapping> manifest_mapping =
@@ -27,10 +27,30 @@ class FontCollection {
 
   static void RegisterNatives(tonic::DartLibraryNatives* natives);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the number of bytes of shaped words the text layout cache
+  ///             may hold. The cache is shared by all font collections in the
+  ///             process.
+  ///
+  static void SetLayoutCacheMaxBytes(size_t max_bytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the hit, miss, and eviction counts and the size of the
+  ///             text layout cache to the timeline.
+  ///
+  static void TraceLayoutCacheStatsToTimeline();
+
   std::shared_ptr<txt::FontCollection> GetFontCollection() const;
 
   void SetupDefaultFontManager();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Measures the text runs of long paragraphs in parallel on the
+  ///             given task runner before breaking them into lines.
+  ///
+  void SetParallelShapingTaskRunner(
+      std::shared_ptr<fml::BasicTaskRunner> task_runner);
+
   void RegisterFonts(std::shared_ptr<AssetManager> asset_manager);
 
   void RegisterTestFonts();
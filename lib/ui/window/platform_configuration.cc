@@ -223,6 +223,9 @@ void PlatformConfiguration::DidCreateIsolate() {
   dispatch_platform_message_.Set(
       tonic::DartState::Current(),
       Dart_GetField(library, tonic::ToDart("_dispatchPlatformMessage")));
+  dispatch_platform_messages_.Set(
+      tonic::DartState::Current(),
+      Dart_GetField(library, tonic::ToDart("_dispatchPlatformMessages")));
   dispatch_semantics_action_.Set(
       tonic::DartState::Current(),
       Dart_GetField(library, tonic::ToDart("_dispatchSemanticsAction")));
@@ -315,8 +318,7 @@ void PlatformConfiguration::DispatchPlatformMessage(
     return;
   }
   tonic::DartState::Scope scope(dart_state);
-  Dart_Handle data_handle =
-      (message->hasData()) ? ToByteData(message->data()) : Dart_Null();
+  Dart_Handle data_handle = WrapByteData(message->releaseData());
   if (Dart_IsError(data_handle)) {
     FML_DLOG(WARNING)
         << "Dropping platform message because of a Dart error on channel: "
@@ -336,6 +338,55 @@ void PlatformConfiguration::DispatchPlatformMessage(
                          tonic::ToDart(response_id)}));
 }
 
+void PlatformConfiguration::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  std::shared_ptr<tonic::DartState> dart_state =
+      dispatch_platform_messages_.dart_state().lock();
+  if (!dart_state) {
+    FML_DLOG(WARNING) << "Dropping " << messages.size()
+                      << " platform messages for lack of DartState.";
+    return;
+  }
+  tonic::DartState::Scope scope(dart_state);
+
+  // The messages are flattened into a single list of (channel, data, response
+  // id) triples. See `_dispatchPlatformMessages` in hooks.dart.
+  std::vector<Dart_Handle> entries;
+  entries.reserve(messages.size() * 3);
+  for (const auto& message : messages) {
+    Dart_Handle data_handle = WrapByteData(message->releaseData());
+    if (Dart_IsError(data_handle)) {
+      FML_DLOG(WARNING)
+          << "Dropping platform message because of a Dart error on channel: "
+          << message->channel();
+      continue;
+    }
+
+    int response_id = 0;
+    if (auto response = message->response()) {
+      response_id = next_response_id_++;
+      pending_responses_[response_id] = response;
+    }
+
+    entries.push_back(tonic::ToDart(message->channel()));
+    entries.push_back(data_handle);
+    entries.push_back(tonic::ToDart(response_id));
+  }
+
+  Dart_Handle message_list = Dart_NewList(entries.size());
+  if (Dart_IsError(message_list)) {
+    FML_DLOG(WARNING) << "Dropping " << messages.size()
+                      << " platform messages because of a Dart error.";
+    return;
+  }
+  for (size_t i = 0; i < entries.size(); i++) {
+    Dart_ListSetAt(message_list, i, entries[i]);
+  }
+
+  tonic::LogIfError(
+      tonic::DartInvoke(dispatch_platform_messages_.Get(), {message_list}));
+}
+
 void PlatformConfiguration::DispatchSemanticsAction(int32_t id,
                                                     SemanticsAction action,
                                                     std::vector<uint8_t> args) {
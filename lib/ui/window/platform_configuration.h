@@ -311,6 +311,19 @@ class PlatformConfiguration final {
   ///
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the PlatformConfiguration that the client has sent
+  ///             it a batch of messages. The messages are handed to the
+  ///             framework in order in a single call into the isolate. This
+  ///             call originates in the platform view and has been forwarded
+  ///             through the engine to here.
+  ///
+  /// @param[in]  messages  The messages sent from the embedder to the Dart
+  ///                       application.
+  ///
+  void DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the framework that the embedder encountered an
   ///             accessibility related action on the specified node. This call
@@ -455,6 +468,7 @@ class PlatformConfiguration final {
   tonic::DartPersistentValue update_semantics_enabled_;
   tonic::DartPersistentValue update_accessibility_features_;
   tonic::DartPersistentValue dispatch_platform_message_;
+  tonic::DartPersistentValue dispatch_platform_messages_;
   tonic::DartPersistentValue dispatch_key_message_;
   tonic::DartPersistentValue dispatch_semantics_action_;
   tonic::DartPersistentValue begin_frame_;
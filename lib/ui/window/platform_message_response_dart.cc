@@ -14,6 +14,37 @@
 
 namespace flutter {
 
+namespace {
+
+// Below this size, copying the payload into the Dart heap is cheaper than
+// setting up and finalizing an external typed data object.
+constexpr size_t kExternalByteDataThreshold = 1000;
+
+void FinalizeMapping(void* isolate_callback_data, void* peer) {
+  delete reinterpret_cast<fml::Mapping*>(peer);
+}
+
+}  // namespace
+
+Dart_Handle WrapByteData(std::unique_ptr<fml::Mapping> mapping) {
+  if (!mapping) {
+    return Dart_Null();
+  }
+  const size_t size = mapping->GetSize();
+  uint8_t* bytes = mapping->GetMutableMapping();
+  if (size < kExternalByteDataThreshold || bytes == nullptr) {
+    return tonic::DartByteData::Create(mapping->GetMapping(), size);
+  }
+  fml::Mapping* peer = mapping.release();
+  Dart_Handle byte_data = Dart_NewExternalTypedDataWithFinalizer(
+      Dart_TypedData_kByteData, bytes, size, peer, size, FinalizeMapping);
+  if (Dart_IsError(byte_data)) {
+    // The finalizer is only attached on success.
+    delete peer;
+  }
+  return byte_data;
+}
+
 PlatformMessageResponseDart::PlatformMessageResponseDart(
     tonic::DartPersistentValue callback,
     fml::RefPtr<fml::TaskRunner> ui_task_runner)
@@ -42,8 +73,7 @@ void PlatformMessageResponseDart::Complete(std::unique_ptr<fml::Mapping> data) {
         }
         tonic::DartState::Scope scope(dart_state);
 
-        Dart_Handle byte_buffer =
-            tonic::DartByteData::Create(data->GetMapping(), data->GetSize());
+        Dart_Handle byte_buffer = WrapByteData(std::move(data));
         tonic::DartInvoke(callback.Release(), {byte_buffer});
       }));
 }
@@ -11,6 +11,12 @@
 
 namespace flutter {
 
+// Wraps the mapping in a Dart ByteData. Large mutable mappings are handed to
+// Dart as external typed data, which takes ownership of the mapping and frees
+// it when the ByteData is collected; everything else is copied. Returns
+// Dart_Null() for a null mapping. Must be called within a Dart scope.
+Dart_Handle WrapByteData(std::unique_ptr<fml::Mapping> mapping);
+
 class PlatformMessageResponseDart : public PlatformMessageResponse {
   FML_FRIEND_MAKE_REF_COUNTED(PlatformMessageResponseDart);
 
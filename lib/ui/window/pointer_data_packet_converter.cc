@@ -4,12 +4,59 @@
 
 #include "flutter/lib/ui/window/pointer_data_packet_converter.h"
 
+#include <cmath>
+#include <cstddef>
 #include <cstring>
+#include <limits>
 
 #include "flutter/fml/logging.h"
 
 namespace flutter {
 
+namespace {
+
+static_assert(sizeof(PointerData) == kPointerDataFieldCount * kBytesPerField,
+              "PointerData must only hold 8 byte fields.");
+static_assert(kPointerDataFieldCount <= 32,
+              "The packed layout flags the fields with uint32 bitmasks.");
+
+constexpr uint32_t FieldBit(size_t offset) {
+  return 1u << (offset / kBytesPerField);
+}
+
+// The fields of PointerData that hold a double rather than an int64_t. Must
+// match _kPointerDataDoubleFields in platform_dispatcher.dart.
+constexpr uint32_t kDoubleFields =
+    FieldBit(offsetof(PointerData, physical_x)) |
+    FieldBit(offsetof(PointerData, physical_y)) |
+    FieldBit(offsetof(PointerData, physical_delta_x)) |
+    FieldBit(offsetof(PointerData, physical_delta_y)) |
+    FieldBit(offsetof(PointerData, pressure)) |
+    FieldBit(offsetof(PointerData, pressure_min)) |
+    FieldBit(offsetof(PointerData, pressure_max)) |
+    FieldBit(offsetof(PointerData, distance)) |
+    FieldBit(offsetof(PointerData, distance_max)) |
+    FieldBit(offsetof(PointerData, size)) |
+    FieldBit(offsetof(PointerData, radius_major)) |
+    FieldBit(offsetof(PointerData, radius_minor)) |
+    FieldBit(offsetof(PointerData, radius_min)) |
+    FieldBit(offsetof(PointerData, radius_max)) |
+    FieldBit(offsetof(PointerData, orientation)) |
+    FieldBit(offsetof(PointerData, tilt)) |
+    FieldBit(offsetof(PointerData, scroll_delta_x)) |
+    FieldBit(offsetof(PointerData, scroll_delta_y));
+
+constexpr size_t kTimeStampField =
+    offsetof(PointerData, time_stamp) / kBytesPerField;
+
+template <typename T>
+void Append(std::vector<uint8_t>& buffer, T value) {
+  const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+  buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+}  // namespace
+
 PointerDataPacketConverter::PointerDataPacketConverter() : pointer_(0) {}
 
 PointerDataPacketConverter::~PointerDataPacketConverter() = default;
@@ -41,6 +88,60 @@ std::unique_ptr<PointerDataPacket> PointerDataPacketConverter::Convert(
   return converted_packet;
 }
 
+std::vector<uint8_t> PointerDataPacketConverter::Pack(
+    const PointerDataPacket& packet) {
+  const auto& buffer = packet.data();
+  const size_t count = buffer.size() / sizeof(PointerData);
+
+  std::vector<uint8_t> packed;
+  packed.reserve(sizeof(uint32_t) + count * 8 * sizeof(uint32_t));
+  Append(packed, static_cast<uint32_t>(count));
+
+  int64_t previous[kPointerDataFieldCount] = {};
+  int64_t fields[kPointerDataFieldCount];
+  for (size_t i = 0; i < count; i++) {
+    memcpy(fields, &buffer[i * sizeof(PointerData)], sizeof(PointerData));
+    const size_t masks_offset = packed.size();
+    packed.resize(masks_offset + 2 * sizeof(uint32_t));
+    uint32_t present_fields = 0;
+    uint32_t wide_fields = 0;
+    for (size_t field = 0; field < kPointerDataFieldCount; field++) {
+      if (fields[field] == previous[field]) {
+        continue;
+      }
+      const uint32_t bit = 1u << field;
+      present_fields |= bit;
+      if (kDoubleFields & bit) {
+        double value;
+        memcpy(&value, &fields[field], sizeof(value));
+        if (std::abs(value) <= std::numeric_limits<float>::max() &&
+            static_cast<double>(static_cast<float>(value)) == value) {
+          Append(packed, static_cast<float>(value));
+        } else {
+          wide_fields |= bit;
+          Append(packed, value);
+        }
+      } else {
+        const int64_t value = field == kTimeStampField
+                                  ? fields[field] - previous[field]
+                                  : fields[field];
+        if (value >= std::numeric_limits<int32_t>::min() &&
+            value <= std::numeric_limits<int32_t>::max()) {
+          Append(packed, static_cast<int32_t>(value));
+        } else {
+          wide_fields |= bit;
+          Append(packed, value);
+        }
+      }
+    }
+    memcpy(&packed[masks_offset], &present_fields, sizeof(uint32_t));
+    memcpy(&packed[masks_offset + sizeof(uint32_t)], &wide_fields,
+           sizeof(uint32_t));
+    memcpy(previous, fields, sizeof(fields));
+  }
+  return packed;
+}
+
 void PointerDataPacketConverter::ConvertPointerData(
     PointerData pointer_data,
     std::vector<PointerData>& converted_pointers) {
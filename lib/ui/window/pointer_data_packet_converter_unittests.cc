@@ -4,6 +4,7 @@
 
 #include "flutter/lib/ui/window/pointer_data_packet_converter.h"
 
+#include <cmath>
 #include <cstring>
 
 #include "gtest/gtest.h"
@@ -599,5 +600,104 @@ TEST(PointerDataPacketConverterTest, CanConvetScroll) {
   ASSERT_EQ(result[6].scroll_delta_y, 0.0);
 }
 
+
+// Decodes the packed layout the way _unpackPackedPointerDataPacket does.
+std::vector<PointerData> UnpackPackedPointerData(
+    const std::vector<uint8_t>& packed) {
+  const uint32_t double_fields = 0x1BFFC780;
+  size_t offset = 0;
+  auto read = [&packed, &offset](void* value, size_t size) {
+    EXPECT_LE(offset + size, packed.size());
+    memcpy(value, &packed[offset], size);
+    offset += size;
+  };
+
+  uint32_t count;
+  read(&count, sizeof(count));
+  std::vector<PointerData> result;
+  int64_t fields[kPointerDataFieldCount] = {};
+  for (uint32_t i = 0; i < count; i++) {
+    uint32_t present_fields, wide_fields;
+    read(&present_fields, sizeof(present_fields));
+    read(&wide_fields, sizeof(wide_fields));
+    for (size_t field = 0; field < kPointerDataFieldCount; field++) {
+      const uint32_t bit = 1u << field;
+      if (!(present_fields & bit)) {
+        continue;
+      }
+      const bool wide = wide_fields & bit;
+      if (double_fields & bit) {
+        double value;
+        if (wide) {
+          read(&value, sizeof(value));
+        } else {
+          float narrow_value;
+          read(&narrow_value, sizeof(narrow_value));
+          value = narrow_value;
+        }
+        memcpy(&fields[field], &value, sizeof(value));
+      } else {
+        int64_t value;
+        if (wide) {
+          read(&value, sizeof(value));
+        } else {
+          int32_t narrow_value;
+          read(&narrow_value, sizeof(narrow_value));
+          value = narrow_value;
+        }
+        fields[field] = field == 1 ? fields[field] + value : value;
+      }
+    }
+    PointerData pointer_data;
+    memcpy(&pointer_data, fields, sizeof(pointer_data));
+    result.push_back(pointer_data);
+  }
+  EXPECT_EQ(offset, packed.size());
+  return result;
+}
+
+TEST(PointerDataPacketConverterTest, CanPackPointerDataPacket) {
+  PointerDataPacketConverter converter;
+  auto packet = std::make_unique<PointerDataPacket>(6);
+  PointerData data;
+  CreateSimulatedPointerData(data, PointerData::Change::kDown, 0, 1.5, 2.25, 1);
+  data.time_stamp = 1600000000000000;
+  data.pressure = 0.5;
+  data.pressure_max = 1.0;
+  packet->SetPointerData(0, data);
+  for (int i = 1; i <= 3; i++) {
+    CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 1.5 + i,
+                               2.25 + i, 1);
+    data.time_stamp = 1600000000000000 + i * 1000;
+    data.pressure = 0.5;
+    data.pressure_max = 1.0;
+    packet->SetPointerData(i, data);
+  }
+  // Not exactly representable as float32.
+  CreateSimulatedPointerData(data, PointerData::Change::kMove, 0, 0.1, M_PI, 1);
+  data.time_stamp = 1600000000004000;
+  packet->SetPointerData(4, data);
+  CreateSimulatedPointerData(data, PointerData::Change::kUp, 0, 0.1, M_PI, 0);
+  data.time_stamp = 1600000000004000;
+  data.orientation = NAN;
+  packet->SetPointerData(5, data);
+  auto converted_packet = converter.Convert(std::move(packet));
+  const std::vector<uint8_t> converted_data = converted_packet->data();
+
+  const std::vector<uint8_t> packed =
+      PointerDataPacketConverter::Pack(*converted_packet);
+  std::vector<PointerData> unpacked = UnpackPackedPointerData(packed);
+  std::vector<PointerData> result;
+  UnpackPointerPacket(result, std::move(converted_packet));
+
+  ASSERT_EQ(unpacked.size(), result.size());
+  ASSERT_EQ(memcmp(unpacked.data(), result.data(),
+                   result.size() * sizeof(PointerData)),
+            0);
+  ASSERT_TRUE(std::isnan(unpacked.back().orientation));
+  // The moves only hold the time stamp, the position, and its delta.
+  ASSERT_LT(packed.size(), converted_data.size() / 4);
+}
+
 }  // namespace testing
 }  // namespace flutter
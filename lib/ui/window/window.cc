@@ -20,20 +20,29 @@ Window::Window(int64_t window_id, ViewportMetrics metrics)
 Window::~Window() {}
 
 void Window::DispatchPointerDataPacket(const PointerDataPacket& packet) {
+  DispatchPointerData("_dispatchPointerDataPacket", packet.data());
+}
+
+void Window::DispatchPackedPointerDataPacket(
+    const std::vector<uint8_t>& packed) {
+  DispatchPointerData("_dispatchPackedPointerDataPacket", packed);
+}
+
+void Window::DispatchPointerData(const char* hook,
+                                 const std::vector<uint8_t>& buffer) {
   std::shared_ptr<tonic::DartState> dart_state = library_.dart_state().lock();
   if (!dart_state) {
     return;
   }
   tonic::DartState::Scope scope(dart_state);
 
-  const std::vector<uint8_t>& buffer = packet.data();
   Dart_Handle data_handle =
       tonic::DartByteData::Create(buffer.data(), buffer.size());
   if (Dart_IsError(data_handle)) {
     return;
   }
-  tonic::LogIfError(tonic::DartInvokeField(
-      library_.value(), "_dispatchPointerDataPacket", {data_handle}));
+  tonic::LogIfError(
+      tonic::DartInvokeField(library_.value(), hook, {data_handle}));
 }
 
 void Window::DispatchKeyDataPacket(const KeyDataPacket& packet,
@@ -31,6 +31,9 @@ class Window final {
   // Dispatch a packet to the framework that indicates one or a few pointer
   // events.
   void DispatchPointerDataPacket(const PointerDataPacket& packet);
+  // Dispatch pointer events encoded by PointerDataPacketConverter::Pack to the
+  // framework.
+  void DispatchPackedPointerDataPacket(const std::vector<uint8_t>& packed);
   // Dispatch a packet to the framework that indicates a key event.
   //
   // The `response_id` is used to label the response of whether the key event
@@ -45,6 +48,9 @@ class Window final {
   tonic::DartPersistentValue library_;
   int64_t window_id_;
   ViewportMetrics viewport_metrics_;
+
+  void DispatchPointerData(const char* hook,
+                           const std::vector<uint8_t>& buffer);
 };
 
 }  // namespace flutter
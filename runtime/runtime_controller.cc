@@ -250,6 +250,18 @@ bool RuntimeController::DispatchPlatformMessage(
   return false;
 }
 
+bool RuntimeController::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
+    TRACE_EVENT1("flutter", "RuntimeController::DispatchPlatformMessages",
+                 "mode", "basic");
+    platform_configuration->DispatchPlatformMessages(std::move(messages));
+    return true;
+  }
+
+  return false;
+}
+
 bool RuntimeController::DispatchPointerDataPacket(
     const PointerDataPacket& packet) {
   if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
@@ -262,6 +274,20 @@ bool RuntimeController::DispatchPointerDataPacket(
   return false;
 }
 
+bool RuntimeController::DispatchPackedPointerDataPacket(
+    const std::vector<uint8_t>& packed) {
+  if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
+    TRACE_EVENT1("flutter",
+                 "RuntimeController::DispatchPackedPointerDataPacket", "mode",
+                 "basic");
+    platform_configuration->get_window(0)->DispatchPackedPointerDataPacket(
+        packed);
+    return true;
+  }
+
+  return false;
+}
+
 bool RuntimeController::DispatchKeyDataPacket(const KeyDataPacket& packet,
                                               KeyDataResponse callback) {
   if (auto* platform_configuration = GetPlatformConfigurationIfAvailable()) {
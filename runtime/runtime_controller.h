@@ -413,6 +413,18 @@ class RuntimeController : public PlatformConfigurationClient {
   ///
   virtual bool DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatch the specified platform messages to the running root
+  ///             isolate in order and in a single call into the isolate.
+  ///
+  /// @param[in]  messages  The messages to dispatch to the isolate.
+  ///
+  /// @return     If the messages were dispatched to the running root isolate.
+  ///             This may fail is an isolate is not running.
+  ///
+  virtual bool DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Dispatch the specified pointer data message to the running
   ///             root isolate.
@@ -424,6 +436,18 @@ class RuntimeController : public PlatformConfigurationClient {
   ///
   bool DispatchPointerDataPacket(const PointerDataPacket& packet);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Dispatch pointer data encoded by
+  ///             `PointerDataPacketConverter::Pack` to the running root
+  ///             isolate.
+  ///
+  /// @param[in]  packed  The packed pointer data to dispatch to the isolate.
+  ///
+  /// @return     If the pointer data was dispatched. This may fail is an
+  ///             isolate is not running.
+  ///
+  bool DispatchPackedPointerDataPacket(const std::vector<uint8_t>& packed);
+
   //----------------------------------------------------------------------------
   /// @brief      Dispatch the specified pointer data message to the running
   ///             root isolate.
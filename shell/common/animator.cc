@@ -17,6 +17,28 @@ namespace {
 constexpr fml::TimeDelta kNotifyIdleTaskWaitTime =
     fml::TimeDelta::FromMilliseconds(51);
 
+// The pipeline depth in the throughput frame latency mode.
+constexpr size_t kThroughputPipelineDepth = 3;
+
+// In the low latency frame latency mode, frames begin this much earlier than
+// the durations of recent frames require, to absorb scheduling jitter.
+constexpr fml::TimeDelta kLowLatencyFrameMargin =
+    fml::TimeDelta::FromMilliseconds(2);
+
+size_t DefaultPipelineDepth(const TaskRunners& task_runners) {
+#if SHELL_ENABLE_METAL
+  return 2;
+#else   // SHELL_ENABLE_METAL
+  // TODO(dnfield): We should remove this logic and set the pipeline depth
+  // back to 2 in this case. See
+  // https://github.com/flutter/engine/pull/9132 for discussion.
+  return task_runners.GetPlatformTaskRunner() ==
+                 task_runners.GetRasterTaskRunner()
+             ? 1
+             : 2;
+#endif  // SHELL_ENABLE_METAL
+}
+
 }  // namespace
 
 Animator::Animator(Delegate& delegate,
@@ -29,18 +51,10 @@ Animator::Animator(Delegate& delegate,
       last_vsync_start_time_(),
       last_frame_target_time_(),
       dart_frame_deadline_(0),
-#if SHELL_ENABLE_METAL
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(2)),
-#else   // SHELL_ENABLE_METAL
-      // TODO(dnfield): We should remove this logic and set the pipeline depth
-      // back to 2 in this case. See
-      // https://github.com/flutter/engine/pull/9132 for discussion.
-      layer_tree_pipeline_(fml::MakeRefCounted<LayerTreePipeline>(
-          task_runners.GetPlatformTaskRunner() ==
-                  task_runners.GetRasterTaskRunner()
-              ? 1
-              : 2)),
-#endif  // SHELL_ENABLE_METAL
+      default_pipeline_depth_(DefaultPipelineDepth(task_runners_)),
+      layer_tree_pipeline_depth_(default_pipeline_depth_),
+      layer_tree_pipeline_(
+          fml::MakeRefCounted<LayerTreePipeline>(layer_tree_pipeline_depth_)),
       pending_frame_semaphore_(1),
       frame_number_(1),
       paused_(false),
@@ -72,6 +86,22 @@ void Animator::SetDimensionChangePending() {
   dimension_change_pending_ = true;
 }
 
+void Animator::SetFrameLatencyMode(FrameLatencyMode mode) {
+  frame_latency_mode_ = mode;
+}
+
+size_t Animator::GetPipelineDepth() const {
+  switch (frame_latency_mode_) {
+    case FrameLatencyMode::kLowLatency:
+      return 1;
+    case FrameLatencyMode::kThroughput:
+      return kThroughputPipelineDepth;
+    case FrameLatencyMode::kDefault:
+      break;
+  }
+  return default_pipeline_depth_;
+}
+
 void Animator::EnqueueTraceFlowId(uint64_t trace_flow_id) {
   fml::TaskRunner::RunNowOrPostTask(
       task_runners_.GetUITaskRunner(),
@@ -113,6 +143,18 @@ void Animator::BeginFrame(fml::TimePoint vsync_start_time,
   pending_frame_semaphore_.Signal();
 
   if (!producer_continuation_) {
+    // The pipeline can only be replaced while no frame is being produced into
+    // it. The frames already in the old pipeline are still consumed by the
+    // rasterizer, which holds a reference to it.
+    const size_t pipeline_depth = GetPipelineDepth();
+    if (pipeline_depth != layer_tree_pipeline_depth_) {
+      TRACE_EVENT1("flutter", "Animator::ResizePipeline", "depth",
+                   std::to_string(pipeline_depth).c_str());
+      layer_tree_pipeline_depth_ = pipeline_depth;
+      layer_tree_pipeline_ =
+          fml::MakeRefCounted<LayerTreePipeline>(layer_tree_pipeline_depth_);
+    }
+
     // We may already have a valid pipeline continuation in case a previous
     // begin frame did not result in an Animation::Render. Simply reuse that
     // instead of asking the pipeline for a fresh continuation.
@@ -173,6 +215,27 @@ void Animator::BeginFrame(fml::TimePoint vsync_start_time,
   }
 }
 
+void Animator::BeginFrameLate(fml::TimePoint vsync_start_time,
+                              fml::TimePoint frame_target_time) {
+  const auto frame_duration = delegate_.GetPredictedFrameDuration();
+  const auto begin_time =
+      frame_target_time - frame_duration - kLowLatencyFrameMargin;
+  if (frame_duration <= fml::TimeDelta::Zero() ||
+      begin_time <= fml::TimePoint::Now()) {
+    BeginFrame(vsync_start_time, frame_target_time);
+    return;
+  }
+
+  task_runners_.GetUITaskRunner()->PostTaskForTime(
+      [self = weak_factory_.GetWeakPtr(), vsync_start_time,
+       frame_target_time]() {
+        if (self) {
+          self->BeginFrame(vsync_start_time, frame_target_time);
+        }
+      },
+      begin_time);
+}
+
 void Animator::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
   if (dimension_change_pending_ &&
       layer_tree->frame_size() != last_layer_tree_size_) {
@@ -241,6 +304,9 @@ void Animator::AwaitVSync() {
         if (self) {
           if (self->CanReuseLastLayerTree()) {
             self->DrawLastLayerTree();
+          } else if (self->frame_latency_mode_ ==
+                     FrameLatencyMode::kLowLatency) {
+            self->BeginFrameLate(vsync_start_time, frame_target_time);
           } else {
             self->BeginFrame(vsync_start_time, frame_target_time);
           }
@@ -7,6 +7,7 @@
 
 #include <deque>
 
+#include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "flutter/fml/memory/weak_ptr.h"
@@ -39,6 +40,10 @@ class Animator final {
         fml::TimePoint frame_target_time) = 0;
 
     virtual void OnAnimatorDrawLastLayerTree() = 0;
+
+    // The time the next frame is expected to take to build and rasterize, or
+    // zero if it is unknown.
+    virtual fml::TimeDelta GetPredictedFrameDuration() = 0;
   };
 
   Animator(Delegate& delegate,
@@ -75,6 +80,13 @@ class Animator final {
 
   void SetDimensionChangePending();
 
+  //--------------------------------------------------------------------------
+  /// @brief    Changes how frames trade latency for throughput. The pipeline
+  ///           depth changes once the frame being produced, if any, is
+  ///           complete.
+  ///
+  void SetFrameLatencyMode(FrameLatencyMode mode);
+
   // Enqueue |trace_flow_id| into |trace_flow_ids_|.  The flow event will be
   // ended at either the next frame, or the next vsync interval with no active
   // active rendering.
@@ -86,6 +98,13 @@ class Animator final {
   void BeginFrame(fml::TimePoint frame_start_time,
                   fml::TimePoint frame_target_time);
 
+  // Begins the frame as late as it can while still being ready by the target
+  // time, going by the durations of recent frames.
+  void BeginFrameLate(fml::TimePoint frame_start_time,
+                      fml::TimePoint frame_target_time);
+
+  size_t GetPipelineDepth() const;
+
   bool CanReuseLastLayerTree();
   void DrawLastLayerTree();
 
@@ -104,6 +123,9 @@ class Animator final {
   fml::TimePoint last_vsync_start_time_;
   fml::TimePoint last_frame_target_time_;
   int64_t dart_frame_deadline_;
+  FrameLatencyMode frame_latency_mode_ = FrameLatencyMode::kDefault;
+  const size_t default_pipeline_depth_;
+  size_t layer_tree_pipeline_depth_;
   fml::RefPtr<LayerTreePipeline> layer_tree_pipeline_;
   fml::Semaphore pending_frame_semaphore_;
   LayerTreePipeline::ProducerContinuation producer_continuation_;
@@ -10,6 +10,7 @@
 #include <future>
 #include <memory>
 
+#include "flutter/flow/layers/layer_tree.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/shell_test_platform_view.h"
 #include "flutter/testing/testing.h"
@@ -18,6 +19,106 @@
 namespace flutter {
 namespace testing {
 
+namespace {
+
+// Renders a layer tree for every frame it is asked to begin. The layer trees
+// are only taken out of the pipeline if |SetConsumesFrames| was called.
+class FakeAnimatorDelegate : public Animator::Delegate {
+ public:
+  void SetAnimator(Animator* animator) { animator_ = animator; }
+
+  void SetPredictedFrameDuration(fml::TimeDelta duration) {
+    predicted_frame_duration_ = duration;
+  }
+
+  void SetOnBeginFrame(fml::closure callback) {
+    on_begin_frame_ = std::move(callback);
+  }
+
+  void SetConsumesFrames(bool consumes_frames) {
+    consumes_frames_ = consumes_frames;
+  }
+
+  size_t GetBeginFrameCount() const { return begin_frame_count_; }
+
+  // |Animator::Delegate|
+  void OnAnimatorBeginFrame(fml::TimePoint frame_target_time) override {
+    begin_frame_count_++;
+    animator_->Render(std::make_unique<LayerTree>(SkISize::Make(1, 1), 1.0f));
+    if (on_begin_frame_) {
+      on_begin_frame_();
+    }
+  }
+
+  // |Animator::Delegate|
+  void OnAnimatorNotifyIdle(int64_t deadline) override {}
+
+  // |Animator::Delegate|
+  void OnAnimatorDraw(fml::RefPtr<Pipeline<flutter::LayerTree>> pipeline,
+                      fml::TimePoint frame_target_time) override {
+    if (consumes_frames_) {
+      EXPECT_EQ(pipeline->Consume([](std::unique_ptr<LayerTree>) {}),
+                PipelineConsumeResult::Done);
+    }
+  }
+
+  // |Animator::Delegate|
+  void OnAnimatorDrawLastLayerTree() override {}
+
+  // |Animator::Delegate|
+  fml::TimeDelta GetPredictedFrameDuration() override {
+    return predicted_frame_duration_;
+  }
+
+ private:
+  Animator* animator_ = nullptr;
+  fml::TimeDelta predicted_frame_duration_;
+  fml::closure on_begin_frame_;
+  bool consumes_frames_ = false;
+  size_t begin_frame_count_ = 0;
+};
+
+// Fires vsync only when the test asks it to.
+class ManualVsyncWaiter : public VsyncWaiter {
+ public:
+  explicit ManualVsyncWaiter(TaskRunners task_runners)
+      : VsyncWaiter(std::move(task_runners)) {}
+
+  void Fire(fml::TimePoint frame_target_time) {
+    FireCallback(fml::TimePoint::Now(), frame_target_time);
+  }
+
+ protected:
+  // |VsyncWaiter|
+  void AwaitVSync() override {}
+};
+
+void PostSync(const fml::RefPtr<fml::TaskRunner>& task_runner,
+              const fml::closure& task) {
+  fml::AutoResetWaitableEvent latch;
+  task_runner->PostTask([&latch, &task]() {
+    task();
+    latch.Signal();
+  });
+  latch.Wait();
+}
+
+// Requests a frame from |animator| and fires the vsync it waits for.
+void RunVsync(Animator* animator,
+              ManualVsyncWaiter* waiter,
+              const fml::RefPtr<fml::TaskRunner>& ui_task_runner,
+              fml::TimePoint frame_target_time) {
+  PostSync(ui_task_runner, [animator]() { animator->RequestFrame(); });
+  // Runs Animator::AwaitVSync, which the request posted.
+  PostSync(ui_task_runner, []() {});
+  waiter->Fire(frame_target_time);
+  // Runs the vsync callback, which begins the frame or tries again at the next
+  // vsync when the pipeline is full.
+  PostSync(ui_task_runner, []() {});
+}
+
+}  // namespace
+
 TEST_F(ShellTest, VSyncTargetTime) {
   // Add native callbacks to listen for window.onBeginFrame
   int64_t target_time;
@@ -94,5 +195,93 @@ TEST_F(ShellTest, VSyncTargetTime) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+TEST_F(ShellTest, AnimatorPipelineDepthFollowsFrameLatencyMode) {
+  TaskRunners task_runners = GetTaskRunnersForFixture();
+  auto ui_task_runner = task_runners.GetUITaskRunner();
+  FakeAnimatorDelegate delegate;
+  std::unique_ptr<Animator> animator;
+  ManualVsyncWaiter* waiter = nullptr;
+  PostSync(ui_task_runner, [&]() {
+    auto vsync_waiter = std::make_unique<ManualVsyncWaiter>(task_runners);
+    waiter = vsync_waiter.get();
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(vsync_waiter));
+    delegate.SetAnimator(animator.get());
+  });
+
+  const auto frame_target_time =
+      fml::TimePoint::Now() + fml::TimeDelta::FromMilliseconds(16);
+  auto count_frames_until_pipeline_is_full = [&]() {
+    const size_t begin_frame_count = delegate.GetBeginFrameCount();
+    for (int i = 0; i < 5; i++) {
+      RunVsync(animator.get(), waiter, ui_task_runner, frame_target_time);
+    }
+    return delegate.GetBeginFrameCount() - begin_frame_count;
+  };
+
+  // The UI and raster task runners are distinct, so the default depth is two.
+  EXPECT_EQ(count_frames_until_pipeline_is_full(), 2u);
+
+  // The full pipeline is replaced by an empty one of the new depth at the
+  // next frame.
+  PostSync(ui_task_runner, [&]() {
+    animator->SetFrameLatencyMode(FrameLatencyMode::kThroughput);
+  });
+  EXPECT_EQ(count_frames_until_pipeline_is_full(), 3u);
+
+  PostSync(ui_task_runner, [&]() {
+    animator->SetFrameLatencyMode(FrameLatencyMode::kLowLatency);
+  });
+  EXPECT_EQ(count_frames_until_pipeline_is_full(), 1u);
+
+  PostSync(ui_task_runner, [&]() { animator.reset(); });
+}
+
+TEST_F(ShellTest, AnimatorBeginsLowLatencyFramesLate) {
+  TaskRunners task_runners = GetTaskRunnersForFixture();
+  auto ui_task_runner = task_runners.GetUITaskRunner();
+  FakeAnimatorDelegate delegate;
+  std::unique_ptr<Animator> animator;
+  ManualVsyncWaiter* waiter = nullptr;
+  PostSync(ui_task_runner, [&]() {
+    auto vsync_waiter = std::make_unique<ManualVsyncWaiter>(task_runners);
+    waiter = vsync_waiter.get();
+    animator = std::make_unique<Animator>(delegate, task_runners,
+                                          std::move(vsync_waiter));
+    animator->SetFrameLatencyMode(FrameLatencyMode::kLowLatency);
+    delegate.SetAnimator(animator.get());
+  });
+  delegate.SetConsumesFrames(true);
+
+  fml::AutoResetWaitableEvent begin_frame_latch;
+  fml::TimePoint begin_frame_time;
+  delegate.SetOnBeginFrame([&]() {
+    begin_frame_time = fml::TimePoint::Now();
+    begin_frame_latch.Signal();
+  });
+
+  // Without a prediction, the frame begins at vsync.
+  RunVsync(animator.get(), waiter, ui_task_runner,
+           fml::TimePoint::Now() + fml::TimeDelta::FromMilliseconds(16));
+  EXPECT_EQ(delegate.GetBeginFrameCount(), 1u);
+  begin_frame_latch.Wait();
+
+  // With a prediction, the frame begins when there is just enough time left,
+  // plus a 2ms margin, to build and rasterize it before the target time.
+  const auto frame_duration = fml::TimeDelta::FromMilliseconds(100);
+  delegate.SetPredictedFrameDuration(frame_duration);
+  const auto frame_target_time =
+      fml::TimePoint::Now() + fml::TimeDelta::FromMilliseconds(500);
+  RunVsync(animator.get(), waiter, ui_task_runner, frame_target_time);
+  EXPECT_EQ(delegate.GetBeginFrameCount(), 1u);
+
+  begin_frame_latch.Wait();
+  EXPECT_EQ(delegate.GetBeginFrameCount(), 2u);
+  EXPECT_GE(begin_frame_time, frame_target_time - frame_duration -
+                                  fml::TimeDelta::FromMilliseconds(2));
+
+  PostSync(ui_task_runner, [&]() { animator.reset(); });
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/common/settings.h"
 #include "flutter/fml/eintr_wrapper.h"
 #include "flutter/fml/file.h"
@@ -18,6 +19,7 @@
 #include "flutter/fml/unique_fd.h"
 #include "flutter/lib/snapshot/snapshot.h"
 #include "flutter/lib/ui/text/font_collection.h"
+#include "flutter/lib/ui/window/pointer_data_packet_converter.h"
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/shell.h"
@@ -55,7 +57,15 @@ Engine::Engine(
       image_decoder_(task_runners, image_decoder_task_runner, io_manager),
       task_runners_(std::move(task_runners)),
       weak_factory_(this) {
-  pointer_data_dispatcher_ = dispatcher_maker(*this);
+  if (settings_.resample_pointer_events) {
+    pointer_data_dispatcher_ =
+        std::make_unique<ResamplingPointerDataDispatcher>(*this);
+  } else {
+    pointer_data_dispatcher_ = dispatcher_maker(*this);
+  }
+  if (settings_.defer_offscreen_semantics) {
+    semantics_viewport_filter_ = std::make_unique<SemanticsViewportFilter>();
+  }
 }
 
 Engine::Engine(Delegate& delegate,
@@ -98,6 +108,12 @@ Engine::Engine(Delegate& delegate,
       settings_.persistent_isolate_data,     // persistent isolate data
       std::move(volatile_path_tracker)       // volatile path tracker
   );
+  // Spawned engines share the font collection, and with it the setting of the
+  // engine that created it.
+  if (settings_.enable_parallel_text_shaping) {
+    font_collection_->SetParallelShapingTaskRunner(
+        vm.GetConcurrentWorkerTaskRunner());
+  }
 }
 
 std::unique_ptr<Engine> Engine::Spawn(
@@ -136,6 +152,9 @@ fml::WeakPtr<Engine> Engine::GetWeakPtr() const {
 
 void Engine::SetupDefaultFontManager() {
   TRACE_EVENT0("flutter", "Engine::SetupDefaultFontManager");
+  font_collection_->GetFontCollection()->SetFallbackCacheDirectory(
+      PersistentCache::CreateEngineCacheDirectory("fonts"),
+      task_runners_.GetIOTaskRunner());
   font_collection_->SetupDefaultFontManager();
 }
 
@@ -218,6 +237,7 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
 void Engine::BeginFrame(fml::TimePoint frame_time) {
   TRACE_EVENT0("flutter", "Engine::BeginFrame");
   runtime_controller_->BeginFrame(frame_time);
+  FontCollection::TraceLayoutCacheStatsToTimeline();
 }
 
 void Engine::ReportTimings(std::vector<int64_t> timings) {
@@ -275,6 +295,13 @@ void Engine::SetViewportMetrics(const ViewportMetrics& metrics) {
       viewport_metrics_.device_pixel_ratio != metrics.device_pixel_ratio;
   viewport_metrics_ = metrics;
   runtime_controller_->SetViewportMetrics(viewport_metrics_);
+  if (semantics_viewport_filter_) {
+    SemanticsNodeUpdates updates = semantics_viewport_filter_->SetViewport(
+        SkRect::MakeWH(metrics.physical_width, metrics.physical_height));
+    if (!updates.empty()) {
+      delegate_.OnEngineUpdateSemantics(std::move(updates), {});
+    }
+  }
   if (animator_) {
     if (dimensions_changed) {
       animator_->SetDimensionChangePending();
@@ -286,25 +313,11 @@ void Engine::SetViewportMetrics(const ViewportMetrics& metrics) {
 }
 
 void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
-  std::string channel = message->channel();
-  if (channel == kLifecycleChannel) {
-    if (HandleLifecyclePlatformMessage(message.get())) {
-      return;
-    }
-  } else if (channel == kLocalizationChannel) {
-    if (HandleLocalizationPlatformMessage(message.get())) {
-      return;
-    }
-  } else if (channel == kSettingsChannel) {
-    HandleSettingsPlatformMessage(message.get());
-    return;
-  } else if (!runtime_controller_->IsRootIsolateRunning() &&
-             channel == kNavigationChannel) {
-    // If there's no runtime_, we may still need to set the initial route.
-    HandleNavigationPlatformMessage(std::move(message));
+  if (HandleEnginePlatformMessage(message)) {
     return;
   }
 
+  std::string channel = message->channel();
   if (runtime_controller_->IsRootIsolateRunning() &&
       runtime_controller_->DispatchPlatformMessage(std::move(message))) {
     return;
@@ -313,9 +326,55 @@ void Engine::DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message) {
   FML_DLOG(WARNING) << "Dropping platform message on channel: " << channel;
 }
 
+void Engine::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  TRACE_EVENT0("flutter", "Engine::DispatchPlatformMessages");
+  std::vector<fml::RefPtr<PlatformMessage>> isolate_messages;
+  isolate_messages.reserve(messages.size());
+  for (auto& message : messages) {
+    if (!HandleEnginePlatformMessage(message)) {
+      isolate_messages.push_back(std::move(message));
+    }
+  }
+
+  if (isolate_messages.empty()) {
+    return;
+  }
+
+  const size_t isolate_message_count = isolate_messages.size();
+  if (runtime_controller_->IsRootIsolateRunning() &&
+      runtime_controller_->DispatchPlatformMessages(
+          std::move(isolate_messages))) {
+    return;
+  }
+
+  FML_DLOG(WARNING) << "Dropping " << isolate_message_count
+                    << " batched platform messages.";
+}
+
+bool Engine::HandleEnginePlatformMessage(
+    const fml::RefPtr<PlatformMessage>& message) {
+  const std::string& channel = message->channel();
+  if (channel == kLifecycleChannel) {
+    return HandleLifecyclePlatformMessage(message.get());
+  } else if (channel == kLocalizationChannel) {
+    return HandleLocalizationPlatformMessage(message.get());
+  } else if (channel == kSettingsChannel) {
+    HandleSettingsPlatformMessage(message.get());
+    return true;
+  } else if (!runtime_controller_->IsRootIsolateRunning() &&
+             channel == kNavigationChannel) {
+    // If there's no runtime_, we may still need to set the initial route.
+    HandleNavigationPlatformMessage(message);
+    return true;
+  }
+  return false;
+}
+
 bool Engine::HandleLifecyclePlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
-  std::string state(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string state(reinterpret_cast<const char*>(data.GetMapping()),
+                    data.GetSize());
   if (state == "AppLifecycleState.paused" ||
       state == "AppLifecycleState.detached") {
     activity_running_ = false;
@@ -342,7 +401,8 @@ bool Engine::HandleNavigationPlatformMessage(
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject()) {
     return false;
   }
@@ -360,7 +420,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject()) {
     return false;
   }
@@ -400,7 +461,8 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
 
 void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
-  std::string jsonData(reinterpret_cast<const char*>(data.data()), data.size());
+  std::string jsonData(reinterpret_cast<const char*>(data.GetMapping()),
+                       data.GetSize());
   if (runtime_controller_->SetUserSettingsData(std::move(jsonData)) &&
       have_surface_) {
     ScheduleFrame();
@@ -426,10 +488,20 @@ void Engine::DispatchKeyDataPacket(std::unique_ptr<KeyDataPacket> packet,
 void Engine::DispatchSemanticsAction(int id,
                                      SemanticsAction action,
                                      std::vector<uint8_t> args) {
+  if (semantics_viewport_filter_) {
+    SemanticsNodeUpdates updates =
+        semantics_viewport_filter_->OnSemanticsAction(id, action);
+    if (!updates.empty()) {
+      delegate_.OnEngineUpdateSemantics(std::move(updates), {});
+    }
+  }
   runtime_controller_->DispatchSemanticsAction(id, action, std::move(args));
 }
 
 void Engine::SetSemanticsEnabled(bool enabled) {
+  if (semantics_viewport_filter_) {
+    semantics_viewport_filter_->Reset();
+  }
   runtime_controller_->SetSemanticsEnabled(enabled);
 }
 
@@ -454,6 +526,10 @@ std::string Engine::DefaultRouteName() {
   return "/";
 }
 
+void Engine::SetFrameLatencyMode(FrameLatencyMode mode) {
+  animator_->SetFrameLatencyMode(mode);
+}
+
 void Engine::ScheduleFrame(bool regenerate_layer_tree) {
   animator_->RequestFrame(regenerate_layer_tree);
 }
@@ -474,6 +550,12 @@ void Engine::Render(std::unique_ptr<flutter::LayerTree> layer_tree) {
 
 void Engine::UpdateSemantics(SemanticsNodeUpdates update,
                              CustomAccessibilityActionUpdates actions) {
+  if (semantics_viewport_filter_) {
+    update = semantics_viewport_filter_->Filter(std::move(update));
+    if (update.empty() && actions.empty()) {
+      return;
+    }
+  }
   delegate_.OnEngineUpdateSemantics(std::move(update), std::move(actions));
 }
 
@@ -511,7 +593,12 @@ void Engine::DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
                               uint64_t trace_flow_id) {
   animator_->EnqueueTraceFlowId(trace_flow_id);
   if (runtime_controller_) {
-    runtime_controller_->DispatchPointerDataPacket(*packet);
+    if (settings_.pack_pointer_data) {
+      runtime_controller_->DispatchPackedPointerDataPacket(
+          PointerDataPacketConverter::Pack(*packet));
+    } else {
+      runtime_controller_->DispatchPointerDataPacket(*packet);
+    }
   }
 }
 
@@ -526,8 +613,8 @@ void Engine::HandleAssetPlatformMessage(fml::RefPtr<PlatformMessage> message) {
     return;
   }
   const auto& data = message->data();
-  std::string asset_name(reinterpret_cast<const char*>(data.data()),
-                         data.size());
+  std::string asset_name(reinterpret_cast<const char*>(data.GetMapping()),
+                         data.GetSize());
 
   if (asset_manager_) {
     std::unique_ptr<fml::Mapping> asset_mapping =
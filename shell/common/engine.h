@@ -31,6 +31,7 @@
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/semantics_viewport_filter.h"
 #include "flutter/shell/common/shell_io_manager.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
@@ -685,6 +686,15 @@ class Engine final : public RuntimeDelegate,
   ///
   void OnOutputSurfaceDestroyed();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Changes how the animator trades the latency of frames for
+  ///             their throughput. The shell forwards this here on the UI task
+  ///             runner.
+  ///
+  /// @param[in]  mode  The frame latency mode.
+  ///
+  void SetFrameLatencyMode(FrameLatencyMode mode);
+
   //----------------------------------------------------------------------------
   /// @brief      Updates the viewport metrics for the currently running Flutter
   ///             application. The viewport metrics detail the size of the
@@ -707,6 +717,21 @@ class Engine final : public RuntimeDelegate,
   ///
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Notifies the engine that the embedder has sent it a batch of
+  ///             messages. Messages on channels handled by the engine itself
+  ///             are processed in order. All other messages are delivered to
+  ///             the root isolate in their original order in a single call
+  ///             into the isolate. This call originates in the platform view
+  ///             and has been forwarded to the engine on the UI task runner
+  ///             here.
+  ///
+  /// @param[in]  messages  The messages sent from the embedder to the Dart
+  ///                       application.
+  ///
+  void DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Notifies the engine that the embedder has sent it a pointer
   ///             data packet. A pointer data packet may contain multiple
@@ -905,6 +930,9 @@ class Engine final : public RuntimeDelegate,
   // is destructed first.
   std::unique_ptr<PointerDataDispatcher> pointer_data_dispatcher_;
 
+  // Only set if |Settings::defer_offscreen_semantics| is enabled.
+  std::unique_ptr<SemanticsViewportFilter> semantics_viewport_filter_;
+
   std::string last_entry_point_;
   std::string last_entry_point_library_;
   std::string initial_route_;
@@ -951,6 +979,10 @@ class Engine final : public RuntimeDelegate,
 
   void StartAnimatorIfPossible();
 
+  // Processes messages on the channels the engine listens to. Returns true if
+  // the message was consumed and must not be forwarded to the root isolate.
+  bool HandleEnginePlatformMessage(const fml::RefPtr<PlatformMessage>& message);
+
   bool HandleLifecyclePlatformMessage(PlatformMessage* message);
 
   bool HandleNavigationPlatformMessage(fml::RefPtr<PlatformMessage> message);
@@ -22,6 +22,7 @@ namespace flutter {
 
 namespace {
 class MockDelegate : public Engine::Delegate {
+ public:
   MOCK_METHOD2(OnEngineUpdateSemantics,
                void(SemanticsNodeUpdates, CustomAccessibilityActionUpdates));
   MOCK_METHOD1(OnEngineHandlePlatformMessage,
@@ -66,6 +67,8 @@ class MockRuntimeController : public RuntimeController {
       : RuntimeController(client, p_task_runners) {}
   MOCK_METHOD0(IsRootIsolateRunning, bool());
   MOCK_METHOD1(DispatchPlatformMessage, bool(fml::RefPtr<PlatformMessage>));
+  MOCK_METHOD1(DispatchPlatformMessages,
+               bool(std::vector<fml::RefPtr<PlatformMessage>>));
   MOCK_METHOD3(LoadDartDeferredLibraryError,
                void(intptr_t, const std::string, bool));
   MOCK_CONST_METHOD0(GetDartVM, DartVM*());
@@ -246,6 +249,51 @@ TEST_F(EngineTest, DispatchPlatformMessageInitialRouteIgnored) {
   });
 }
 
+TEST_F(EngineTest, DispatchPlatformMessagesForwardsBatchInOrder) {
+  PostUITaskSync([this] {
+    MockRuntimeDelegate client;
+    auto mock_runtime_controller =
+        std::make_unique<MockRuntimeController>(client, task_runners_);
+    EXPECT_CALL(*mock_runtime_controller, IsRootIsolateRunning())
+        .WillRepeatedly(::testing::Return(true));
+    EXPECT_CALL(*mock_runtime_controller, DispatchPlatformMessage(::testing::_))
+        .Times(0);
+    std::vector<std::string> dispatched_channels;
+    EXPECT_CALL(*mock_runtime_controller,
+                DispatchPlatformMessages(::testing::_))
+        .WillOnce(::testing::Invoke(
+            [&dispatched_channels](
+                std::vector<fml::RefPtr<PlatformMessage>> messages) {
+              for (const auto& message : messages) {
+                dispatched_channels.push_back(message->channel());
+              }
+              return true;
+            }));
+    auto engine = std::make_unique<Engine>(
+        /*delegate=*/delegate_,
+        /*dispatcher_maker=*/dispatcher_maker_,
+        /*image_decoder_task_runner=*/image_decoder_task_runner_,
+        /*task_runners=*/task_runners_,
+        /*settings=*/settings_,
+        /*animator=*/std::move(animator_),
+        /*io_manager=*/io_manager_,
+        /*font_collection=*/std::make_shared<FontCollection>(),
+        /*runtime_controller=*/std::move(mock_runtime_controller));
+
+    std::vector<fml::RefPtr<PlatformMessage>> messages;
+    messages.push_back(fml::MakeRefCounted<PlatformMessage>("foo", nullptr));
+    // Consumed by the engine.
+    messages.push_back(MakePlatformMessage(
+        "flutter/settings", {{"alwaysUse24HourFormat", "true"}}, nullptr));
+    messages.push_back(fml::MakeRefCounted<PlatformMessage>("bar", nullptr));
+    messages.push_back(fml::MakeRefCounted<PlatformMessage>("foo", nullptr));
+    engine->DispatchPlatformMessages(std::move(messages));
+
+    EXPECT_EQ(dispatched_channels,
+              std::vector<std::string>({"foo", "bar", "foo"}));
+  });
+}
+
 TEST_F(EngineTest, SpawnSharesFontLibrary) {
   PostUITaskSync([this] {
     MockRuntimeDelegate client;
@@ -299,4 +347,63 @@ TEST_F(EngineTest, PassesLoadDartDeferredLibraryErrorToRuntime) {
   });
 }
 
+TEST_F(EngineTest, DefersOffscreenSemantics) {
+  settings_.defer_offscreen_semantics = true;
+  PostUITaskSync([this] {
+    MockRuntimeDelegate client;
+    auto mock_runtime_controller =
+        std::make_unique<MockRuntimeController>(client, task_runners_);
+    auto engine = std::make_unique<Engine>(
+        /*delegate=*/delegate_,
+        /*dispatcher_maker=*/dispatcher_maker_,
+        /*image_decoder_task_runner=*/image_decoder_task_runner_,
+        /*task_runners=*/task_runners_,
+        /*settings=*/settings_,
+        /*animator=*/std::move(animator_),
+        /*io_manager=*/io_manager_,
+        /*font_collection=*/std::make_shared<FontCollection>(),
+        /*runtime_controller=*/std::move(mock_runtime_controller));
+    SemanticsNodeUpdates passed;
+    EXPECT_CALL(delegate_, OnEngineUpdateSemantics(::testing::_, ::testing::_))
+        .WillRepeatedly(::testing::SaveArg<0>(&passed));
+    engine->SetViewportMetrics(ViewportMetrics(1.0, 100, 200));
+
+    // A list of ten items that are 100 pixels high.
+    SemanticsNodeUpdates updates;
+    SemanticsNode root;
+    root.id = 0;
+    root.rect = SkRect::MakeWH(100, 200);
+    for (int32_t id = 1; id <= 10; id++) {
+      root.childrenInTraversalOrder.push_back(id);
+      root.childrenInHitTestOrder.push_back(id);
+      SemanticsNode item;
+      item.id = id;
+      item.rect = SkRect::MakeWH(100, 100);
+      item.transform = SkM44::Translate(0, (id - 1) * 100);
+      updates[id] = item;
+    }
+    updates[0] = root;
+    RuntimeDelegate& runtime_delegate = *engine;
+    runtime_delegate.UpdateSemantics(updates, {});
+    ASSERT_EQ(passed.count(0), size_t{1});
+    EXPECT_EQ(passed[0].childrenInTraversalOrder.size(), size_t{5});
+    EXPECT_EQ(passed.size(), size_t{6});
+
+    // Updates that only touch deferred nodes are not passed on.
+    passed.clear();
+    SemanticsNodeUpdates deferred_update;
+    deferred_update[10] = updates[10];
+    runtime_delegate.UpdateSemantics(deferred_update, {});
+    EXPECT_TRUE(passed.empty());
+
+    engine->SetViewportMetrics(ViewportMetrics(1.0, 100, 400));
+    ASSERT_EQ(passed.count(0), size_t{1});
+    EXPECT_EQ(passed[0].childrenInTraversalOrder.size(), size_t{9});
+    EXPECT_EQ(passed.count(10), size_t{0});
+
+    engine->DispatchSemanticsAction(10, SemanticsAction::kShowOnScreen, {});
+    EXPECT_EQ(passed.count(10), size_t{1});
+  });
+}
+
 }  // namespace flutter
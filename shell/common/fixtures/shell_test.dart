@@ -206,3 +206,31 @@ void canAccessResourceFromAssetDir() async {
     },
   );
 }
+
+@pragma('vm:entry-point')
+void platformMessagesMain() {
+  // Records the channels of the messages received so far and replies with
+  // them, comma separated, to a message on the 'test/done' channel.
+  final List<String> channels = <String>[];
+  PlatformDispatcher.instance.onPlatformMessage =
+      (String name, ByteData? data, PlatformMessageResponseCallback? callback) {
+    if (name != 'test/done') {
+      channels.add(name);
+      return;
+    }
+    final String received = channels.join(',');
+    channels.clear();
+    callback!(Uint8List.fromList(utf8.encode(received)).buffer.asByteData());
+  };
+}
+
+@pragma('vm:entry-point')
+void pointerDataPacketsMain() {
+  // Reads the decoded pointer data like the gesture binding of the framework.
+  double distance = 0;
+  PlatformDispatcher.instance.onPointerDataPacket = (PointerDataPacket packet) {
+    for (final PointerData data in packet.data) {
+      distance += data.physicalDeltaX.abs() + data.physicalDeltaY.abs();
+    }
+  };
+}
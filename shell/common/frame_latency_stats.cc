@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_latency_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+size_t BucketForDuration(fml::TimeDelta duration) {
+  if (duration <= fml::TimeDelta::Zero()) {
+    return 0;
+  }
+  // Bucket i holds the durations in (i, i + 1] milliseconds.
+  const int64_t bucket = (duration.ToMicroseconds() - 1) / 1000;
+  return std::min(static_cast<size_t>(bucket),
+                  FrameLatencyStats::kHistogramBucketCount - 1);
+}
+
+}  // namespace
+
+FrameLatencyStats::FrameLatencyStats() = default;
+
+FrameLatencyStats::~FrameLatencyStats() = default;
+
+void FrameLatencyStats::AddFrameTiming(const FrameTiming& timing) {
+  const auto build_duration = timing.Get(FrameTiming::kBuildFinish) -
+                              timing.Get(FrameTiming::kBuildStart);
+  const auto raster_duration = timing.Get(FrameTiming::kRasterFinish) -
+                               timing.Get(FrameTiming::kRasterStart);
+  const auto latency = timing.Get(FrameTiming::kRasterFinish) -
+                       timing.Get(FrameTiming::kVsyncStart);
+
+  Frame frame;
+  frame.buckets[static_cast<size_t>(Metric::kBuild)] =
+      BucketForDuration(build_duration);
+  frame.buckets[static_cast<size_t>(Metric::kRaster)] =
+      BucketForDuration(raster_duration);
+  frame.buckets[static_cast<size_t>(Metric::kLatency)] =
+      BucketForDuration(latency);
+  frame.duration = build_duration + raster_duration;
+
+  std::scoped_lock lock(mutex_);
+  for (size_t metric = 0; metric < kMetricCount; metric++) {
+    histograms_[metric][frame.buckets[metric]]++;
+  }
+  recent_frames_.push_back(frame);
+  if (recent_frames_.size() > kHistogramFrameCount) {
+    const Frame& oldest = recent_frames_.front();
+    for (size_t metric = 0; metric < kMetricCount; metric++) {
+      histograms_[metric][oldest.buckets[metric]]--;
+    }
+    recent_frames_.pop_front();
+  }
+}
+
+fml::TimeDelta FrameLatencyStats::GetPredictedFrameDuration() const {
+  std::scoped_lock lock(mutex_);
+  fml::TimeDelta duration = fml::TimeDelta::Zero();
+  const size_t count = std::min(recent_frames_.size(), kPredictionFrameCount);
+  for (auto frame = recent_frames_.end() - count; frame != recent_frames_.end();
+       ++frame) {
+    duration = std::max(duration, frame->duration);
+  }
+  return duration;
+}
+
+fml::TimeDelta FrameLatencyStats::GetPercentile(Metric metric,
+                                                double fraction) const {
+  std::scoped_lock lock(mutex_);
+  return GetPercentileLocked(metric, fraction);
+}
+
+fml::TimeDelta FrameLatencyStats::GetPercentileLocked(Metric metric,
+                                                      double fraction) const {
+  if (recent_frames_.empty()) {
+    return fml::TimeDelta::Zero();
+  }
+  const auto rank = static_cast<size_t>(
+      std::ceil(std::clamp(fraction, 0.0, 1.0) * recent_frames_.size()));
+  const auto& histogram = histograms_[static_cast<size_t>(metric)];
+  size_t count = 0;
+  for (size_t bucket = 0; bucket < histogram.size(); bucket++) {
+    count += histogram[bucket];
+    if (count >= std::max<size_t>(rank, 1)) {
+      return fml::TimeDelta::FromMilliseconds(bucket + 1);
+    }
+  }
+  return fml::TimeDelta::FromMilliseconds(kHistogramBucketCount);
+}
+
+size_t FrameLatencyStats::GetFrameCount() const {
+  std::scoped_lock lock(mutex_);
+  return recent_frames_.size();
+}
+
+void FrameLatencyStats::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  std::scoped_lock lock(mutex_);
+  FML_TRACE_COUNTER(
+      "flutter", "FrameLatency", reinterpret_cast<int64_t>(this),
+      "LatencyP50Millis",
+      GetPercentileLocked(Metric::kLatency, 0.5).ToMilliseconds(),
+      "LatencyP90Millis",
+      GetPercentileLocked(Metric::kLatency, 0.9).ToMilliseconds(),
+      "LatencyP99Millis",
+      GetPercentileLocked(Metric::kLatency, 0.99).ToMilliseconds(),
+      "BuildP90Millis",
+      GetPercentileLocked(Metric::kBuild, 0.9).ToMilliseconds(),
+      "RasterP90Millis",
+      GetPercentileLocked(Metric::kRaster, 0.9).ToMilliseconds());
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
@@ -0,0 +1,97 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_FRAME_LATENCY_STATS_H_
+#define FLUTTER_SHELL_COMMON_FRAME_LATENCY_STATS_H_
+
+#include <array>
+#include <deque>
+#include <mutex>
+
+#include "flutter/common/settings.h"
+#include "flutter/fml/macros.h"
+#include "flutter/fml/time/time_delta.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Collects the timings of the recently rasterized frames into histograms, and
+/// predicts how long the next frame will take to build and rasterize.
+///
+/// Three durations are tracked for every frame: the build time on the UI
+/// thread, the raster time on the raster thread, and the latency from the
+/// start of the vsync interval to the end of rasterization.
+///
+/// Frame timings are added on the raster thread while the prediction is read
+/// on the UI thread, so all methods are thread-safe.
+///
+class FrameLatencyStats {
+ public:
+  enum class Metric {
+    kBuild,
+    kRaster,
+    kLatency,
+  };
+
+  /// The histograms have one bucket per millisecond. The last bucket holds
+  /// every longer duration.
+  static constexpr size_t kHistogramBucketCount = 100;
+
+  /// The number of recent frames the histograms are made of. Older frames are
+  /// dropped, so that the percentiles follow changes in the workload.
+  static constexpr size_t kHistogramFrameCount = 300;
+
+  /// The number of recent frames the prediction is based on.
+  static constexpr size_t kPredictionFrameCount = 8;
+
+  FrameLatencyStats();
+
+  ~FrameLatencyStats();
+
+  void AddFrameTiming(const FrameTiming& timing);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The time the next frame is expected to take to build and
+  ///             rasterize, which is the longest that any of the recent
+  ///             frames took. Zero if no frame was rasterized yet.
+  ///
+  fml::TimeDelta GetPredictedFrameDuration() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The duration that the given fraction, in [0, 1], of the
+  ///             frames did not exceed, rounded up to the millisecond.
+  ///
+  fml::TimeDelta GetPercentile(Metric metric, double fraction) const;
+
+  /// The number of frames in the histograms, at most
+  /// |kHistogramFrameCount|.
+  size_t GetFrameCount() const;
+
+  void TraceStatsToTimeline() const;
+
+ private:
+  static constexpr size_t kMetricCount = 3;
+
+  using Histogram = std::array<size_t, kHistogramBucketCount>;
+
+  struct Frame {
+    // The bucket of the frame in the histogram of each metric.
+    std::array<size_t, kMetricCount> buckets;
+    // The build and raster time of the frame.
+    fml::TimeDelta duration;
+  };
+
+  mutable std::mutex mutex_;
+  std::array<Histogram, kMetricCount> histograms_ = {};
+  // The frames in the histograms, oldest first.
+  std::deque<Frame> recent_frames_;
+
+  fml::TimeDelta GetPercentileLocked(Metric metric, double fraction) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(FrameLatencyStats);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_FRAME_LATENCY_STATS_H_
@@ -0,0 +1,105 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/frame_latency_stats.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// A frame that starts building 1ms into its vsync interval and is rasterized
+// right after it is built.
+FrameTiming CreateFrameTiming(int64_t build_millis, int64_t raster_millis) {
+  const auto vsync_start = fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMilliseconds(1000));
+  const auto build_start = vsync_start + fml::TimeDelta::FromMilliseconds(1);
+  const auto build_finish =
+      build_start + fml::TimeDelta::FromMilliseconds(build_millis);
+  FrameTiming timing;
+  timing.Set(FrameTiming::kVsyncStart, vsync_start);
+  timing.Set(FrameTiming::kBuildStart, build_start);
+  timing.Set(FrameTiming::kBuildFinish, build_finish);
+  timing.Set(FrameTiming::kRasterStart, build_finish);
+  timing.Set(FrameTiming::kRasterFinish,
+             build_finish + fml::TimeDelta::FromMilliseconds(raster_millis));
+  return timing;
+}
+
+}  // namespace
+
+TEST(FrameLatencyStatsTest, StartsEmpty) {
+  FrameLatencyStats stats;
+  EXPECT_EQ(stats.GetFrameCount(), 0u);
+  EXPECT_EQ(stats.GetPredictedFrameDuration(), fml::TimeDelta::Zero());
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kLatency, 0.5),
+            fml::TimeDelta::Zero());
+}
+
+TEST(FrameLatencyStatsTest, ComputesPercentiles) {
+  FrameLatencyStats stats;
+  for (int i = 0; i < 9; i++) {
+    stats.AddFrameTiming(CreateFrameTiming(4, 5));
+  }
+  stats.AddFrameTiming(CreateFrameTiming(4, 20));
+  EXPECT_EQ(stats.GetFrameCount(), 10u);
+
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kBuild, 0.99),
+            fml::TimeDelta::FromMilliseconds(4));
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kRaster, 0.9),
+            fml::TimeDelta::FromMilliseconds(5));
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kRaster, 0.99),
+            fml::TimeDelta::FromMilliseconds(20));
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kLatency, 0.5),
+            fml::TimeDelta::FromMilliseconds(10));
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kLatency, 1.0),
+            fml::TimeDelta::FromMilliseconds(25));
+}
+
+TEST(FrameLatencyStatsTest, ClampsLongFramesToLastBucket) {
+  FrameLatencyStats stats;
+  stats.AddFrameTiming(CreateFrameTiming(500, 500));
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kLatency, 0.5),
+            fml::TimeDelta::FromMilliseconds(
+                FrameLatencyStats::kHistogramBucketCount));
+}
+
+TEST(FrameLatencyStatsTest, ForgetsFramesOutsideTheWindow) {
+  FrameLatencyStats stats;
+  for (size_t i = 0; i < FrameLatencyStats::kHistogramFrameCount; i++) {
+    stats.AddFrameTiming(CreateFrameTiming(4, 20));
+  }
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kRaster, 0.5),
+            fml::TimeDelta::FromMilliseconds(20));
+
+  // Once the slow frames are out of the window, only the fast ones count.
+  for (size_t i = 0; i < FrameLatencyStats::kHistogramFrameCount; i++) {
+    stats.AddFrameTiming(CreateFrameTiming(4, 5));
+  }
+  EXPECT_EQ(stats.GetFrameCount(), FrameLatencyStats::kHistogramFrameCount);
+  EXPECT_EQ(stats.GetPercentile(FrameLatencyStats::Metric::kRaster, 1.0),
+            fml::TimeDelta::FromMilliseconds(5));
+}
+
+TEST(FrameLatencyStatsTest, PredictsFromRecentFrames) {
+  FrameLatencyStats stats;
+  stats.AddFrameTiming(CreateFrameTiming(10, 10));
+  EXPECT_EQ(stats.GetPredictedFrameDuration(),
+            fml::TimeDelta::FromMilliseconds(20));
+
+  // The slow frame is forgotten once enough faster frames follow it.
+  for (size_t i = 1; i < FrameLatencyStats::kPredictionFrameCount; i++) {
+    stats.AddFrameTiming(CreateFrameTiming(2, 3));
+    EXPECT_EQ(stats.GetPredictedFrameDuration(),
+              fml::TimeDelta::FromMilliseconds(20));
+  }
+  stats.AddFrameTiming(CreateFrameTiming(2, 3));
+  EXPECT_EQ(stats.GetPredictedFrameDuration(),
+            fml::TimeDelta::FromMilliseconds(5));
+}
+
+}  // namespace testing
+}  // namespace flutter
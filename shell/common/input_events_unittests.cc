@@ -2,6 +2,9 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cstring>
+
+#include "flutter/shell/common/pointer_data_dispatcher.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/testing/testing.h"
 
@@ -412,5 +415,164 @@ TEST_F(ShellTest, CanCorrectlySynthesizePointerPacket) {
   ASSERT_FALSE(DartVMRef::IsInstanceRunning());
 }
 
+// Records the dispatched packets and runs the vsync callback on demand.
+class FakePointerDataDispatcherDelegate
+    : public PointerDataDispatcher::Delegate {
+ public:
+  // |PointerDataDispatcher::Delegate|
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    const auto& data = packet->data();
+    std::vector<PointerData> events(data.size() / sizeof(PointerData));
+    memcpy(events.data(), data.data(), data.size());
+    packets.push_back(std::move(events));
+  }
+
+  // |PointerDataDispatcher::Delegate|
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    vsync_callback = callback;
+  }
+
+  void FireVsync() {
+    auto callback = std::move(vsync_callback);
+    vsync_callback = nullptr;
+    if (callback) {
+      callback();
+    }
+  }
+
+  std::vector<std::vector<PointerData>> packets;
+  fml::closure vsync_callback;
+};
+
+static void DispatchSimulatedPointerData(PointerDataDispatcher& dispatcher,
+                                         PointerData::Change change,
+                                         int64_t device,
+                                         int64_t time_stamp,
+                                         double x,
+                                         double delta_x) {
+  PointerData data;
+  CreateSimulatedPointerData(data, change, x, 0.0);
+  data.device = device;
+  data.time_stamp = time_stamp;
+  data.physical_delta_x = delta_x;
+  auto packet = std::make_unique<PointerDataPacket>(1);
+  packet->SetPointerData(0, data);
+  dispatcher.DispatchPacket(std::move(packet), 0);
+}
+
+static fml::TimePoint FromMicroseconds(int64_t micros) {
+  return fml::TimePoint::FromEpochDelta(
+      fml::TimeDelta::FromMicroseconds(micros));
+}
+
+TEST(ResamplingPointerDataDispatcherTest, MergesAndResamplesMoves) {
+  FakePointerDataDispatcherDelegate delegate;
+  fml::TimePoint now;
+  ResamplingPointerDataDispatcher dispatcher(
+      delegate, fml::TimeDelta::FromMilliseconds(4), [&now] { return now; });
+  // The time stamps use a clock of their own, and the events arrive 1ms after
+  // they are stamped.
+  const int64_t clock_offset = 5000000000;
+  auto deliver = [&](PointerData::Change change, int64_t time_stamp, double x,
+                     double delta_x) {
+    now = FromMicroseconds(clock_offset + time_stamp + 1000);
+    DispatchSimulatedPointerData(dispatcher, change, 0, time_stamp, x,
+                                 delta_x);
+  };
+
+  // A 1 kHz drag moving by 1 pixel per sample.
+  deliver(PointerData::Change::kDown, 0, 0.0, 0.0);
+  for (int64_t i = 1; i <= 15; i++) {
+    deliver(PointerData::Change::kMove, i * 1000, i, 1.0);
+  }
+  // The sampling time is 16.5ms - 1ms - 4ms = 11.5ms.
+  now = FromMicroseconds(clock_offset + 16500);
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  ASSERT_EQ(delegate.packets[0].size(), 2u);
+  EXPECT_EQ(delegate.packets[0][0].change, PointerData::Change::kDown);
+  const PointerData resampled = delegate.packets[0][1];
+  EXPECT_EQ(resampled.change, PointerData::Change::kMove);
+  EXPECT_EQ(resampled.time_stamp, 11500);
+  EXPECT_DOUBLE_EQ(resampled.physical_x, 11.5);
+  EXPECT_DOUBLE_EQ(resampled.physical_delta_x, 11.5);
+  ASSERT_TRUE(delegate.vsync_callback);
+
+  deliver(PointerData::Change::kMove, 16000, 16.0, 1.0);
+  deliver(PointerData::Change::kUp, 17000, 16.0, 0.0);
+  now = FromMicroseconds(clock_offset + 33000);
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  ASSERT_EQ(delegate.packets[1].size(), 2u);
+  const PointerData merged = delegate.packets[1][0];
+  EXPECT_EQ(merged.change, PointerData::Change::kMove);
+  EXPECT_EQ(merged.time_stamp, 16000);
+  EXPECT_DOUBLE_EQ(merged.physical_x, 16.0);
+  EXPECT_DOUBLE_EQ(merged.physical_delta_x, 4.5);
+  EXPECT_EQ(delegate.packets[1][1].change, PointerData::Change::kUp);
+  EXPECT_FALSE(delegate.vsync_callback);
+}
+
+TEST(ResamplingPointerDataDispatcherTest, PreservesTheOrderOfOtherChanges) {
+  using Change = PointerData::Change;
+  FakePointerDataDispatcherDelegate delegate;
+  fml::TimePoint now;
+  ResamplingPointerDataDispatcher dispatcher(
+      delegate, fml::TimeDelta::FromMicroseconds(500), [&now] { return now; });
+  auto deliver = [&](Change change, int64_t device, int64_t time_stamp,
+                     double x, double delta_x) {
+    now = std::max(now, FromMicroseconds(time_stamp));
+    DispatchSimulatedPointerData(dispatcher, change, device, time_stamp, x,
+                                 delta_x);
+  };
+
+  deliver(Change::kDown, 0, 0, 0.0, 0.0);
+  deliver(Change::kMove, 0, 1, 1.0, 1.0);
+  deliver(Change::kDown, 1, 2, 0.0, 0.0);
+  deliver(Change::kMove, 0, 3, 2.0, 1.0);
+  deliver(Change::kMove, 1, 4, 1.0, 1.0);
+  deliver(Change::kCancel, 0, 5, 2.0, 0.0);
+  deliver(Change::kDown, 0, 6, 2.0, 0.0);
+  deliver(Change::kMove, 0, 7, 3.0, 1.0);
+  deliver(Change::kMove, 1, 8, 2.0, 1.0);
+  deliver(Change::kUp, 1, 9, 2.0, 0.0);
+  // Stamped after the sampling time, so it is held back along with the
+  // events of the same device that follow it.
+  deliver(Change::kMove, 0, 1000, 4.0, 1.0);
+  deliver(Change::kUp, 0, 10, 4.0, 0.0);
+  delegate.FireVsync();
+
+  ASSERT_EQ(delegate.packets.size(), 1u);
+  const auto events = delegate.packets[0];
+  std::vector<std::pair<int64_t, Change>> changes;
+  for (const auto& event : events) {
+    changes.emplace_back(event.device, event.change);
+  }
+  const std::vector<std::pair<int64_t, Change>> expected_changes = {
+      {0, Change::kDown},   {1, Change::kDown}, {0, Change::kMove},
+      {0, Change::kCancel}, {0, Change::kDown}, {1, Change::kMove},
+      {1, Change::kUp},     {0, Change::kMove},
+  };
+  EXPECT_EQ(changes, expected_changes);
+  EXPECT_DOUBLE_EQ(events[2].physical_x, 2.0);
+  EXPECT_DOUBLE_EQ(events[2].physical_delta_x, 2.0);
+  EXPECT_DOUBLE_EQ(events[5].physical_x, 2.0);
+  EXPECT_DOUBLE_EQ(events[5].physical_delta_x, 2.0);
+  EXPECT_EQ(events[7].time_stamp, 500);
+  EXPECT_GT(events[7].physical_x, 3.0);
+  EXPECT_LT(events[7].physical_x, 4.0);
+
+  now = FromMicroseconds(2000);
+  delegate.FireVsync();
+  ASSERT_EQ(delegate.packets.size(), 2u);
+  ASSERT_EQ(delegate.packets[1].size(), 2u);
+  EXPECT_EQ(delegate.packets[1][0].change, Change::kMove);
+  EXPECT_DOUBLE_EQ(
+      events[7].physical_x + delegate.packets[1][0].physical_delta_x, 4.0);
+  EXPECT_EQ(delegate.packets[1][1].change, Change::kUp);
+}
+
 }  // namespace testing
 }  // namespace flutter
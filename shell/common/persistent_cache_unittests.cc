@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/graphics/persistent_cache_file.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/layers/physical_shape_layer.h"
@@ -14,6 +15,8 @@
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/log_settings.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/fml/thread.h"
 #include "flutter/fml/unique_fd.h"
 #include "flutter/shell/common/shell_test.h"
 #include "flutter/shell/common/switches.h"
@@ -212,6 +215,312 @@ TEST_F(ShellTest, CanLoadSkSLsFromAsset) {
   fml::UnlinkFile(asset_dir.fd(), PersistentCache::kAssetFileName);
 }
 
+static sk_sp<SkData> MakeTextSkData(const std::string& text) {
+  return SkData::MakeWithCopy(text.data(), text.size());
+}
+
+static std::shared_ptr<fml::UniqueFD> OpenTestDirectory(
+    const fml::ScopedTemporaryDirectory& dir) {
+  return std::make_shared<fml::UniqueFD>(fml::OpenDirectory(
+      dir.path().c_str(), false, fml::FilePermission::kReadWrite));
+}
+
+TEST(PersistentCacheFileTest, StoresSurviveReopeningAndCompaction) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = OpenTestDirectory(dir);
+  sk_sp<SkData> key_a = MakeTextSkData("A");
+  sk_sp<SkData> key_b = MakeTextSkData("B");
+
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+    ASSERT_NE(cache_file, nullptr);
+    ASSERT_EQ(cache_file->Load(*key_a), nullptr);
+    ASSERT_TRUE(cache_file->Store(*key_a, *MakeTextSkData("x")));
+    ASSERT_TRUE(cache_file->Store(*key_b, *MakeTextSkData("y")));
+    ASSERT_TRUE(cache_file->Store(*key_a, *MakeTextSkData("z")));
+    CheckTextSkData(cache_file->Load(*key_a), "z");
+    ASSERT_EQ(cache_file->LoadAll().size(), 2u);
+  }
+
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+    ASSERT_NE(cache_file, nullptr);
+    sk_sp<SkData> value_b = cache_file->Load(*key_b);
+    ASSERT_TRUE(cache_file->Compact());
+    // Data loaded before the compaction stays valid.
+    CheckTextSkData(value_b, "y");
+    CheckTextSkData(cache_file->Load(*key_a), "z");
+    ASSERT_EQ(cache_file->LoadAll().size(), 2u);
+  }
+
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", true);
+    ASSERT_NE(cache_file, nullptr);
+    CheckTextSkData(cache_file->Load(*key_b), "y");
+    ASSERT_FALSE(cache_file->Store(*key_b, *MakeTextSkData("w")));
+  }
+}
+
+TEST(PersistentCacheFileTest, DropsCorruptRecords) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = OpenTestDirectory(dir);
+  sk_sp<SkData> key_a = MakeTextSkData("A");
+  sk_sp<SkData> key_b = MakeTextSkData("B");
+
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+    ASSERT_NE(cache_file, nullptr);
+    ASSERT_TRUE(cache_file->Store(*key_a, *MakeTextSkData("x")));
+    ASSERT_TRUE(cache_file->Store(*key_b, *MakeTextSkData("y")));
+  }
+
+  // Flip a byte in the last record as an interrupted write would. The records
+  // are followed by the zeroed space reserved for future ones.
+  {
+    auto file = fml::OpenFile(*directory, "cache", false,
+                              fml::FilePermission::kReadWrite);
+    fml::FileMapping mapping(file, {fml::FileMapping::Protection::kRead,
+                                    fml::FileMapping::Protection::kWrite});
+    uint8_t* bytes = mapping.GetMutableMapping();
+    ASSERT_NE(bytes, nullptr);
+    size_t end = mapping.GetSize();
+    while (end > 0 && bytes[end - 1] == 0) {
+      end--;
+    }
+    ASSERT_GT(end, 0u);
+    bytes[end - 1] ^= 0xff;
+  }
+
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+    ASSERT_NE(cache_file, nullptr);
+    CheckTextSkData(cache_file->Load(*key_a), "x");
+    ASSERT_EQ(cache_file->Load(*key_b), nullptr);
+  }
+
+  // A file with a damaged header is replaced by an empty one.
+  fml::DataMapping garbage(std::string(64, 'x'));
+  ASSERT_TRUE(fml::WriteAtomically(*directory, "cache", garbage));
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+    ASSERT_NE(cache_file, nullptr);
+    ASSERT_EQ(cache_file->LoadAll().size(), 0u);
+    ASSERT_TRUE(cache_file->Store(*key_a, *MakeTextSkData("x")));
+    CheckTextSkData(cache_file->Load(*key_a), "x");
+  }
+}
+
+TEST(PersistentCacheFileTest, ReservedSpaceSurvivesReopening) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = OpenTestDirectory(dir);
+  const std::string value(1000, 'v');
+
+  {
+    auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+    ASSERT_NE(cache_file, nullptr);
+    for (int i = 0; i < 200; i++) {
+      ASSERT_TRUE(cache_file->Store(*MakeTextSkData(std::to_string(i)),
+                                    *MakeTextSkData(value)));
+    }
+  }
+
+  auto cache_file = PersistentCacheFile::Open(directory, "cache", false);
+  ASSERT_NE(cache_file, nullptr);
+  ASSERT_EQ(cache_file->LoadAll().size(), 200u);
+  ASSERT_TRUE(cache_file->Store(*MakeTextSkData("A"), *MakeTextSkData("x")));
+  CheckTextSkData(cache_file->Load(*MakeTextSkData("199")), value);
+  CheckTextSkData(cache_file->Load(*MakeTextSkData("A")), "x");
+  ASSERT_EQ(cache_file->LoadAll().size(), 201u);
+}
+
+TEST(PersistentCacheFileTest, KeepsRecordsStoredThroughAnotherInstance) {
+  fml::ScopedTemporaryDirectory dir;
+  auto directory = OpenTestDirectory(dir);
+  sk_sp<SkData> key_a = MakeTextSkData("A");
+  sk_sp<SkData> key_b = MakeTextSkData("B");
+  sk_sp<SkData> key_c = MakeTextSkData("C");
+
+  // Two instances stand in for two processes sharing the file.
+  auto first = PersistentCacheFile::Open(directory, "cache", false);
+  auto second = PersistentCacheFile::Open(directory, "cache", false);
+  ASSERT_NE(first, nullptr);
+  ASSERT_NE(second, nullptr);
+  ASSERT_TRUE(first->Store(*key_a, *MakeTextSkData("x")));
+  ASSERT_TRUE(second->Store(*key_b, *MakeTextSkData("y")));
+  ASSERT_TRUE(first->Store(*key_c, *MakeTextSkData("z")));
+  CheckTextSkData(first->Load(*key_b), "y");
+
+  auto reopened = PersistentCacheFile::Open(directory, "cache", true);
+  ASSERT_NE(reopened, nullptr);
+  CheckTextSkData(reopened->Load(*key_a), "x");
+  CheckTextSkData(reopened->Load(*key_b), "y");
+  CheckTextSkData(reopened->Load(*key_c), "z");
+}
+
+TEST_F(ShellTest, MigratesLegacyPersistentCacheFiles) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+
+  // "IE" is the Base32 encoding of "A", the naming used by the legacy layout
+  // of one file per entry.
+  fml::DataMapping legacy_data(std::string("x"));
+  ASSERT_TRUE(fml::WriteAtomically(cache_dir, "IE", legacy_data));
+
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  // The legacy file is read until it is migrated on a worker.
+  sk_sp<SkData> key = MakeTextSkData("A");
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  CheckTextSkData(persistent_cache->load(*key), "x");
+  ASSERT_TRUE(fml::FileExists(cache_dir, "IE"));
+
+  fml::Thread worker("io.flutter.test.persistent_cache_worker");
+  persistent_cache->AddWorkerTaskRunner(worker.GetTaskRunner());
+  fml::AutoResetWaitableEvent latch;
+  worker.GetTaskRunner()->PostTask([&latch]() { latch.Signal(); });
+  latch.Wait();
+  persistent_cache->RemoveWorkerTaskRunner(worker.GetTaskRunner());
+
+  CheckTextSkData(persistent_cache->load(*key), "x");
+  ASSERT_FALSE(fml::FileExists(cache_dir, "IE"));
+  ASSERT_TRUE(fml::FileExists(cache_dir, PersistentCache::kCacheFileName));
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(ShellTest, FallsBackToLegacyFilesWithoutCacheFile) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+
+  // A directory in the way of the cache file keeps it from being opened.
+  ASSERT_TRUE(fml::CreateDirectory(cache_dir, {PersistentCache::kCacheFileName},
+                                   fml::FilePermission::kReadWrite)
+                  .is_valid());
+
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  sk_sp<SkData> key = MakeTextSkData("A");
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  StorePersistentCache(persistent_cache, *key, *MakeTextSkData("x"));
+  ASSERT_TRUE(fml::FileExists(cache_dir, "IE"));
+  CheckTextSkData(persistent_cache->load(*key), "x");
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(ShellTest, PrioritizesSkSLsUsedByTheFirstFrame) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  sk_sp<SkData> key_a = MakeTextSkData("A");
+  sk_sp<SkData> key_b = MakeTextSkData("B");
+  sk_sp<SkData> key_c = MakeTextSkData("C");
+  sk_sp<SkData> value = MakeTextSkData("x");
+
+  // Only the shaders stored before the first frame are recorded.
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  StorePersistentCache(persistent_cache, *key_b, *value);
+  persistent_cache->MarkFirstFrameRasterized();
+  StorePersistentCache(persistent_cache, *key_c, *value);
+
+  // The recording is read back by later runs.
+  PersistentCache::ResetCacheForProcess();
+  std::vector<PersistentCache::SkSLCache> sksls = {
+      {key_a, value}, {key_b, value}, {key_c, value}};
+  ASSERT_EQ(
+      PersistentCache::GetCacheForProcess()->PrioritizeFirstFrameSkSLs(sksls),
+      1u);
+  ASSERT_EQ(sksls[0].first, key_b);
+  ASSERT_EQ(sksls[1].first, key_a);
+  ASSERT_EQ(sksls[2].first, key_c);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(ShellTest, PrioritizesAllSkSLsWithoutFirstFrameRecord) {
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  // As after an install, no run has rasterized its first frame yet.
+  sk_sp<SkData> key_a = MakeTextSkData("A");
+  sk_sp<SkData> key_b = MakeTextSkData("B");
+  sk_sp<SkData> value = MakeTextSkData("x");
+  std::vector<PersistentCache::SkSLCache> sksls = {{key_a, value},
+                                                   {key_b, value}};
+  ASSERT_EQ(
+      PersistentCache::GetCacheForProcess()->PrioritizeFirstFrameSkSLs(sksls),
+      2u);
+  ASSERT_EQ(sksls[0].first, key_a);
+  ASSERT_EQ(sksls[1].first, key_b);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(ShellTest, PrioritizesSkSLsFromAsset) {
+  fml::LogSettings warning_only = {fml::LOG_WARNING};
+  fml::ScopedSetLogSettings scoped_set_log_settings(warning_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+
+  sk_sp<SkData> key_a = MakeTextSkData("A");
+  sk_sp<SkData> key_b = MakeTextSkData("B");
+  sk_sp<SkData> key_c = MakeTextSkData("C");
+  sk_sp<SkData> value = MakeTextSkData("x");
+
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  StorePersistentCache(persistent_cache, *key_b, *value);
+  persistent_cache->MarkFirstFrameRasterized();
+  PersistentCache::ResetCacheForProcess();
+
+  // The asset holds "A", which is Base32 encoded as "IE".
+  const std::string kTestJson = "{\"data\": {\"IE\": \"eA==\"}}";
+  fml::ScopedTemporaryDirectory asset_dir;
+  fml::DataMapping json(
+      std::vector<uint8_t>{kTestJson.begin(), kTestJson.end()});
+  fml::WriteAtomically(asset_dir.fd(), PersistentCache::kAssetFileName, json);
+  auto asset_manager = std::make_shared<AssetManager>();
+  RunConfiguration config(nullptr, asset_manager);
+  asset_manager->PushBack(std::make_unique<DirectoryAssetBundle>(
+      fml::OpenDirectory(asset_dir.path().c_str(), false,
+                         fml::FilePermission::kRead),
+      false));
+  PersistentCache::GetCacheForProcess()->LoadSkSLs();
+
+  std::vector<PersistentCache::SkSLCache> sksls = {
+      {key_c, value}, {key_a, value}, {key_b, value}};
+  ASSERT_EQ(
+      PersistentCache::GetCacheForProcess()->PrioritizeFirstFrameSkSLs(sksls),
+      2u);
+  ASSERT_EQ(sksls[0].first, key_a);
+  ASSERT_EQ(sksls[1].first, key_b);
+  ASSERT_EQ(sksls[2].first, key_c);
+
+  // Cleanup
+  PersistentCache::SetAssetManager(nullptr);
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
 TEST_F(ShellTest, CanRemoveOldPersistentCache) {
   fml::ScopedTemporaryDirectory base_dir;
   ASSERT_TRUE(base_dir.fd().is_valid());
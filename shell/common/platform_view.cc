@@ -36,6 +36,11 @@ void PlatformView::DispatchPlatformMessage(
   delegate_.OnPlatformViewDispatchPlatformMessage(std::move(message));
 }
 
+void PlatformView::DispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  delegate_.OnPlatformViewDispatchPlatformMessages(std::move(messages));
+}
+
 void PlatformView::DispatchPointerDataPacket(
     std::unique_ptr<PointerDataPacket> packet) {
   delegate_.OnPlatformViewDispatchPointerDataPacket(
@@ -116,6 +116,19 @@ class PlatformView {
     virtual void OnPlatformViewDispatchPlatformMessage(
         fml::RefPtr<PlatformMessage> message) = 0;
 
+    //--------------------------------------------------------------------------
+    /// @brief      Notifies the delegate that the platform has dispatched a
+    ///             batch of platform messages from the embedder to the Flutter
+    ///             application. The batch must be forwarded to the running
+    ///             isolate hosted by the engine on the UI thread as a unit and
+    ///             in order.
+    ///
+    /// @param[in]  messages  The platform messages to dispatch to the running
+    ///                       root isolate.
+    ///
+    virtual void OnPlatformViewDispatchPlatformMessages(
+        std::vector<fml::RefPtr<PlatformMessage>> messages) = 0;
+
     //--------------------------------------------------------------------------
     /// @brief      Notifies the delegate that the platform view has encountered
     ///             a pointer event. This pointer event needs to be forwarded to
@@ -381,6 +394,22 @@ class PlatformView {
   ///
   void DispatchPlatformMessage(fml::RefPtr<PlatformMessage> message);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders to dispatch a batch of platform messages to
+  ///             the running root isolate hosted by the engine. The messages
+  ///             are delivered in order in a single task on the UI thread and
+  ///             a single entry into the isolate, which is considerably
+  ///             cheaper than dispatching them one by one. The same delivery
+  ///             caveats as for `DispatchPlatformMessage` apply.
+  ///
+  /// @see        DispatchPlatformMessage()
+  ///
+  /// @param[in]  messages  The platform messages to deliver to the root
+  ///                       isolate.
+  ///
+  void DispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages);
+
   //----------------------------------------------------------------------------
   /// @brief      Overridden by embedders to perform actions in response to
   ///             platform messages sent from the framework to the embedder.
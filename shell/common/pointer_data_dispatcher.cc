@@ -4,6 +4,9 @@
 
 #include "flutter/shell/common/pointer_data_dispatcher.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "flutter/fml/trace_event.h"
 
 namespace flutter {
@@ -15,6 +18,16 @@ SmoothPointerDataDispatcher::SmoothPointerDataDispatcher(Delegate& delegate)
     : DefaultPointerDataDispatcher(delegate), weak_factory_(this) {}
 SmoothPointerDataDispatcher::~SmoothPointerDataDispatcher() = default;
 
+ResamplingPointerDataDispatcher::ResamplingPointerDataDispatcher(
+    Delegate& delegate,
+    fml::TimeDelta sampling_offset,
+    Clock clock)
+    : DefaultPointerDataDispatcher(delegate),
+      sampling_offset_(sampling_offset),
+      clock_(std::move(clock)),
+      weak_factory_(this) {}
+ResamplingPointerDataDispatcher::~ResamplingPointerDataDispatcher() = default;
+
 void DefaultPointerDataDispatcher::DispatchPacket(
     std::unique_ptr<PointerDataPacket> packet,
     uint64_t trace_flow_id) {
@@ -68,4 +81,171 @@ void SmoothPointerDataDispatcher::DispatchPendingPacket() {
   ScheduleSecondaryVsyncCallback();
 }
 
+static bool IsResamplable(const PointerData& event) {
+  return event.signal_kind == PointerData::SignalKind::kNone &&
+         (event.change == PointerData::Change::kMove ||
+          event.change == PointerData::Change::kHover);
+}
+
+// Whether |next| continues the run of moves of |event|.
+static bool ContinuesMove(const PointerData& event, const PointerData& next) {
+  return IsResamplable(next) && next.device == event.device &&
+         next.change == event.change && next.buttons == event.buttons;
+}
+
+void ResamplingPointerDataDispatcher::DispatchPacket(
+    std::unique_ptr<PointerDataPacket> packet,
+    uint64_t trace_flow_id) {
+  TRACE_EVENT0("flutter", "ResamplingPointerDataDispatcher::DispatchPacket");
+  TRACE_FLOW_STEP("flutter", "PointerEvent", trace_flow_id);
+
+  const int64_t arrival_time = clock_().ToEpochDelta().ToMicroseconds();
+  const auto& data = packet->data();
+  const size_t count = data.size() / sizeof(PointerData);
+  for (size_t i = 0; i < count; i++) {
+    PendingEvent pending;
+    memcpy(&pending.event, &data[i * sizeof(PointerData)],
+           sizeof(PointerData));
+    pending.trace_flow_id = trace_flow_id;
+    const int64_t offset = arrival_time - pending.event.time_stamp;
+    if (!time_stamp_offset_.has_value() || offset < *time_stamp_offset_) {
+      time_stamp_offset_ = offset;
+    }
+    pending_events_.push_back(pending);
+  }
+  ScheduleSecondaryVsyncCallback();
+}
+
+void ResamplingPointerDataDispatcher::ScheduleSecondaryVsyncCallback() {
+  delegate_.ScheduleSecondaryVsyncCallback(
+      reinterpret_cast<uintptr_t>(this),
+      [dispatcher = weak_factory_.GetWeakPtr()]() {
+        if (dispatcher) {
+          dispatcher->DispatchPendingEvents();
+        }
+      });
+}
+
+void ResamplingPointerDataDispatcher::DispatchPendingEvents() {
+  TRACE_EVENT0("flutter",
+               "ResamplingPointerDataDispatcher::DispatchPendingEvents");
+  if (pending_events_.empty()) {
+    return;
+  }
+
+  const int64_t sampling_time =
+      (clock_() - sampling_offset_).ToEpochDelta().ToMicroseconds() -
+      time_stamp_offset_.value_or(0);
+
+  std::vector<PointerData> dispatched_events;
+  std::vector<PendingEvent> held_events;
+  std::vector<int64_t> held_devices;
+  // The merged moves of the devices that are not dispatched yet, in the order
+  // the devices started moving. There are only ever a few devices.
+  std::vector<PointerData> moves;
+  // The flows of the packets that had events dispatched, oldest first.
+  std::vector<uint64_t> dispatched_trace_flow_ids;
+
+  auto find_move = [&moves](int64_t device) {
+    return std::find_if(
+        moves.begin(), moves.end(),
+        [device](const PointerData& move) { return move.device == device; });
+  };
+
+  for (const PendingEvent& pending : pending_events_) {
+    const PointerData& event = pending.event;
+    const bool is_device_held =
+        std::find(held_devices.begin(), held_devices.end(), event.device) !=
+        held_devices.end();
+    if (is_device_held || event.time_stamp > sampling_time) {
+      if (!is_device_held) {
+        held_devices.push_back(event.device);
+      }
+      held_events.push_back(pending);
+      continue;
+    }
+
+    if (dispatched_trace_flow_ids.empty() ||
+        dispatched_trace_flow_ids.back() != pending.trace_flow_id) {
+      dispatched_trace_flow_ids.push_back(pending.trace_flow_id);
+    }
+
+    auto move = find_move(event.device);
+    if (move != moves.end()) {
+      if (ContinuesMove(*move, event)) {
+        // The merged move travels from the position before |move| to the
+        // position of |event|.
+        PointerData merged = event;
+        merged.physical_delta_x += move->physical_delta_x;
+        merged.physical_delta_y += move->physical_delta_y;
+        *move = merged;
+        continue;
+      }
+      dispatched_events.push_back(*move);
+      moves.erase(move);
+    }
+
+    if (IsResamplable(event)) {
+      moves.push_back(event);
+    } else {
+      dispatched_events.push_back(event);
+    }
+  }
+
+  for (PointerData& move : moves) {
+    auto next = std::find_if(held_events.begin(), held_events.end(),
+                             [&move](const PendingEvent& pending) {
+                               return pending.event.device == move.device;
+                             });
+    if (next != held_events.end() && ContinuesMove(move, next->event) &&
+        next->event.time_stamp > move.time_stamp) {
+      PointerData& next_event = next->event;
+      const double t = static_cast<double>(sampling_time - move.time_stamp) /
+                       (next_event.time_stamp - move.time_stamp);
+      const double x =
+          move.physical_x + (next_event.physical_x - move.physical_x) * t;
+      const double y =
+          move.physical_y + (next_event.physical_y - move.physical_y) * t;
+      move.physical_delta_x += x - move.physical_x;
+      move.physical_delta_y += y - move.physical_y;
+      move.physical_x = x;
+      move.physical_y = y;
+      move.time_stamp = sampling_time;
+      next_event.physical_delta_x = next_event.physical_x - x;
+      next_event.physical_delta_y = next_event.physical_y - y;
+    }
+    dispatched_events.push_back(move);
+  }
+
+  pending_events_ = std::move(held_events);
+  if (!pending_events_.empty()) {
+    ScheduleSecondaryVsyncCallback();
+  }
+
+  if (dispatched_events.empty()) {
+    return;
+  }
+
+  // The packet continues the flow of the most recent packet it has events of.
+  // The flows of the older packets end here unless some of their events are
+  // still held.
+  const uint64_t trace_flow_id = dispatched_trace_flow_ids.back();
+  dispatched_trace_flow_ids.pop_back();
+  for (uint64_t id : dispatched_trace_flow_ids) {
+    if (std::none_of(pending_events_.begin(), pending_events_.end(),
+                     [id](const PendingEvent& pending) {
+                       return pending.trace_flow_id == id;
+                     })) {
+      TRACE_FLOW_END("flutter", "PointerEvent", id);
+    }
+  }
+
+  auto packet = std::make_unique<PointerDataPacket>(dispatched_events.size());
+  for (size_t i = 0; i < dispatched_events.size(); i++) {
+    packet->SetPointerData(i, dispatched_events[i]);
+  }
+  DefaultPointerDataDispatcher::DispatchPacket(std::move(packet),
+                                               trace_flow_id);
+}
+
 }  // namespace flutter
@@ -4,6 +4,7 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include <optional>
 #include <utility>
 
 #include "flutter/common/graphics/persistent_cache.h"
@@ -43,6 +44,9 @@ Rasterizer::Rasterizer(Delegate& delegate)
       user_override_resource_cache_bytes_(false),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
+  const Settings& settings = delegate.GetSettings();
+  compositor_context_->raster_cache().SetMaxBytes(
+      settings.raster_cache_max_bytes, settings.raster_cache_max_unused_frames);
 }
 
 #if defined(LEGACY_FUCHSIA_EMBEDDER)
@@ -55,6 +59,9 @@ Rasterizer::Rasterizer(
       user_override_resource_cache_bytes_(false),
       weak_factory_(this) {
   FML_DCHECK(compositor_context_);
+  const Settings& settings = delegate.GetSettings();
+  compositor_context_->raster_cache().SetMaxBytes(
+      settings.raster_cache_max_bytes, settings.raster_cache_max_unused_frames);
 }
 #endif
 
@@ -100,6 +107,9 @@ void Rasterizer::Teardown() {
   compositor_context_->OnGrContextDestroyed();
   surface_.reset();
   last_layer_tree_.reset();
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  last_diffed_layer_tree_id_ = 0;
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
 
   if (raster_thread_merger_.get() != nullptr &&
       raster_thread_merger_.get()->IsMerged()) {
@@ -338,6 +348,7 @@ RasterStatus Rasterizer::DoDraw(
   RasterStatus raster_status = DrawToSurface(*layer_tree);
   if (raster_status == RasterStatus::kSuccess) {
     last_layer_tree_ = std::move(layer_tree);
+    persistent_cache->MarkFirstFrameRasterized();
   } else if (raster_status == RasterStatus::kResubmit ||
              raster_status == RasterStatus::kSkipAndRetry) {
     resubmitted_layer_tree_ = std::move(layer_tree);
@@ -461,11 +472,44 @@ RasterStatus Rasterizer::DrawToSurface(flutter::LayerTree& layer_tree) {
   );
 
   if (compositor_frame) {
-    RasterStatus raster_status = compositor_frame->Raster(layer_tree, false);
+    FrameDamage* frame_damage_ptr = nullptr;
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+    // Partial repaint is only possible when rendering straight into the
+    // surface. Platform views are composited by the embedder and are not part
+    // of the diff.
+    std::optional<FrameDamage> frame_damage;
+    const auto& framebuffer_info = frame->framebuffer_info();
+    if (framebuffer_info.supports_partial_repaint && !embedder_root_canvas &&
+        !external_view_embedder_) {
+      frame_damage.emplace();
+      // A layer tree that was rasterized without a diff has no paint regions
+      // to diff against, so the whole frame is repainted instead.
+      if (framebuffer_info.existing_damage && last_layer_tree_ &&
+          last_layer_tree_->unique_id() == last_diffed_layer_tree_id_) {
+        frame_damage->SetPreviousLayerTree(last_layer_tree_.get());
+        frame_damage->AddAdditionalDamage(*framebuffer_info.existing_damage);
+      }
+      frame_damage_ptr = &frame_damage.value();
+    }
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
+    RasterStatus raster_status =
+        compositor_frame->Raster(layer_tree, false, frame_damage_ptr);
     if (raster_status == RasterStatus::kFailed ||
         raster_status == RasterStatus::kSkipAndRetry) {
       return raster_status;
     }
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+    last_diffed_layer_tree_id_ = frame_damage ? layer_tree.unique_id() : 0;
+    if (frame_damage && frame_damage->GetDamage()) {
+      SurfaceFrame::SubmitInfo submit_info;
+      submit_info.frame_damage = frame_damage->GetDamage()->frame_damage;
+      submit_info.buffer_damage = frame_damage->GetDamage()->buffer_damage;
+      frame->set_submit_info(submit_info);
+    }
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
     if (shared_engine_block_thread_merging_ && raster_thread_merger_ &&
         raster_thread_merger_->IsMerged()) {
       // TODO(73620): Remove when platform views are accounted for.
@@ -516,7 +560,7 @@ static sk_sp<SkData> ScreenshotLayerTreeAsPicture(
   auto frame = compositor_context.ACQUIRE_FRAME(
       nullptr, recorder.getRecordingCanvas(), nullptr,
       root_surface_transformation, false, true, nullptr);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
 
 #if defined(OS_FUCHSIA)
   SkSerialProcs procs = {0};
@@ -584,7 +628,7 @@ sk_sp<SkData> Rasterizer::ScreenshotLayerTreeAsImage(
       surface_context, canvas, nullptr, root_surface_transformation, false,
       true, nullptr);
   canvas->clear(SK_ColorTRANSPARENT);
-  frame->Raster(*tree, true);
+  frame->Raster(*tree, true, nullptr);
   canvas->flush();
 
   // Prepare an image from the surface, this image may potentially be on th GPU.
@@ -668,6 +712,27 @@ void Rasterizer::SetExternalViewEmbedder(
   external_view_embedder_ = view_embedder;
 }
 
+void Rasterizer::EnableAsyncRasterCache(
+    fml::RefPtr<fml::TaskRunner> io_task_runner,
+    fml::WeakPtr<IOManager> io_manager) {
+  compositor_context_->raster_cache().SetAsyncRasterizationDispatcher(
+      [io_task_runner, io_manager](
+          std::function<void(GrDirectContext*)> task) {
+        io_task_runner->PostTask([io_manager, task = std::move(task)]() {
+          if (!io_manager) {
+            task(nullptr);
+            return;
+          }
+          io_manager->GetIsGpuDisabledSyncSwitch()->Execute(
+              fml::SyncSwitch::Handlers()
+                  .SetIfTrue([&task] { task(nullptr); })
+                  .SetIfFalse([&task, &io_manager] {
+                    task(io_manager->GetResourceContext().get());
+                  }));
+        });
+      });
+}
+
 void Rasterizer::FireNextFrameCallbackIfPresent() {
   if (!next_frame_callback_) {
     return;
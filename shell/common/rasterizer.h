@@ -21,6 +21,7 @@
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/time/time_point.h"
+#include "flutter/lib/ui/io_manager.h"
 #include "flutter/lib/ui/snapshot_delegate.h"
 #include "flutter/shell/common/pipeline.h"
 
@@ -89,6 +90,10 @@ class Rasterizer final : public SnapshotDelegate {
     /// is critical that GPU operations are not processed.
     virtual std::shared_ptr<fml::SyncSwitch> GetIsGpuDisabledSyncSwitch()
         const = 0;
+
+    /// The settings used to launch the shell. The rasterizer reads the raster
+    /// cache budget from these.
+    virtual const Settings& GetSettings() const = 0;
   };
 
   //----------------------------------------------------------------------------
@@ -361,6 +366,22 @@ class Rasterizer final : public SnapshotDelegate {
   void SetExternalViewEmbedder(
       const std::shared_ptr<ExternalViewEmbedder>& view_embedder);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Makes the raster cache rasterize pictures on the IO thread
+  ///             with the shared resource context instead of doing so inline
+  ///             during preroll. Pictures are drawn uncached until their
+  ///             cache entry becomes available in a later frame. This is done
+  ///             on shell initialization.
+  ///
+  /// @see        `RasterCache::SetAsyncRasterizationDispatcher`
+  ///
+  /// @param[in]  io_task_runner  The task runner of the IO thread.
+  /// @param[in]  io_manager      The IO manager that owns the resource
+  ///                             context. Only dereferenced on the IO thread.
+  ///
+  void EnableAsyncRasterCache(fml::RefPtr<fml::TaskRunner> io_task_runner,
+                              fml::WeakPtr<IOManager> io_manager);
+
   //----------------------------------------------------------------------------
   /// @brief      Returns a pointer to the compositor context used by this
   ///             rasterizer. This pointer will never be `nullptr`.
@@ -449,6 +470,12 @@ class Rasterizer final : public SnapshotDelegate {
   std::unique_ptr<flutter::CompositorContext> compositor_context_;
   // This is the last successfully rasterized layer tree.
   std::unique_ptr<flutter::LayerTree> last_layer_tree_;
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  // The unique id of the last layer tree whose paint regions were recorded by
+  // a diff, or 0. The next frame can only be diffed against |last_layer_tree_|
+  // if it is this tree.
+  uint64_t last_diffed_layer_tree_id_ = 0;
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
   // Set when we need attempt to rasterize the layer tree again. This layer_tree
   // has not successfully rasterized. This can happen due to the change in the
   // thread configuration. This will be inserted to the front of the pipeline.
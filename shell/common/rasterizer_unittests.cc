@@ -6,9 +6,15 @@
 
 #include "flutter/shell/common/rasterizer.h"
 
+#include "flutter/flow/layers/container_layer.h"
 #include "flutter/shell/common/thread_host.h"
 #include "flutter/testing/testing.h"
 #include "gmock/gmock.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+#if SHELL_ENABLE_SOFTWARE
+#include "flutter/shell/gpu/gpu_surface_software.h"
+#endif  // SHELL_ENABLE_SOFTWARE
 
 using testing::_;
 using testing::ByMove;
@@ -19,12 +25,20 @@ namespace flutter {
 namespace {
 class MockDelegate : public Rasterizer::Delegate {
  public:
+  MockDelegate() {
+    ON_CALL(*this, GetSettings()).WillByDefault(ReturnRef(settings_));
+  }
+
   MOCK_METHOD1(OnFrameRasterized, void(const FrameTiming& frame_timing));
   MOCK_METHOD0(GetFrameBudget, fml::Milliseconds());
   MOCK_CONST_METHOD0(GetLatestFrameTargetTime, fml::TimePoint());
   MOCK_CONST_METHOD0(GetTaskRunners, const TaskRunners&());
   MOCK_CONST_METHOD0(GetIsGpuDisabledSyncSwitch,
                      std::shared_ptr<fml::SyncSwitch>());
+  MOCK_CONST_METHOD0(GetSettings, const Settings&());
+
+ private:
+  Settings settings_;
 };
 
 class MockSurface : public Surface {
@@ -65,6 +79,67 @@ class MockExternalViewEmbedder : public ExternalViewEmbedder {
                     fml::RefPtr<fml::RasterThreadMerger> raster_thread_merger));
   MOCK_METHOD0(SupportsDynamicThreadMerging, bool());
 };
+
+#if SHELL_ENABLE_SOFTWARE
+class TestSoftwareSurfaceDelegate : public GPUSurfaceSoftwareDelegate {
+ public:
+  // |GPUSurfaceSoftwareDelegate|
+  sk_sp<SkSurface> AcquireBackingStore(const SkISize& size) override {
+    if (!backing_store_ || backing_store_->width() != size.width() ||
+        backing_store_->height() != size.height() || !reuse_backing_store_) {
+      backing_store_ = SkSurface::MakeRasterN32Premul(size.width(),
+                                                      size.height());
+    }
+    return backing_store_;
+  }
+
+  // |GPUSurfaceSoftwareDelegate|
+  bool PresentBackingStore(sk_sp<SkSurface> backing_store) override {
+    return true;
+  }
+
+  void set_reuse_backing_store(bool reuse) { reuse_backing_store_ = reuse; }
+
+  sk_sp<SkSurface> backing_store() const { return backing_store_; }
+
+ private:
+  sk_sp<SkSurface> backing_store_;
+  bool reuse_backing_store_ = true;
+};
+#endif  // SHELL_ENABLE_SOFTWARE
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+std::unique_ptr<SurfaceFrame> CreatePartialRepaintFrame(
+    sk_sp<SkSurface> surface,
+    bool supports_partial_repaint,
+    std::vector<SurfaceFrame::SubmitInfo>* submit_infos) {
+  auto frame = std::make_unique<SurfaceFrame>(
+      surface, /*supports_readback=*/true,
+      [submit_infos](const SurfaceFrame& surface_frame, SkCanvas*) {
+        submit_infos->push_back(surface_frame.submit_info());
+        return true;
+      });
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  framebuffer_info.supports_partial_repaint = supports_partial_repaint;
+  if (supports_partial_repaint) {
+    // The surface holds the previously presented frame.
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+  }
+  frame->set_framebuffer_info(framebuffer_info);
+  return frame;
+}
+
+void DrawLayerTree(Rasterizer& rasterizer, const SkISize& frame_size) {
+  auto pipeline = fml::AdoptRef(new Pipeline<LayerTree>(/*depth=*/10));
+  auto layer_tree = std::make_unique<LayerTree>(frame_size,
+                                                /*device_pixel_ratio=*/1.0f);
+  layer_tree->set_root_layer(std::make_shared<ContainerLayer>());
+  bool result = pipeline->Produce().Complete(std::move(layer_tree));
+  EXPECT_TRUE(result);
+  auto no_discard = [](LayerTree&) { return false; };
+  rasterizer.Draw(pipeline, no_discard);
+}
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
 }  // namespace
 
 TEST(RasterizerTest, create) {
@@ -299,4 +374,148 @@ TEST(RasterizerTest, externalViewEmbedderDoesntEndFrameWhenNoSurfaceIsSet) {
   });
   latch.Wait();
 }
+
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+TEST(RasterizerTest, drawWithPartialRepaintReportsDamageSinceLastFrame) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::IO | ThreadHost::Type::UI);
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  TaskRunners task_runners("test",
+                           fml::MessageLoop::GetCurrent().GetTaskRunner(),
+                           fml::MessageLoop::GetCurrent().GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+
+  MockDelegate delegate;
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  EXPECT_CALL(delegate, OnFrameRasterized(_)).Times(2);
+
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<MockSurface>();
+
+  const SkISize frame_size = SkISize::Make(10, 10);
+  auto backing_store = SkSurface::MakeRasterN32Premul(10, 10);
+  std::vector<SurfaceFrame::SubmitInfo> submit_infos;
+  EXPECT_CALL(*surface, AcquireFrame(frame_size))
+      .WillOnce(Return(ByMove(CreatePartialRepaintFrame(
+          backing_store, /*supports_partial_repaint=*/true, &submit_infos))))
+      .WillOnce(Return(ByMove(CreatePartialRepaintFrame(
+          backing_store, /*supports_partial_repaint=*/true, &submit_infos))));
+
+  rasterizer->Setup(std::move(surface));
+  DrawLayerTree(*rasterizer, frame_size);
+  DrawLayerTree(*rasterizer, frame_size);
+
+  ASSERT_EQ(submit_infos.size(), 2u);
+  // There is nothing to diff the first frame against.
+  EXPECT_EQ(submit_infos[0].frame_damage, SkIRect::MakeSize(frame_size));
+  EXPECT_EQ(submit_infos[0].buffer_damage, SkIRect::MakeSize(frame_size));
+  // The second frame is identical to the first one.
+  ASSERT_TRUE(submit_infos[1].frame_damage.has_value());
+  EXPECT_TRUE(submit_infos[1].frame_damage->isEmpty());
+  ASSERT_TRUE(submit_infos[1].buffer_damage.has_value());
+  EXPECT_TRUE(submit_infos[1].buffer_damage->isEmpty());
+}
+
+TEST(RasterizerTest, drawWithPartialRepaintDoesNotDiffAgainstUndiffedFrame) {
+  std::string test_name =
+      ::testing::UnitTest::GetInstance()->current_test_info()->name();
+  ThreadHost thread_host("io.flutter.test." + test_name + ".",
+                         ThreadHost::Type::IO | ThreadHost::Type::UI);
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  TaskRunners task_runners("test",
+                           fml::MessageLoop::GetCurrent().GetTaskRunner(),
+                           fml::MessageLoop::GetCurrent().GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+
+  MockDelegate delegate;
+  EXPECT_CALL(delegate, GetTaskRunners())
+      .WillRepeatedly(ReturnRef(task_runners));
+  EXPECT_CALL(delegate, OnFrameRasterized(_)).Times(3);
+
+  auto rasterizer = std::make_unique<Rasterizer>(delegate);
+  auto surface = std::make_unique<MockSurface>();
+
+  const SkISize frame_size = SkISize::Make(10, 10);
+  auto backing_store = SkSurface::MakeRasterN32Premul(10, 10);
+  std::vector<SurfaceFrame::SubmitInfo> submit_infos;
+  EXPECT_CALL(*surface, AcquireFrame(frame_size))
+      .WillOnce(Return(ByMove(CreatePartialRepaintFrame(
+          backing_store, /*supports_partial_repaint=*/false, &submit_infos))))
+      .WillOnce(Return(ByMove(CreatePartialRepaintFrame(
+          backing_store, /*supports_partial_repaint=*/true, &submit_infos))))
+      .WillOnce(Return(ByMove(CreatePartialRepaintFrame(
+          backing_store, /*supports_partial_repaint=*/true, &submit_infos))));
+
+  rasterizer->Setup(std::move(surface));
+  DrawLayerTree(*rasterizer, frame_size);
+  DrawLayerTree(*rasterizer, frame_size);
+  DrawLayerTree(*rasterizer, frame_size);
+
+  ASSERT_EQ(submit_infos.size(), 3u);
+  // No damage is reported for surfaces without partial repaint.
+  EXPECT_FALSE(submit_infos[0].frame_damage.has_value());
+  EXPECT_FALSE(submit_infos[0].buffer_damage.has_value());
+  // The first frame was not diffed, so the second frame is repainted fully.
+  EXPECT_EQ(submit_infos[1].frame_damage, SkIRect::MakeSize(frame_size));
+  EXPECT_EQ(submit_infos[1].buffer_damage, SkIRect::MakeSize(frame_size));
+  // The second frame was diffed and can be diffed against.
+  ASSERT_TRUE(submit_infos[2].frame_damage.has_value());
+  EXPECT_TRUE(submit_infos[2].frame_damage->isEmpty());
+}
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
+#if SHELL_ENABLE_SOFTWARE
+TEST(GPUSurfaceSoftwareTest, ReportsNoExistingDamageForReusedBackingStore) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  TestSoftwareSurfaceDelegate delegate;
+  GPUSurfaceSoftware surface(&delegate, /*render_to_surface=*/true);
+  const SkISize size = SkISize::Make(10, 10);
+
+  // Nothing has been presented yet.
+  auto frame = surface.AcquireFrame(size);
+  ASSERT_TRUE(frame);
+  EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+  frame->SkiaCanvas()->clear(SK_ColorRED);
+  ASSERT_TRUE(frame->Submit());
+
+  // The backing store still holds the presented frame.
+  frame = surface.AcquireFrame(size);
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  ASSERT_TRUE(frame->framebuffer_info().existing_damage.has_value());
+  EXPECT_TRUE(frame->framebuffer_info().existing_damage->isEmpty());
+  frame->SkiaCanvas()->clear(SK_ColorGREEN);
+  ASSERT_TRUE(frame->Submit());
+
+  // The backing store was drawn into after it was presented.
+  delegate.backing_store()->getCanvas()->clear(SK_ColorBLUE);
+  frame = surface.AcquireFrame(size);
+  ASSERT_TRUE(frame);
+  EXPECT_TRUE(frame->framebuffer_info().supports_partial_repaint);
+  EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+}
+
+TEST(GPUSurfaceSoftwareTest, DoesNotSupportPartialRepaintWithoutReuse) {
+  fml::MessageLoop::EnsureInitializedForCurrentThread();
+  TestSoftwareSurfaceDelegate delegate;
+  delegate.set_reuse_backing_store(false);
+  GPUSurfaceSoftware surface(&delegate, /*render_to_surface=*/true);
+  const SkISize size = SkISize::Make(10, 10);
+
+  for (int i = 0; i < 3; i++) {
+    auto frame = surface.AcquireFrame(size);
+    ASSERT_TRUE(frame);
+    EXPECT_FALSE(frame->framebuffer_info().supports_partial_repaint);
+    EXPECT_FALSE(frame->framebuffer_info().existing_damage.has_value());
+    frame->SkiaCanvas()->clear(SK_ColorRED);
+    ASSERT_TRUE(frame->Submit());
+  }
+}
+#endif  // SHELL_ENABLE_SOFTWARE
 }  // namespace flutter
@@ -0,0 +1,323 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/semantics_viewport_filter.h"
+
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace flutter {
+
+namespace {
+
+// Must match the id of the root node in semantics.dart.
+constexpr int32_t kRootNodeId = 0;
+
+// The parent of a child that its parent no longer lists.
+constexpr int32_t kDetachedNodeId = -2;
+
+// Unlike SkRect::intersects, this accepts empty rects, which are common for
+// semantics nodes that only hold actions.
+bool Overlaps(const SkRect& rect, const SkRect& bounds) {
+  return rect.left() <= bounds.right() && rect.right() >= bounds.left() &&
+         rect.top() <= bounds.bottom() && rect.bottom() >= bounds.top();
+}
+
+}  // namespace
+
+SemanticsViewportFilter::SemanticsViewportFilter() = default;
+
+SemanticsViewportFilter::~SemanticsViewportFilter() = default;
+
+SemanticsNodeUpdates SemanticsViewportFilter::SetViewport(
+    const SkRect& viewport) {
+  if (viewport == viewport_) {
+    return {};
+  }
+  viewport_ = viewport;
+  return Refilter({kRootNodeId}, {});
+}
+
+SemanticsNodeUpdates SemanticsViewportFilter::Filter(
+    SemanticsNodeUpdates updates) {
+  // Detach the previous children of the updated nodes, and attach their
+  // current ones. The children left detached were removed from the tree,
+  // unless the framework moved them to another updated node.
+  std::unordered_set<int32_t> updated;
+  updated.reserve(updates.size());
+  std::vector<int32_t> detached;
+  for (auto& [id, node] : updates) {
+    updated.insert(id);
+    auto found = nodes_.find(id);
+    if (found != nodes_.end()) {
+      for (int32_t child : found->second.childrenInTraversalOrder) {
+        auto parent = parents_.find(child);
+        if (parent != parents_.end() && parent->second == id) {
+          parent->second = kDetachedNodeId;
+          detached.push_back(child);
+        }
+      }
+    }
+    if (node.HasFlag(SemanticsFlags::kIsFocused)) {
+      input_focus_ids_.insert(id);
+    } else {
+      input_focus_ids_.erase(id);
+    }
+    nodes_[id] = std::move(node);
+  }
+  for (int32_t id : updated) {
+    if (id == kRootNodeId) {
+      parents_[id] = -1;
+    }
+    for (int32_t child : nodes_[id].childrenInTraversalOrder) {
+      parents_[child] = id;
+    }
+  }
+  for (int32_t child : detached) {
+    auto parent = parents_.find(child);
+    if (parent != parents_.end() && parent->second == kDetachedNodeId) {
+      RemoveSubtree(child);
+    }
+  }
+  // Drop the new nodes that are not attached to the tree.
+  for (int32_t id : updated) {
+    if (nodes_.find(id) != nodes_.end() &&
+        parents_.find(id) == parents_.end()) {
+      RemoveSubtree(id);
+    }
+  }
+
+  std::unordered_set<int32_t> dirty;
+  for (int32_t id : updated) {
+    if (nodes_.find(id) != nodes_.end()) {
+      dirty.insert(id);
+    }
+  }
+  return Refilter(dirty, updated);
+}
+
+SemanticsNodeUpdates SemanticsViewportFilter::OnSemanticsAction(
+    int32_t node_id,
+    SemanticsAction action) {
+  switch (action) {
+    case SemanticsAction::kDidGainAccessibilityFocus:
+      accessibility_focus_id_ = node_id;
+      break;
+    case SemanticsAction::kDidLoseAccessibilityFocus:
+      if (accessibility_focus_id_ != node_id) {
+        return {};
+      }
+      accessibility_focus_id_ = -1;
+      break;
+    case SemanticsAction::kShowOnScreen:
+      shown_node_id_ = node_id;
+      break;
+    default:
+      return {};
+  }
+  return Refilter({}, {});
+}
+
+void SemanticsViewportFilter::Reset() {
+  nodes_.clear();
+  parents_.clear();
+  transforms_.clear();
+  passed_nodes_.clear();
+  pinned_nodes_.clear();
+  input_focus_ids_.clear();
+  accessibility_focus_id_ = -1;
+  shown_node_id_ = -1;
+}
+
+size_t SemanticsViewportFilter::GetDeferredNodeCount() const {
+  return nodes_.size() - passed_nodes_.size();
+}
+
+SemanticsNodeUpdates SemanticsViewportFilter::Refilter(
+    const std::unordered_set<int32_t>& dirty,
+    const std::unordered_set<int32_t>& updated) {
+  TRACE_EVENT0("flutter", "SemanticsViewportFilter::Refilter");
+  if (nodes_.find(kRootNodeId) == nodes_.end()) {
+    return {};
+  }
+
+  // Focused nodes are kept wherever they are, together with the path to
+  // them. The nodes whose pinning changed are walked again.
+  std::vector<int32_t> focus_ids(input_focus_ids_.begin(),
+                                 input_focus_ids_.end());
+  focus_ids.push_back(accessibility_focus_id_);
+  focus_ids.push_back(shown_node_id_);
+  std::unordered_set<int32_t> pinned;
+  for (int32_t node_id : focus_ids) {
+    while (nodes_.find(node_id) != nodes_.end() &&
+           pinned.insert(node_id).second) {
+      node_id = parents_[node_id];
+    }
+  }
+  std::unordered_set<int32_t> roots = dirty;
+  for (int32_t node_id : pinned) {
+    if (pinned_nodes_.find(node_id) == pinned_nodes_.end()) {
+      roots.insert(node_id);
+    }
+  }
+  for (int32_t node_id : pinned_nodes_) {
+    if (pinned.find(node_id) == pinned.end() &&
+        nodes_.find(node_id) != nodes_.end()) {
+      roots.insert(node_id);
+    }
+  }
+  pinned_nodes_ = std::move(pinned);
+
+  SkRect bounds = SkRect::MakeLargest();
+  if (!viewport_.isEmpty()) {
+    bounds = viewport_.makeOutset(viewport_.width() * kViewportMargin,
+                                  viewport_.height() * kViewportMargin);
+  }
+
+  // Walk the subtrees that are not part of another walked subtree. The
+  // visibility of their parents does not change, so only the children these
+  // parents are passed on with have to be updated.
+  std::unordered_set<int32_t> changed;
+  for (int32_t node_id : roots) {
+    int32_t parent_id = parents_[node_id];
+    bool nested = false;
+    for (int32_t ancestor = parent_id; ancestor != -1;
+         ancestor = parents_[ancestor]) {
+      if (roots.find(ancestor) != roots.end()) {
+        nested = true;
+        break;
+      }
+    }
+    if (nested) {
+      continue;
+    }
+    if (parent_id == -1) {
+      Visit(node_id, SkM44(), true, bounds, changed);
+      continue;
+    }
+    auto parent = passed_nodes_.find(parent_id);
+    Visit(node_id, transforms_[parent_id], parent != passed_nodes_.end(),
+          bounds, changed);
+    if (parent == passed_nodes_.end()) {
+      continue;
+    }
+    std::vector<int32_t> children;
+    for (int32_t child : nodes_[parent_id].childrenInTraversalOrder) {
+      if (passed_nodes_.find(child) != passed_nodes_.end()) {
+        children.push_back(child);
+      }
+    }
+    if (children != parent->second) {
+      parent->second = std::move(children);
+      changed.insert(parent_id);
+    }
+  }
+
+  // Pass on the nodes that are new to the platform view, that changed, or
+  // whose visible children changed. Nodes that are no longer visible are
+  // removed by the last of these.
+  for (int32_t node_id : updated) {
+    if (passed_nodes_.find(node_id) != passed_nodes_.end()) {
+      changed.insert(node_id);
+    }
+  }
+  SemanticsNodeUpdates result;
+  for (int32_t node_id : changed) {
+    const std::vector<int32_t>& children = passed_nodes_[node_id];
+    SemanticsNode node = nodes_[node_id];
+    if (children.size() != node.childrenInTraversalOrder.size()) {
+      node.childrenInTraversalOrder = children;
+      std::vector<int32_t> hit_test_children;
+      for (int32_t child : node.childrenInHitTestOrder) {
+        if (passed_nodes_.find(child) != passed_nodes_.end()) {
+          hit_test_children.push_back(child);
+        }
+      }
+      node.childrenInHitTestOrder = std::move(hit_test_children);
+    }
+    result.emplace(node_id, std::move(node));
+  }
+
+  // A node shown on screen stays pinned until it gets into the viewport, from
+  // where the platform can no longer lose it. It is unpinned by the next
+  // refilter.
+  auto shown = nodes_.find(shown_node_id_);
+  if (shown != nodes_.end() && !viewport_.isEmpty() &&
+      Overlaps(transforms_[shown_node_id_].asM33().mapRect(shown->second.rect),
+               viewport_)) {
+    shown_node_id_ = -1;
+  }
+  return result;
+}
+
+bool SemanticsViewportFilter::Visit(int32_t node_id,
+                                    const SkM44& parent_transform,
+                                    bool parent_visible,
+                                    const SkRect& bounds,
+                                    std::unordered_set<int32_t>& changed) {
+  auto found = nodes_.find(node_id);
+  if (found == nodes_.end()) {
+    return false;
+  }
+  // The transforms of hidden nodes are cached as well, as later updates may
+  // only walk their subtrees.
+  const SemanticsNode& node = found->second;
+  SkM44 transform = parent_transform * node.transform;
+  transforms_[node_id] = transform;
+  bool visible =
+      parent_visible &&
+      (node_id == kRootNodeId ||
+       pinned_nodes_.find(node_id) != pinned_nodes_.end() ||
+       Overlaps(transform.asM33().mapRect(node.rect), bounds));
+  std::vector<int32_t> children;
+  for (int32_t child : node.childrenInTraversalOrder) {
+    if (Visit(child, transform, visible, bounds, changed)) {
+      children.push_back(child);
+    }
+  }
+  if (!visible) {
+    passed_nodes_.erase(node_id);
+    return false;
+  }
+  auto passed = passed_nodes_.find(node_id);
+  if (passed == passed_nodes_.end() || passed->second != children) {
+    passed_nodes_[node_id] = std::move(children);
+    changed.insert(node_id);
+  }
+  return true;
+}
+
+void SemanticsViewportFilter::RemoveSubtree(int32_t node_id) {
+  std::vector<int32_t> stack = {node_id};
+  while (!stack.empty()) {
+    int32_t id = stack.back();
+    stack.pop_back();
+    parents_.erase(id);
+    auto found = nodes_.find(id);
+    if (found == nodes_.end()) {
+      continue;
+    }
+    // Children that the framework moved elsewhere have another parent.
+    for (int32_t child : found->second.childrenInTraversalOrder) {
+      auto parent = parents_.find(child);
+      if (parent != parents_.end() && parent->second == id) {
+        stack.push_back(child);
+      }
+    }
+    nodes_.erase(found);
+    transforms_.erase(id);
+    passed_nodes_.erase(id);
+    pinned_nodes_.erase(id);
+    input_focus_ids_.erase(id);
+    if (accessibility_focus_id_ == id) {
+      accessibility_focus_id_ = -1;
+    }
+    if (shown_node_id_ == id) {
+      shown_node_id_ = -1;
+    }
+  }
+}
+
+}  // namespace flutter
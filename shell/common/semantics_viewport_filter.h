@@ -0,0 +1,125 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_COMMON_SEMANTICS_VIEWPORT_FILTER_H_
+#define FLUTTER_SHELL_COMMON_SEMANTICS_VIEWPORT_FILTER_H_
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/lib/ui/semantics/semantics_node.h"
+#include "third_party/skia/include/core/SkM44.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// Holds back the semantics nodes that are far outside of the viewport from
+/// the platform view.
+///
+/// The filter keeps the latest version of every node of the semantics tree.
+/// Out of the nodes of each update, it only passes on the ones whose bounds
+/// are close to the viewport, and it removes the other nodes from the
+/// children lists it passes on, so that the platform sees a consistent tree
+/// that just ends at the edges of the viewport. Deferred nodes are passed on
+/// once they get close to the viewport, because the framework moved them or
+/// the viewport changed, or when the platform focuses them or asks for them
+/// to be shown on screen.
+///
+/// The root node, the node with input focus and the node with accessibility
+/// focus, along with their ancestors, are always passed on.
+///
+/// The filter caches the parent and the transform of every node, so that an
+/// update only walks the subtrees of the nodes it changes. Only a new
+/// viewport walks the whole tree.
+///
+/// This class is not thread-safe and is used on the UI task runner.
+///
+class SemanticsViewportFilter {
+ public:
+  /// How far outside of the viewport nodes are passed on, as a fraction of
+  /// the viewport size. This keeps the nodes the platform may traverse to
+  /// next, which lets it scroll the content that holds them.
+  static constexpr float kViewportMargin = 1.0f;
+
+  SemanticsViewportFilter();
+
+  ~SemanticsViewportFilter();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the viewport in physical pixels, the coordinate space of
+  ///             the parent of the root semantics node. Nodes are not
+  ///             filtered until a non-empty viewport is set.
+  ///
+  /// @return     The updates for the nodes that the new viewport brings in or
+  ///             out of view.
+  ///
+  SemanticsNodeUpdates SetViewport(const SkRect& viewport);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Applies a semantics update from the framework.
+  ///
+  /// @return     The part of the update, and of the nodes deferred before,
+  ///             that should be passed on to the platform view.
+  ///
+  SemanticsNodeUpdates Filter(SemanticsNodeUpdates updates);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Notes a semantics action dispatched by the platform. The
+  ///             target of accessibility focus or of a request to be shown on
+  ///             screen is passed on even if it is outside of the viewport.
+  ///
+  /// @return     The updates for the nodes that this materializes.
+  ///
+  SemanticsNodeUpdates OnSemanticsAction(int32_t node_id,
+                                         SemanticsAction action);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Forgets the semantics tree, as the framework sends it anew
+  ///             once semantics are enabled again.
+  ///
+  void Reset();
+
+  /// The number of nodes that are known but were not passed on.
+  size_t GetDeferredNodeCount() const;
+
+ private:
+  // The latest version of every node of the tree.
+  std::unordered_map<int32_t, SemanticsNode> nodes_;
+  // The parent of every node of the tree, -1 for the root node.
+  std::unordered_map<int32_t, int32_t> parents_;
+  // The transform of every node of the tree to the coordinate space of the
+  // viewport, as of the last walk of its subtree.
+  std::unordered_map<int32_t, SkM44> transforms_;
+  // The nodes passed on to the platform view, with the children they were
+  // passed on with.
+  std::unordered_map<int32_t, std::vector<int32_t>> passed_nodes_;
+  // The nodes that are passed on wherever they are.
+  std::unordered_set<int32_t> pinned_nodes_;
+  std::unordered_set<int32_t> input_focus_ids_;
+  SkRect viewport_ = SkRect::MakeEmpty();
+  int32_t accessibility_focus_id_ = -1;
+  int32_t shown_node_id_ = -1;
+
+  // Walks the subtrees of |dirty| and of the nodes that got pinned or
+  // unpinned, and returns the updates for the platform view.
+  SemanticsNodeUpdates Refilter(const std::unordered_set<int32_t>& dirty,
+                                const std::unordered_set<int32_t>& updated);
+
+  bool Visit(int32_t node_id,
+             const SkM44& parent_transform,
+             bool parent_visible,
+             const SkRect& bounds,
+             std::unordered_set<int32_t>& changed);
+
+  void RemoveSubtree(int32_t node_id);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(SemanticsViewportFilter);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_COMMON_SEMANTICS_VIEWPORT_FILTER_H_
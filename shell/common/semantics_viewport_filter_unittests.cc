@@ -0,0 +1,245 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/common/semantics_viewport_filter.h"
+
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+constexpr int kItemCount = 20;
+constexpr float kItemHeight = 100;
+
+// A list item at |offset| from the top of the list.
+SemanticsNode CreateItem(int32_t id, float offset) {
+  SemanticsNode node;
+  node.id = id;
+  node.label = "item " + std::to_string(id);
+  node.rect = SkRect::MakeWH(100, kItemHeight);
+  node.transform = SkM44::Translate(0, offset);
+  return node;
+}
+
+// A list of |kItemCount| items, scrolled by |scroll_offset|.
+SemanticsNodeUpdates CreateList(float scroll_offset) {
+  SemanticsNodeUpdates updates;
+  SemanticsNode root;
+  root.id = 0;
+  root.rect = SkRect::MakeWH(100, 200);
+  for (int32_t id = 1; id <= kItemCount; id++) {
+    root.childrenInTraversalOrder.push_back(id);
+    root.childrenInHitTestOrder.push_back(id);
+    updates[id] = CreateItem(id, (id - 1) * kItemHeight - scroll_offset);
+  }
+  updates[0] = root;
+  return updates;
+}
+
+}  // namespace
+
+TEST(SemanticsViewportFilterTest, PassesAllNodesWithoutViewport) {
+  SemanticsViewportFilter filter;
+  SemanticsNodeUpdates result = filter.Filter(CreateList(0));
+  EXPECT_EQ(result.size(), size_t{kItemCount + 1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder.size(), size_t{kItemCount});
+  EXPECT_EQ(filter.GetDeferredNodeCount(), size_t{0});
+}
+
+TEST(SemanticsViewportFilterTest, DefersNodesOutsideOfViewport) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  SemanticsNodeUpdates result = filter.Filter(CreateList(0));
+
+  // The viewport and one viewport size around it hold items 1 to 5.
+  std::vector<int32_t> expected_children = {1, 2, 3, 4, 5};
+  EXPECT_EQ(result.size(), size_t{6});
+  EXPECT_EQ(result[0].childrenInTraversalOrder, expected_children);
+  EXPECT_EQ(result[0].childrenInHitTestOrder, expected_children);
+  EXPECT_EQ(filter.GetDeferredNodeCount(), size_t{kItemCount - 5});
+
+  // Changes to deferred nodes are held back as well.
+  SemanticsNodeUpdates update;
+  update[10] = CreateItem(10, 9 * kItemHeight);
+  update[10].label = "changed";
+  EXPECT_TRUE(filter.Filter(std::move(update)).empty());
+
+  // Resending unchanged visible nodes passes them on again.
+  SemanticsNodeUpdates resend;
+  resend[1] = CreateItem(1, 0);
+  result = filter.Filter(std::move(resend));
+  EXPECT_EQ(result.size(), size_t{1});
+  EXPECT_EQ(result.count(1), size_t{1});
+}
+
+TEST(SemanticsViewportFilterTest, PassesNodesScrolledIntoView) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  filter.Filter(CreateList(0));
+
+  // The framework only sends the items when it scrolls them.
+  SemanticsNodeUpdates updates = CreateList(500);
+  updates.erase(0);
+  SemanticsNodeUpdates result = filter.Filter(std::move(updates));
+
+  std::vector<int32_t> expected_children = {3, 4, 5, 6, 7, 8, 9, 10};
+  ASSERT_EQ(result.count(0), size_t{1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder, expected_children);
+  for (int32_t id : expected_children) {
+    EXPECT_EQ(result.count(id), size_t{1});
+  }
+  EXPECT_EQ(result.size(), size_t{9});
+  EXPECT_EQ(result[10].label, "item 10");
+}
+
+TEST(SemanticsViewportFilterTest, PassesNodesBroughtIntoViewByViewport) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  filter.Filter(CreateList(0));
+
+  SemanticsNodeUpdates result = filter.SetViewport(SkRect::MakeWH(100, 400));
+  std::vector<int32_t> expected_children = {1, 2, 3, 4, 5, 6, 7, 8, 9};
+  ASSERT_EQ(result.count(0), size_t{1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder, expected_children);
+  EXPECT_EQ(result.size(), size_t{5});
+
+  EXPECT_TRUE(filter.SetViewport(SkRect::MakeWH(100, 400)).empty());
+}
+
+TEST(SemanticsViewportFilterTest, KeepsFocusedNodes) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  filter.Filter(CreateList(0));
+  EXPECT_TRUE(
+      filter.OnSemanticsAction(2, SemanticsAction::kDidGainAccessibilityFocus)
+          .empty());
+
+  SemanticsNodeUpdates updates = CreateList(1500);
+  updates.erase(0);
+  SemanticsNodeUpdates result = filter.Filter(std::move(updates));
+  std::vector<int32_t> expected_children = {2,  13, 14, 15,
+                                            16, 17, 18, 19, 20};
+  ASSERT_EQ(result.count(0), size_t{1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder, expected_children);
+
+  // Losing focus lets the node go.
+  result =
+      filter.OnSemanticsAction(2, SemanticsAction::kDidLoseAccessibilityFocus);
+  ASSERT_EQ(result.count(0), size_t{1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder.front(), 13);
+  EXPECT_EQ(result.size(), size_t{1});
+}
+
+TEST(SemanticsViewportFilterTest, MaterializesNodesShownOnScreen) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  filter.Filter(CreateList(0));
+
+  SemanticsNodeUpdates result =
+      filter.OnSemanticsAction(12, SemanticsAction::kShowOnScreen);
+  std::vector<int32_t> expected_children = {1, 2, 3, 4, 5, 12};
+  EXPECT_EQ(result.size(), size_t{2});
+  ASSERT_EQ(result.count(12), size_t{1});
+  EXPECT_EQ(result[12].label, "item 12");
+  EXPECT_EQ(result[0].childrenInTraversalOrder, expected_children);
+}
+
+TEST(SemanticsViewportFilterTest, UnpinsShownNodesOnceInViewport) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  filter.Filter(CreateList(0));
+  filter.OnSemanticsAction(12, SemanticsAction::kShowOnScreen);
+
+  // The framework scrolls the node into view.
+  SemanticsNodeUpdates updates = CreateList(1100);
+  updates.erase(0);
+  SemanticsNodeUpdates result = filter.Filter(std::move(updates));
+  ASSERT_EQ(result.count(0), size_t{1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder.front(), 9);
+
+  // Scrolling back no longer keeps it.
+  updates = CreateList(0);
+  updates.erase(0);
+  result = filter.Filter(std::move(updates));
+  std::vector<int32_t> expected_children = {1, 2, 3, 4, 5};
+  ASSERT_EQ(result.count(0), size_t{1});
+  EXPECT_EQ(result[0].childrenInTraversalOrder, expected_children);
+}
+
+TEST(SemanticsViewportFilterTest, UpdatesChildrenOfDeferredNodes) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  SemanticsNodeUpdates list = CreateList(0);
+  list[10].childrenInTraversalOrder = {30};
+  list[10].childrenInHitTestOrder = {30};
+  list[30] = CreateItem(30, 0);
+  filter.Filter(std::move(list));
+
+  // Only the subtree of the child is walked, from the cached position of its
+  // deferred parent.
+  SemanticsNodeUpdates update;
+  update[30] = CreateItem(30, 0);
+  update[30].label = "changed";
+  EXPECT_TRUE(filter.Filter(std::move(update)).empty());
+
+  SemanticsNodeUpdates updates = CreateList(900);
+  updates.erase(0);
+  updates[10].childrenInTraversalOrder = {30};
+  updates[10].childrenInHitTestOrder = {30};
+  SemanticsNodeUpdates result = filter.Filter(std::move(updates));
+  ASSERT_EQ(result.count(30), size_t{1});
+  EXPECT_EQ(result[30].label, "changed");
+  EXPECT_EQ(result[10].childrenInTraversalOrder, std::vector<int32_t>{30});
+}
+
+TEST(SemanticsViewportFilterTest, KeepsNodesMovedToAnotherParent) {
+  SemanticsViewportFilter filter;
+  SemanticsNodeUpdates list = CreateList(0);
+  list[1].childrenInTraversalOrder = {30};
+  list[1].childrenInHitTestOrder = {30};
+  list[30] = CreateItem(30, 0);
+  filter.Filter(std::move(list));
+
+  SemanticsNodeUpdates updates;
+  updates[1] = CreateItem(1, 0);
+  updates[2] = CreateItem(2, kItemHeight);
+  updates[2].childrenInTraversalOrder = {30};
+  updates[2].childrenInHitTestOrder = {30};
+  SemanticsNodeUpdates result = filter.Filter(std::move(updates));
+  EXPECT_EQ(result.size(), size_t{2});
+  EXPECT_TRUE(result[1].childrenInTraversalOrder.empty());
+  EXPECT_EQ(result[2].childrenInTraversalOrder, std::vector<int32_t>{30});
+  EXPECT_EQ(filter.GetDeferredNodeCount(), size_t{0});
+
+  // Removing it from its new parent drops it.
+  updates.clear();
+  updates[2] = CreateItem(2, kItemHeight);
+  filter.Filter(std::move(updates));
+  SemanticsNodeUpdates show = CreateList(0);
+  EXPECT_EQ(filter.Filter(std::move(show)).count(30), size_t{0});
+}
+
+TEST(SemanticsViewportFilterTest, ForgetsRemovedNodes) {
+  SemanticsViewportFilter filter;
+  filter.SetViewport(SkRect::MakeWH(100, 200));
+  SemanticsNodeUpdates list = CreateList(0);
+  SemanticsNode root = list[0];
+  filter.Filter(std::move(list));
+
+  root.childrenInTraversalOrder.resize(10);
+  root.childrenInHitTestOrder.resize(10);
+  SemanticsNodeUpdates updates;
+  updates[0] = root;
+  EXPECT_EQ(filter.Filter(std::move(updates)).size(), size_t{1});
+  EXPECT_EQ(filter.GetDeferredNodeCount(), size_t{5});
+
+  filter.Reset();
+  EXPECT_EQ(filter.GetDeferredNodeCount(), size_t{0});
+  EXPECT_EQ(filter.Filter(CreateList(0)).size(), size_t{6});
+}
+
+}  // namespace testing
+}  // namespace flutter
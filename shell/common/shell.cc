@@ -20,6 +20,7 @@
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/fml/unique_fd.h"
+#include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
@@ -130,6 +131,11 @@ void PerformInitializationTasks(Settings& settings) {
   });
 
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
+
+  if (settings.text_layout_cache_max_bytes > 0) {
+    FontCollection::SetLayoutCacheMaxBytes(
+        settings.text_layout_cache_max_bytes);
+  }
 }
 
 }  // namespace
@@ -283,6 +289,7 @@ std::unique_ptr<Shell> Shell::CreateShellOnPlatformThread(
         // from the platform.
         auto animator = std::make_unique<Animator>(*shell, task_runners,
                                                    std::move(vsync_waiter));
+        animator->SetFrameLatencyMode(shell->GetSettings().frame_latency_mode);
 
         engine_promise.set_value(
             on_create_engine(*shell,                          //
@@ -427,6 +434,11 @@ Shell::Shell(DartVMRef vm,
           task_runners_.GetRasterTaskRunner(),
           std::bind(&Shell::OnServiceProtocolEstimateRasterCacheMemory, this,
                     std::placeholders::_1, std::placeholders::_2)};
+  service_protocol_handlers_
+      [ServiceProtocol::kGetLayerDiffStatisticsExtensionName] = {
+          task_runners_.GetRasterTaskRunner(),
+          std::bind(&Shell::OnServiceProtocolGetLayerDiffStatistics, this,
+                    std::placeholders::_1, std::placeholders::_2)};
 }
 
 Shell::~Shell() {
@@ -554,6 +566,19 @@ void Shell::NotifyLowMemoryWarning() const {
   // to purge them.
 }
 
+void Shell::SetFrameLatencyMode(FrameLatencyMode mode) {
+  task_runners_.GetUITaskRunner()->PostTask(
+      [engine = weak_engine_, mode]() {
+        if (engine) {
+          engine->SetFrameLatencyMode(mode);
+        }
+      });
+}
+
+const FrameLatencyStats& Shell::GetFrameLatencyStats() const {
+  return frame_latency_stats_;
+}
+
 void Shell::RunEngine(RunConfiguration run_configuration) {
   RunEngine(std::move(run_configuration), nullptr);
 }
@@ -647,6 +672,11 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   auto view_embedder = platform_view_->CreateExternalViewEmbedder();
   rasterizer_->SetExternalViewEmbedder(view_embedder);
 
+  if (settings_.enable_async_raster_cache) {
+    rasterizer_->EnableAsyncRasterCache(task_runners_.GetIOTaskRunner(),
+                                        io_manager_->GetWeakIOManager());
+  }
+
   // The weak ptr must be generated in the platform thread which owns the unique
   // ptr.
   weak_engine_ = engine_->GetWeakPtr();
@@ -961,6 +991,20 @@ void Shell::OnPlatformViewDispatchPlatformMessage(
       });
 }
 
+// |PlatformView::Delegate|
+void Shell::OnPlatformViewDispatchPlatformMessages(
+    std::vector<fml::RefPtr<PlatformMessage>> messages) {
+  FML_DCHECK(is_setup_);
+  FML_DCHECK(task_runners_.GetPlatformTaskRunner()->RunsTasksOnCurrentThread());
+
+  task_runners_.GetUITaskRunner()->PostTask(
+      [engine = weak_engine_, messages = std::move(messages)]() mutable {
+        if (engine) {
+          engine->DispatchPlatformMessages(std::move(messages));
+        }
+      });
+}
+
 // |PlatformView::Delegate|
 void Shell::OnPlatformViewDispatchPointerDataPacket(
     std::unique_ptr<PointerDataPacket> packet) {
@@ -1186,6 +1230,11 @@ void Shell::OnAnimatorDrawLastLayerTree() {
       });
 }
 
+// |Animator::Delegate|
+fml::TimeDelta Shell::GetPredictedFrameDuration() {
+  return frame_latency_stats_.GetPredictedFrameDuration();
+}
+
 // |Engine::Delegate|
 void Shell::OnEngineUpdateSemantics(SemanticsNodeUpdates update,
                                     CustomAccessibilityActionUpdates actions) {
@@ -1224,7 +1273,8 @@ void Shell::HandleEngineSkiaMessage(fml::RefPtr<PlatformMessage> message) {
   const auto& data = message->data();
 
   rapidjson::Document document;
-  document.Parse(reinterpret_cast<const char*>(data.data()), data.size());
+  document.Parse(reinterpret_cast<const char*>(data.GetMapping()),
+                 data.GetSize());
   if (document.HasParseError() || !document.IsObject())
     return;
   auto root = document.GetObject();
@@ -1362,6 +1412,9 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
     settings_.frame_rasterized_callback(timing);
   }
 
+  frame_latency_stats_.AddFrameTiming(timing);
+  frame_latency_stats_.TraceStatsToTimeline();
+
   if (!needs_report_timings_) {
     return;
   }
@@ -1675,6 +1728,29 @@ bool Shell::OnServiceProtocolEstimateRasterCacheMemory(
   return true;
 }
 
+// Service protocol handler
+bool Shell::OnServiceProtocolGetLayerDiffStatistics(
+    const ServiceProtocol::Handler::ServiceProtocolMap& params,
+    rapidjson::Document* response) {
+  FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
+  response->SetObject();
+  response->AddMember("type", "LayerDiffStatistics", response->GetAllocator());
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+  const auto& history = rasterizer_->compositor_context()->diff_history();
+  response->AddMember<uint64_t>("trackedLayers", history.tracked_layer_count(),
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("deepCompares", history.deep_compare_count(),
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("deepComparesEqual",
+                                history.deep_compare_equal_count(),
+                                response->GetAllocator());
+  response->AddMember<uint64_t>("skippedDeepCompares",
+                                history.skipped_deep_compare_count(),
+                                response->GetAllocator());
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+  return true;
+}
+
 // Service protocol handler
 bool Shell::OnServiceProtocolSetAssetBundlePath(
     const ServiceProtocol::Handler::ServiceProtocolMap& params,
@@ -35,6 +35,7 @@
 #include "flutter/shell/common/animator.h"
 #include "flutter/shell/common/display_manager.h"
 #include "flutter/shell/common/engine.h"
+#include "flutter/shell/common/frame_latency_stats.h"
 #include "flutter/shell/common/platform_view.h"
 #include "flutter/shell/common/rasterizer.h"
 #include "flutter/shell/common/shell_io_manager.h"
@@ -200,7 +201,7 @@ class Shell final : public PlatformView::Delegate,
   //------------------------------------------------------------------------------
   /// @return     The settings used to launch this shell.
   ///
-  const Settings& GetSettings() const;
+  const Settings& GetSettings() const override;
 
   //------------------------------------------------------------------------------
   /// @brief      If callers wish to interact directly with any shell
@@ -259,6 +260,21 @@ class Shell final : public PlatformView::Delegate,
   ///             the rasterizer cache is purged.
   void NotifyLowMemoryWarning() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Used by embedders to change how frames trade latency for
+  ///             throughput at runtime. The initial mode comes from the
+  ///             settings.
+  ///
+  /// @param[in]  mode  The frame latency mode.
+  ///
+  void SetFrameLatencyMode(FrameLatencyMode mode);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The histograms of the build, raster and vsync-to-raster
+  ///             durations of the frames rasterized by this shell.
+  ///
+  const FrameLatencyStats& GetFrameLatencyStats() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Used by embedders to check if all shell subcomponents are
   ///             initialized. It is the embedder's responsibility to make this
@@ -397,6 +413,10 @@ class Shell final : public PlatformView::Delegate,
   // here for easier conversions to Dart objects.
   std::vector<int64_t> unreported_timings_;
 
+  // Thread-safe. Fed on the raster thread and used by the animator to predict
+  // frame durations on the UI thread.
+  FrameLatencyStats frame_latency_stats_;
+
   /// Manages the displays. This class is thread safe, can be accessed from any
   /// of the threads.
   std::unique_ptr<DisplayManager> display_manager_;
@@ -461,6 +481,10 @@ class Shell final : public PlatformView::Delegate,
   void OnPlatformViewDispatchPlatformMessage(
       fml::RefPtr<PlatformMessage> message) override;
 
+  // |PlatformView::Delegate|
+  void OnPlatformViewDispatchPlatformMessages(
+      std::vector<fml::RefPtr<PlatformMessage>> messages) override;
+
   // |PlatformView::Delegate|
   void OnPlatformViewDispatchPointerDataPacket(
       std::unique_ptr<PointerDataPacket> packet) override;
@@ -523,6 +547,9 @@ class Shell final : public PlatformView::Delegate,
   // |Animator::Delegate|
   void OnAnimatorDrawLastLayerTree() override;
 
+  // |Animator::Delegate|
+  fml::TimeDelta GetPredictedFrameDuration() override;
+
   // |Engine::Delegate|
   void OnEngineUpdateSemantics(
       SemanticsNodeUpdates update,
@@ -619,6 +646,14 @@ class Shell final : public PlatformView::Delegate,
       const ServiceProtocol::Handler::ServiceProtocolMap& params,
       rapidjson::Document* response);
 
+  // Service protocol handler
+  //
+  // Reports the cross-frame statistics of the layer tree diffing used for
+  // partial repaint.
+  bool OnServiceProtocolGetLayerDiffStatistics(
+      const ServiceProtocol::Handler::ServiceProtocolMap& params,
+      rapidjson::Document* response);
+
   // Creates an asset bundle from the original settings asset path or
   // directory.
   std::unique_ptr<DirectoryAssetBundle> RestoreOriginalAssetResolver();
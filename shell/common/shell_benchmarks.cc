@@ -5,14 +5,91 @@
 #include "flutter/shell/common/shell.h"
 
 #include "flutter/benchmarking/benchmarking.h"
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/common/graphics/persistent_cache_file.h"
+#include "flutter/flow/layers/physical_shape_layer.h"
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/waitable_event.h"
+#include "flutter/lib/ui/window/platform_message_response.h"
+#include "flutter/lib/ui/window/pointer_data_packet_converter.h"
 #include "flutter/runtime/dart_vm.h"
+#include "flutter/shell/common/pointer_data_dispatcher.h"
+#include "flutter/shell/common/run_configuration.h"
+#include "flutter/shell/common/shell_test.h"
+#include "flutter/shell/common/shell_test_platform_view.h"
 #include "flutter/shell/common/thread_host.h"
+#include "flutter/shell/common/vsync_waiter_fallback.h"
+#include "flutter/shell/version/version.h"
 #include "flutter/testing/elf_loader.h"
 #include "flutter/testing/testing.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContextOptions.h"
+
+#ifdef SHELL_ENABLE_GL
+#include "flutter/testing/test_gl_surface.h"
+#endif  // SHELL_ENABLE_GL
 
 namespace flutter {
 
+static Settings CreateBenchmarkSettings(
+    const fml::UniqueFD& assets_dir,
+    testing::ELFAOTSymbols& aot_symbols) {
+  Settings settings = {};
+  settings.task_observer_add = [](intptr_t, fml::closure) {};
+  settings.task_observer_remove = [](intptr_t) {};
+
+  if (DartVM::IsRunningPrecompiledCode()) {
+    aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary();
+    FML_CHECK(testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
+        << "Could not setup settings with AOT symbols.";
+  } else {
+    settings.application_kernels = [&assets_dir]() {
+      std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
+      kernel_mappings.emplace_back(
+          fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
+      return kernel_mappings;
+    };
+  }
+  return settings;
+}
+
+static std::unique_ptr<ThreadHost> CreateBenchmarkThreadHost() {
+  return std::make_unique<ThreadHost>(
+      "io.flutter.bench.", ThreadHost::Type::Platform |
+                               ThreadHost::Type::RASTER |
+                               ThreadHost::Type::IO | ThreadHost::Type::UI);
+}
+
+static std::unique_ptr<Shell> CreateBenchmarkShell(ThreadHost& thread_host,
+                                                   const Settings& settings) {
+  TaskRunners task_runners("test",
+                           thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+
+  return Shell::Create(
+      flutter::PlatformData(), std::move(task_runners), settings,
+      [](Shell& shell) {
+        return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
+      },
+      [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+}
+
+static void DestroyBenchmarkShell(std::unique_ptr<Shell> shell,
+                                  ThreadHost& thread_host) {
+  // Shutdown must occur synchronously on the platform thread.
+  fml::AutoResetWaitableEvent latch;
+  fml::TaskRunner::RunNowOrPostTask(
+      thread_host.platform_thread->GetTaskRunner(),
+      [&shell, &latch]() mutable {
+        shell.reset();
+        latch.Signal();
+      });
+  latch.Wait();
+}
+
 static void StartupAndShutdownShell(benchmark::State& state,
                                     bool measure_startup,
                                     bool measure_shutdown) {
@@ -24,41 +101,9 @@ static void StartupAndShutdownShell(benchmark::State& state,
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_startup);
-    Settings settings = {};
-    settings.task_observer_add = [](intptr_t, fml::closure) {};
-    settings.task_observer_remove = [](intptr_t) {};
-
-    if (DartVM::IsRunningPrecompiledCode()) {
-      aot_symbols = testing::LoadELFSymbolFromFixturesIfNeccessary();
-      FML_CHECK(
-          testing::PrepareSettingsForAOTWithSymbols(settings, aot_symbols))
-          << "Could not setup settings with AOT symbols.";
-    } else {
-      settings.application_kernels = [&]() {
-        std::vector<std::unique_ptr<const fml::Mapping>> kernel_mappings;
-        kernel_mappings.emplace_back(
-            fml::FileMapping::CreateReadOnly(assets_dir, "kernel_blob.bin"));
-        return kernel_mappings;
-      };
-    }
-
-    thread_host = std::make_unique<ThreadHost>(
-        "io.flutter.bench.", ThreadHost::Type::Platform |
-                                 ThreadHost::Type::RASTER |
-                                 ThreadHost::Type::IO | ThreadHost::Type::UI);
-
-    TaskRunners task_runners("test",
-                             thread_host->platform_thread->GetTaskRunner(),
-                             thread_host->raster_thread->GetTaskRunner(),
-                             thread_host->ui_thread->GetTaskRunner(),
-                             thread_host->io_thread->GetTaskRunner());
-
-    shell = Shell::Create(
-        flutter::PlatformData(), std::move(task_runners), settings,
-        [](Shell& shell) {
-          return std::make_unique<PlatformView>(shell, shell.GetTaskRunners());
-        },
-        [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+    Settings settings = CreateBenchmarkSettings(assets_dir, aot_symbols);
+    thread_host = CreateBenchmarkThreadHost();
+    shell = CreateBenchmarkShell(*thread_host, settings);
   }
 
   FML_CHECK(shell);
@@ -80,19 +125,9 @@ static void StartupAndShutdownShell(benchmark::State& state,
 
   {
     benchmarking::ScopedPauseTiming pause(state, !measure_shutdown);
-    // Shutdown must occur synchronously on the platform thread.
-    fml::AutoResetWaitableEvent latch;
-    fml::TaskRunner::RunNowOrPostTask(
-        thread_host->platform_thread->GetTaskRunner(),
-        [&shell, &latch]() mutable {
-          shell.reset();
-          latch.Signal();
-        });
-    latch.Wait();
+    DestroyBenchmarkShell(std::move(shell), *thread_host);
     thread_host.reset();
   }
-
-  FML_CHECK(!shell);
 }
 
 static void BM_ShellInitialization(benchmark::State& state) {
@@ -119,4 +154,467 @@ static void BM_ShellInitializationAndShutdown(benchmark::State& state) {
 
 BENCHMARK(BM_ShellInitializationAndShutdown);
 
+namespace {
+
+// Signals a latch when the application responds to a message.
+class SignalingPlatformMessageResponse : public PlatformMessageResponse {
+ public:
+  explicit SignalingPlatformMessageResponse(fml::AutoResetWaitableEvent& latch)
+      : latch_(latch) {}
+
+  // |PlatformMessageResponse|
+  void Complete(std::unique_ptr<fml::Mapping> data) override {
+    is_complete_ = true;
+    latch_.Signal();
+  }
+
+  // |PlatformMessageResponse|
+  void CompleteEmpty() override {
+    is_complete_ = true;
+    latch_.Signal();
+  }
+
+ private:
+  fml::AutoResetWaitableEvent& latch_;
+};
+
+}  // namespace
+
+// Measures the cost of delivering a burst of small platform messages from the
+// platform thread to a message handler in the root isolate, either one task
+// and isolate entry per message or all of them batched. Reports the time per
+// message.
+static void BM_PlatformMessageDispatch(benchmark::State& state,
+                                       bool batched) {
+  const size_t message_count = state.range(0);
+
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateBenchmarkSettings(assets_dir, aot_symbols);
+  auto thread_host = CreateBenchmarkThreadHost();
+  auto shell = CreateBenchmarkShell(*thread_host, settings);
+  FML_CHECK(shell);
+
+  {
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("platformMessagesMain");
+    fml::AutoResetWaitableEvent latch;
+    fml::TaskRunner::RunNowOrPostTask(
+        thread_host->platform_thread->GetTaskRunner(),
+        [&shell, &latch, &configuration]() {
+          shell->RunEngine(std::move(configuration),
+                           [&latch](Engine::RunStatus status) {
+                             FML_CHECK(status == Engine::RunStatus::Success);
+                             latch.Signal();
+                           });
+        });
+    latch.Wait();
+  }
+
+  const std::vector<uint8_t> payload(16, 0x42);
+  fml::AutoResetWaitableEvent done;
+
+  while (state.KeepRunning()) {
+    auto done_response =
+        fml::MakeRefCounted<SignalingPlatformMessageResponse>(done);
+    fml::TaskRunner::RunNowOrPostTask(
+        thread_host->platform_thread->GetTaskRunner(), [&]() {
+          auto platform_view = shell->GetPlatformView();
+          std::vector<fml::RefPtr<PlatformMessage>> messages;
+          messages.reserve(message_count + 1);
+          for (size_t i = 0; i < message_count; i++) {
+            messages.push_back(fml::MakeRefCounted<PlatformMessage>(
+                "test/sensor", payload, nullptr));
+          }
+          messages.push_back(
+              fml::MakeRefCounted<PlatformMessage>("test/done", done_response));
+          if (batched) {
+            platform_view->DispatchPlatformMessages(std::move(messages));
+          } else {
+            for (auto& message : messages) {
+              platform_view->DispatchPlatformMessage(std::move(message));
+            }
+          }
+        });
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * message_count);
+
+  DestroyBenchmarkShell(std::move(shell), *thread_host);
+}
+
+BENCHMARK_CAPTURE(BM_PlatformMessageDispatch, individual, false)
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1000)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_PlatformMessageDispatch, batched, true)
+    ->Arg(1)
+    ->Arg(100)
+    ->Arg(1000)
+    ->UseRealTime();
+
+// Creates a raw packet of a drag with |move_count| moves, as an embedder would
+// send it.
+static std::unique_ptr<PointerDataPacket> CreateDragPacket(size_t move_count) {
+  auto packet = std::make_unique<PointerDataPacket>(move_count + 2);
+  for (size_t i = 0; i < move_count + 2; i++) {
+    PointerData data;
+    data.Clear();
+    data.time_stamp = 1600000000000000 + i * 1000;
+    data.kind = PointerData::DeviceKind::kTouch;
+    data.change = PointerData::Change::kMove;
+    data.buttons = kPointerButtonTouchContact;
+    if (i == 0) {
+      data.change = PointerData::Change::kDown;
+    } else if (i == move_count + 1) {
+      data.change = PointerData::Change::kUp;
+      data.buttons = 0;
+    }
+    data.physical_x = 100.0f + i * 2.5f;
+    data.physical_y = 300.0f + i * 1.25f;
+    data.pressure = 1.0;
+    data.pressure_max = 1.0;
+    data.size = 0.04f;
+    data.radius_major = 12.5f;
+    data.radius_minor = 12.5f;
+    packet->SetPointerData(i, data);
+  }
+  return packet;
+}
+
+// Measures the time the UI thread takes to hand a packet of drag events to the
+// framework and decode it into PointerData objects, with the fixed or the
+// packed layout. Reports the bytes per event of the layout.
+static void BM_PointerDataPacketDecode(benchmark::State& state, bool packed) {
+  const size_t move_count = state.range(0);
+
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  Settings settings = CreateBenchmarkSettings(assets_dir, aot_symbols);
+  settings.pack_pointer_data = packed;
+  auto thread_host = CreateBenchmarkThreadHost();
+  auto shell = CreateBenchmarkShell(*thread_host, settings);
+  FML_CHECK(shell);
+
+  auto configuration = RunConfiguration::InferFromSettings(settings);
+  configuration.SetEntrypoint("pointerDataPacketsMain");
+  testing::ShellTest::RunEngine(shell.get(), std::move(configuration));
+
+  {
+    PointerDataPacketConverter converter;
+    auto converted = converter.Convert(CreateDragPacket(move_count));
+    const size_t event_count = converted->data().size() / sizeof(PointerData);
+    size_t bytes = converted->data().size();
+    if (packed) {
+      bytes = PointerDataPacketConverter::Pack(*converted).size();
+    }
+    state.counters["bytes_per_event"] =
+        static_cast<double>(bytes) / event_count;
+  }
+
+  fml::AutoResetWaitableEvent done;
+  while (state.KeepRunning()) {
+    fml::TaskRunner::RunNowOrPostTask(
+        thread_host->platform_thread->GetTaskRunner(), [&]() {
+          shell->GetPlatformView()->DispatchPointerDataPacket(
+              CreateDragPacket(move_count));
+          // The packet is dispatched by a task posted to the UI thread just
+          // before this one.
+          thread_host->ui_thread->GetTaskRunner()->PostTask(
+              [&done]() { done.Signal(); });
+        });
+    done.Wait();
+  }
+  state.SetItemsProcessed(state.iterations() * (move_count + 2));
+
+  DestroyBenchmarkShell(std::move(shell), *thread_host);
+}
+
+BENCHMARK_CAPTURE(BM_PointerDataPacketDecode, fixed, false)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->UseRealTime();
+
+BENCHMARK_CAPTURE(BM_PointerDataPacketDecode, packed, true)
+    ->Arg(10)
+    ->Arg(100)
+    ->Arg(1000)
+    ->UseRealTime();
+
+#ifdef SHELL_ENABLE_GL
+// Creates a shell whose platform view renders with OpenGL, so the SkSL cache
+// is precompiled when its context is created.
+static std::unique_ptr<Shell> CreateBenchmarkShellWithGLSurface(
+    ThreadHost& thread_host,
+    const Settings& settings) {
+  TaskRunners task_runners("test",
+                           thread_host.platform_thread->GetTaskRunner(),
+                           thread_host.raster_thread->GetTaskRunner(),
+                           thread_host.ui_thread->GetTaskRunner(),
+                           thread_host.io_thread->GetTaskRunner());
+  auto vsync_clock = std::make_shared<testing::ShellTestVsyncClock>();
+
+  return Shell::Create(
+      flutter::PlatformData(), task_runners, settings,
+      [vsync_clock, task_runners](Shell& shell) {
+        return testing::ShellTestPlatformView::Create(
+            shell, shell.GetTaskRunners(), vsync_clock,
+            [task_runners]() {
+              return static_cast<std::unique_ptr<VsyncWaiter>>(
+                  std::make_unique<VsyncWaiterFallback>(task_runners));
+            },
+            testing::ShellTestPlatformView::BackendType::kGLBackend,
+            nullptr);
+      },
+      [](Shell& shell) { return std::make_unique<Rasterizer>(shell); });
+}
+
+static SkPath CreateBenchmarkFramePath() {
+  SkPath path;
+  path.addCircle(50, 50, 20);
+  return path;
+}
+
+// Fills the SkSL cache under |cache_base_dir|, which must be the cache
+// directory of |PersistentCache|, the way a previous run of the benchmark
+// would. Skia compiles the shaders of the
+// benchmark frame into the cache, which lists them as the first frame
+// shaders. Each of the |count| other shaders reuses the SkSL of one of them
+// under a key of its own, so it is compiled again when it is precompiled.
+static void PopulateSkSLCache(const fml::UniqueFD& cache_base_dir,
+                              size_t count) {
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(true);
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
+  {
+    GrContextOptions options;
+    options.fShaderCacheStrategy = GrContextOptions::ShaderCacheStrategy::kSkSL;
+    options.fPersistentCache = persistent_cache;
+    testing::TestGLSurface gl_surface(SkISize::Make(100, 100));
+    sk_sp<GrDirectContext> context = gl_surface.CreateGrContext(options);
+    FML_CHECK(context);
+    sk_sp<SkSurface> surface = SkSurface::MakeRenderTarget(
+        context.get(), SkBudgeted::kNo, SkImageInfo::MakeN32Premul(100, 100));
+    FML_CHECK(surface);
+
+    // Draw what the PhysicalShapeLayer of the benchmark frame draws.
+    const SkPath path = CreateBenchmarkFramePath();
+    PhysicalShapeLayer::DrawShadow(surface->getCanvas(), path, SK_ColorBLUE,
+                                   1.0f, false, 1.0f);
+    SkPaint paint;
+    paint.setColor(SK_ColorRED);
+    paint.setAntiAlias(true);
+    surface->getCanvas()->drawPath(path, paint);
+    surface->flushAndSubmit();
+  }
+  persistent_cache->MarkFirstFrameRasterized();
+
+  const std::vector<PersistentCache::SkSLCache> first_frame_sksls =
+      persistent_cache->LoadSkSLs();
+  FML_CHECK(!first_frame_sksls.empty());
+  PersistentCache::ResetCacheForProcess();
+
+  auto sksl_dir = std::make_shared<fml::UniqueFD>(fml::CreateDirectory(
+      cache_base_dir,
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion(),
+       PersistentCache::kSkSLSubdirName},
+      fml::FilePermission::kReadWrite));
+  auto cache_file = PersistentCacheFile::Open(
+      sksl_dir, PersistentCache::kCacheFileName, false);
+  FML_CHECK(cache_file);
+
+  for (size_t i = 0; i < count; i++) {
+    const PersistentCache::SkSLCache& sksl =
+        first_frame_sksls[i % first_frame_sksls.size()];
+    // Skia keys are arrays of 32-bit words, so extend the key by one word.
+    std::vector<uint8_t> key(sksl.first->bytes(),
+                             sksl.first->bytes() + sksl.first->size());
+    const uint32_t index = i;
+    const uint8_t* index_bytes = reinterpret_cast<const uint8_t*>(&index);
+    key.insert(key.end(), index_bytes, index_bytes + sizeof(uint32_t));
+    cache_file->Store(*SkData::MakeWithCopy(key.data(), key.size()),
+                      *sksl.second);
+  }
+  cache_file->Compact();
+}
+
+// Measures the time from creating a shell until its first frame is
+// rasterized, with the shaders of that frame and the given number of other
+// shaders in the SkSL cache.
+static void BM_ShellTimeToFirstFrameWithCachedSkSLs(
+    benchmark::State& state) {  // NOLINT
+  auto assets_dir = fml::OpenDirectory(testing::GetFixturesPath(), false,
+                                       fml::FilePermission::kRead);
+  testing::ELFAOTSymbols aot_symbols;
+  fml::ScopedTemporaryDirectory cache_dir;
+  PersistentCache::SetCacheDirectoryPath(cache_dir.path());
+  PopulateSkSLCache(cache_dir.fd(), state.range(0));
+
+  auto builder = [](std::shared_ptr<ContainerLayer> root) {
+    root->Add(std::make_shared<PhysicalShapeLayer>(
+        SK_ColorRED, SK_ColorBLUE, 1.0f, CreateBenchmarkFramePath(),
+        Clip::antiAlias));
+  };
+
+  while (state.KeepRunning()) {
+    std::unique_ptr<ThreadHost> thread_host;
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      PersistentCache::ResetCacheForProcess();
+      thread_host = CreateBenchmarkThreadHost();
+    }
+
+    fml::AutoResetWaitableEvent first_frame_latch;
+    Settings settings = CreateBenchmarkSettings(assets_dir, aot_symbols);
+    settings.cache_sksl = true;
+    settings.frame_rasterized_callback =
+        [&first_frame_latch](const FrameTiming&) {
+          first_frame_latch.Signal();
+        };
+    auto shell = CreateBenchmarkShellWithGLSurface(*thread_host, settings);
+    FML_CHECK(shell);
+
+    testing::ShellTest::PlatformViewNotifyCreated(shell.get());
+    auto configuration = RunConfiguration::InferFromSettings(settings);
+    configuration.SetEntrypoint("emptyMain");
+    testing::ShellTest::RunEngine(shell.get(), std::move(configuration));
+    testing::ShellTest::PumpOneFrame(shell.get(), 100, 100, builder);
+    first_frame_latch.Wait();
+
+    {
+      benchmarking::ScopedPauseTiming pause(state);
+      DestroyBenchmarkShell(std::move(shell), *thread_host);
+      thread_host.reset();
+    }
+  }
+
+  PersistentCache::SetCacheDirectoryPath("");
+  PersistentCache::ResetCacheForProcess();
+}
+
+BENCHMARK(BM_ShellTimeToFirstFrameWithCachedSkSLs)
+    ->Arg(0)
+    ->Arg(100)
+    ->Arg(1000)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+#endif  // SHELL_ENABLE_GL
+
+namespace {
+
+// Counts the dispatched pointer events, and runs the vsync callback when the
+// benchmark simulates a vsync.
+class CountingPointerDataDispatcherDelegate
+    : public PointerDataDispatcher::Delegate {
+ public:
+  // |PointerDataDispatcher::Delegate|
+  void DoDispatchPacket(std::unique_ptr<PointerDataPacket> packet,
+                        uint64_t trace_flow_id) override {
+    dispatched_events += packet->data().size() / sizeof(PointerData);
+  }
+
+  // |PointerDataDispatcher::Delegate|
+  void ScheduleSecondaryVsyncCallback(uintptr_t id,
+                                      const fml::closure& callback) override {
+    vsync_callback = callback;
+  }
+
+  void FireVsync() {
+    auto callback = std::move(vsync_callback);
+    vsync_callback = nullptr;
+    if (callback) {
+      callback();
+    }
+  }
+
+  size_t dispatched_events = 0;
+  fml::closure vsync_callback;
+};
+
+}  // namespace
+
+// Simulates one second of a drag sampled at |state.range(0)| Hz and delivered
+// one sample per packet. Each packet goes through the
+// PointerDataPacketConverter and the dispatcher, with a vsync every 16.67ms.
+// Reports the number of events handed to the framework, which unpacks each of
+// them in Dart.
+static void BM_PointerDataDispatch(benchmark::State& state, bool resample) {
+  const int64_t sample_rate = state.range(0);
+  const int64_t frame_interval_us = 16667;
+  const int64_t duration_us = 1000000;
+
+  fml::TimePoint now;
+  size_t dispatched_events = 0;
+  while (state.KeepRunning()) {
+    CountingPointerDataDispatcherDelegate delegate;
+    PointerDataPacketConverter converter;
+    std::unique_ptr<PointerDataDispatcher> dispatcher;
+    if (resample) {
+      dispatcher = std::make_unique<ResamplingPointerDataDispatcher>(
+          delegate, ResamplingPointerDataDispatcher::kDefaultSamplingOffset,
+          [&now]() { return now; });
+    } else {
+      dispatcher = std::make_unique<DefaultPointerDataDispatcher>(delegate);
+    }
+
+    int64_t next_vsync_us = frame_interval_us;
+    for (int64_t i = 0; i <= sample_rate; i++) {
+      const int64_t time_us = i * duration_us / sample_rate;
+      while (time_us >= next_vsync_us) {
+        now = fml::TimePoint::FromEpochDelta(
+            fml::TimeDelta::FromMicroseconds(next_vsync_us));
+        delegate.FireVsync();
+        next_vsync_us += frame_interval_us;
+      }
+
+      PointerData data;
+      data.Clear();
+      data.time_stamp = time_us;
+      data.kind = PointerData::DeviceKind::kMouse;
+      data.change = PointerData::Change::kMove;
+      data.buttons = kPointerButtonMousePrimary;
+      if (i == 0) {
+        data.change = PointerData::Change::kDown;
+      } else if (i == sample_rate) {
+        data.change = PointerData::Change::kUp;
+        data.buttons = 0;
+      }
+      data.physical_x = i * 0.25;
+      data.physical_y = i * 0.5;
+      auto packet = std::make_unique<PointerDataPacket>(1);
+      packet->SetPointerData(0, data);
+      now = fml::TimePoint::FromEpochDelta(
+          fml::TimeDelta::FromMicroseconds(time_us));
+      dispatcher->DispatchPacket(converter.Convert(std::move(packet)), i);
+    }
+    while (delegate.vsync_callback) {
+      now = fml::TimePoint::FromEpochDelta(
+          fml::TimeDelta::FromMicroseconds(next_vsync_us));
+      delegate.FireVsync();
+      next_vsync_us += frame_interval_us;
+    }
+    dispatched_events += delegate.dispatched_events;
+  }
+  state.SetItemsProcessed(state.iterations() * (sample_rate + 1));
+  state.counters["dispatched_events"] = benchmark::Counter(
+      dispatched_events, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK_CAPTURE(BM_PointerDataDispatch, default, false)
+    ->Arg(1000)
+    ->Arg(2000)
+    ->Arg(4000)
+    ->Arg(8000);
+
+BENCHMARK_CAPTURE(BM_PointerDataDispatch, resampling, true)
+    ->Arg(1000)
+    ->Arg(2000)
+    ->Arg(4000)
+    ->Arg(8000);
+
 }  // namespace flutter
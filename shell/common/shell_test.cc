@@ -253,6 +253,9 @@ void ShellTest::OnServiceProtocol(
           case ServiceProtocolEnum::kEstimateRasterCacheMemory:
             shell->OnServiceProtocolEstimateRasterCacheMemory(params, response);
             break;
+          case ServiceProtocolEnum::kGetLayerDiffStatistics:
+            shell->OnServiceProtocolGetLayerDiffStatistics(params, response);
+            break;
           case ServiceProtocolEnum::kSetAssetBundlePath:
             shell->OnServiceProtocolSetAssetBundlePath(params, response);
             break;
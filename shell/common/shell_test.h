@@ -96,6 +96,7 @@ class ShellTest : public FixtureTest {
   enum ServiceProtocolEnum {
     kGetSkSLs,
     kEstimateRasterCacheMemory,
+    kGetLayerDiffStatistics,
     kSetAssetBundlePath,
     kRunInView,
   };
@@ -59,6 +59,9 @@ class MockPlatformViewDelegate : public PlatformView::Delegate {
   MOCK_METHOD1(OnPlatformViewDispatchPlatformMessage,
                void(fml::RefPtr<PlatformMessage> message));
 
+  MOCK_METHOD1(OnPlatformViewDispatchPlatformMessages,
+               void(std::vector<fml::RefPtr<PlatformMessage>> messages));
+
   MOCK_METHOD1(OnPlatformViewDispatchPointerDataPacket,
                void(std::unique_ptr<PointerDataPacket> packet));
 
@@ -2174,6 +2177,29 @@ TEST_F(ShellTest, OnServiceProtocolEstimateRasterCacheMemoryWorks) {
   DestroyShell(std::move(shell));
 }
 
+#ifdef FLUTTER_ENABLE_DIFF_CONTEXT
+TEST_F(ShellTest, OnServiceProtocolGetLayerDiffStatisticsWorks) {
+  Settings settings = CreateSettingsForFixture();
+  std::unique_ptr<Shell> shell = CreateShell(settings);
+
+  ServiceProtocol::Handler::ServiceProtocolMap empty_params;
+  rapidjson::Document document;
+  OnServiceProtocol(
+      shell.get(), ServiceProtocolEnum::kGetLayerDiffStatistics,
+      shell->GetTaskRunners().GetRasterTaskRunner(), empty_params, &document);
+  rapidjson::StringBuffer buffer;
+  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+  document.Accept(writer);
+  std::string expected_json =
+      "{\"type\":\"LayerDiffStatistics\",\"trackedLayers\":0,\"deepCompares\""
+      ":0,\"deepComparesEqual\":0,\"skippedDeepCompares\":0}";
+  std::string actual_json = buffer.GetString();
+  ASSERT_EQ(actual_json, expected_json);
+
+  DestroyShell(std::move(shell));
+}
+#endif  // FLUTTER_ENABLE_DIFF_CONTEXT
+
 TEST_F(ShellTest, DiscardLayerTreeOnResize) {
   auto settings = CreateSettingsForFixture();
 
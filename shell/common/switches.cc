@@ -9,6 +9,7 @@
 #include <sstream>
 #include <string>
 
+#include "flutter/fml/logging.h"
 #include "flutter/fml/native_library.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/size.h"
@@ -409,12 +410,64 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
   settings.purge_persistent_cache =
       command_line.HasOption(FlagForSwitch(Switch::PurgePersistentCache));
 
+  settings.enable_async_raster_cache =
+      command_line.HasOption(FlagForSwitch(Switch::EnableAsyncRasterCache));
+
+  settings.resample_pointer_events =
+      command_line.HasOption(FlagForSwitch(Switch::ResamplePointerEvents));
+
+  settings.pack_pointer_data =
+      command_line.HasOption(FlagForSwitch(Switch::PackPointerData));
+
+  settings.defer_offscreen_semantics =
+      command_line.HasOption(FlagForSwitch(Switch::DeferOffscreenSemantics));
+
+  std::string frame_latency_mode;
+  if (command_line.GetOptionValue(FlagForSwitch(Switch::FrameLatencyMode),
+                                  &frame_latency_mode)) {
+    if (frame_latency_mode == "low-latency") {
+      settings.frame_latency_mode = FrameLatencyMode::kLowLatency;
+    } else if (frame_latency_mode == "throughput") {
+      settings.frame_latency_mode = FrameLatencyMode::kThroughput;
+    } else {
+      FML_LOG(ERROR) << "Unknown frame latency mode: " << frame_latency_mode;
+    }
+  }
+
   if (command_line.HasOption(FlagForSwitch(Switch::OldGenHeapSize))) {
     std::string old_gen_heap_size;
     command_line.GetOptionValue(FlagForSwitch(Switch::OldGenHeapSize),
                                 &old_gen_heap_size);
     settings.old_gen_heap_size = std::stoi(old_gen_heap_size);
   }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::RasterCacheMaxBytes))) {
+    std::string raster_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::RasterCacheMaxBytes),
+                                &raster_cache_max_bytes);
+    settings.raster_cache_max_bytes = std::stoull(raster_cache_max_bytes);
+  }
+
+  if (command_line.HasOption(
+          FlagForSwitch(Switch::RasterCacheMaxUnusedFrames))) {
+    std::string raster_cache_max_unused_frames;
+    command_line.GetOptionValue(
+        FlagForSwitch(Switch::RasterCacheMaxUnusedFrames),
+        &raster_cache_max_unused_frames);
+    settings.raster_cache_max_unused_frames =
+        std::stoull(raster_cache_max_unused_frames);
+  }
+
+  if (command_line.HasOption(FlagForSwitch(Switch::TextLayoutCacheMaxBytes))) {
+    std::string text_layout_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::TextLayoutCacheMaxBytes),
+                                &text_layout_cache_max_bytes);
+    settings.text_layout_cache_max_bytes =
+        std::stoull(text_layout_cache_max_bytes);
+  }
+
+  settings.enable_parallel_text_shaping =
+      command_line.HasOption(FlagForSwitch(Switch::EnableParallelTextShaping));
   return settings;
 }
 
@@ -202,6 +202,51 @@ DEF_SWITCH(
 DEF_SWITCH(OldGenHeapSize,
            "old-gen-heap-size",
            "The size limit in megabytes for the Dart VM old gen heap space.")
+DEF_SWITCH(RasterCacheMaxBytes,
+           "raster-cache-max-bytes",
+           "The maximum number of bytes of images the raster cache may hold. "
+           "Entries are evicted by age and measured raster cost once the "
+           "budget is reached. By default, the raster cache evicts every "
+           "entry that was not used in the last frame.")
+DEF_SWITCH(RasterCacheMaxUnusedFrames,
+           "raster-cache-max-unused-frames",
+           "The number of frames a raster cache entry may go unused before it "
+           "is evicted. Only used together with --raster-cache-max-bytes.")
+DEF_SWITCH(EnableAsyncRasterCache,
+           "enable-async-raster-cache",
+           "Rasterize raster cache entries on the IO thread instead of the "
+           "raster thread. Pictures are drawn uncached until their entry "
+           "becomes available in a later frame.")
+DEF_SWITCH(ResamplePointerEvents,
+           "resample-pointer-events",
+           "Dispatch pointer events once per vsync, merging consecutive moves "
+           "of each device and resampling their positions to the frame time. "
+           "Reduces the work of the framework for high rate input devices.")
+DEF_SWITCH(PackPointerData,
+           "pack-pointer-data",
+           "Hand pointer events to the framework in a packed layout that only "
+           "holds the fields that changed since the previous event, which is "
+           "smaller and faster to decode.")
+DEF_SWITCH(DeferOffscreenSemantics,
+           "defer-offscreen-semantics",
+           "Only send the semantics nodes near the viewport to the platform "
+           "accessibility layer. The others are sent once they scroll into "
+           "view or get accessibility focus.")
+DEF_SWITCH(FrameLatencyMode,
+           "frame-latency-mode",
+           "Either \"low-latency\", to keep a single frame in flight and begin "
+           "frames as late in the vsync interval as recent frame times allow, "
+           "or \"throughput\", to let the UI thread build further ahead of "
+           "the raster thread.")
+DEF_SWITCH(TextLayoutCacheMaxBytes,
+           "text-layout-cache-max-bytes",
+           "The maximum number of bytes of shaped words the text layout cache "
+           "may hold. The least recently used words are evicted once the "
+           "budget is reached.")
+DEF_SWITCH(EnableParallelTextShaping,
+           "enable-parallel-text-shaping",
+           "Measure the text runs of long paragraphs in parallel on the "
+           "concurrent worker threads before breaking them into lines.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
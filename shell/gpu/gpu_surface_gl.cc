@@ -4,10 +4,14 @@
 
 #include "flutter/shell/gpu/gpu_surface_gl.h"
 
+#include <string>
+
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/fml/base32.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/message_loop.h"
 #include "flutter/fml/size.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 #include "third_party/skia/include/core/SkSurface.h"
@@ -34,8 +38,14 @@ static const int kGrCacheMaxCount = 8192;
 // system channel.
 static const size_t kGrCacheMaxByteSize = 24 * (1 << 20);
 
+// Deferred SkSL shaders are precompiled in tasks of roughly this duration so
+// that frames can be rasterized in between.
+static constexpr fml::TimeDelta kSkSLPrecompileSliceDuration =
+    fml::TimeDelta::FromMilliseconds(4);
+
 sk_sp<GrDirectContext> GPUSurfaceGL::MakeGLContext(
-    GPUSurfaceGLDelegate* delegate) {
+    GPUSurfaceGLDelegate* delegate,
+    std::vector<PersistentCache::SkSLCache>* deferred_sksls) {
   auto context_switch = delegate->GLContextMakeCurrent();
   if (!context_switch->GetResult()) {
     FML_LOG(ERROR)
@@ -70,42 +80,117 @@ sk_sp<GrDirectContext> GPUSurfaceGL::MakeGLContext(
 
   context->setResourceCacheLimits(kGrCacheMaxCount, kGrCacheMaxByteSize);
 
+  PersistentCache* persistent_cache = PersistentCache::GetCacheForProcess();
   std::vector<PersistentCache::SkSLCache> caches =
-      PersistentCache::GetCacheForProcess()->LoadSkSLs();
+      persistent_cache->LoadSkSLs();
+  const size_t first_frame_count =
+      deferred_sksls ? persistent_cache->PrioritizeFirstFrameSkSLs(caches)
+                     : caches.size();
   int compiled_count = 0;
-  for (const auto& cache : caches) {
-    compiled_count += context->precompileShader(*cache.first, *cache.second);
+  {
+    TRACE_EVENT1("flutter", "PrecompileFirstFrameSkSLs", "count",
+                 std::to_string(first_frame_count).c_str());
+    for (size_t i = 0; i < first_frame_count; i++) {
+      compiled_count +=
+          context->precompileShader(*caches[i].first, *caches[i].second);
+    }
   }
   FML_LOG(INFO) << "Found " << caches.size() << " SkSL shaders; precompiled "
-                << compiled_count;
+                << compiled_count << " used by the first frame";
+
+  if (deferred_sksls) {
+    deferred_sksls->assign(
+        std::make_move_iterator(caches.begin() + first_frame_count),
+        std::make_move_iterator(caches.end()));
+  }
 
   return context;
 }
 
 GPUSurfaceGL::GPUSurfaceGL(GPUSurfaceGLDelegate* delegate,
                            bool render_to_surface)
-    : GPUSurfaceGL(MakeGLContext(delegate), delegate, render_to_surface) {
-  context_owner_ = true;
+    : delegate_(delegate),
+      context_owner_(true),
+      render_to_surface_(render_to_surface),
+      weak_factory_(this) {
+  context_ = MakeGLContext(delegate_, &deferred_sksls_);
+  Setup();
 }
 
-GPUSurfaceGL::GPUSurfaceGL(sk_sp<GrDirectContext> gr_context,
-                           GPUSurfaceGLDelegate* delegate,
-                           bool render_to_surface)
+GPUSurfaceGL::GPUSurfaceGL(
+    sk_sp<GrDirectContext> gr_context,
+    GPUSurfaceGLDelegate* delegate,
+    bool render_to_surface,
+    std::vector<PersistentCache::SkSLCache> deferred_sksls)
     : delegate_(delegate),
       context_(gr_context),
       context_owner_(false),
       render_to_surface_(render_to_surface),
+      deferred_sksls_(std::move(deferred_sksls)),
       weak_factory_(this) {
+  Setup();
+}
+
+void GPUSurfaceGL::Setup() {
   auto context_switch = delegate_->GLContextMakeCurrent();
   if (!context_switch->GetResult()) {
     FML_LOG(ERROR)
         << "Could not make the context current to setup the gr context.";
+    deferred_sksls_.clear();
     return;
   }
 
   delegate_->GLContextClearCurrent();
 
-  valid_ = gr_context != nullptr;
+  valid_ = context_ != nullptr;
+
+  if (valid_ && !deferred_sksls_.empty()) {
+    PostDeferredSkSLPrecompilation();
+  }
+}
+
+void GPUSurfaceGL::PostDeferredSkSLPrecompilation() {
+  if (!fml::MessageLoop::IsInitializedForCurrentThread()) {
+    FML_LOG(WARNING) << "Dropping " << deferred_sksls_.size()
+                     << " SkSL shaders to precompile on a thread without a "
+                        "message loop.";
+    deferred_sksls_.clear();
+    return;
+  }
+  fml::MessageLoop::GetCurrent().GetTaskRunner()->PostTask(
+      [weak = weak_factory_.GetWeakPtr()]() {
+        if (weak) {
+          weak->PrecompileDeferredSkSLs();
+        }
+      });
+}
+
+void GPUSurfaceGL::PrecompileDeferredSkSLs() {
+  TRACE_EVENT0("flutter", "PrecompileDeferredSkSLs");
+  auto context_switch = delegate_->GLContextMakeCurrent();
+  if (!context_switch->GetResult()) {
+    FML_LOG(ERROR) << "Could not make the context current to precompile SkSL "
+                      "shaders.";
+    deferred_sksls_.clear();
+    return;
+  }
+
+  const fml::TimePoint deadline =
+      fml::TimePoint::Now() + kSkSLPrecompileSliceDuration;
+  do {
+    const auto& sksl = deferred_sksls_[next_deferred_sksl_++];
+    context_->precompileShader(*sksl.first, *sksl.second);
+  } while (next_deferred_sksl_ < deferred_sksls_.size() &&
+           fml::TimePoint::Now() < deadline);
+
+  if (next_deferred_sksl_ < deferred_sksls_.size()) {
+    PostDeferredSkSLPrecompilation();
+  } else {
+    FML_LOG(INFO) << "Precompiled " << deferred_sksls_.size()
+                  << " deferred SkSL shaders";
+    deferred_sksls_.clear();
+    next_deferred_sksl_ = 0;
+  }
 }
 
 GPUSurfaceGL::~GPUSurfaceGL() {
@@ -259,15 +344,29 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceGL::AcquireFrame(const SkISize& size) {
   SurfaceFrame::SubmitCallback submit_callback =
       [weak = weak_factory_.GetWeakPtr()](const SurfaceFrame& surface_frame,
                                           SkCanvas* canvas) {
-        return weak ? weak->PresentSurface(canvas) : false;
+        return weak ? weak->PresentSurface(surface_frame, canvas) : false;
       };
 
-  return std::make_unique<SurfaceFrame>(
+  auto frame = std::make_unique<SurfaceFrame>(
       surface, delegate_->SurfaceSupportsReadback(), submit_callback,
       std::move(context_switch));
+
+  // Damage is computed in frame coordinates, so partial repaint is only
+  // possible when those match the framebuffer coordinates.
+  if (root_surface_transformation.isIdentity()) {
+    SurfaceFrame::FramebufferInfo framebuffer_info;
+    framebuffer_info.existing_damage =
+        delegate_->GLContextFBOExistingDamage(fbo_id_);
+    framebuffer_info.supports_partial_repaint =
+        framebuffer_info.existing_damage.has_value();
+    frame->set_framebuffer_info(framebuffer_info);
+  }
+
+  return frame;
 }
 
-bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
+bool GPUSurfaceGL::PresentSurface(const SurfaceFrame& surface_frame,
+                                  SkCanvas* canvas) {
   if (delegate_ == nullptr || canvas == nullptr || context_ == nullptr) {
     return false;
   }
@@ -277,7 +376,11 @@ bool GPUSurfaceGL::PresentSurface(SkCanvas* canvas) {
     onscreen_surface_->getCanvas()->flush();
   }
 
-  if (!delegate_->GLContextPresent(fbo_id_)) {
+  GLPresentInfo present_info;
+  present_info.fbo_id = fbo_id_;
+  present_info.frame_damage = surface_frame.submit_info().frame_damage;
+  present_info.buffer_damage = surface_frame.submit_info().buffer_damage;
+  if (!delegate_->GLContextPresentWithInfo(present_info)) {
     return false;
   }
 
@@ -7,8 +7,10 @@
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "flutter/common/graphics/gl_context_switch.h"
+#include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/flow/surface.h"
 #include "flutter/fml/macros.h"
@@ -20,14 +22,22 @@ namespace flutter {
 
 class GPUSurfaceGL : public Surface {
  public:
-  static sk_sp<GrDirectContext> MakeGLContext(GPUSurfaceGLDelegate* delegate);
+  // Creates the context and precompiles the cached SkSL shaders. If
+  // |deferred_sksls| is not null, only the shaders that previous runs needed
+  // for their first frame are precompiled, and the others are returned in
+  // |deferred_sksls| for a surface to precompile between frames.
+  static sk_sp<GrDirectContext> MakeGLContext(
+      GPUSurfaceGLDelegate* delegate,
+      std::vector<PersistentCache::SkSLCache>* deferred_sksls = nullptr);
 
   GPUSurfaceGL(GPUSurfaceGLDelegate* delegate, bool render_to_surface);
 
-  // Creates a new GL surface reusing an existing GrDirectContext.
+  // Creates a new GL surface reusing an existing GrDirectContext. The surface
+  // precompiles |deferred_sksls| with the context between frames.
   GPUSurfaceGL(sk_sp<GrDirectContext> gr_context,
                GPUSurfaceGLDelegate* delegate,
-               bool render_to_surface);
+               bool render_to_surface,
+               std::vector<PersistentCache::SkSLCache> deferred_sksls = {});
 
   // |Surface|
   ~GPUSurfaceGL() override;
@@ -63,15 +73,24 @@ class GPUSurfaceGL : public Surface {
   // external view embedder is present.
   const bool render_to_surface_ = true;
   bool valid_ = false;
+  // SkSL shaders left to precompile between frames.
+  std::vector<PersistentCache::SkSLCache> deferred_sksls_;
+  size_t next_deferred_sksl_ = 0;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceGL> weak_factory_;
 
+  void Setup();
+
   bool CreateOrUpdateSurfaces(const SkISize& size);
 
   sk_sp<SkSurface> AcquireRenderSurface(
       const SkISize& untransformed_size,
       const SkMatrix& root_surface_transformation);
 
-  bool PresentSurface(SkCanvas* canvas);
+  bool PresentSurface(const SurfaceFrame& surface_frame, SkCanvas* canvas);
+
+  void PostDeferredSkSLPrecompilation();
+
+  void PrecompileDeferredSkSLs();
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceGL);
 };
@@ -12,6 +12,16 @@ namespace flutter {
 
 GPUSurfaceGLDelegate::~GPUSurfaceGLDelegate() = default;
 
+bool GPUSurfaceGLDelegate::GLContextPresentWithInfo(
+    const GLPresentInfo& present_info) {
+  return GLContextPresent(present_info.fbo_id);
+}
+
+std::optional<SkIRect> GPUSurfaceGLDelegate::GLContextFBOExistingDamage(
+    uint32_t fbo_id) const {
+  return std::nullopt;
+}
+
 bool GPUSurfaceGLDelegate::GLContextFBOResetAfterPresent() const {
   return false;
 }
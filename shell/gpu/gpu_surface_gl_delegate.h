@@ -5,10 +5,13 @@
 #ifndef FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 #define FLUTTER_SHELL_GPU_GPU_SURFACE_GL_DELEGATE_H_
 
+#include <optional>
+
 #include "flutter/common/graphics/gl_context_switch.h"
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/macros.h"
 #include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 
 namespace flutter {
@@ -20,6 +23,20 @@ struct GLFrameInfo {
   uint32_t height;
 };
 
+// A structure to represent the information which is passed to the embedder
+// when presenting a frame.
+struct GLPresentInfo {
+  uint32_t fbo_id;
+
+  // The area of the frame that changed since the previously presented frame.
+  // If absent, the whole frame changed.
+  std::optional<SkIRect> frame_damage;
+
+  // The area of the framebuffer that was repainted. If absent, the whole
+  // framebuffer was repainted.
+  std::optional<SkIRect> buffer_damage;
+};
+
 class GPUSurfaceGLDelegate {
  public:
   ~GPUSurfaceGLDelegate();
@@ -35,9 +52,23 @@ class GPUSurfaceGLDelegate {
   // context and not any of the contexts dedicated for IO.
   virtual bool GLContextPresent(uint32_t fbo_id) = 0;
 
+  // Called to present the main GL surface along with the area of the frame
+  // that changed, so that platforms supporting it can present only that area.
+  // The default implementation ignores the damage and calls
+  // GLContextPresent.
+  virtual bool GLContextPresentWithInfo(const GLPresentInfo& present_info);
+
   // The ID of the main window bound framebuffer. Typically FBO0.
   virtual intptr_t GLContextFBO(GLFrameInfo frame_info) const = 0;
 
+  // The area of the given framebuffer that does not hold the content of the
+  // previously presented frame (e.g. computed from the EGL buffer age). An
+  // empty rect means the framebuffer holds the previous frame. Returning
+  // std::nullopt, the default, means the content is unknown and disables
+  // partial repaint.
+  virtual std::optional<SkIRect> GLContextFBOExistingDamage(
+      uint32_t fbo_id) const;
+
   // The rendering subsystem assumes that the ID of the main window bound
   // framebuffer remains constant throughout. If this assumption in incorrect,
   // embedders are required to return true from this method. In such cases,
@@ -66,10 +66,31 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceSoftware::AcquireFrame(
 
     canvas->flush();
 
-    return self->delegate_->PresentBackingStore(surface_frame.SkiaSurface());
+    sk_sp<SkSurface> surface = surface_frame.SkiaSurface();
+    if (!self->delegate_->PresentBackingStore(surface)) {
+      self->last_presented_generation_id_ = 0;
+      return false;
+    }
+    self->last_presented_generation_id_ = surface->generationID();
+    return true;
   };
 
-  return std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+  auto frame = std::make_unique<SurfaceFrame>(backing_store, true, on_submit);
+
+  // Diffing the layer tree only pays off if the delegate hands back the
+  // backing store it last presented. Partial repaint is advertised once it has
+  // done so, which spares delegates that allocate a new backing store per
+  // frame the cost of the diff.
+  SurfaceFrame::FramebufferInfo framebuffer_info;
+  if (last_presented_generation_id_ != 0 &&
+      backing_store->generationID() == last_presented_generation_id_) {
+    reuses_backing_store_ = true;
+    framebuffer_info.existing_damage = SkIRect::MakeEmpty();
+  }
+  framebuffer_info.supports_partial_repaint = reuses_backing_store_;
+  frame->set_framebuffer_info(framebuffer_info);
+
+  return frame;
 }
 
 // |Surface|
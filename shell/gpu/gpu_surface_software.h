@@ -38,6 +38,14 @@ class GPUSurfaceSoftware : public Surface {
   // hack to make avoid allocating resources for the root surface when an
   // external view embedder is present.
   const bool render_to_surface_;
+  // The generation ID of the backing store right after it was last presented.
+  // If the delegate hands back a backing store with the same generation ID,
+  // it still holds the previous frame and only the damaged area needs to be
+  // repainted.
+  uint32_t last_presented_generation_id_ = 0;
+  // Whether the delegate has handed back a backing store it was presented
+  // with, unchanged.
+  bool reuses_backing_store_ = false;
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceSoftware> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GPUSurfaceSoftware);
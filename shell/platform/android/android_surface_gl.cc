@@ -54,11 +54,13 @@ std::unique_ptr<Surface> AndroidSurfaceGL::CreateGPUSurface(
   } else {
     sk_sp<GrDirectContext> main_skia_context =
         GLContextPtr()->GetMainSkiaContext();
+    std::vector<PersistentCache::SkSLCache> deferred_sksls;
     if (!main_skia_context) {
-      main_skia_context = GPUSurfaceGL::MakeGLContext(this);
+      main_skia_context = GPUSurfaceGL::MakeGLContext(this, &deferred_sksls);
       GLContextPtr()->SetMainSkiaContext(main_skia_context);
     }
-    return std::make_unique<GPUSurfaceGL>(main_skia_context, this, true);
+    return std::make_unique<GPUSurfaceGL>(main_skia_context, this, true,
+                                          std::move(deferred_sksls));
   }
 }
 
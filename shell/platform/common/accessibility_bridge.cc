@@ -5,6 +5,7 @@
 #include "accessibility_bridge.h"
 
 #include <functional>
+#include <unordered_set>
 #include <utility>
 
 #include "flutter/third_party/accessibility/ax/ax_tree_update.h"
@@ -54,19 +55,42 @@ void AccessibilityBridge::CommitUpdates() {
   std::vector<std::vector<SemanticsNode>> results;
   while (!pending_semantics_node_updates_.empty()) {
     auto begin = pending_semantics_node_updates_.begin();
-    SemanticsNode target = begin->second;
-    std::vector<SemanticsNode> sub_tree_list;
-    GetSubTreeList(target, sub_tree_list);
-    results.push_back(sub_tree_list);
+    SemanticsNode target = std::move(begin->second);
     pending_semantics_node_updates_.erase(begin);
+    std::vector<SemanticsNode> sub_tree_list;
+    GetSubTreeList(std::move(target), sub_tree_list);
+    results.push_back(std::move(sub_tree_list));
   }
 
+  // The framework resends nodes whose semantics did not change, for example
+  // the siblings of a node that was added. Those are left out of the update so
+  // that neither the conversion nor the diffing in ui::AXTree is repeated for
+  // them. A node that moves to another parent, and its subtree, is always sent
+  // because ui::AXTree recreates it.
+  std::unordered_set<int32_t> moved_nodes;
   for (size_t i = results.size(); i > 0; i--) {
-    for (SemanticsNode node : results[i - 1]) {
+    for (SemanticsNode& node : results[i - 1]) {
+      bool moved = moved_nodes.find(node.id) != moved_nodes.end();
+      if (!moved && IsCommittedFlutterUpdate(node)) {
+        continue;
+      }
+      for (int32_t child : node.children_in_traversal_order) {
+        ui::AXNode* child_node = tree_.GetFromId(child);
+        if (moved || (child_node && child_node->parent() &&
+                      child_node->parent()->id() != node.id)) {
+          moved_nodes.insert(child);
+        }
+      }
       ConvertFluterUpdate(node, update);
+      committed_semantics_nodes_[node.id] = std::move(node);
     }
   }
 
+  if (update.nodes.empty() && !update.has_tree_data) {
+    pending_semantics_custom_action_updates_.clear();
+    return;
+  }
+
   tree_.Unserialize(update);
   pending_semantics_node_updates_.clear();
   pending_semantics_custom_action_updates_.clear();
@@ -74,6 +98,9 @@ void AccessibilityBridge::CommitUpdates() {
   std::string error = tree_.error();
   if (!error.empty()) {
     BASE_LOG() << "Failed to update ui::AXTree, error: " << error;
+    // The tree no longer matches the committed nodes, so the next update is
+    // sent in full.
+    committed_semantics_nodes_.clear();
     return;
   }
   // Handles accessibility events as the result of the semantics update.
@@ -133,6 +160,7 @@ void AccessibilityBridge::OnNodeDeleted(ui::AXTree* tree,
   if (id_wrapper_map_.find(node_id) != id_wrapper_map_.end()) {
     id_wrapper_map_.erase(node_id);
   }
+  committed_semantics_nodes_.erase(node_id);
 }
 
 void AccessibilityBridge::OnAtomicUpdateFinished(
@@ -157,17 +185,39 @@ void AccessibilityBridge::OnAtomicUpdateFinished(
 // Private method.
 void AccessibilityBridge::GetSubTreeList(SemanticsNode target,
                                          std::vector<SemanticsNode>& result) {
-  result.push_back(target);
-  for (int32_t child : target.children_in_traversal_order) {
+  result.push_back(std::move(target));
+  // |result| may grow while the children are visited, so the target is
+  // referred to by index.
+  size_t target_index = result.size() - 1;
+  for (size_t i = 0;
+       i < result[target_index].children_in_traversal_order.size(); i++) {
+    int32_t child = result[target_index].children_in_traversal_order[i];
     auto iter = pending_semantics_node_updates_.find(child);
     if (iter != pending_semantics_node_updates_.end()) {
-      SemanticsNode node = iter->second;
-      GetSubTreeList(node, result);
+      SemanticsNode node = std::move(iter->second);
       pending_semantics_node_updates_.erase(iter);
+      GetSubTreeList(std::move(node), result);
     }
   }
 }
 
+bool AccessibilityBridge::IsCommittedFlutterUpdate(const SemanticsNode& node) {
+  auto committed = committed_semantics_nodes_.find(node.id);
+  if (committed == committed_semantics_nodes_.end() ||
+      !SemanticsNodeEquals(committed->second, node)) {
+    return false;
+  }
+  // The descriptions of custom actions are looked up at conversion time, so a
+  // node must be converted again when one of its custom actions changes.
+  for (int32_t action : node.custom_accessibility_actions) {
+    if (pending_semantics_custom_action_updates_.find(action) !=
+        pending_semantics_custom_action_updates_.end()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void AccessibilityBridge::ConvertFluterUpdate(const SemanticsNode& node,
                                               ui::AXTreeUpdate& tree_update) {
   ui::AXNodeData node_data;
@@ -193,7 +243,7 @@ void AccessibilityBridge::ConvertFluterUpdate(const SemanticsNode& node,
     node_data.child_ids.push_back(child);
   }
   SetTreeData(node, tree_update);
-  tree_update.nodes.push_back(node_data);
+  tree_update.nodes.push_back(std::move(node_data));
 }
 
 void AccessibilityBridge::SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -431,6 +481,33 @@ void AccessibilityBridge::SetTreeData(const SemanticsNode& node,
   }
 }
 
+bool AccessibilityBridge::SemanticsNodeEquals(const SemanticsNode& a,
+                                              const SemanticsNode& b) {
+  const FlutterTransformation& ta = a.transform;
+  const FlutterTransformation& tb = b.transform;
+  return a.id == b.id && a.flags == b.flags && a.actions == b.actions &&
+         a.text_selection_base == b.text_selection_base &&
+         a.text_selection_extent == b.text_selection_extent &&
+         a.scroll_child_count == b.scroll_child_count &&
+         a.scroll_index == b.scroll_index &&
+         a.scroll_position == b.scroll_position &&
+         a.scroll_extent_max == b.scroll_extent_max &&
+         a.scroll_extent_min == b.scroll_extent_min &&
+         a.elevation == b.elevation && a.thickness == b.thickness &&
+         a.text_direction == b.text_direction &&
+         a.rect.left == b.rect.left && a.rect.top == b.rect.top &&
+         a.rect.right == b.rect.right && a.rect.bottom == b.rect.bottom &&
+         ta.scaleX == tb.scaleX && ta.skewX == tb.skewX &&
+         ta.transX == tb.transX && ta.skewY == tb.skewY &&
+         ta.scaleY == tb.scaleY && ta.transY == tb.transY &&
+         ta.pers0 == tb.pers0 && ta.pers1 == tb.pers1 &&
+         ta.pers2 == tb.pers2 && a.label == b.label && a.hint == b.hint &&
+         a.value == b.value && a.increased_value == b.increased_value &&
+         a.decreased_value == b.decreased_value &&
+         a.children_in_traversal_order == b.children_in_traversal_order &&
+         a.custom_accessibility_actions == b.custom_accessibility_actions;
+}
+
 AccessibilityBridge::SemanticsNode
 AccessibilityBridge::FromFlutterSemanticsNode(
     const FlutterSemanticsNode* flutter_node) {
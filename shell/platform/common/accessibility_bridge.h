@@ -134,7 +134,9 @@ class AccessibilityBridge
   ///             of an atomic batch to avoid leaving the tree in a unstable
   ///             state. For example if a node reparents from A to B, callers
   ///             should only call this method when both removal from A and
-  ///             addition to B are in the pending updates.
+  ///             addition to B are in the pending updates. Pending nodes
+  ///             that are identical to the ones already in the tree are not
+  ///             applied again.
   void CommitUpdates();
 
   //------------------------------------------------------------------------------
@@ -197,11 +199,15 @@ class AccessibilityBridge
   std::unordered_map<int32_t, SemanticsNode> pending_semantics_node_updates_;
   std::unordered_map<int32_t, SemanticsCustomAction>
       pending_semantics_custom_action_updates_;
+  // The last update of every node in |tree_|, used to leave out the pending
+  // updates that would not change the tree.
+  std::unordered_map<int32_t, SemanticsNode> committed_semantics_nodes_;
   AccessibilityNodeId last_focused_id_ = ui::AXNode::kInvalidAXID;
   std::unique_ptr<AccessibilityBridgeDelegate> delegate_;
 
   void InitAXTree(const ui::AXTreeUpdate& initial_state);
   void GetSubTreeList(SemanticsNode target, std::vector<SemanticsNode>& result);
+  bool IsCommittedFlutterUpdate(const SemanticsNode& node);
   void ConvertFluterUpdate(const SemanticsNode& node,
                            ui::AXTreeUpdate& tree_update);
   void SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -223,6 +229,8 @@ class AccessibilityBridge
   void SetValueFromFlutterUpdate(ui::AXNodeData& node_data,
                                  const SemanticsNode& node);
   void SetTreeData(const SemanticsNode& node, ui::AXTreeUpdate& tree_update);
+  static bool SemanticsNodeEquals(const SemanticsNode& a,
+                                  const SemanticsNode& b);
   SemanticsNode FromFlutterSemanticsNode(
       const FlutterSemanticsNode* flutter_node);
   SemanticsCustomAction FromFlutterSemanticsCustomAction(
@@ -0,0 +1,118 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/accessibility_bridge.h"
+#include "flutter/shell/platform/common/test_accessibility_bridge.h"
+
+namespace flutter {
+
+namespace {
+
+// A semantics tree shaped like a long list: a root with |kRowSize| children
+// per row, each row holding |kRowSize| leaves.
+constexpr int kRowSize = 100;
+
+class SemanticsTree {
+ public:
+  explicit SemanticsTree(int node_count) : labels_(node_count) {
+    nodes_.resize(node_count);
+    children_.resize(node_count);
+    for (int id = 0; id < node_count; id++) {
+      labels_[id] = "node " + std::to_string(id);
+      FlutterSemanticsNode& node = nodes_[id];
+      node = {};
+      node.id = id;
+      node.text_selection_base = -1;
+      node.text_selection_extent = -1;
+      node.label = labels_[id].c_str();
+      node.hint = "";
+      node.value = "";
+      node.increased_value = "";
+      node.decreased_value = "";
+      node.rect = {0, 0, 100, 20};
+      node.transform = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+      if (id > 0) {
+        int parent = id <= kRowSize ? 0 : (id - 1) / kRowSize;
+        children_[parent].push_back(id);
+      }
+    }
+    for (int id = 0; id < node_count; id++) {
+      nodes_[id].child_count = children_[id].size();
+      nodes_[id].children_in_traversal_order = children_[id].data();
+    }
+  }
+
+  // Relabels |count| nodes, as a frame that updates some text does.
+  void Relabel(int count, int generation) {
+    for (int i = 0; i < count; i++) {
+      int id = 1 + (generation * count + i) % (nodes_.size() - 1);
+      labels_[id] = "node " + std::to_string(id) + " v" +
+                    std::to_string(generation);
+      nodes_[id].label = labels_[id].c_str();
+    }
+  }
+
+  // Sends every node to |bridge|, as the framework does for the dirty
+  // semantics nodes of a frame, and commits them.
+  void Send(AccessibilityBridge& bridge) const {
+    for (const FlutterSemanticsNode& node : nodes_) {
+      bridge.AddFlutterSemanticsNodeUpdate(&node);
+    }
+    bridge.CommitUpdates();
+  }
+
+ private:
+  std::vector<std::string> labels_;
+  std::vector<FlutterSemanticsNode> nodes_;
+  std::vector<std::vector<int32_t>> children_;
+};
+
+}  // namespace
+
+static void BM_AccessibilityBridgeCreateTree(
+    benchmark::State& state) {  // NOLINT
+  SemanticsTree tree(state.range(0));
+  while (state.KeepRunning()) {
+    auto bridge = std::make_shared<AccessibilityBridge>(
+        std::make_unique<TestAccessibilityBridgeDelegate>());
+    tree.Send(*bridge);
+    benchmark::DoNotOptimize(bridge);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AccessibilityBridgeCreateTree)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+// Resends a whole tree in which |state.range(1)| nodes changed.
+static void BM_AccessibilityBridgeUpdateTree(
+    benchmark::State& state) {  // NOLINT
+  SemanticsTree tree(state.range(0));
+  auto bridge = std::make_shared<AccessibilityBridge>(
+      std::make_unique<TestAccessibilityBridgeDelegate>());
+  tree.Send(*bridge);
+  int generation = 0;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    tree.Relabel(state.range(1), generation++);
+    state.ResumeTiming();
+    tree.Send(*bridge);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AccessibilityBridgeUpdateTree)
+    ->ArgPair(1000, 10)
+    ->ArgPair(10000, 10)
+    ->ArgPair(10000, 10000)
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace flutter
@@ -200,5 +200,143 @@ TEST(AccessibilityBridgeTest, canHandleSelectionChangeCorrectly) {
             ui::AXEventGenerator::Event::OTHER_ATTRIBUTE_CHANGED);
 }
 
+TEST(AccessibilityBridgeTest, onlyAppliesChangedNodes) {
+  TestAccessibilityBridgeDelegate* delegate =
+      new TestAccessibilityBridgeDelegate();
+  std::unique_ptr<TestAccessibilityBridgeDelegate> ptr(delegate);
+  std::shared_ptr<AccessibilityBridge> bridge =
+      std::make_shared<AccessibilityBridge>(std::move(ptr));
+  FlutterSemanticsNode root = {};
+  root.id = 0;
+  root.text_selection_base = -1;
+  root.text_selection_extent = -1;
+  root.label = "root";
+  root.hint = "";
+  root.value = "";
+  root.increased_value = "";
+  root.decreased_value = "";
+  root.child_count = 2;
+  int32_t children[] = {1, 2};
+  root.children_in_traversal_order = children;
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+
+  FlutterSemanticsNode child1 = {};
+  child1.id = 1;
+  child1.text_selection_base = -1;
+  child1.text_selection_extent = -1;
+  child1.label = "child 1";
+  child1.hint = "";
+  child1.value = "";
+  child1.increased_value = "";
+  child1.decreased_value = "";
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+
+  FlutterSemanticsNode child2 = child1;
+  child2.id = 2;
+  child2.label = "child 2";
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+
+  bridge->CommitUpdates();
+  delegate->accessibilitiy_events.clear();
+
+  // Resending identical nodes leaves the tree untouched.
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->CommitUpdates();
+  EXPECT_TRUE(delegate->accessibilitiy_events.empty());
+
+  // Only the node that changed is updated.
+  child2.label = "new child 2";
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->CommitUpdates();
+
+  auto child1_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  auto child2_node = bridge->GetFlutterPlatformNodeDelegateFromID(2).lock();
+  EXPECT_EQ(child1_node->GetName(), "child 1");
+  EXPECT_EQ(child2_node->GetName(), "new child 2");
+  ASSERT_FALSE(delegate->accessibilitiy_events.empty());
+  for (const auto& event : delegate->accessibilitiy_events) {
+    EXPECT_EQ(event.node->id(), 2);
+  }
+}
+
+TEST(AccessibilityBridgeTest, canReparentUnchangedNodes) {
+  std::shared_ptr<AccessibilityBridge> bridge =
+      std::make_shared<AccessibilityBridge>(
+          std::make_unique<TestAccessibilityBridgeDelegate>());
+  FlutterSemanticsNode root = {};
+  root.id = 0;
+  root.text_selection_base = -1;
+  root.text_selection_extent = -1;
+  root.label = "root";
+  root.hint = "";
+  root.value = "";
+  root.increased_value = "";
+  root.decreased_value = "";
+  root.child_count = 2;
+  int32_t root_children[] = {1, 2};
+  root.children_in_traversal_order = root_children;
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+
+  FlutterSemanticsNode parent1 = root;
+  parent1.id = 1;
+  parent1.label = "parent 1";
+  parent1.child_count = 1;
+  int32_t parent1_children[] = {3};
+  parent1.children_in_traversal_order = parent1_children;
+  bridge->AddFlutterSemanticsNodeUpdate(&parent1);
+
+  FlutterSemanticsNode parent2 = root;
+  parent2.id = 2;
+  parent2.label = "parent 2";
+  parent2.child_count = 0;
+  parent2.children_in_traversal_order = nullptr;
+  bridge->AddFlutterSemanticsNodeUpdate(&parent2);
+
+  FlutterSemanticsNode child = root;
+  child.id = 3;
+  child.label = "child";
+  child.child_count = 1;
+  int32_t child_children[] = {4};
+  child.children_in_traversal_order = child_children;
+  bridge->AddFlutterSemanticsNodeUpdate(&child);
+
+  FlutterSemanticsNode grandchild = parent2;
+  grandchild.id = 4;
+  grandchild.label = "grandchild";
+  bridge->AddFlutterSemanticsNodeUpdate(&grandchild);
+
+  bridge->CommitUpdates();
+
+  // Move the unchanged subtree of node 3 from node 1 to node 2.
+  parent1.child_count = 0;
+  parent1.children_in_traversal_order = nullptr;
+  parent2.child_count = 1;
+  parent2.children_in_traversal_order = parent1_children;
+  bridge->AddFlutterSemanticsNodeUpdate(&parent1);
+  bridge->AddFlutterSemanticsNodeUpdate(&parent2);
+  bridge->AddFlutterSemanticsNodeUpdate(&child);
+  bridge->AddFlutterSemanticsNodeUpdate(&grandchild);
+  bridge->CommitUpdates();
+
+  auto parent1_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  auto parent2_node = bridge->GetFlutterPlatformNodeDelegateFromID(2).lock();
+  auto child_node = bridge->GetFlutterPlatformNodeDelegateFromID(3).lock();
+  auto grandchild_node =
+      bridge->GetFlutterPlatformNodeDelegateFromID(4).lock();
+  EXPECT_EQ(parent1_node->GetChildCount(), 0);
+  EXPECT_EQ(parent2_node->GetChildCount(), 1);
+  EXPECT_EQ(parent2_node->GetData().child_ids[0], 3);
+  ASSERT_TRUE(child_node);
+  EXPECT_EQ(child_node->GetChildCount(), 1);
+  EXPECT_EQ(child_node->GetData().child_ids[0], 4);
+  EXPECT_EQ(child_node->GetName(), "child");
+  ASSERT_TRUE(grandchild_node);
+  EXPECT_EQ(grandchild_node->GetName(), "grandchild");
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -0,0 +1,292 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "encodable_value.h"
+
+namespace flutter {
+
+// A bump allocator holding the lists and maps of the EncodableValueViews
+// decoded from a message.
+//
+// Memory is handed out from large blocks and only released all at once, when
+// the arena is reset or destroyed, so decoding a message costs a handful of
+// allocations regardless of how many values it contains. An arena can be
+// reused for successive messages by calling Reset() once the views decoded
+// into it are no longer in use.
+class EncodableValueArena {
+ public:
+  // Creates an arena that allocates blocks of at least |block_size| bytes.
+  explicit EncodableValueArena(size_t block_size = 4096)
+      : block_size_(block_size) {}
+
+  ~EncodableValueArena() = default;
+
+  // Prevent copying.
+  EncodableValueArena(EncodableValueArena const&) = delete;
+  EncodableValueArena& operator=(EncodableValueArena const&) = delete;
+
+  // Returns uninitialized storage for |count| objects of type T, or nullptr if
+  // |count| is zero. The arena never runs destructors, so T must be trivially
+  // destructible.
+  template <typename T>
+  T* Allocate(size_t count) {
+    static_assert(std::is_trivially_destructible_v<T>,
+                  "Arena objects are never destroyed.");
+    if (count == 0) {
+      return nullptr;
+    }
+    return static_cast<T*>(AllocateBytes(count * sizeof(T), alignof(T)));
+  }
+
+  // Invalidates everything allocated so far. The first block is kept to serve
+  // later allocations.
+  void Reset() {
+    if (blocks_.empty()) {
+      return;
+    }
+    blocks_.resize(1);
+    next_ = blocks_[0].data.get();
+    remaining_ = blocks_[0].size;
+    allocated_bytes_ = 0;
+  }
+
+  // The number of bytes handed out since the arena was created or reset,
+  // including alignment padding.
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+ private:
+  struct Block {
+    std::unique_ptr<uint8_t[]> data;
+    size_t size;
+  };
+
+  void* AllocateBytes(size_t size, size_t alignment) {
+    size_t padding = Padding(next_, alignment);
+    if (next_ == nullptr || padding + size > remaining_) {
+      size_t block_size = std::max(block_size_, size + alignment);
+      blocks_.push_back({std::unique_ptr<uint8_t[]>(new uint8_t[block_size]),
+                         block_size});
+      next_ = blocks_.back().data.get();
+      remaining_ = block_size;
+      padding = Padding(next_, alignment);
+    }
+    void* result = next_ + padding;
+    next_ += padding + size;
+    remaining_ -= padding + size;
+    allocated_bytes_ += padding + size;
+    return result;
+  }
+
+  static size_t Padding(const uint8_t* pointer, size_t alignment) {
+    size_t misalignment = reinterpret_cast<uintptr_t>(pointer) % alignment;
+    return misalignment == 0 ? 0 : alignment - misalignment;
+  }
+
+  size_t block_size_;
+  std::vector<Block> blocks_;
+  uint8_t* next_ = nullptr;
+  size_t remaining_ = 0;
+  size_t allocated_bytes_ = 0;
+};
+
+// A read-only view of a contiguous sequence of T, in the manner of C++20's
+// std::span.
+template <typename T>
+class EncodableSpan {
+ public:
+  using value_type = T;
+  using const_iterator = const T*;
+
+  constexpr EncodableSpan() = default;
+
+  constexpr EncodableSpan(const T* data, size_t size)
+      : data_(data), size_(size) {}
+
+  const T* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const T* begin() const { return data_; }
+  const T* end() const { return data_ + size_; }
+
+  const T& operator[](size_t index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  // Returns a copy of the elements.
+  std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+
+  // Spans compare by their elements, like the vectors they stand in for.
+  bool operator==(const EncodableSpan& other) const {
+    return std::equal(begin(), end(), other.begin(), other.end());
+  }
+  bool operator!=(const EncodableSpan& other) const {
+    return !(*this == other);
+  }
+  bool operator<(const EncodableSpan& other) const {
+    return std::lexicographical_compare(begin(), end(), other.begin(),
+                                        other.end());
+  }
+
+ private:
+  const T* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+class EncodableValueView;
+
+// A list of views, allocated in an EncodableValueArena.
+using EncodableListView = EncodableSpan<EncodableValueView>;
+
+// A map of views, stored as key-value pairs sorted by key in an
+// EncodableValueArena. Keys are ordered as in EncodableMap, and if a message
+// contains duplicate keys, only the first one can be found.
+class EncodableMapView
+    : public EncodableSpan<std::pair<EncodableValueView, EncodableValueView>> {
+ public:
+  using EncodableSpan::EncodableSpan;
+
+  // Returns the value for |key|, or nullptr if the map doesn't contain it.
+  const EncodableValueView* Find(const EncodableValueView& key) const;
+
+  // Returns the value for the string |key|, or nullptr if the map doesn't
+  // contain it.
+  const EncodableValueView* Find(std::string_view key) const;
+  const EncodableValueView* Find(const char* key) const {
+    return Find(std::string_view(key));
+  }
+};
+
+namespace internal {
+// The order of the types here must match EncodableValueVariant, so that a
+// view and the value it represents have the same index().
+using EncodableValueViewVariant = std::variant<std::monostate,
+                                               bool,
+                                               int32_t,
+                                               int64_t,
+                                               double,
+                                               std::string_view,
+                                               EncodableSpan<uint8_t>,
+                                               EncodableSpan<int32_t>,
+                                               EncodableSpan<int64_t>,
+                                               EncodableSpan<double>,
+                                               EncodableListView,
+                                               EncodableMapView>;
+}  // namespace internal
+
+// A non-owning counterpart of EncodableValue, produced by the zero-copy
+// decoding methods of the standard codecs.
+//
+// Strings and typed lists point directly into the decoded message whenever
+// its layout allows, while lists and maps are allocated in an
+// EncodableValueArena. A view is only valid as long as both the message and
+// the arena it was decoded into; use ToEncodableValue() to keep a value
+// beyond that.
+//
+// Views have no equivalent of CustomEncodableValue.
+class EncodableValueView : public internal::EncodableValueViewVariant {
+ public:
+  using super = internal::EncodableValueViewVariant;
+  using super::super;
+  using super::operator=;
+
+  // Returns true if the value is null.
+  bool IsNull() const { return std::holds_alternative<std::monostate>(*this); }
+
+  // Returns the value as an int64_t, accepting both int32_t and int64_t, as
+  // EncodableValue::LongValue does.
+  int64_t LongValue() const {
+    if (std::holds_alternative<int32_t>(*this)) {
+      return std::get<int32_t>(*this);
+    }
+    return std::get<int64_t>(*this);
+  }
+
+  // Returns a deep copy of the value that references neither the message nor
+  // the arena.
+  EncodableValue ToEncodableValue() const {
+    switch (index()) {
+      case 0:
+        return EncodableValue();
+      case 1:
+        return EncodableValue(std::get<bool>(*this));
+      case 2:
+        return EncodableValue(std::get<int32_t>(*this));
+      case 3:
+        return EncodableValue(std::get<int64_t>(*this));
+      case 4:
+        return EncodableValue(std::get<double>(*this));
+      case 5:
+        return EncodableValue(std::string(std::get<std::string_view>(*this)));
+      case 6:
+        return EncodableValue(
+            std::get<EncodableSpan<uint8_t>>(*this).ToVector());
+      case 7:
+        return EncodableValue(
+            std::get<EncodableSpan<int32_t>>(*this).ToVector());
+      case 8:
+        return EncodableValue(
+            std::get<EncodableSpan<int64_t>>(*this).ToVector());
+      case 9:
+        return EncodableValue(
+            std::get<EncodableSpan<double>>(*this).ToVector());
+      case 10: {
+        const auto& list_view = std::get<EncodableListView>(*this);
+        EncodableList list;
+        list.reserve(list_view.size());
+        for (const auto& item : list_view) {
+          list.push_back(item.ToEncodableValue());
+        }
+        return EncodableValue(std::move(list));
+      }
+      case 11: {
+        EncodableMap map;
+        for (const auto& pair : std::get<EncodableMapView>(*this)) {
+          map.emplace(pair.first.ToEncodableValue(),
+                      pair.second.ToEncodableValue());
+        }
+        return EncodableValue(std::move(map));
+      }
+    }
+    assert(false);
+    return EncodableValue();
+  }
+};
+
+inline const EncodableValueView* EncodableMapView::Find(
+    const EncodableValueView& key) const {
+  auto it = std::lower_bound(
+      begin(), end(), key,
+      [](const auto& pair, const EncodableValueView& key) {
+        return pair.first < key;
+      });
+  if (it == end() || it->first != key) {
+    return nullptr;
+  }
+  return &it->second;
+}
+
+inline const EncodableValueView* EncodableMapView::Find(
+    std::string_view key) const {
+  return Find(EncodableValueView(key));
+}
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_ENCODABLE_VALUE_VIEW_H_
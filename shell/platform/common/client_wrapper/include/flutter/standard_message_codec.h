@@ -6,8 +6,11 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_MESSAGE_CODEC_H_
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "encodable_value.h"
+#include "encodable_value_view.h"
 #include "message_codec.h"
 #include "standard_codec_serializer.h"
 
@@ -35,6 +38,24 @@ class StandardMessageCodec : public MessageCodec<EncodableValue> {
   StandardMessageCodec(StandardMessageCodec const&) = delete;
   StandardMessageCodec& operator=(StandardMessageCodec const&) = delete;
 
+  // Decodes |binary_message| without copying its contents: strings and typed
+  // lists in the result point into |binary_message|, while lists and maps are
+  // allocated in |arena|. The result is only valid while both are alive.
+  //
+  // Returns std::nullopt if the message is malformed or contains a type that
+  // is not part of the standard encoding, since views can't represent the
+  // values of custom serializers.
+  std::optional<EncodableValueView> DecodeMessageView(
+      const uint8_t* binary_message,
+      size_t message_size,
+      EncodableValueArena* arena) const;
+
+  // Convenience wrapper around DecodeMessageView for a message held in a
+  // vector, which must outlive the result.
+  std::optional<EncodableValueView> DecodeMessageView(
+      const std::vector<uint8_t>& message,
+      EncodableValueArena* arena) const;
+
  protected:
   // |flutter::MessageCodec|
   std::unique_ptr<EncodableValue> DecodeMessageInternal(
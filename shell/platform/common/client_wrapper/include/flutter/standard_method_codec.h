@@ -6,14 +6,24 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_METHOD_CODEC_H_
 
 #include <memory>
+#include <optional>
+#include <string_view>
 
 #include "encodable_value.h"
+#include "encodable_value_view.h"
 #include "method_call.h"
 #include "method_codec.h"
 #include "standard_codec_serializer.h"
 
 namespace flutter {
 
+// A method call decoded by StandardMethodCodec::DecodeMethodCallView, which
+// references the message it was decoded from.
+struct EncodableMethodCallView {
+  std::string_view method_name;
+  EncodableValueView arguments;
+};
+
 // An implementation of MethodCodec that uses a binary serialization.
 class StandardMethodCodec : public MethodCodec<EncodableValue> {
  public:
@@ -35,6 +45,16 @@ class StandardMethodCodec : public MethodCodec<EncodableValue> {
   StandardMethodCodec(StandardMethodCodec const&) = delete;
   StandardMethodCodec& operator=(StandardMethodCodec const&) = delete;
 
+  // Decodes the method call in |message| without copying its contents, as
+  // StandardMessageCodec::DecodeMessageView does. The result is only valid
+  // while both |message| and |arena| are alive.
+  //
+  // Returns std::nullopt if the message is not a valid method call.
+  std::optional<EncodableMethodCallView> DecodeMethodCallView(
+      const uint8_t* message,
+      size_t message_size,
+      EncodableValueArena* arena) const;
+
  protected:
   // |flutter::MethodCodec|
   std::unique_ptr<MethodCall<EncodableValue>> DecodeMethodCallInternal(
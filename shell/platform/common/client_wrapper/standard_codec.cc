@@ -7,14 +7,19 @@
 // together to simplify use of the client wrapper, since the common case is
 // that any client that needs one of these files needs all three.
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <new>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "byte_buffer_streams.h"
+#include "include/flutter/encodable_value_view.h"
 #include "include/flutter/standard_codec_serializer.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
@@ -277,6 +282,213 @@ void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
                      count * type_size);
 }
 
+// ===== encodable_value_view.h =====
+
+namespace {
+
+// Decodes the standard encoding into EncodableValueViews.
+//
+// Unlike StandardCodecSerializer, this references the bytes of the message
+// instead of copying them, and checks every read against the end of the
+// message, since a view must never point outside of it.
+class EncodableValueViewReader {
+ public:
+  EncodableValueViewReader(const uint8_t* bytes,
+                           size_t size,
+                           EncodableValueArena* arena)
+      : bytes_(bytes), size_(size), arena_(arena) {}
+
+  // Reads the next value into |value|. Returns false if the message is
+  // truncated or contains a type that views can't represent.
+  bool ReadValue(EncodableValueView* value) {
+    uint8_t type;
+    if (!ReadByte(&type)) {
+      return false;
+    }
+    switch (static_cast<EncodedType>(type)) {
+      case EncodedType::kNull:
+        *value = std::monostate();
+        return true;
+      case EncodedType::kTrue:
+        *value = true;
+        return true;
+      case EncodedType::kFalse:
+        *value = false;
+        return true;
+      case EncodedType::kInt32:
+        return ReadScalar<int32_t>(value);
+      case EncodedType::kInt64:
+        return ReadScalar<int64_t>(value);
+      case EncodedType::kFloat64:
+        return ReadAlignment(8) && ReadScalar<double>(value);
+      case EncodedType::kLargeInt:
+      case EncodedType::kString: {
+        size_t size;
+        if (!ReadSize(&size) || size > Remaining()) {
+          return false;
+        }
+        *value = std::string_view(
+            reinterpret_cast<const char*>(ReadBytes(size)), size);
+        return true;
+      }
+      case EncodedType::kUInt8List:
+        return ReadVector<uint8_t>(value);
+      case EncodedType::kInt32List:
+        return ReadVector<int32_t>(value);
+      case EncodedType::kInt64List:
+        return ReadVector<int64_t>(value);
+      case EncodedType::kFloat64List:
+        return ReadVector<double>(value);
+      case EncodedType::kList: {
+        size_t length;
+        // Every value takes at least a byte, which bounds the allocation.
+        if (!ReadSize(&length) || length > Remaining()) {
+          return false;
+        }
+        auto* items = arena_->Allocate<EncodableValueView>(length);
+        for (size_t i = 0; i < length; ++i) {
+          new (&items[i]) EncodableValueView();
+          if (!ReadValue(&items[i])) {
+            return false;
+          }
+        }
+        *value = EncodableListView(items, length);
+        return true;
+      }
+      case EncodedType::kMap: {
+        using Entry = std::pair<EncodableValueView, EncodableValueView>;
+        size_t length;
+        if (!ReadSize(&length) || length > Remaining() / 2) {
+          return false;
+        }
+        auto* entries = arena_->Allocate<Entry>(length);
+        for (size_t i = 0; i < length; ++i) {
+          new (&entries[i]) Entry();
+          if (!ReadValue(&entries[i].first) ||
+              !ReadValue(&entries[i].second)) {
+            return false;
+          }
+        }
+        // Maps encoded from an EncodableMap are already sorted. The sort is
+        // stable so that, as with EncodableMap, the first of duplicate keys
+        // wins.
+        auto compare_keys = [](const Entry& a, const Entry& b) {
+          return a.first < b.first;
+        };
+        if (!std::is_sorted(entries, entries + length, compare_keys)) {
+          std::stable_sort(entries, entries + length, compare_keys);
+        }
+        *value = EncodableMapView(entries, length);
+        return true;
+      }
+    }
+    std::cerr << "Unsupported type in StandardMessageCodec::DecodeMessageView: "
+              << static_cast<int>(type) << std::endl;
+    return false;
+  }
+
+ private:
+  size_t Remaining() const { return size_ - position_; }
+
+  bool ReadByte(uint8_t* byte) {
+    if (Remaining() < 1) {
+      return false;
+    }
+    *byte = bytes_[position_++];
+    return true;
+  }
+
+  // Returns the next |length| bytes, which the caller must have checked are
+  // available.
+  const uint8_t* ReadBytes(size_t length) {
+    const uint8_t* bytes = bytes_ + position_;
+    position_ += length;
+    return bytes;
+  }
+
+  template <typename T>
+  bool ReadScalar(EncodableValueView* value) {
+    if (Remaining() < sizeof(T)) {
+      return false;
+    }
+    T scalar;
+    std::memcpy(&scalar, ReadBytes(sizeof(T)), sizeof(T));
+    *value = scalar;
+    return true;
+  }
+
+  bool ReadAlignment(size_t alignment) {
+    size_t mod = position_ % alignment;
+    if (mod == 0) {
+      return true;
+    }
+    if (Remaining() < alignment - mod) {
+      return false;
+    }
+    position_ += alignment - mod;
+    return true;
+  }
+
+  bool ReadSize(size_t* size) {
+    uint8_t byte;
+    if (!ReadByte(&byte)) {
+      return false;
+    }
+    if (byte < 254) {
+      *size = byte;
+      return true;
+    }
+    size_t width = byte == 254 ? 2 : 4;
+    if (Remaining() < width) {
+      return false;
+    }
+    if (width == 2) {
+      uint16_t value;
+      std::memcpy(&value, ReadBytes(2), 2);
+      *size = value;
+    } else {
+      uint32_t value;
+      std::memcpy(&value, ReadBytes(4), 4);
+      *size = value;
+    }
+    return true;
+  }
+
+  template <typename T>
+  bool ReadVector(EncodableValueView* value) {
+    size_t count;
+    if (!ReadSize(&count)) {
+      return false;
+    }
+    if (sizeof(T) > 1 && !ReadAlignment(sizeof(T))) {
+      return false;
+    }
+    if (count > Remaining() / sizeof(T)) {
+      return false;
+    }
+    const uint8_t* bytes = ReadBytes(count * sizeof(T));
+    if (reinterpret_cast<uintptr_t>(bytes) % alignof(T) == 0) {
+      *value = EncodableSpan<T>(reinterpret_cast<const T*>(bytes), count);
+      return true;
+    }
+    // The encoding aligns elements relative to the start of the message, so
+    // they are only aligned in memory if the message itself is.
+    T* elements = arena_->Allocate<T>(count);
+    if (count > 0) {
+      std::memcpy(elements, bytes, count * sizeof(T));
+    }
+    *value = EncodableSpan<T>(elements, count);
+    return true;
+  }
+
+  const uint8_t* bytes_;
+  size_t size_;
+  size_t position_ = 0;
+  EncodableValueArena* arena_;
+};
+
+}  // namespace
+
 // ===== standard_message_codec.h =====
 
 // static
@@ -312,6 +524,24 @@ std::unique_ptr<EncodableValue> StandardMessageCodec::DecodeMessageInternal(
   return std::make_unique<EncodableValue>(serializer_->ReadValue(&stream));
 }
 
+std::optional<EncodableValueView> StandardMessageCodec::DecodeMessageView(
+    const uint8_t* binary_message,
+    size_t message_size,
+    EncodableValueArena* arena) const {
+  EncodableValueViewReader reader(binary_message, message_size, arena);
+  EncodableValueView value;
+  if (!reader.ReadValue(&value)) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+std::optional<EncodableValueView> StandardMessageCodec::DecodeMessageView(
+    const std::vector<uint8_t>& message,
+    EncodableValueArena* arena) const {
+  return DecodeMessageView(message.data(), message.size(), arena);
+}
+
 std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
@@ -366,6 +596,28 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
                                                       std::move(arguments));
 }
 
+std::optional<EncodableMethodCallView>
+StandardMethodCodec::DecodeMethodCallView(const uint8_t* message,
+                                          size_t message_size,
+                                          EncodableValueArena* arena) const {
+  EncodableValueViewReader reader(message, message_size, arena);
+  EncodableMethodCallView method_call;
+  EncodableValueView method_name;
+  if (!reader.ReadValue(&method_name)) {
+    return std::nullopt;
+  }
+  if (!std::holds_alternative<std::string_view>(method_name)) {
+    std::cerr << "Invalid method call; method name is not a string."
+              << std::endl;
+    return std::nullopt;
+  }
+  method_call.method_name = std::get<std::string_view>(method_name);
+  if (!reader.ReadValue(&method_call.arguments)) {
+    return std::nullopt;
+  }
+  return method_call;
+}
+
 std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
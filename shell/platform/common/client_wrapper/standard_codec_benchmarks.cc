@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/encodable_value_view.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_method_codec.h"
+
+namespace flutter {
+
+// Builds a message shaped like a typical plugin payload: a map of records,
+// each with a few strings and numbers, plus a block of typed data.
+static EncodableValue CreateMessage(int record_count) {
+  EncodableList records;
+  for (int i = 0; i < record_count; i++) {
+    records.push_back(EncodableValue(EncodableMap{
+        {EncodableValue("id"), EncodableValue(i)},
+        {EncodableValue("name"), EncodableValue("record " + std::to_string(i))},
+        {EncodableValue("path"),
+         EncodableValue("/storage/emulated/0/Pictures/" + std::to_string(i) +
+                        ".jpg")},
+        {EncodableValue("timestamp"), EncodableValue(int64_t{1600000000000})},
+        {EncodableValue("scale"), EncodableValue(1.5)},
+        {EncodableValue("selected"), EncodableValue(i % 2 == 0)},
+    }));
+  }
+  return EncodableValue(EncodableMap{
+      {EncodableValue("records"), EncodableValue(std::move(records))},
+      {EncodableValue("samples"),
+       EncodableValue(std::vector<double>(record_count * 8, 0.25))},
+  });
+}
+
+static void BM_StandardMessageCodecEncode(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const EncodableValue message = CreateMessage(state.range(0));
+  size_t encoded_size = 0;
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(message);
+    encoded_size = encoded->size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded_size);
+}
+
+BENCHMARK(BM_StandardMessageCodecEncode)->Arg(1)->Arg(100)->Arg(1000);
+
+static void BM_StandardMessageCodecDecode(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const auto encoded = codec.EncodeMessage(CreateMessage(state.range(0)));
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    benchmark::DoNotOptimize(decoded);
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+BENCHMARK(BM_StandardMessageCodecDecode)->Arg(1)->Arg(100)->Arg(1000);
+
+// Decodes into views, reusing one arena as a channel handler would.
+static void BM_StandardMessageCodecDecodeView(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = StandardMessageCodec::GetInstance();
+  const auto encoded = codec.EncodeMessage(CreateMessage(state.range(0)));
+  EncodableValueArena arena;
+  size_t arena_bytes = 0;
+  while (state.KeepRunning()) {
+    arena.Reset();
+    auto decoded = codec.DecodeMessageView(*encoded, &arena);
+    benchmark::DoNotOptimize(decoded);
+    arena_bytes = arena.allocated_bytes();
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+  state.counters["arena_bytes"] = arena_bytes;
+}
+
+BENCHMARK(BM_StandardMessageCodecDecodeView)->Arg(1)->Arg(100)->Arg(1000);
+
+// Decodes a method call and looks up one of its arguments, the common work of
+// a method channel handler, with |state.range(1)| selecting views.
+static void BM_StandardMethodCodecDecodeMethodCall(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = StandardMethodCodec::GetInstance();
+  const auto encoded = codec.EncodeMethodCall(MethodCall<EncodableValue>(
+      "loadRecords",
+      std::make_unique<EncodableValue>(CreateMessage(state.range(0)))));
+  const bool use_views = state.range(1) != 0;
+  EncodableValueArena arena;
+  while (state.KeepRunning()) {
+    if (use_views) {
+      arena.Reset();
+      auto method_call =
+          codec.DecodeMethodCallView(encoded->data(), encoded->size(), &arena);
+      const auto& arguments =
+          std::get<EncodableMapView>(method_call->arguments);
+      benchmark::DoNotOptimize(arguments.Find("records"));
+    } else {
+      auto method_call = codec.DecodeMethodCall(*encoded);
+      const auto& arguments =
+          std::get<EncodableMap>(*method_call->arguments());
+      benchmark::DoNotOptimize(arguments.find(EncodableValue("records")));
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+BENCHMARK(BM_StandardMethodCodecDecodeMethodCall)
+    ->ArgPair(1, false)
+    ->ArgPair(1, true)
+    ->ArgPair(100, false)
+    ->ArgPair(100, true);
+
+}  // namespace flutter
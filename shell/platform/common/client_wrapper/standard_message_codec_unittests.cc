@@ -4,6 +4,7 @@
 
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
 
+#include <cstring>
 #include <map>
 #include <vector>
 
@@ -12,6 +13,16 @@
 
 namespace flutter {
 
+// Validates that decoding |encoding| into a view yields |value|.
+static void CheckDecodeView(const EncodableValue& value,
+                            const std::vector<uint8_t>& encoding) {
+  EncodableValueArena arena;
+  auto view =
+      StandardMessageCodec::GetInstance().DecodeMessageView(encoding, &arena);
+  ASSERT_TRUE(view.has_value());
+  EXPECT_EQ(value, view->ToEncodableValue());
+}
+
 // Validates round-trip encoding and decoding of |value|, and checks that the
 // encoded value matches |expected_encoding|.
 //
@@ -35,6 +46,7 @@ static void CheckEncodeDecode(
     EXPECT_TRUE(custom_comparator(value, *decoded));
   } else {
     EXPECT_EQ(value, *decoded);
+    CheckDecodeView(value, *encoded);
   }
 }
 
@@ -61,6 +73,7 @@ static void CheckEncodeDecodeWithEncodePrefix(
   auto decoded = codec.DecodeMessage(*encoded);
 
   EXPECT_EQ(value, *decoded);
+  CheckDecodeView(value, *encoded);
 }
 
 TEST(StandardMessageCodec, CanEncodeAndDecodeNull) {
@@ -219,4 +232,90 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeVariableLengthCustomType) {
                     some_data_comparator);
 }
 
+TEST(StandardMessageCodec, DecodeMessageViewReferencesTheMessage) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(EncodableValue(EncodableList{
+      EncodableValue("hello"),
+      EncodableValue(std::vector<int32_t>{1, 2, 3}),
+  }));
+  EncodableValueArena arena;
+  auto view = codec.DecodeMessageView(*encoded, &arena);
+  ASSERT_TRUE(view.has_value());
+
+  const auto& list = std::get<EncodableListView>(*view);
+  ASSERT_EQ(list.size(), 2u);
+  auto string = std::get<std::string_view>(list[0]);
+  EXPECT_EQ(string, "hello");
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(string.data()), encoded->data());
+  EXPECT_LT(reinterpret_cast<const uint8_t*>(string.data()),
+            encoded->data() + encoded->size());
+  auto int_list = std::get<EncodableSpan<int32_t>>(list[1]);
+  EXPECT_EQ(int_list.ToVector(), std::vector<int32_t>({1, 2, 3}));
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(int_list.data()),
+            encoded->data());
+  EXPECT_LT(reinterpret_cast<const uint8_t*>(int_list.data()),
+            encoded->data() + encoded->size());
+}
+
+TEST(StandardMessageCodec, DecodeMessageViewCopiesMisalignedTypedLists) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  std::vector<double> doubles = {1.5, -2.25};
+  auto encoded = codec.EncodeMessage(EncodableValue(doubles));
+  // Shifts the message so that its doubles are misaligned in memory.
+  std::vector<uint8_t> buffer(encoded->size() + 1);
+  std::memcpy(buffer.data() + 1, encoded->data(), encoded->size());
+  EncodableValueArena arena;
+  auto view =
+      codec.DecodeMessageView(buffer.data() + 1, encoded->size(), &arena);
+  ASSERT_TRUE(view.has_value());
+
+  auto span = std::get<EncodableSpan<double>>(*view);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(span.data()) % alignof(double), 0u);
+  EXPECT_EQ(span.ToVector(), doubles);
+}
+
+TEST(StandardMessageCodec, DecodeMessageViewSortsMaps) {
+  // {"b": 1, "a": 2, "b": 3}, in the order a Dart map would send it.
+  std::vector<uint8_t> bytes = {
+      0x0d, 0x03, 0x07, 0x01, 0x62, 0x03, 0x01, 0x00, 0x00, 0x00,
+      0x07, 0x01, 0x61, 0x03, 0x02, 0x00, 0x00, 0x00, 0x07, 0x01,
+      0x62, 0x03, 0x03, 0x00, 0x00, 0x00,
+  };
+  EncodableValueArena arena;
+  auto view =
+      StandardMessageCodec::GetInstance().DecodeMessageView(bytes, &arena);
+  ASSERT_TRUE(view.has_value());
+
+  const auto& map = std::get<EncodableMapView>(*view);
+  ASSERT_EQ(map.size(), 3u);
+  EXPECT_EQ(std::get<std::string_view>(map[0].first), "a");
+  ASSERT_NE(map.Find("a"), nullptr);
+  EXPECT_EQ(map.Find("a")->LongValue(), 2);
+  // As with EncodableMap, the first of duplicate keys wins.
+  ASSERT_NE(map.Find("b"), nullptr);
+  EXPECT_EQ(map.Find("b")->LongValue(), 1);
+  EXPECT_EQ(map.Find("c"), nullptr);
+  EXPECT_EQ(map.Find(EncodableValueView(int32_t{1})), nullptr);
+}
+
+TEST(StandardMessageCodec, DecodeMessageViewRejectsMalformedMessages) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(EncodableValue(EncodableList{
+      EncodableValue("hello"),
+      EncodableValue(3.14),
+      EncodableValue(std::vector<int64_t>{1, 2}),
+  }));
+  EncodableValueArena arena;
+  for (size_t size = 0; size < encoded->size(); size++) {
+    EXPECT_FALSE(codec.DecodeMessageView(encoded->data(), size, &arena))
+        << "Accepted a message truncated to " << size << " bytes";
+  }
+  // A list claiming far more elements than the message holds.
+  std::vector<uint8_t> huge_list = {0x0c, 0xff, 0xff, 0xff, 0xff, 0x7f};
+  EXPECT_FALSE(codec.DecodeMessageView(huge_list, &arena));
+  // An unknown type.
+  std::vector<uint8_t> unknown_type = {0x80};
+  EXPECT_FALSE(codec.DecodeMessageView(unknown_type, &arena));
+}
+
 }  // namespace flutter
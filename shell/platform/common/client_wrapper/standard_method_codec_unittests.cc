@@ -55,6 +55,28 @@ TEST(StandardMethodCodec, HandlesMethodCallsWithArgument) {
   EXPECT_TRUE(MethodCallsAreEqual(call, *decoded));
 }
 
+TEST(StandardMethodCodec, DecodesMethodCallViews) {
+  const StandardMethodCodec& codec = StandardMethodCodec::GetInstance();
+  MethodCall<> call("hello", std::make_unique<EncodableValue>(EncodableMap{
+                                 {EncodableValue("answer"), EncodableValue(42)},
+                             }));
+  auto encoded = codec.EncodeMethodCall(call);
+  ASSERT_NE(encoded.get(), nullptr);
+  EncodableValueArena arena;
+  auto decoded =
+      codec.DecodeMethodCallView(encoded->data(), encoded->size(), &arena);
+  ASSERT_TRUE(decoded.has_value());
+  EXPECT_EQ(decoded->method_name, "hello");
+  const auto& arguments = std::get<EncodableMapView>(decoded->arguments);
+  ASSERT_NE(arguments.Find("answer"), nullptr);
+  EXPECT_EQ(arguments.Find("answer")->LongValue(), 42);
+
+  // The method name must be a string.
+  std::vector<uint8_t> bad_name = {0x03, 0x01, 0x00, 0x00, 0x00, 0x00};
+  EXPECT_FALSE(
+      codec.DecodeMethodCallView(bad_name.data(), bad_name.size(), &arena));
+}
+
 TEST(StandardMethodCodec, HandlesSuccessEnvelopesWithNullResult) {
   const StandardMethodCodec& codec = StandardMethodCodec::GetInstance();
   auto encoded = codec.EncodeSuccessEnvelope();
@@ -0,0 +1,186 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/json_message_codec.h"
+#include "flutter/shell/platform/common/json_method_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// Encodes a method call whose arguments hold |record_count| records, shaped
+// like the payloads of a plugin listing files.
+std::vector<uint8_t> CreateMethodCall(int record_count) {
+  JsonMessageWriter writer;
+  writer.StartObject();
+  writer.Key("method");
+  writer.String("listFiles");
+  writer.Key("args");
+  writer.StartArray();
+  for (int i = 0; i < record_count; i++) {
+    writer.StartObject();
+    writer.Key("id");
+    writer.Int64(i);
+    writer.Key("name");
+    writer.String("file " + std::to_string(i) + ".jpg");
+    writer.Key("path");
+    writer.String("/home/user/Pictures/\"Holidays\"/file " +
+                  std::to_string(i) + ".jpg");
+    writer.Key("size");
+    writer.Int64(int64_t{1024} * i);
+    writer.Key("tags");
+    writer.StartArray();
+    writer.String("image");
+    writer.String("jpeg");
+    writer.EndArray();
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+  return *writer.Finish();
+}
+
+// Sums the "id" fields of the records, ignoring everything else.
+class IdSumHandler : public JsonMethodCallHandler {
+ public:
+  // |JsonMethodCallHandler|
+  bool Method(std::string_view method_name) override { return true; }
+
+  // |JsonMessageHandler|
+  bool Key(std::string_view key) override {
+    in_id_ = key == "id";
+    return true;
+  }
+
+  // |JsonMessageHandler|
+  bool Int64(int64_t value) override {
+    if (in_id_) {
+      sum += value;
+    }
+    return true;
+  }
+
+  int64_t sum = 0;
+
+ private:
+  bool in_id_ = false;
+};
+
+}  // namespace
+
+// Reads the ids through a rapidjson::Document, as JsonMethodCodec users do.
+static void BM_JsonMethodCodecDecodeDocument(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const std::vector<uint8_t> message = CreateMethodCall(state.range(0));
+  while (state.KeepRunning()) {
+    auto method_call = codec.DecodeMethodCall(message);
+    int64_t sum = 0;
+    for (const auto& record : method_call->arguments()->GetArray()) {
+      sum += record["id"].GetInt64();
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+BENCHMARK(BM_JsonMethodCodecDecodeDocument)->Arg(10)->Arg(1000)->Arg(10000);
+
+static void BM_JsonMethodCodecDecodeStreaming(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const std::vector<uint8_t> message = CreateMethodCall(state.range(0));
+  while (state.KeepRunning()) {
+    IdSumHandler handler;
+    codec.DecodeMethodCallStreaming(message.data(), message.size(), &handler);
+    benchmark::DoNotOptimize(handler.sum);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+BENCHMARK(BM_JsonMethodCodecDecodeStreaming)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Messages from the engine are read-only, so this includes copying the
+// message into a scratch buffer before parsing it in situ.
+static void BM_JsonMethodCodecDecodeStreamingInSitu(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = JsonMethodCodec::GetInstance();
+  const std::vector<uint8_t> message = CreateMethodCall(state.range(0));
+  std::vector<uint8_t> scratch;
+  while (state.KeepRunning()) {
+    scratch.assign(message.begin(), message.end());
+    IdSumHandler handler;
+    codec.DecodeMethodCallStreamingInSitu(scratch.data(), scratch.size(),
+                                          &handler);
+    benchmark::DoNotOptimize(handler.sum);
+  }
+  state.SetBytesProcessed(state.iterations() * message.size());
+}
+
+BENCHMARK(BM_JsonMethodCodecDecodeStreamingInSitu)
+    ->Arg(10)
+    ->Arg(1000)
+    ->Arg(10000);
+
+// Builds the message of CreateMethodCall as a document, then encodes it.
+static void BM_JsonMessageCodecEncodeDocument(
+    benchmark::State& state) {  // NOLINT
+  const auto& codec = JsonMessageCodec::GetInstance();
+  const int record_count = state.range(0);
+  size_t message_size = 0;
+  while (state.KeepRunning()) {
+    rapidjson::Document document(rapidjson::kObjectType);
+    auto& allocator = document.GetAllocator();
+    rapidjson::Value records(rapidjson::kArrayType);
+    for (int i = 0; i < record_count; i++) {
+      rapidjson::Value record(rapidjson::kObjectType);
+      record.AddMember("id", i, allocator);
+      record.AddMember(
+          "name",
+          rapidjson::Value("file " + std::to_string(i) + ".jpg", allocator),
+          allocator);
+      record.AddMember(
+          "path",
+          rapidjson::Value("/home/user/Pictures/\"Holidays\"/file " +
+                               std::to_string(i) + ".jpg",
+                           allocator),
+          allocator);
+      record.AddMember("size", int64_t{1024} * i, allocator);
+      rapidjson::Value tags(rapidjson::kArrayType);
+      tags.PushBack("image", allocator);
+      tags.PushBack("jpeg", allocator);
+      record.AddMember("tags", tags, allocator);
+      records.PushBack(record, allocator);
+    }
+    document.AddMember("method", "listFiles", allocator);
+    document.AddMember("args", records, allocator);
+    auto encoded = codec.EncodeMessage(document);
+    message_size = encoded->size();
+    benchmark::DoNotOptimize(encoded);
+  }
+  state.SetBytesProcessed(state.iterations() * message_size);
+}
+
+BENCHMARK(BM_JsonMessageCodecEncodeDocument)->Arg(10)->Arg(1000)->Arg(10000);
+
+// Writes the same message with a JsonMessageWriter, without a document.
+static void BM_JsonMessageCodecEncodeStreaming(
+    benchmark::State& state) {  // NOLINT
+  size_t message_size = 0;
+  while (state.KeepRunning()) {
+    std::vector<uint8_t> message = CreateMethodCall(state.range(0));
+    message_size = message.size();
+    benchmark::DoNotOptimize(message);
+  }
+  state.SetBytesProcessed(state.iterations() * message_size);
+}
+
+BENCHMARK(BM_JsonMessageCodecEncodeStreaming)->Arg(10)->Arg(1000)->Arg(10000);
+
+}  // namespace flutter
@@ -5,14 +5,183 @@
 #include "flutter/shell/platform/common/json_message_codec.h"
 
 #include <iostream>
+#include <limits>
 #include <string>
 
 #include "rapidjson/error/en.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/writer.h"
 
 namespace flutter {
 
+namespace {
+
+// Adapts a JsonMessageHandler to the handler concept of rapidjson::Reader.
+class ReaderHandler {
+ public:
+  explicit ReaderHandler(JsonMessageHandler* handler) : handler_(handler) {}
+
+  bool Null() { return handler_->Null(); }
+
+  bool Bool(bool value) { return handler_->Bool(value); }
+
+  bool Int(int value) { return handler_->Int64(value); }
+
+  bool Uint(unsigned value) { return handler_->Int64(value); }
+
+  bool Int64(int64_t value) { return handler_->Int64(value); }
+
+  bool Uint64(uint64_t value) {
+    if (value <= static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+      return handler_->Int64(static_cast<int64_t>(value));
+    }
+    return handler_->Double(static_cast<double>(value));
+  }
+
+  bool Double(double value) { return handler_->Double(value); }
+
+  // Only used with kParseNumbersAsStringsFlag.
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) {
+    return false;
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy) {
+    return handler_->String(std::string_view(str, length));
+  }
+
+  bool StartObject() { return handler_->StartObject(); }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    return handler_->Key(std::string_view(str, length));
+  }
+
+  bool EndObject(rapidjson::SizeType member_count) {
+    return handler_->EndObject();
+  }
+
+  bool StartArray() { return handler_->StartArray(); }
+
+  bool EndArray(rapidjson::SizeType element_count) {
+    return handler_->EndArray();
+  }
+
+ private:
+  JsonMessageHandler* handler_;
+};
+
+// A rapidjson input stream for in situ parsing of a mutable buffer. Unlike
+// rapidjson::InsituStringStream, the buffer doesn't need to be
+// null-terminated: the parser writes at most up to the closing quote of each
+// string, so it stays within the buffer.
+class InsituMemoryStream {
+ public:
+  typedef char Ch;
+
+  InsituMemoryStream(char* begin, size_t size)
+      : begin_(begin), end_(begin + size), src_(begin) {}
+
+  Ch Peek() const { return src_ == end_ ? '\0' : *src_; }
+
+  Ch Take() { return src_ == end_ ? '\0' : *src_++; }
+
+  size_t Tell() const { return static_cast<size_t>(src_ - begin_); }
+
+  Ch* PutBegin() { return dst_ = src_; }
+
+  void Put(Ch c) { *dst_++ = c; }
+
+  size_t PutEnd(Ch* begin) { return static_cast<size_t>(dst_ - begin); }
+
+  void Flush() {}
+
+ private:
+  char* begin_;
+  char* end_;
+  char* src_;
+  char* dst_ = nullptr;
+};
+
+// Streams the JSON events of |stream| to |handler|. Returns false if the
+// message is invalid, but not if the handler stopped early.
+template <unsigned parse_flags, typename Stream>
+bool ParseStreaming(Stream& stream, JsonMessageHandler* handler) {
+  ReaderHandler reader_handler(handler);
+  rapidjson::Reader reader;
+  rapidjson::ParseResult result =
+      reader.Parse<parse_flags>(stream, reader_handler);
+  if (result.IsError() &&
+      result.Code() != rapidjson::kParseErrorTermination) {
+    std::cerr << "Unable to parse JSON message:" << std::endl
+              << rapidjson::GetParseError_En(result.Code()) << std::endl;
+    return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+JsonMessageWriter::JsonMessageWriter()
+    : buffer_(std::make_unique<std::vector<uint8_t>>()),
+      stream_(buffer_.get()),
+      writer_(stream_) {}
+
+JsonMessageWriter::~JsonMessageWriter() = default;
+
+void JsonMessageWriter::Null() {
+  failed_ |= !writer_.Null();
+}
+
+void JsonMessageWriter::Bool(bool value) {
+  failed_ |= !writer_.Bool(value);
+}
+
+void JsonMessageWriter::Int64(int64_t value) {
+  failed_ |= !writer_.Int64(value);
+}
+
+void JsonMessageWriter::Double(double value) {
+  failed_ |= !writer_.Double(value);
+}
+
+void JsonMessageWriter::String(std::string_view value) {
+  failed_ |= !writer_.String(value.data(),
+                             static_cast<rapidjson::SizeType>(value.size()));
+}
+
+void JsonMessageWriter::StartObject() {
+  failed_ |= !writer_.StartObject();
+}
+
+void JsonMessageWriter::Key(std::string_view key) {
+  failed_ |=
+      !writer_.Key(key.data(), static_cast<rapidjson::SizeType>(key.size()));
+}
+
+void JsonMessageWriter::EndObject() {
+  failed_ |= !writer_.EndObject();
+}
+
+void JsonMessageWriter::StartArray() {
+  failed_ |= !writer_.StartArray();
+}
+
+void JsonMessageWriter::EndArray() {
+  failed_ |= !writer_.EndArray();
+}
+
+void JsonMessageWriter::Value(const rapidjson::Value& value) {
+  failed_ |= !value.Accept(writer_);
+}
+
+std::unique_ptr<std::vector<uint8_t>> JsonMessageWriter::Finish() {
+  if (failed_ || !writer_.IsComplete()) {
+    return nullptr;
+  }
+  return std::move(buffer_);
+}
+
 // static
 const JsonMessageCodec& JsonMessageCodec::GetInstance() {
   static JsonMessageCodec sInstance;
@@ -21,10 +190,18 @@ const JsonMessageCodec& JsonMessageCodec::GetInstance() {
 
 std::unique_ptr<std::vector<uint8_t>> JsonMessageCodec::EncodeMessageInternal(
     const rapidjson::Document& message) const {
-  // TODO: Look into alternate writers that would avoid the buffer copy.
+  JsonMessageWriter writer;
+  writer.Value(message);
+  std::unique_ptr<std::vector<uint8_t>> encoded = writer.Finish();
+  if (encoded) {
+    return encoded;
+  }
+
+  // The writer fails on values JSON can't represent, such as NaN. Encoding
+  // always returned a message, so keep what rapidjson managed to write.
   rapidjson::StringBuffer buffer;
-  rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-  message.Accept(writer);
+  rapidjson::Writer<rapidjson::StringBuffer> fallback_writer(buffer);
+  message.Accept(fallback_writer);
   const char* buffer_start = buffer.GetString();
   return std::make_unique<std::vector<uint8_t>>(
       buffer_start, buffer_start + buffer.GetSize());
@@ -47,4 +224,21 @@ std::unique_ptr<rapidjson::Document> JsonMessageCodec::DecodeMessageInternal(
   return json_message;
 }
 
+bool JsonMessageCodec::DecodeMessageStreaming(
+    const uint8_t* message,
+    size_t message_size,
+    JsonMessageHandler* handler) const {
+  rapidjson::MemoryStream stream(reinterpret_cast<const char*>(message),
+                                 message_size);
+  return ParseStreaming<rapidjson::kParseDefaultFlags>(stream, handler);
+}
+
+bool JsonMessageCodec::DecodeMessageStreamingInSitu(
+    uint8_t* message,
+    size_t message_size,
+    JsonMessageHandler* handler) const {
+  InsituMemoryStream stream(reinterpret_cast<char*>(message), message_size);
+  return ParseStreaming<rapidjson::kParseInsituFlag>(stream, handler);
+}
+
 }  // namespace flutter
@@ -6,11 +6,122 @@
 #define FLUTTER_SHELL_PLATFORM_COMMON_JSON_MESSAGE_CODEC_H_
 
 #include <rapidjson/document.h>
+#include <rapidjson/writer.h>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
 
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/message_codec.h"
 
 namespace flutter {
 
+// A SAX-style receiver of the JSON events decoded by
+// JsonMessageCodec::DecodeMessageStreaming, for reading a message without
+// building a document.
+//
+// Each method returns whether decoding should continue, so a handler can stop
+// as soon as it has read the fields it needs. The default implementations
+// ignore the event. Strings are only valid for the duration of the call,
+// unless the message is decoded in situ.
+class JsonMessageHandler {
+ public:
+  virtual ~JsonMessageHandler() = default;
+
+  virtual bool Null() { return true; }
+
+  virtual bool Bool(bool value) { return true; }
+
+  // Integers that don't fit in an int64_t are reported as doubles.
+  virtual bool Int64(int64_t value) { return true; }
+
+  virtual bool Double(double value) { return true; }
+
+  virtual bool String(std::string_view value) { return true; }
+
+  virtual bool StartObject() { return true; }
+
+  virtual bool Key(std::string_view key) { return true; }
+
+  virtual bool EndObject() { return true; }
+
+  virtual bool StartArray() { return true; }
+
+  virtual bool EndArray() { return true; }
+};
+
+// Encodes a JSON message incrementally, without building a document first.
+//
+// The calls must form exactly one JSON value, e.g.:
+//   JsonMessageWriter writer;
+//   writer.StartObject();
+//   writer.Key("name");
+//   writer.String("value");
+//   writer.EndObject();
+//   std::unique_ptr<std::vector<uint8_t>> message = writer.Finish();
+class JsonMessageWriter {
+ public:
+  JsonMessageWriter();
+
+  ~JsonMessageWriter();
+
+  // Prevent copying.
+  JsonMessageWriter(JsonMessageWriter const&) = delete;
+  JsonMessageWriter& operator=(JsonMessageWriter const&) = delete;
+
+  void Null();
+
+  void Bool(bool value);
+
+  void Int64(int64_t value);
+
+  // Non-finite values are not valid JSON and fail the message.
+  void Double(double value);
+
+  void String(std::string_view value);
+
+  void StartObject();
+
+  void Key(std::string_view key);
+
+  void EndObject();
+
+  void StartArray();
+
+  void EndArray();
+
+  // Writes |value| and everything it contains.
+  void Value(const rapidjson::Value& value);
+
+  // Returns the encoded message, or nullptr if the calls so far didn't form a
+  // single valid JSON value or included a number JSON can't represent, such as
+  // NaN. The writer can't be used afterwards.
+  std::unique_ptr<std::vector<uint8_t>> Finish();
+
+ private:
+  // A rapidjson output stream appending to |buffer_|, which saves copying the
+  // message out of a rapidjson::StringBuffer.
+  class OutputStream {
+   public:
+    typedef char Ch;
+
+    explicit OutputStream(std::vector<uint8_t>* buffer) : buffer_(buffer) {}
+
+    void Put(Ch c) { buffer_->push_back(static_cast<uint8_t>(c)); }
+
+    void Flush() {}
+
+   private:
+    std::vector<uint8_t>* buffer_;
+  };
+
+  std::unique_ptr<std::vector<uint8_t>> buffer_;
+  OutputStream stream_;
+  rapidjson::Writer<OutputStream> writer_;
+  bool failed_ = false;
+};
+
 // A message encoding/decoding mechanism for communications to/from the
 // Flutter engine via JSON channels.
 class JsonMessageCodec : public MessageCodec<rapidjson::Document> {
@@ -24,6 +135,23 @@ class JsonMessageCodec : public MessageCodec<rapidjson::Document> {
   JsonMessageCodec(JsonMessageCodec const&) = delete;
   JsonMessageCodec& operator=(JsonMessageCodec const&) = delete;
 
+  // Decodes |message| by streaming its JSON events to |handler| rather than
+  // building a document.
+  //
+  // Returns false if the message is not valid JSON. A handler stopping early
+  // is not an error, and the rest of the message is not read in that case.
+  bool DecodeMessageStreaming(const uint8_t* message,
+                              size_t message_size,
+                              JsonMessageHandler* handler) const;
+
+  // Like DecodeMessageStreaming, but parses in situ: strings are unescaped in
+  // place, which modifies |message|, and the strings passed to |handler| point
+  // into |message| instead of a temporary copy. They stay valid as long as
+  // |message| does.
+  bool DecodeMessageStreamingInSitu(uint8_t* message,
+                                    size_t message_size,
+                                    JsonMessageHandler* handler) const;
+
  protected:
   // Instances should be obtained via GetInstance.
   JsonMessageCodec() = default;
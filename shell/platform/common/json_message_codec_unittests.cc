@@ -4,8 +4,10 @@
 
 #include "flutter/shell/platform/common/json_message_codec.h"
 
+#include <cstring>
 #include <limits>
 #include <map>
+#include <string>
 #include <vector>
 
 #include "gtest/gtest.h"
@@ -23,6 +25,50 @@ static void CheckEncodeDecode(const rapidjson::Document& value) {
   EXPECT_EQ(value, *decoded);
 }
 
+// Records the events of a streamed message in a compact textual form.
+class RecordingHandler : public JsonMessageHandler {
+ public:
+  bool Null() override { return Record("null"); }
+
+  bool Bool(bool value) override { return Record(value ? "true" : "false"); }
+
+  bool Int64(int64_t value) override {
+    return Record("int:" + std::to_string(value));
+  }
+
+  bool Double(double value) override {
+    return Record("double:" + std::to_string(value));
+  }
+
+  bool String(std::string_view value) override {
+    strings.push_back(value);
+    return Record("string:" + std::string(value));
+  }
+
+  bool StartObject() override { return Record("{"); }
+
+  bool Key(std::string_view key) override {
+    return Record("key:" + std::string(key));
+  }
+
+  bool EndObject() override { return Record("}"); }
+
+  bool StartArray() override { return Record("["); }
+
+  bool EndArray() override { return Record("]"); }
+
+  std::vector<std::string> events;
+  std::vector<std::string_view> strings;
+  // Decoding stops after this many events.
+  size_t max_events = std::numeric_limits<size_t>::max();
+
+ private:
+  bool Record(std::string event) {
+    events.push_back(std::move(event));
+    return events.size() < max_events;
+  }
+};
+
 }  // namespace
 
 // Tests that a JSON document with various data types round-trips correctly.
@@ -43,4 +89,122 @@ TEST(JsonMessageCodec, EncodeDecode) {
   CheckEncodeDecode(array);
 }
 
+TEST(JsonMessageCodec, DecodesStreaming) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  std::string json =
+      R"({"a":[1,-2.5,"x\"y",true,null,18446744073709551615],"b":{}})";
+  RecordingHandler handler;
+  EXPECT_TRUE(codec.DecodeMessageStreaming(
+      reinterpret_cast<const uint8_t*>(json.data()), json.size(), &handler));
+  std::vector<std::string> expected_events = {
+      "{",
+      "key:a",
+      "[",
+      "int:1",
+      "double:-2.500000",
+      "string:x\"y",
+      "true",
+      "null",
+      "double:18446744073709551616.000000",
+      "]",
+      "key:b",
+      "{",
+      "}",
+      "}",
+  };
+  EXPECT_EQ(handler.events, expected_events);
+}
+
+TEST(JsonMessageCodec, DecodesStreamingInSitu) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  std::string json = R"(["plain","esc\taped"])";
+  std::vector<uint8_t> message(json.begin(), json.end());
+  RecordingHandler handler;
+  EXPECT_TRUE(codec.DecodeMessageStreamingInSitu(message.data(),
+                                                 message.size(), &handler));
+  std::vector<std::string> expected_events = {
+      "[",
+      "string:plain",
+      "string:esc\taped",
+      "]",
+  };
+  EXPECT_EQ(handler.events, expected_events);
+  // The strings remain valid, pointing into the message.
+  ASSERT_EQ(handler.strings.size(), 2u);
+  EXPECT_EQ(handler.strings[0], "plain");
+  EXPECT_EQ(handler.strings[1], "esc\taped");
+  for (std::string_view string : handler.strings) {
+    EXPECT_GE(reinterpret_cast<const uint8_t*>(string.data()),
+              message.data());
+    EXPECT_LE(reinterpret_cast<const uint8_t*>(string.data() + string.size()),
+              message.data() + message.size());
+  }
+}
+
+TEST(JsonMessageCodec, StreamingHandlerCanStopEarly) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  // The message is truncated, but only after the part the handler reads.
+  std::string json = R"({"id":7,"payload":[1,2,)";
+  RecordingHandler handler;
+  handler.max_events = 3;
+  EXPECT_TRUE(codec.DecodeMessageStreaming(
+      reinterpret_cast<const uint8_t*>(json.data()), json.size(), &handler));
+  std::vector<std::string> expected_events = {"{", "key:id", "int:7"};
+  EXPECT_EQ(handler.events, expected_events);
+}
+
+TEST(JsonMessageCodec, StreamingRejectsInvalidJson) {
+  const JsonMessageCodec& codec = JsonMessageCodec::GetInstance();
+  for (std::string json : {"", "{", R"({"a":1)", R"(["a)", "[1] 2"}) {
+    RecordingHandler handler;
+    EXPECT_FALSE(codec.DecodeMessageStreaming(
+        reinterpret_cast<const uint8_t*>(json.data()), json.size(), &handler))
+        << json;
+    std::vector<uint8_t> message(json.begin(), json.end());
+    EXPECT_FALSE(codec.DecodeMessageStreamingInSitu(message.data(),
+                                                    message.size(), &handler))
+        << json;
+  }
+}
+
+TEST(JsonMessageCodec, WritesStreaming) {
+  rapidjson::Document nested(rapidjson::kArrayType);
+  nested.PushBack(true, nested.GetAllocator());
+
+  JsonMessageWriter writer;
+  writer.StartObject();
+  writer.Key("a");
+  writer.Int64(-7);
+  writer.Key("b");
+  writer.StartArray();
+  writer.Double(0.5);
+  writer.String("x\"y");
+  writer.Null();
+  writer.Value(nested);
+  writer.EndArray();
+  writer.EndObject();
+  auto message = writer.Finish();
+  ASSERT_TRUE(message);
+  std::string json(message->begin(), message->end());
+  EXPECT_EQ(json, R"({"a":-7,"b":[0.5,"x\"y",null,[true]]})");
+}
+
+TEST(JsonMessageCodec, StreamingWriterRejectsIncompleteMessages) {
+  JsonMessageWriter writer;
+  writer.StartArray();
+  EXPECT_FALSE(writer.Finish());
+}
+
+TEST(JsonMessageCodec, EncodingNaNStillReturnsMessage) {
+  rapidjson::Document array(rapidjson::kArrayType);
+  array.PushBack(std::numeric_limits<double>::quiet_NaN(),
+                 array.GetAllocator());
+
+  JsonMessageWriter writer;
+  writer.Value(array);
+  EXPECT_FALSE(writer.Finish());
+
+  EXPECT_TRUE(JsonMessageCodec::GetInstance().EncodeMessage(array));
+}
+
 }  // namespace flutter
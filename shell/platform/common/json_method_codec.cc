@@ -4,6 +4,10 @@
 
 #include "flutter/shell/platform/common/json_method_codec.h"
 
+#include <functional>
+#include <string>
+#include <vector>
+
 #include "flutter/shell/platform/common/json_message_codec.h"
 
 namespace flutter {
@@ -30,6 +34,178 @@ std::unique_ptr<rapidjson::Document> ExtractElement(
   return extracted;
 }
 
+// Extracts the method name and arguments of a method call from the JSON
+// events of its envelope, forwarding them to a JsonMethodCallHandler.
+//
+// The handler always receives the method name first. Argument events that
+// precede it in the message are buffered until it is found.
+class MethodCallEnvelopeHandler : public JsonMessageHandler {
+ public:
+  explicit MethodCallEnvelopeHandler(JsonMethodCallHandler* handler)
+      : handler_(handler) {}
+
+  // Whether the message was found not to be a method call.
+  bool invalid() const { return invalid_; }
+
+  // |JsonMessageHandler|
+  bool Null() override {
+    return OnScalar([this]() { return handler_->Null(); });
+  }
+
+  // |JsonMessageHandler|
+  bool Bool(bool value) override {
+    return OnScalar([this, value]() { return handler_->Bool(value); });
+  }
+
+  // |JsonMessageHandler|
+  bool Int64(int64_t value) override {
+    return OnScalar([this, value]() { return handler_->Int64(value); });
+  }
+
+  // |JsonMessageHandler|
+  bool Double(double value) override {
+    return OnScalar([this, value]() { return handler_->Double(value); });
+  }
+
+  // |JsonMessageHandler|
+  bool String(std::string_view value) override {
+    if (depth_ == 1 && field_ == Field::kMethod) {
+      has_method_ = true;
+      return handler_->Method(value) && ReplayPendingEvents();
+    }
+    if (!IsValuePositionValid()) {
+      return Fail();
+    }
+    return ForwardString(value, &JsonMessageHandler::String);
+  }
+
+  // |JsonMessageHandler|
+  bool StartObject() override {
+    if (depth_ == 0) {
+      depth_++;
+      return true;
+    }
+    return OnStart([this]() { return handler_->StartObject(); });
+  }
+
+  // |JsonMessageHandler|
+  bool Key(std::string_view key) override {
+    if (depth_ == 1) {
+      if (key == kMessageMethodKey) {
+        field_ = Field::kMethod;
+      } else if (key == kMessageArgumentsKey) {
+        field_ = Field::kArguments;
+      } else {
+        field_ = Field::kOther;
+      }
+      return true;
+    }
+    return ForwardString(key, &JsonMessageHandler::Key);
+  }
+
+  // |JsonMessageHandler|
+  bool EndObject() override {
+    depth_--;
+    if (depth_ == 0) {
+      // The end of the envelope.
+      return has_method_ || Fail();
+    }
+    return Forward([this]() { return handler_->EndObject(); });
+  }
+
+  // |JsonMessageHandler|
+  bool StartArray() override {
+    return OnStart([this]() { return handler_->StartArray(); });
+  }
+
+  // |JsonMessageHandler|
+  bool EndArray() override {
+    depth_--;
+    return Forward([this]() { return handler_->EndArray(); });
+  }
+
+ private:
+  // The envelope field being decoded.
+  enum class Field { kNone, kMethod, kArguments, kOther };
+
+  using StringEvent = bool (JsonMessageHandler::*)(std::string_view);
+
+  bool Fail() {
+    invalid_ = true;
+    return false;
+  }
+
+  // Whether a value other than the method name can appear here.
+  bool IsValuePositionValid() const {
+    return depth_ != 0 && !(depth_ == 1 && field_ == Field::kMethod);
+  }
+
+  // Forwards an event to |handler_| if it belongs to the arguments, or
+  // buffers it if the method name hasn't been seen yet.
+  template <typename F>
+  bool Forward(F forward) {
+    if (field_ != Field::kArguments) {
+      return true;
+    }
+    if (has_method_) {
+      return forward();
+    }
+    pending_events_.emplace_back(std::move(forward));
+    return true;
+  }
+
+  // Like Forward, but copies the string if the event is buffered, since it
+  // only lives until the event returns.
+  bool ForwardString(std::string_view value, StringEvent event) {
+    if (field_ == Field::kArguments && !has_method_) {
+      pending_events_.emplace_back(
+          [this, event, value = std::string(value)]() {
+            return (handler_->*event)(value);
+          });
+      return true;
+    }
+    return Forward([this, event, value]() { return (handler_->*event)(value); });
+  }
+
+  // Handles a value that isn't the method name.
+  template <typename F>
+  bool OnScalar(F forward) {
+    if (!IsValuePositionValid()) {
+      return Fail();
+    }
+    return Forward(std::move(forward));
+  }
+
+  // Handles the start of a nested object or array.
+  template <typename F>
+  bool OnStart(F forward) {
+    if (!IsValuePositionValid()) {
+      return Fail();
+    }
+    depth_++;
+    return Forward(std::move(forward));
+  }
+
+  // Delivers the argument events buffered before the method name.
+  bool ReplayPendingEvents() {
+    std::vector<std::function<bool()>> events = std::move(pending_events_);
+    pending_events_.clear();
+    for (auto& event : events) {
+      if (!event()) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  JsonMethodCallHandler* handler_;
+  int depth_ = 0;
+  Field field_ = Field::kNone;
+  bool has_method_ = false;
+  bool invalid_ = false;
+  std::vector<std::function<bool()>> pending_events_;
+};
+
 }  // namespace
 
 // static
@@ -66,9 +242,24 @@ JsonMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 
 std::unique_ptr<std::vector<uint8_t>> JsonMethodCodec::EncodeMethodCallInternal(
     const MethodCall<rapidjson::Document>& method_call) const {
-  // TODO: Consider revisiting the codec APIs to avoid the need to copy
-  // everything when doing encoding (e.g., by having a version that takes
-  // owership of the object to encode, so that it can be moved instead).
+  JsonMessageWriter writer;
+  writer.StartObject();
+  writer.Key(kMessageMethodKey);
+  writer.String(method_call.method_name());
+  writer.Key(kMessageArgumentsKey);
+  if (method_call.arguments()) {
+    writer.Value(*method_call.arguments());
+  } else {
+    writer.Null();
+  }
+  writer.EndObject();
+  std::unique_ptr<std::vector<uint8_t>> encoded = writer.Finish();
+  if (encoded) {
+    return encoded;
+  }
+
+  // The arguments hold a value the writer can't encode. Encode a document
+  // instead, which always returns a message.
   rapidjson::Document message(rapidjson::kObjectType);
   auto& allocator = message.GetAllocator();
   rapidjson::Value name(method_call.method_name(), allocator);
@@ -78,21 +269,32 @@ std::unique_ptr<std::vector<uint8_t>> JsonMethodCodec::EncodeMethodCallInternal(
   }
   message.AddMember(kMessageMethodKey, name, allocator);
   message.AddMember(kMessageArgumentsKey, arguments, allocator);
-
   return JsonMessageCodec::GetInstance().EncodeMessage(message);
 }
 
 std::unique_ptr<std::vector<uint8_t>>
 JsonMethodCodec::EncodeSuccessEnvelopeInternal(
     const rapidjson::Document* result) const {
-  rapidjson::Document envelope;
-  envelope.SetArray();
+  JsonMessageWriter writer;
+  writer.StartArray();
+  if (result) {
+    writer.Value(*result);
+  } else {
+    writer.Null();
+  }
+  writer.EndArray();
+  std::unique_ptr<std::vector<uint8_t>> encoded = writer.Finish();
+  if (encoded) {
+    return encoded;
+  }
+
+  // See EncodeMethodCallInternal.
+  rapidjson::Document envelope(rapidjson::kArrayType);
   rapidjson::Value result_value;
   if (result) {
     result_value.CopyFrom(*result, envelope.GetAllocator());
   }
   envelope.PushBack(result_value, envelope.GetAllocator());
-
   return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
 }
 
@@ -101,6 +303,22 @@ JsonMethodCodec::EncodeErrorEnvelopeInternal(
     const std::string& error_code,
     const std::string& error_message,
     const rapidjson::Document* error_details) const {
+  JsonMessageWriter writer;
+  writer.StartArray();
+  writer.String(error_code);
+  writer.String(error_message);
+  if (error_details) {
+    writer.Value(*error_details);
+  } else {
+    writer.Null();
+  }
+  writer.EndArray();
+  std::unique_ptr<std::vector<uint8_t>> encoded = writer.Finish();
+  if (encoded) {
+    return encoded;
+  }
+
+  // See EncodeMethodCallInternal.
   rapidjson::Document envelope(rapidjson::kArrayType);
   auto& allocator = envelope.GetAllocator();
   envelope.PushBack(rapidjson::Value(error_code, allocator), allocator);
@@ -110,7 +328,6 @@ JsonMethodCodec::EncodeErrorEnvelopeInternal(
     details_value.CopyFrom(*error_details, allocator);
   }
   envelope.PushBack(details_value, allocator);
-
   return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
 }
 
@@ -154,4 +371,24 @@ bool JsonMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
   }
 }
 
+bool JsonMethodCodec::DecodeMethodCallStreaming(
+    const uint8_t* message,
+    size_t message_size,
+    JsonMethodCallHandler* handler) const {
+  MethodCallEnvelopeHandler envelope_handler(handler);
+  return JsonMessageCodec::GetInstance().DecodeMessageStreaming(
+             message, message_size, &envelope_handler) &&
+         !envelope_handler.invalid();
+}
+
+bool JsonMethodCodec::DecodeMethodCallStreamingInSitu(
+    uint8_t* message,
+    size_t message_size,
+    JsonMethodCallHandler* handler) const {
+  MethodCallEnvelopeHandler envelope_handler(handler);
+  return JsonMessageCodec::GetInstance().DecodeMessageStreamingInSitu(
+             message, message_size, &envelope_handler) &&
+         !envelope_handler.invalid();
+}
+
 }  // namespace flutter
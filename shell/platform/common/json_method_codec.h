@@ -7,11 +7,25 @@
 
 #include <rapidjson/document.h>
 
+#include <string_view>
+
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/method_call.h"
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/method_codec.h"
+#include "flutter/shell/platform/common/json_message_codec.h"
 
 namespace flutter {
 
+// A SAX-style receiver of the method calls decoded by
+// JsonMethodCodec::DecodeMethodCallStreaming. The JSON events of the
+// arguments are delivered through the JsonMessageHandler methods.
+class JsonMethodCallHandler : public JsonMessageHandler {
+ public:
+  // Called with the name of the method, before any of the argument events.
+  // Arguments that precede the method name in the message are buffered until
+  // it is found. Returns whether decoding should continue.
+  virtual bool Method(std::string_view method_name) = 0;
+};
+
 // An implementation of MethodCodec that uses JSON strings as the serialization.
 class JsonMethodCodec : public MethodCodec<rapidjson::Document> {
  public:
@@ -24,6 +38,23 @@ class JsonMethodCodec : public MethodCodec<rapidjson::Document> {
   JsonMethodCodec(JsonMethodCodec const&) = delete;
   JsonMethodCodec& operator=(JsonMethodCodec const&) = delete;
 
+  // Decodes the method call in |message| by streaming it to |handler| rather
+  // than building a document, as JsonMessageCodec::DecodeMessageStreaming
+  // does.
+  //
+  // Returns false if the message is not a valid method call. A handler
+  // stopping early is not an error, and the rest of the message is not read
+  // in that case.
+  bool DecodeMethodCallStreaming(const uint8_t* message,
+                                 size_t message_size,
+                                 JsonMethodCallHandler* handler) const;
+
+  // Like DecodeMethodCallStreaming, but parses |message| in situ, as
+  // JsonMessageCodec::DecodeMessageStreamingInSitu does.
+  bool DecodeMethodCallStreamingInSitu(uint8_t* message,
+                                       size_t message_size,
+                                       JsonMethodCallHandler* handler) const;
+
  protected:
   // Instances should be obtained via GetInstance.
   JsonMethodCodec() = default;
@@ -4,6 +4,10 @@
 
 #include "flutter/shell/platform/common/json_method_codec.h"
 
+#include <limits>
+#include <string>
+#include <vector>
+
 #include "flutter/shell/platform/common/client_wrapper/include/flutter/method_result_functions.h"
 #include "gtest/gtest.h"
 
@@ -26,6 +30,37 @@ bool MethodCallsAreEqual(const MethodCall<rapidjson::Document>& a,
   return *a.arguments() == *b.arguments();
 }
 
+// Records the method name and the argument events of a streamed method call.
+class RecordingMethodCallHandler : public JsonMethodCallHandler {
+ public:
+  bool Method(std::string_view method_name) override {
+    events.push_back("method:" + std::string(method_name));
+    return true;
+  }
+
+  bool Int64(int64_t value) override {
+    events.push_back("int:" + std::to_string(value));
+    return true;
+  }
+
+  bool String(std::string_view value) override {
+    events.push_back("string:" + std::string(value));
+    return true;
+  }
+
+  bool StartArray() override {
+    events.push_back("[");
+    return true;
+  }
+
+  bool EndArray() override {
+    events.push_back("]");
+    return true;
+  }
+
+  std::vector<std::string> events;
+};
+
 }  // namespace
 
 TEST(JsonMethodCodec, HandlesMethodCallsWithNullArguments) {
@@ -55,6 +90,90 @@ TEST(JsonMethodCodec, HandlesMethodCallsWithArgument) {
   EXPECT_TRUE(MethodCallsAreEqual(call, *decoded));
 }
 
+TEST(JsonMethodCodec, DecodesMethodCallsStreaming) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+
+  auto arguments = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = arguments->GetAllocator();
+  arguments->PushBack(42, allocator);
+  arguments->PushBack("world", allocator);
+  MethodCall<rapidjson::Document> call("hello", std::move(arguments));
+  auto encoded = codec.EncodeMethodCall(call);
+  ASSERT_TRUE(encoded);
+
+  std::vector<std::string> expected_events = {
+      "method:hello", "[", "int:42", "string:world", "]",
+  };
+  RecordingMethodCallHandler handler;
+  EXPECT_TRUE(codec.DecodeMethodCallStreaming(encoded->data(),
+                                              encoded->size(), &handler));
+  EXPECT_EQ(handler.events, expected_events);
+
+  RecordingMethodCallHandler in_situ_handler;
+  EXPECT_TRUE(codec.DecodeMethodCallStreamingInSitu(
+      encoded->data(), encoded->size(), &in_situ_handler));
+  EXPECT_EQ(in_situ_handler.events, expected_events);
+}
+
+TEST(JsonMethodCodec, StreamingIgnoresUnknownEnvelopeFields) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+  std::string json = R"({"method":"m","extra":["x"],"args":["y"]})";
+  RecordingMethodCallHandler handler;
+  EXPECT_TRUE(codec.DecodeMethodCallStreaming(
+      reinterpret_cast<const uint8_t*>(json.data()), json.size(), &handler));
+  std::vector<std::string> expected_events = {
+      "method:m", "[", "string:y", "]",
+  };
+  EXPECT_EQ(handler.events, expected_events);
+}
+
+TEST(JsonMethodCodec, StreamingBuffersArgumentsBeforeMethod) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+  std::string json = R"({"args":[1,"x"],"method":"m"})";
+  std::vector<std::string> expected_events = {
+      "method:m", "[", "int:1", "string:x", "]",
+  };
+
+  RecordingMethodCallHandler handler;
+  EXPECT_TRUE(codec.DecodeMethodCallStreaming(
+      reinterpret_cast<const uint8_t*>(json.data()), json.size(), &handler));
+  EXPECT_EQ(handler.events, expected_events);
+
+  RecordingMethodCallHandler in_situ_handler;
+  EXPECT_TRUE(codec.DecodeMethodCallStreamingInSitu(
+      reinterpret_cast<uint8_t*>(json.data()), json.size(), &in_situ_handler));
+  EXPECT_EQ(in_situ_handler.events, expected_events);
+}
+
+TEST(JsonMethodCodec, StreamingRejectsInvalidMethodCalls) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+  for (std::string json : {
+           R"(["method","args"])",
+           R"({"args":[]})",
+           R"({"method":7,"args":[]})",
+           R"({"method":["m"],"args":[]})",
+       }) {
+    RecordingMethodCallHandler handler;
+    EXPECT_FALSE(codec.DecodeMethodCallStreaming(
+        reinterpret_cast<const uint8_t*>(json.data()), json.size(), &handler))
+        << json;
+  }
+}
+
+TEST(JsonMethodCodec, EncodingNaNStillReturnsMessages) {
+  const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
+  auto nan = [] {
+    auto value = std::make_unique<rapidjson::Document>();
+    value->SetDouble(std::numeric_limits<double>::quiet_NaN());
+    return value;
+  };
+
+  MethodCall<rapidjson::Document> call("hello", nan());
+  EXPECT_TRUE(codec.EncodeMethodCall(call));
+  EXPECT_TRUE(codec.EncodeSuccessEnvelope(nan().get()));
+  EXPECT_TRUE(codec.EncodeErrorEnvelope("code", "message", nan().get()));
+}
+
 TEST(JsonMethodCodec, HandlesSuccessEnvelopesWithNullResult) {
   const JsonMethodCodec& codec = JsonMethodCodec::GetInstance();
   auto encoded = codec.EncodeSuccessEnvelope();
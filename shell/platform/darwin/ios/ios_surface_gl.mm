@@ -41,12 +41,13 @@ std::unique_ptr<Surface> IOSSurfaceGL::CreateGPUSurface(GrDirectContext* gr_cont
   } else {
     IOSContextGL* gl_context = CastToGLContext(GetContext());
     sk_sp<GrDirectContext> context = gl_context->GetMainContext();
+    std::vector<PersistentCache::SkSLCache> deferred_sksls;
     if (!context) {
-      context = GPUSurfaceGL::MakeGLContext(this);
+      context = GPUSurfaceGL::MakeGLContext(this, &deferred_sksls);
       gl_context->SetMainContext(context);
     }
 
-    return std::make_unique<GPUSurfaceGL>(context, this, true);
+    return std::make_unique<GPUSurfaceGL>(context, this, true, std::move(deferred_sksls));
   }
 }
 
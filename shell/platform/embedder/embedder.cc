@@ -8,6 +8,7 @@
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <set>
 #include <string>
 #include <vector>
@@ -176,6 +177,16 @@ static void* DefaultGLProcResolver(const char* name) {
 }
 #endif  // OS_LINUX || OS_WIN
 
+#ifdef SHELL_ENABLE_GL
+static FlutterRect SkIRectToFlutterRect(const SkIRect& rect) {
+  FlutterRect flutter_rect = {static_cast<double>(rect.left()),
+                              static_cast<double>(rect.top()),
+                              static_cast<double>(rect.right()),
+                              static_cast<double>(rect.bottom())};
+  return flutter_rect;
+}
+#endif  // SHELL_ENABLE_GL
+
 static flutter::Shell::CreateCallback<flutter::PlatformView>
 InferOpenGLPlatformViewCreationCallback(
     const FlutterRendererConfig* config,
@@ -195,15 +206,31 @@ InferOpenGLPlatformViewCreationCallback(
   auto gl_clear_current = [ptr = config->open_gl.clear_current,
                            user_data]() -> bool { return ptr(user_data); };
 
-  auto gl_present = [present = config->open_gl.present,
-                     present_with_info = config->open_gl.present_with_info,
-                     user_data](uint32_t fbo_id) -> bool {
+  auto gl_present =
+      [present = config->open_gl.present,
+       present_with_info = config->open_gl.present_with_info,
+       user_data](const flutter::GLPresentInfo& gl_present_info) -> bool {
     if (present) {
       return present(user_data);
     } else {
+      FlutterRect frame_damage_rect = {};
+      FlutterRect buffer_damage_rect = {};
       FlutterPresentInfo present_info = {};
       present_info.struct_size = sizeof(FlutterPresentInfo);
-      present_info.fbo_id = fbo_id;
+      present_info.fbo_id = gl_present_info.fbo_id;
+      present_info.frame_damage.struct_size = sizeof(FlutterDamage);
+      if (gl_present_info.frame_damage) {
+        frame_damage_rect = SkIRectToFlutterRect(*gl_present_info.frame_damage);
+        present_info.frame_damage.num_rects = 1;
+        present_info.frame_damage.damage = &frame_damage_rect;
+      }
+      present_info.buffer_damage.struct_size = sizeof(FlutterDamage);
+      if (gl_present_info.buffer_damage) {
+        buffer_damage_rect =
+            SkIRectToFlutterRect(*gl_present_info.buffer_damage);
+        present_info.buffer_damage.num_rects = 1;
+        present_info.buffer_damage.damage = &buffer_damage_rect;
+      }
       return present_with_info(user_data, &present_info);
     }
   };
@@ -272,6 +299,32 @@ InferOpenGLPlatformViewCreationCallback(
   bool fbo_reset_after_present =
       SAFE_ACCESS(open_gl_config, fbo_reset_after_present, false);
 
+  std::function<std::optional<SkIRect>(intptr_t)>
+      gl_populate_existing_damage = nullptr;
+  if (SAFE_ACCESS(open_gl_config, populate_existing_damage, nullptr) !=
+      nullptr) {
+    gl_populate_existing_damage =
+        [ptr = config->open_gl.populate_existing_damage,
+         user_data](intptr_t fbo_id) -> std::optional<SkIRect> {
+      FlutterDamage existing_damage = {};
+      existing_damage.struct_size = sizeof(FlutterDamage);
+      ptr(user_data, fbo_id, &existing_damage);
+      if (existing_damage.num_rects > 0 && existing_damage.damage == nullptr) {
+        FML_LOG(ERROR) << "Embedder reported existing damage rects without "
+                          "providing them. Repainting the whole frame.";
+        return std::nullopt;
+      }
+      SkIRect damage = SkIRect::MakeEmpty();
+      for (size_t i = 0; i < existing_damage.num_rects; i++) {
+        const FlutterRect& rect = existing_damage.damage[i];
+        damage.join(SkRect::MakeLTRB(rect.left, rect.top, rect.right,
+                                     rect.bottom)
+                        .roundOut());
+      }
+      return damage;
+    };
+  }
+
   flutter::EmbedderSurfaceGL::GLDispatchTable gl_dispatch_table = {
       gl_make_current,                     // gl_make_current_callback
       gl_clear_current,                    // gl_clear_current_callback
@@ -280,6 +333,7 @@ InferOpenGLPlatformViewCreationCallback(
       gl_make_resource_current_callback,   // gl_make_resource_current_callback
       gl_surface_transformation_callback,  // gl_surface_transformation_callback
       gl_proc_resolver,                    // gl_proc_resolver
+      gl_populate_existing_damage,         // gl_populate_existing_damage
   };
 
   return fml::MakeCopyable(
@@ -641,6 +695,10 @@ InferExternalViewEmbedderFromArgs(const FlutterCompositor* compositor) {
       SAFE_ACCESS(compositor, present_layers_callback, nullptr);
   bool avoid_backing_store_cache =
       SAFE_ACCESS(compositor, avoid_backing_store_cache, false);
+  size_t backing_store_size_granularity =
+      SAFE_ACCESS(compositor, backing_store_size_granularity, 0);
+  bool merge_overlay_layers =
+      SAFE_ACCESS(compositor, merge_overlay_layers, false);
 
   // Make sure the required callbacks are present
   if (!c_create_callback || !c_collect_callback || !c_present_callback) {
@@ -667,7 +725,8 @@ InferExternalViewEmbedderFromArgs(const FlutterCompositor* compositor) {
       };
 
   return {std::make_unique<flutter::EmbedderExternalViewEmbedder>(
-              avoid_backing_store_cache, create_render_target_callback,
+              avoid_backing_store_cache, backing_store_size_granularity,
+              merge_overlay_layers, create_render_target_callback,
               present_callback),
           false};
 }
@@ -1041,9 +1100,11 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
           const FlutterPlatformMessage incoming_message = {
               sizeof(FlutterPlatformMessage),  // struct_size
               message->channel().c_str(),      // channel
-              message->data().data(),          // message
-              message->data().size(),          // message_size
+              message->data().GetMapping(),    // message
+              message->data().GetSize(),       // message_size
               handle,                          // response_handle
+              nullptr,                         // message_release_callback
+              nullptr,                         // message_release_user_data
           };
           handle->message = std::move(message);
           return ptr(&incoming_message, user_data);
@@ -1532,13 +1593,23 @@ FlutterEngineResult FlutterEngineSendKeyEvent(FLUTTER_API_SYMBOL(FlutterEngine)
                                   "running Flutter application.");
 }
 
-FlutterEngineResult FlutterEngineSendPlatformMessage(
-    FLUTTER_API_SYMBOL(FlutterEngine) engine,
-    const FlutterPlatformMessage* flutter_message) {
-  if (engine == nullptr) {
-    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
-  }
+// Wraps a buffer the embedder hands over to the engine. The mapping is mutable
+// so that it may be passed to Dart as external typed data without a copy.
+static std::unique_ptr<fml::Mapping> CreateEmbedderOwnedMapping(
+    const uint8_t* data,
+    size_t size,
+    FlutterDataCallback release_callback,
+    void* user_data) {
+  return std::make_unique<fml::NonOwnedMapping>(
+      data, size,
+      [release_callback, user_data](const uint8_t* data, size_t size) {
+        release_callback(data, size, user_data);
+      },
+      true /* is_mutable */);
+}
 
+static FlutterEngineResult ValidatePlatformMessage(
+    const FlutterPlatformMessage* flutter_message) {
   if (flutter_message == nullptr) {
     return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid message argument.");
   }
@@ -1557,6 +1628,15 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
         "Message size was non-zero but the message data was nullptr.");
   }
 
+  return kSuccess;
+}
+
+// The message must have been checked by |ValidatePlatformMessage|.
+static fml::RefPtr<flutter::PlatformMessage> CreatePlatformMessage(
+    const FlutterPlatformMessage* flutter_message) {
+  size_t message_size = SAFE_ACCESS(flutter_message, message_size, 0);
+  const uint8_t* message_data = SAFE_ACCESS(flutter_message, message, nullptr);
+
   const FlutterPlatformMessageResponseHandle* response_handle =
       SAFE_ACCESS(flutter_message, response_handle, nullptr);
 
@@ -1565,25 +1645,98 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     response = response_handle->message->response();
   }
 
-  fml::RefPtr<flutter::PlatformMessage> message;
-  if (message_size == 0) {
-    message = fml::MakeRefCounted<flutter::PlatformMessage>(
-        flutter_message->channel, response);
-  } else {
-    message = fml::MakeRefCounted<flutter::PlatformMessage>(
+  FlutterDataCallback release_callback =
+      SAFE_ACCESS(flutter_message, message_release_callback, nullptr);
+
+  if (release_callback != nullptr && message_size == 0) {
+    // Empty messages reach Dart as null, so there is nothing to hand over.
+    release_callback(
+        message_data, 0,
+        SAFE_ACCESS(flutter_message, message_release_user_data, nullptr));
+  } else if (release_callback != nullptr) {
+    // The embedder hands over the buffer, so it is released even if the
+    // message cannot be delivered.
+    return fml::MakeRefCounted<flutter::PlatformMessage>(
         flutter_message->channel,
-        std::vector<uint8_t>(message_data, message_data + message_size),
+        CreateEmbedderOwnedMapping(
+            message_data, message_size, release_callback,
+            SAFE_ACCESS(flutter_message, message_release_user_data, nullptr)),
         response);
   }
 
+  if (message_size == 0) {
+    return fml::MakeRefCounted<flutter::PlatformMessage>(
+        flutter_message->channel, response);
+  }
+
+  return fml::MakeRefCounted<flutter::PlatformMessage>(
+      flutter_message->channel,
+      std::vector<uint8_t>(message_data, message_data + message_size),
+      response);
+}
+
+FlutterEngineResult FlutterEngineSendPlatformMessage(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* flutter_message) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  FlutterEngineResult validation_result =
+      ValidatePlatformMessage(flutter_message);
+  if (validation_result != kSuccess) {
+    return validation_result;
+  }
+
   return reinterpret_cast<flutter::EmbedderEngine*>(engine)
-                 ->SendPlatformMessage(std::move(message))
+                 ->SendPlatformMessage(CreatePlatformMessage(flutter_message))
              ? kSuccess
              : LOG_EMBEDDER_ERROR(kInternalInconsistency,
                                   "Could not send a message to the running "
                                   "Flutter application.");
 }
 
+FlutterEngineResult FlutterEngineSendPlatformMessages(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* messages,
+    size_t messages_count) {
+  if (engine == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid engine handle.");
+  }
+
+  if (messages == nullptr || messages_count == 0) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Invalid messages argument.");
+  }
+
+  // Validate the whole batch before adopting any of the message buffers so
+  // that the embedder retains ownership of all of them on failure.
+  const FlutterPlatformMessage* current = messages;
+  for (size_t i = 0; i < messages_count; ++i) {
+    FlutterEngineResult validation_result = ValidatePlatformMessage(current);
+    if (validation_result != kSuccess) {
+      return validation_result;
+    }
+    current = reinterpret_cast<const FlutterPlatformMessage*>(
+        reinterpret_cast<const uint8_t*>(current) + current->struct_size);
+  }
+
+  std::vector<fml::RefPtr<flutter::PlatformMessage>> platform_messages;
+  platform_messages.reserve(messages_count);
+  current = messages;
+  for (size_t i = 0; i < messages_count; ++i) {
+    platform_messages.push_back(CreatePlatformMessage(current));
+    current = reinterpret_cast<const FlutterPlatformMessage*>(
+        reinterpret_cast<const uint8_t*>(current) + current->struct_size);
+  }
+
+  return reinterpret_cast<flutter::EmbedderEngine*>(engine)
+                 ->SendPlatformMessages(std::move(platform_messages))
+             ? kSuccess
+             : LOG_EMBEDDER_ERROR(kInternalInconsistency,
+                                  "Could not send messages to the running "
+                                  "Flutter application.");
+}
+
 FlutterEngineResult FlutterPlatformMessageCreateResponseHandle(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     FlutterDataCallback data_callback,
@@ -1660,6 +1813,38 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
   return kSuccess;
 }
 
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    FlutterDataCallback release_callback,
+    void* user_data) {
+  if (data_length != 0 && data == nullptr) {
+    return LOG_EMBEDDER_ERROR(
+        kInvalidArguments,
+        "Data size was non zero but the pointer to the data was null.");
+  }
+
+  if (release_callback == nullptr) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                              "The release callback was null.");
+  }
+
+  auto mapping = CreateEmbedderOwnedMapping(data, data_length,
+                                            release_callback, user_data);
+
+  auto response = handle->message->response();
+
+  if (response) {
+    response->Complete(std::move(mapping));
+  }
+
+  delete handle;
+
+  return kSuccess;
+}
+
 FlutterEngineResult __FlutterEngineFlushPendingTasksNow() {
   fml::MessageLoop::GetCurrent().RunExpiredTasksNow();
   return kSuccess;
@@ -2187,6 +2372,34 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
   }
 }
 
+FlutterEngineResult FlutterEngineSetFrameLatencyMode(
+    FLUTTER_API_SYMBOL(FlutterEngine) raw_engine,
+    FlutterEngineFrameLatencyMode mode) {
+  auto engine = reinterpret_cast<flutter::EmbedderEngine*>(raw_engine);
+  if (engine == nullptr || !engine->IsValid()) {
+    return LOG_EMBEDDER_ERROR(kInvalidArguments, "Engine was invalid.");
+  }
+
+  flutter::FrameLatencyMode frame_latency_mode;
+  switch (mode) {
+    case kFlutterEngineFrameLatencyModeDefault:
+      frame_latency_mode = flutter::FrameLatencyMode::kDefault;
+      break;
+    case kFlutterEngineFrameLatencyModeLowLatency:
+      frame_latency_mode = flutter::FrameLatencyMode::kLowLatency;
+      break;
+    case kFlutterEngineFrameLatencyModeThroughput:
+      frame_latency_mode = flutter::FrameLatencyMode::kThroughput;
+      break;
+    default:
+      return LOG_EMBEDDER_ERROR(kInvalidArguments,
+                                "Invalid frame latency mode specified.");
+  }
+
+  engine->GetShell().SetFrameLatencyMode(frame_latency_mode);
+  return kSuccess;
+}
+
 FlutterEngineResult FlutterEngineGetProcAddresses(
     FlutterEngineProcTable* table) {
   if (!table) {
@@ -2237,6 +2450,10 @@ FlutterEngineResult FlutterEngineGetProcAddresses(
   SET_PROC(PostCallbackOnAllNativeThreads,
            FlutterEnginePostCallbackOnAllNativeThreads);
   SET_PROC(NotifyDisplayUpdate, FlutterEngineNotifyDisplayUpdate);
+  SET_PROC(SendPlatformMessageResponseNoCopy,
+           FlutterEngineSendPlatformMessageResponseNoCopy);
+  SET_PROC(SendPlatformMessages, FlutterEngineSendPlatformMessages);
+  SET_PROC(SetFrameLatencyMode, FlutterEngineSetFrameLatencyMode);
 #undef SET_PROC
 
   return kSuccess;
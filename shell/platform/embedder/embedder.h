@@ -363,6 +363,17 @@ typedef uint32_t (*UIntFrameInfoCallback)(
     void* /* user data */,
     const FlutterFrameInfo* /* frame info */);
 
+/// A structure to represent a damage region, in physical pixels with the
+/// origin at the top left of the surface.
+typedef struct {
+  /// The size of this struct. Must be sizeof(FlutterDamage).
+  size_t struct_size;
+  /// The number of rectangles within the damage region.
+  size_t num_rects;
+  /// The actual damage region(s) in question.
+  FlutterRect* damage;
+} FlutterDamage;
+
 /// This information is passed to the embedder when a surface is presented.
 ///
 /// See: \ref FlutterOpenGLRendererConfig.present_with_info.
@@ -371,8 +382,26 @@ typedef struct {
   size_t struct_size;
   /// Id of the fbo backing the surface that was presented.
   uint32_t fbo_id;
+  /// Damage representing the area that the engine determined changed since
+  /// the previously presented frame. Embedders may use it to present only
+  /// this area (e.g. via `eglSwapBuffersWithDamageKHR`). Zero rects means
+  /// the whole surface changed.
+  FlutterDamage frame_damage;
+  /// Damage used to set the buffer's damage region, i.e. the area of the fbo
+  /// that was repainted (e.g. via `eglSetDamageRegionKHR`). Zero rects means
+  /// the whole fbo was repainted.
+  FlutterDamage buffer_damage;
 } FlutterPresentInfo;
 
+/// Callback for when the engine asks the embedder which area of a frame
+/// buffer object does not hold the content of the previously presented frame.
+/// The embedder fills in `existing_damage`; the rects it points to must remain
+/// valid until the next invocation of the callback.
+typedef void (*FlutterFrameBufferWithDamageCallback)(
+    void* /* user data */,
+    const intptr_t /* fbo id */,
+    FlutterDamage* /* existing damage */);
+
 /// Callback for when a surface is presented.
 typedef bool (*BoolPresentInfoCallback)(
     void* /* user data */,
@@ -436,6 +465,15 @@ typedef struct {
   /// `FlutterPresentInfo` struct that the embedder can use to release any
   /// resources. The return value indicates success of the present call.
   BoolPresentInfoCallback present_with_info;
+  /// Specifying this callback enables partial repaint. Before rendering into
+  /// an fbo, the engine asks the embedder for the area of that fbo that does
+  /// not hold the previously presented frame (e.g. computed from the buffer
+  /// age). Setting `num_rects` to zero means the fbo holds the previous frame.
+  /// If the embedder cannot determine the content of the fbo, it must report
+  /// a single rect covering the whole fbo. The engine then repaints only the
+  /// damaged area and reports it through `present_with_info`. This callback is
+  /// optional.
+  FlutterFrameBufferWithDamageCallback populate_existing_damage;
 } FlutterOpenGLRendererConfig;
 
 /// Alias for id<MTLDevice>.
@@ -717,6 +755,10 @@ struct _FlutterPlatformMessageResponseHandle;
 typedef struct _FlutterPlatformMessageResponseHandle
     FlutterPlatformMessageResponseHandle;
 
+typedef void (*FlutterDataCallback)(const uint8_t* /* data */,
+                                    size_t /* size */,
+                                    void* /* user data */);
+
 typedef struct {
   /// The size of this struct. Must be sizeof(FlutterPlatformMessage).
   size_t struct_size;
@@ -730,16 +772,26 @@ typedef struct {
   /// `FlutterEngineSendPlatformMessageResponse` will cause a memory leak. It is
   /// not safe to send multiple responses on a single response object.
   const FlutterPlatformMessageResponseHandle* response_handle;
+  /// Optional. When set on a message sent via
+  /// `FlutterEngineSendPlatformMessage`, the engine adopts the `message`
+  /// buffer instead of copying it and invokes this callback, on an arbitrary
+  /// thread, once it no longer needs the buffer. Until then the buffer must
+  /// remain valid and must not be accessed by the embedder. The buffer must be
+  /// writable as it may be handed to the Dart application as is. The callback
+  /// is invoked exactly once unless the call fails with `kInvalidArguments`, in
+  /// which case the embedder retains ownership of the buffer. Empty messages
+  /// are delivered as null, and their callback is invoked before
+  /// `FlutterEngineSendPlatformMessage` returns. Unused on messages sent by
+  /// the engine to the embedder.
+  FlutterDataCallback message_release_callback;
+  /// The user data passed to `message_release_callback`.
+  void* message_release_user_data;
 } FlutterPlatformMessage;
 
 typedef void (*FlutterPlatformMessageCallback)(
     const FlutterPlatformMessage* /* message*/,
     void* /* user data */);
 
-typedef void (*FlutterDataCallback)(const uint8_t* /* data */,
-                                    size_t /* size */,
-                                    void* /* user data */);
-
 /// The identifier of the platform view. This identifier is specified by the
 /// application when a platform view is added to the scene via the
 /// `SceneBuilder.addPlatformView` call.
@@ -1095,6 +1147,21 @@ typedef struct {
   FlutterLayersPresentCallback present_layers_callback;
   /// Avoid caching backing stores provided by this compositor.
   bool avoid_backing_store_cache;
+  /// If non-zero, the engine rounds the sizes of the backing stores it asks
+  /// for up to a multiple of this many pixels, so that it can keep using them
+  /// while the size of the surface changes, such as during a window resize.
+  /// The contents of a layer are then rendered into the top left corner of
+  /// its backing store, at the size of the layer, and the compositor must only
+  /// present that part of the backing store.
+  size_t backing_store_size_granularity;
+  /// Avoid presenting a backing store layer for Flutter contents that do not
+  /// overlap any of the platform views below them. Those contents are rendered
+  /// into the backing store of a lower layer instead, which reduces the number
+  /// of backing stores the compositor has to create and blend.
+  ///
+  /// Platform views are presumed to cover their entire bounds, after
+  /// transformation, for this purpose.
+  bool merge_overlay_layers;
 } FlutterCompositor;
 
 typedef struct {
@@ -1159,6 +1226,20 @@ typedef enum {
   kFlutterEngineDisplaysUpdateTypeCount,
 } FlutterEngineDisplaysUpdateType;
 
+/// How the engine trades the latency of frames for their throughput. See
+/// `FlutterEngineSetFrameLatencyMode`.
+typedef enum {
+  /// The pipeline depth suited to the threading configuration of the engine.
+  kFlutterEngineFrameLatencyModeDefault,
+  /// Only one frame is in flight at a time, and frames are begun as late in
+  /// the vsync interval as recent build and raster times allow. This suits
+  /// applications that are sensitive to input latency.
+  kFlutterEngineFrameLatencyModeLowLatency,
+  /// More frames are in flight at a time, so that the UI thread can build the
+  /// next frames while the render thread is still busy.
+  kFlutterEngineFrameLatencyModeThroughput,
+} FlutterEngineFrameLatencyMode;
+
 typedef int64_t FlutterEngineDartPort;
 
 typedef enum {
@@ -1682,6 +1763,33 @@ FlutterEngineResult FlutterEngineSendPlatformMessage(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
 
+//------------------------------------------------------------------------------
+/// @brief      Sends a batch of platform messages to the Flutter application.
+///             The batch is delivered in a single task on the UI thread and a
+///             single call into the root isolate, which makes this much
+///             cheaper than calling `FlutterEngineSendPlatformMessage` for
+///             each message when sending many small messages at once.
+///             Messages are delivered in the order they appear in the batch,
+///             so the ordering of the messages on each channel is preserved.
+///
+///             Like `FlutterPointerEvent`s, the messages are laid out
+///             consecutively and each one is advanced over using its
+///             `struct_size`. If any message is invalid, none are sent.
+///
+/// @see        FlutterEngineSendPlatformMessage()
+///
+/// @param[in]  engine          A running engine instance.
+/// @param[in]  messages        The messages to send.
+/// @param[in]  messages_count  The number of messages in the batch.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessages(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* messages,
+    size_t messages_count);
+
 //------------------------------------------------------------------------------
 /// @brief     Creates a platform message response handle that allows the
 ///            embedder to set a native callback for a response to a message.
@@ -1755,6 +1863,41 @@ FlutterEngineResult FlutterEngineSendPlatformMessageResponse(
     const uint8_t* data,
     size_t data_length);
 
+//------------------------------------------------------------------------------
+/// @brief      Send a response from the native side to a platform message from
+///             the Dart Flutter application without copying the response
+///             data. The engine adopts the data buffer and invokes the release
+///             callback, on an arbitrary thread, once it no longer needs it.
+///             Until then the buffer must remain valid and must not be
+///             accessed by the embedder. The buffer must be writable as it may
+///             be handed to the Dart application as is.
+///
+/// @see        FlutterEngineSendPlatformMessageResponse()
+///
+/// @param[in]  engine            The running engine instance.
+/// @param[in]  handle            The platform message response handle.
+/// @param[in]  data              The data to associate with the platform
+///                               message response.
+/// @param[in]  data_length       The length of the platform message response
+///                               data.
+/// @param[in]  release_callback  The callback invoked when the engine is done
+///                               with `data`. Invoked exactly once unless the
+///                               call fails with `kInvalidArguments`, in which
+///                               case the embedder retains ownership of
+///                               `data`.
+/// @param[in]  user_data         The user data passed to `release_callback`.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSendPlatformMessageResponseNoCopy(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    FlutterDataCallback release_callback,
+    void* user_data);
+
 //------------------------------------------------------------------------------
 /// @brief      This API is only meant to be used by platforms that need to
 ///             flush tasks on a message loop not controlled by the Flutter
@@ -2157,6 +2300,21 @@ FlutterEngineResult FlutterEngineNotifyDisplayUpdate(
     const FlutterEngineDisplay* displays,
     size_t display_count);
 
+//------------------------------------------------------------------------------
+/// @brief      Changes how a running engine trades the latency of frames for
+///             their throughput. The initial mode may be selected with the
+///             `--frame-latency-mode` command line switch.
+///
+/// @param[in]  engine  A running engine instance.
+/// @param[in]  mode    The frame latency mode.
+///
+/// @return     The result of the call.
+///
+FLUTTER_EXPORT
+FlutterEngineResult FlutterEngineSetFrameLatencyMode(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterEngineFrameLatencyMode mode);
+
 #endif  // !FLUTTER_ENGINE_NO_PROTOTYPES
 
 // Typedefs for the function pointers in FlutterEngineProcTable.
@@ -2198,6 +2356,10 @@ typedef FlutterEngineResult (*FlutterEngineSendKeyEventFnPtr)(
 typedef FlutterEngineResult (*FlutterEngineSendPlatformMessageFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     const FlutterPlatformMessage* message);
+typedef FlutterEngineResult (*FlutterEngineSendPlatformMessagesFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessage* messages,
+    size_t messages_count);
 typedef FlutterEngineResult (
     *FlutterEnginePlatformMessageCreateResponseHandleFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
@@ -2213,6 +2375,14 @@ typedef FlutterEngineResult (*FlutterEngineSendPlatformMessageResponseFnPtr)(
     const FlutterPlatformMessageResponseHandle* handle,
     const uint8_t* data,
     size_t data_length);
+typedef FlutterEngineResult (
+    *FlutterEngineSendPlatformMessageResponseNoCopyFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    const FlutterPlatformMessageResponseHandle* handle,
+    const uint8_t* data,
+    size_t data_length,
+    FlutterDataCallback release_callback,
+    void* user_data);
 typedef FlutterEngineResult (*FlutterEngineRegisterExternalTextureFnPtr)(
     FLUTTER_API_SYMBOL(FlutterEngine) engine,
     int64_t texture_identifier);
@@ -2273,6 +2443,9 @@ typedef FlutterEngineResult (*FlutterEngineNotifyDisplayUpdateFnPtr)(
     FlutterEngineDisplaysUpdateType update_type,
     const FlutterEngineDisplay* displays,
     size_t display_count);
+typedef FlutterEngineResult (*FlutterEngineSetFrameLatencyModeFnPtr)(
+    FLUTTER_API_SYMBOL(FlutterEngine) engine,
+    FlutterEngineFrameLatencyMode mode);
 
 /// Function-pointer-based versions of the APIs above.
 typedef struct {
@@ -2317,6 +2490,10 @@ typedef struct {
   FlutterEnginePostCallbackOnAllNativeThreadsFnPtr
       PostCallbackOnAllNativeThreads;
   FlutterEngineNotifyDisplayUpdateFnPtr NotifyDisplayUpdate;
+  FlutterEngineSendPlatformMessageResponseNoCopyFnPtr
+      SendPlatformMessageResponseNoCopy;
+  FlutterEngineSendPlatformMessagesFnPtr SendPlatformMessages;
+  FlutterEngineSetFrameLatencyModeFnPtr SetFrameLatencyMode;
 } FlutterEngineProcTable;
 
 //------------------------------------------------------------------------------
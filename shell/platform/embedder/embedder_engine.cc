@@ -158,6 +158,21 @@ bool EmbedderEngine::SendPlatformMessage(
   return true;
 }
 
+bool EmbedderEngine::SendPlatformMessages(
+    std::vector<fml::RefPtr<flutter::PlatformMessage>> messages) {
+  if (!IsValid() || messages.empty()) {
+    return false;
+  }
+
+  auto platform_view = shell_->GetPlatformView();
+  if (!platform_view) {
+    return false;
+  }
+
+  platform_view->DispatchPlatformMessages(std::move(messages));
+  return true;
+}
+
 bool EmbedderEngine::RegisterTexture(int64_t texture) {
   if (!IsValid()) {
     return false;
@@ -70,6 +70,9 @@ class EmbedderEngine {
 
   bool SendPlatformMessage(fml::RefPtr<flutter::PlatformMessage> message);
 
+  bool SendPlatformMessages(
+      std::vector<fml::RefPtr<flutter::PlatformMessage>> messages);
+
   bool RegisterTexture(int64_t texture);
 
   bool UnregisterTexture(int64_t texture);
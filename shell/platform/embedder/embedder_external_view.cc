@@ -18,30 +18,30 @@ static SkISize TransformedSurfaceSize(const SkISize& size,
 EmbedderExternalView::EmbedderExternalView(
     const SkISize& frame_size,
     const SkMatrix& surface_transformation)
-    : EmbedderExternalView(frame_size, surface_transformation, {}, nullptr) {}
+    : EmbedderExternalView(frame_size,
+                           surface_transformation,
+                           {},
+                           nullptr,
+                           false) {}
 
 EmbedderExternalView::EmbedderExternalView(
     const SkISize& frame_size,
     const SkMatrix& surface_transformation,
     ViewIdentifier view_identifier,
-    std::unique_ptr<EmbeddedViewParams> params)
+    std::unique_ptr<EmbeddedViewParams> params,
+    bool record_contents_bounds)
     : render_surface_size_(
           TransformedSurfaceSize(frame_size, surface_transformation)),
       surface_transformation_(surface_transformation),
       view_identifier_(view_identifier),
       embedded_view_params_(std::move(params)),
       recorder_(std::make_unique<SkPictureRecorder>()),
-      canvas_spy_(std::make_unique<CanvasSpy>(
-          recorder_->beginRecording(frame_size.width(), frame_size.height()))) {
-}
+      canvas_spy_(std::make_unique<CanvasSpy>(recorder_->beginRecording(
+          SkRect::Make(frame_size),
+          record_contents_bounds ? &rtree_factory_ : nullptr))) {}
 
 EmbedderExternalView::~EmbedderExternalView() = default;
 
-EmbedderExternalView::RenderTargetDescriptor
-EmbedderExternalView::CreateRenderTargetDescriptor() const {
-  return {view_identifier_, render_surface_size_};
-}
-
 SkCanvas* EmbedderExternalView::GetCanvas() const {
   return canvas_spy_->GetSpyingCanvas();
 }
@@ -59,7 +59,10 @@ bool EmbedderExternalView::HasPlatformView() const {
 }
 
 bool EmbedderExternalView::HasEngineRenderedContents() const {
-  return canvas_spy_->DidDrawIntoCanvas();
+  if (!recording_finished_) {
+    return canvas_spy_->DidDrawIntoCanvas();
+  }
+  return !pictures_.empty();
 }
 
 EmbedderExternalView::ViewIdentifier EmbedderExternalView::GetViewIdentifier()
@@ -71,6 +74,40 @@ const EmbeddedViewParams* EmbedderExternalView::GetEmbeddedViewParams() const {
   return embedded_view_params_.get();
 }
 
+void EmbedderExternalView::FinishRecording() {
+  if (recording_finished_) {
+    return;
+  }
+  recording_finished_ = true;
+  if (!canvas_spy_->DidDrawIntoCanvas()) {
+    return;
+  }
+  auto picture = recorder_->finishRecordingAsPicture();
+  if (picture) {
+    pictures_.push_back(std::move(picture));
+  }
+}
+
+SkRect EmbedderExternalView::GetEngineRenderedContentsBounds() {
+  FinishRecording();
+  SkRect bounds = SkRect::MakeEmpty();
+  for (const auto& picture : pictures_) {
+    bounds.join(picture->cullRect());
+  }
+  return bounds;
+}
+
+void EmbedderExternalView::TakeEngineRenderedContents(
+    EmbedderExternalView& view) {
+  FML_DCHECK(&view != this);
+  FinishRecording();
+  view.FinishRecording();
+  pictures_.insert(pictures_.end(),
+                   std::make_move_iterator(view.pictures_.begin()),
+                   std::make_move_iterator(view.pictures_.end()));
+  view.pictures_.clear();
+}
+
 bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
   TRACE_EVENT0("flutter", "EmbedderExternalView::Render");
 
@@ -78,8 +115,8 @@ bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
       << "Unnecessarily asked to render into a render target when there was "
          "nothing to render.";
 
-  auto picture = recorder_->finishRecordingAsPicture();
-  if (!picture) {
+  FinishRecording();
+  if (pictures_.empty()) {
     return false;
   }
 
@@ -88,8 +125,10 @@ bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
     return false;
   }
 
-  FML_DCHECK(SkISize::Make(surface->width(), surface->height()) ==
-             render_surface_size_);
+  // Render targets may be larger than the view, in which case the view covers
+  // their top left corner.
+  FML_DCHECK(surface->width() >= render_surface_size_.width() &&
+             surface->height() >= render_surface_size_.height());
 
   auto canvas = surface->getCanvas();
   if (!canvas) {
@@ -98,7 +137,9 @@ bool EmbedderExternalView::Render(const EmbedderRenderTarget& render_target) {
 
   canvas->setMatrix(surface_transformation_);
   canvas->clear(SK_ColorTRANSPARENT);
-  canvas->drawPicture(picture);
+  for (const auto& picture : pictures_) {
+    canvas->drawPicture(picture);
+  }
   canvas->flush();
 
   return true;
@@ -8,12 +8,14 @@
 #include <optional>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "flutter/flow/embedded_views.h"
 #include "flutter/fml/hash_combine.h"
 #include "flutter/fml/macros.h"
 #include "flutter/shell/common/canvas_spy.h"
 #include "flutter/shell/platform/embedder/embedder_render_target.h"
+#include "third_party/skia/include/core/SkBBHFactory.h"
 #include "third_party/skia/include/core/SkPictureRecorder.h"
 
 namespace flutter {
@@ -46,33 +48,6 @@ class EmbedderExternalView {
     };
   };
 
-  struct RenderTargetDescriptor {
-    ViewIdentifier view_identifier;
-    SkISize surface_size;
-
-    RenderTargetDescriptor(ViewIdentifier p_view_identifier,
-                           SkISize p_surface_size)
-        : view_identifier(p_view_identifier), surface_size(p_surface_size) {}
-
-    struct Hash {
-      constexpr std::size_t operator()(
-          const RenderTargetDescriptor& desc) const {
-        return fml::HashCombine(desc.surface_size.width(),
-                                desc.surface_size.height(),
-                                ViewIdentifier::Hash{}(desc.view_identifier));
-      }
-    };
-
-    struct Equal {
-      bool operator()(const RenderTargetDescriptor& lhs,
-                      const RenderTargetDescriptor& rhs) const {
-        return lhs.surface_size == rhs.surface_size &&
-               ViewIdentifier::Equal{}(lhs.view_identifier,
-                                       rhs.view_identifier);
-      }
-    };
-  };
-
   using ViewIdentifierSet = std::unordered_set<ViewIdentifier,
                                                ViewIdentifier::Hash,
                                                ViewIdentifier::Equal>;
@@ -85,10 +60,19 @@ class EmbedderExternalView {
   EmbedderExternalView(const SkISize& frame_size,
                        const SkMatrix& surface_transformation);
 
+  //----------------------------------------------------------------------------
+  /// @param[in]  record_contents_bounds  If set, the contents rendered by
+  ///                                     Flutter are recorded with a bounding
+  ///                                     box hierarchy so that
+  ///                                     `GetEngineRenderedContentsBounds`
+  ///                                     returns their tight bounds instead of
+  ///                                     the frame bounds.
+  ///
   EmbedderExternalView(const SkISize& frame_size,
                        const SkMatrix& surface_transformation,
                        ViewIdentifier view_identifier,
-                       std::unique_ptr<EmbeddedViewParams> params);
+                       std::unique_ptr<EmbeddedViewParams> params,
+                       bool record_contents_bounds);
 
   ~EmbedderExternalView();
 
@@ -102,12 +86,24 @@ class EmbedderExternalView {
 
   const EmbeddedViewParams* GetEmbeddedViewParams() const;
 
-  RenderTargetDescriptor CreateRenderTargetDescriptor() const;
-
   SkCanvas* GetCanvas() const;
 
   SkISize GetRenderSurfaceSize() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The bounds of the contents rendered by Flutter into this view,
+  ///             in frame coordinates. This ends the recording of the view.
+  ///
+  SkRect GetEngineRenderedContentsBounds();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Moves the contents rendered by Flutter into another view on
+  ///             top of the contents of this view, so that they end up in the
+  ///             render target of this view. This ends the recording of both
+  ///             views.
+  ///
+  void TakeEngineRenderedContents(EmbedderExternalView& view);
+
   bool Render(const EmbedderRenderTarget& render_target);
 
  private:
@@ -115,8 +111,16 @@ class EmbedderExternalView {
   const SkMatrix surface_transformation_;
   ViewIdentifier view_identifier_;
   std::unique_ptr<EmbeddedViewParams> embedded_view_params_;
+  // Used when the contents bounds are recorded, so that the pictures are
+  // culled to their contents.
+  SkRTreeFactory rtree_factory_;
   std::unique_ptr<SkPictureRecorder> recorder_;
   std::unique_ptr<CanvasSpy> canvas_spy_;
+  bool recording_finished_ = false;
+  // The pictures to render, bottom to top, once the recording is finished.
+  std::vector<sk_sp<SkPicture>> pictures_;
+
+  void FinishRecording();
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderExternalView);
 };
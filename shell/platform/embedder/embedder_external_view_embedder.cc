@@ -6,6 +6,7 @@
 
 #include <algorithm>
 
+#include "flutter/fml/trace_event.h"
 #include "flutter/shell/platform/embedder/embedder_layers.h"
 #include "flutter/shell/platform/embedder/embedder_render_target.h"
 #include "third_party/skia/include/gpu/GrDirectContext.h"
@@ -14,11 +15,15 @@ namespace flutter {
 
 EmbedderExternalViewEmbedder::EmbedderExternalViewEmbedder(
     bool avoid_backing_store_cache,
+    size_t backing_store_size_granularity,
+    bool merge_overlay_layers,
     const CreateRenderTargetCallback& create_render_target_callback,
     const PresentCallback& present_callback)
     : avoid_backing_store_cache_(avoid_backing_store_cache),
+      merge_overlay_layers_(merge_overlay_layers),
       create_render_target_callback_(create_render_target_callback),
-      present_callback_(present_callback) {
+      present_callback_(present_callback),
+      render_target_cache_(backing_store_size_granularity) {
   FML_DCHECK(create_render_target_callback_);
   FML_DCHECK(present_callback_);
 }
@@ -78,7 +83,8 @@ void EmbedderExternalViewEmbedder::PrerollCompositeEmbeddedView(
       pending_frame_size_,              // frame size
       pending_surface_transformation_,  // surface xformation
       view_id,                          // view identifier
-      std::move(params)                 // embedded view params
+      std::move(params),                // embedded view params
+      merge_overlay_layers_             // record contents bounds
   );
   composition_order_.push_back(view_id);
 }
@@ -120,6 +126,39 @@ SkCanvas* EmbedderExternalViewEmbedder::CompositeEmbeddedView(int view_id) {
   return found->second->GetCanvas();
 }
 
+void EmbedderExternalViewEmbedder::MergeOverlayLayers() {
+  TRACE_EVENT0("flutter", "EmbedderExternalViewEmbedder::MergeOverlayLayers");
+
+  // Flutter contents may be moved into the render target of a lower layer if
+  // they do not overlap any of the platform views in between, as nothing in
+  // between would be drawn on top of them. The root view is always the lowest
+  // layer.
+  EmbedderExternalView* target_view =
+      pending_views_.at(composition_order_.front()).get();
+  std::vector<SkRect> platform_view_rects;
+  for (const auto& view_id : composition_order_) {
+    const auto& external_view = pending_views_.at(view_id);
+    if (external_view.get() == target_view) {
+      continue;
+    }
+    platform_view_rects.push_back(
+        external_view->GetEmbeddedViewParams()->finalBoundingRect());
+    if (!external_view->HasEngineRenderedContents()) {
+      continue;
+    }
+    const auto bounds = external_view->GetEngineRenderedContentsBounds();
+    const bool overlaps_platform_view = std::any_of(
+        platform_view_rects.begin(), platform_view_rects.end(),
+        [&bounds](const SkRect& rect) { return rect.intersects(bounds); });
+    if (overlaps_platform_view) {
+      target_view = external_view.get();
+      platform_view_rects.clear();
+    } else {
+      target_view->TakeEngineRenderedContents(*external_view);
+    }
+  }
+}
+
 static FlutterBackingStoreConfig MakeBackingStoreConfig(
     const SkISize& backing_store_size) {
   FlutterBackingStoreConfig config = {};
@@ -137,6 +176,10 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
     GrDirectContext* context,
     std::unique_ptr<SurfaceFrame> frame,
     const std::shared_ptr<fml::SyncSwitch>& gpu_disable_sync_switch) {
+  if (merge_overlay_layers_) {
+    MergeOverlayLayers();
+  }
+
   auto [matched_render_targets, pending_keys] =
       render_target_cache_.GetExistingTargetsInCache(pending_views_);
 
@@ -151,9 +194,13 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
   // around this issue while that embedder migrates, collection of render
   // targets is deferred after the presentation.
   //
+  // Only the render targets that went unused for a few frames, or that exceed
+  // the budget of the cache, are collected, so that views that come and go do
+  // not churn through backing stores.
+  //
   // @warning: Embedder may trample on our OpenGL context here.
   auto deferred_cleanup_render_targets =
-      render_target_cache_.ClearAllRenderTargetsInCache();
+      render_target_cache_.CollectUnusedRenderTargets();
 
   for (const auto& pending_key : pending_keys) {
     const auto& external_view = pending_views_.at(pending_key);
@@ -168,11 +215,12 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
 
     // This is the size of render surface we want the embedder to create for
     // us. As or right now, this is going to always be equal to the frame size
-    // post transformation. But, in case optimizations are applied that make
-    // it so that embedder rendered into surfaces that aren't full screen,
-    // this assumption will break. So it's just best to ask view for its size
-    // directly.
-    const auto render_surface_size = external_view->GetRenderSurfaceSize();
+    // post transformation, rounded up to the granularity of the render target
+    // cache. But, in case optimizations are applied that make it so that
+    // embedder rendered into surfaces that aren't full screen, this assumption
+    // will break. So it's just best to ask view for its size directly.
+    const auto render_surface_size = render_target_cache_.GetRenderTargetSize(
+        external_view->GetRenderSurfaceSize());
 
     const auto backing_store_config =
         MakeBackingStoreConfig(render_surface_size);
@@ -262,14 +310,14 @@ void EmbedderExternalViewEmbedder::SubmitFrame(
   // @warning: Embedder may trample on our OpenGL context here.
   deferred_cleanup_render_targets.clear();
 
-  // Hold all rendered layers in the render target cache for one frame to
-  // see if they may be reused next frame.
+  // Hold all rendered layers in the render target cache to see if they may be
+  // reused by the next frames.
   for (auto& render_target : matched_render_targets) {
     if (!avoid_backing_store_cache_) {
-      render_target_cache_.CacheRenderTarget(render_target.first,
-                                             std::move(render_target.second));
+      render_target_cache_.CacheRenderTarget(std::move(render_target.second));
     }
   }
+  render_target_cache_.TraceStatsToTimeline();
 
   frame->Submit();
 }
@@ -44,7 +44,16 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   ///                                      will beinvoked every frame for every
   ///                                      engine composited layer. The result
   ///                                      will not cached.
-  ///
+  /// @param[in]  backing_store_size_granularity
+  ///                                     If non-zero, the number of pixels the
+  ///                                     sizes of render targets are rounded
+  ///                                     up to a multiple of, so that they can
+  ///                                     be reused as the frame size changes.
+  /// @param[in]  merge_overlay_layers    If set, Flutter contents that do not
+  ///                                     overlap the platform views below them
+  ///                                     are rendered into the render target
+  ///                                     of a lower layer, so that fewer
+  ///                                     layers are presented.
   /// @param[in]  create_render_target_callback
   ///                                     The render target callback used to
   ///                                     request the render target for a layer.
@@ -55,6 +64,8 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
   ///
   EmbedderExternalViewEmbedder(
       bool avoid_backing_store_cache,
+      size_t backing_store_size_granularity,
+      bool merge_overlay_layers,
       const CreateRenderTargetCallback& create_render_target_callback,
       const PresentCallback& present_callback);
 
@@ -107,6 +118,7 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
 
  private:
   const bool avoid_backing_store_cache_;
+  const bool merge_overlay_layers_;
   const CreateRenderTargetCallback create_render_target_callback_;
   const PresentCallback present_callback_;
   SurfaceTransformationCallback surface_transformation_callback_;
@@ -119,6 +131,8 @@ class EmbedderExternalViewEmbedder final : public ExternalViewEmbedder {
 
   void Reset();
 
+  void MergeOverlayLayers();
+
   SkMatrix GetSurfaceTransformation() const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderExternalViewEmbedder);
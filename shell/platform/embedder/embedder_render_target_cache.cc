@@ -4,16 +4,37 @@
 
 #include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
 
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+
 namespace flutter {
 
-EmbedderRenderTargetCache::EmbedderRenderTargetCache() = default;
+// Render targets are assumed to hold 32-bit pixels.
+static constexpr size_t kBytesPerPixel = 4;
+
+static constexpr double kMegaByteSizeInBytes = (1 << 20);
+
+EmbedderRenderTargetCache::EmbedderRenderTargetCache(size_t size_granularity,
+                                                     size_t max_unused_bytes)
+    : size_granularity_(size_granularity),
+      max_unused_bytes_(max_unused_bytes) {}
 
 EmbedderRenderTargetCache::~EmbedderRenderTargetCache() = default;
 
+std::size_t EmbedderRenderTargetCache::SizeHash::operator()(
+    const SkISize& size) const {
+  return fml::HashCombine(size.width(), size.height());
+}
+
 std::pair<EmbedderRenderTargetCache::RenderTargets,
           EmbedderExternalView::ViewIdentifierSet>
 EmbedderRenderTargetCache::GetExistingTargetsInCache(
     const EmbedderExternalView::PendingViews& pending_views) {
+  frame_number_++;
+  hits_this_frame_ = 0;
+  misses_this_frame_ = 0;
+  evicted_this_frame_ = 0;
+
   RenderTargets resolved_render_targets;
   EmbedderExternalView::ViewIdentifierSet unmatched_identifiers;
 
@@ -22,44 +43,90 @@ EmbedderRenderTargetCache::GetExistingTargetsInCache(
     if (!external_view->HasEngineRenderedContents()) {
       continue;
     }
-    auto& compatible_targets =
-        cached_render_targets_[external_view->CreateRenderTargetDescriptor()];
-    if (compatible_targets.size() == 0) {
+    auto found = cached_render_targets_.find(
+        GetRenderTargetSize(external_view->GetRenderSurfaceSize()));
+    if (found == cached_render_targets_.end() || found->second.empty()) {
       unmatched_identifiers.insert(view.first);
+      misses_this_frame_++;
     } else {
-      std::unique_ptr<EmbedderRenderTarget> target =
-          std::move(compatible_targets.top());
-      compatible_targets.pop();
-      resolved_render_targets[view.first] = std::move(target);
+      // Use the most recently used target, so that the others can age out.
+      auto& compatible_targets = found->second;
+      resolved_render_targets[view.first] =
+          std::move(compatible_targets.back().target);
+      compatible_targets.pop_back();
+      hits_this_frame_++;
     }
   }
   return {std::move(resolved_render_targets), std::move(unmatched_identifiers)};
 }
 
 std::set<std::unique_ptr<EmbedderRenderTarget>>
-EmbedderRenderTargetCache::ClearAllRenderTargetsInCache() {
-  std::set<std::unique_ptr<EmbedderRenderTarget>> cleared_targets;
-  for (auto& targets : cached_render_targets_) {
-    auto& targets_stack = targets.second;
-    while (!targets_stack.empty()) {
-      cleared_targets.emplace(std::move(targets_stack.top()));
-      targets_stack.pop();
+EmbedderRenderTargetCache::CollectUnusedRenderTargets() {
+  std::set<std::unique_ptr<EmbedderRenderTarget>> collected_targets;
+  size_t unused_bytes = 0;
+  for (auto it = cached_render_targets_.begin();
+       it != cached_render_targets_.end();) {
+    auto& targets = it->second;
+    size_t expired = 0;
+    while (expired < targets.size() &&
+           frame_number_ - targets[expired].last_used_frame >=
+               kMaxUnusedFrames) {
+      collected_targets.emplace(std::move(targets[expired].target));
+      expired++;
+    }
+    targets.erase(targets.begin(), targets.begin() + expired);
+    if (targets.empty()) {
+      it = cached_render_targets_.erase(it);
+    } else {
+      unused_bytes += targets.size() * EstimateByteSize(it->first);
+      ++it;
+    }
+  }
+
+  // Targets of each size are ordered from the least recently used one, so the
+  // least recently used target overall is at the front of one of the lists.
+  while (unused_bytes > max_unused_bytes_) {
+    auto oldest = cached_render_targets_.begin();
+    for (auto it = cached_render_targets_.begin();
+         it != cached_render_targets_.end(); ++it) {
+      if (it->second.front().last_used_frame <
+          oldest->second.front().last_used_frame) {
+        oldest = it;
+      }
+    }
+    collected_targets.emplace(std::move(oldest->second.front().target));
+    oldest->second.erase(oldest->second.begin());
+    unused_bytes -= EstimateByteSize(oldest->first);
+    if (oldest->second.empty()) {
+      cached_render_targets_.erase(oldest);
     }
   }
-  cached_render_targets_.clear();
-  return cleared_targets;
+
+  evicted_this_frame_ += collected_targets.size();
+  return collected_targets;
 }
 
 void EmbedderRenderTargetCache::CacheRenderTarget(
-    EmbedderExternalView::ViewIdentifier view_identifier,
     std::unique_ptr<EmbedderRenderTarget> target) {
   if (target == nullptr) {
     return;
   }
   auto surface = target->GetRenderSurface();
-  auto desc = EmbedderExternalView::RenderTargetDescriptor{
-      view_identifier, SkISize::Make(surface->width(), surface->height())};
-  cached_render_targets_[desc].push(std::move(target));
+  auto size = SkISize::Make(surface->width(), surface->height());
+  cached_render_targets_[size].push_back({std::move(target), frame_number_});
+}
+
+SkISize EmbedderRenderTargetCache::GetRenderTargetSize(
+    const SkISize& surface_size) const {
+  if (size_granularity_ == 0) {
+    return surface_size;
+  }
+  auto round_up = [granularity = static_cast<int32_t>(size_granularity_)](
+                      int32_t value) {
+    return (value + granularity - 1) / granularity * granularity;
+  };
+  return SkISize::Make(round_up(surface_size.width()),
+                       round_up(surface_size.height()));
 }
 
 size_t EmbedderRenderTargetCache::GetCachedTargetsCount() const {
@@ -70,4 +137,27 @@ size_t EmbedderRenderTargetCache::GetCachedTargetsCount() const {
   return count;
 }
 
+size_t EmbedderRenderTargetCache::GetCachedTargetsBytes() const {
+  size_t bytes = 0;
+  for (const auto& targets : cached_render_targets_) {
+    bytes += targets.second.size() * EstimateByteSize(targets.first);
+  }
+  return bytes;
+}
+
+void EmbedderRenderTargetCache::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter", "EmbedderRenderTargetCache",
+                    reinterpret_cast<int64_t>(this), "Hits", hits_this_frame_,
+                    "Misses", misses_this_frame_, "Evicted",
+                    evicted_this_frame_, "CachedCount", GetCachedTargetsCount(),
+                    "CachedMBytes",
+                    GetCachedTargetsBytes() / kMegaByteSizeInBytes);
+#endif  // !FLUTTER_RELEASE
+}
+
+size_t EmbedderRenderTargetCache::EstimateByteSize(const SkISize& size) {
+  return static_cast<size_t>(size.width()) * size.height() * kBytesPerPixel;
+}
+
 }  // namespace flutter
@@ -6,9 +6,9 @@
 #define FLUTTER_SHELL_PLATFORM_EMBEDDER_EMBEDDER_RENDER_TARGET_CACHE_H_
 
 #include <set>
-#include <stack>
 #include <tuple>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "flutter/shell/platform/embedder/embedder_external_view.h"
@@ -19,9 +19,37 @@ namespace flutter {
 /// @brief      A cache used to reference render targets that are owned by the
 ///             embedder but needed by th engine to render a frame.
 ///
+///             Render targets are pooled by size and may be used by any view
+///             of a later frame. Render targets that go unused are kept for
+///             a few frames, as long as they fit within a memory budget, so
+///             that views that come and go do not make the embedder create
+///             and collect backing stores every frame.
+///
+///             If the embedder allows it, render target sizes are rounded up
+///             to a granularity so that the render targets can be reused
+///             while the frame size changes, such as during a window resize.
+///
 class EmbedderRenderTargetCache {
  public:
-  EmbedderRenderTargetCache();
+  /// Unused render targets are collected after this many frames.
+  static constexpr size_t kMaxUnusedFrames = 3;
+
+  /// Unused render targets are collected, least recently used first, while
+  /// they hold more than this many bytes.
+  static constexpr size_t kDefaultMaxUnusedBytes = 64 * 1024 * 1024;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a render target cache.
+  ///
+  /// @param[in]  size_granularity  If non-zero, the number of pixels render
+  ///                               target sizes are rounded up to a multiple
+  ///                               of.
+  /// @param[in]  max_unused_bytes  The budget for render targets that were not
+  ///                               used by the last frame.
+  ///
+  explicit EmbedderRenderTargetCache(
+      size_t size_granularity = 0,
+      size_t max_unused_bytes = kDefaultMaxUnusedBytes);
 
   ~EmbedderRenderTargetCache();
 
@@ -31,26 +59,72 @@ class EmbedderRenderTargetCache {
                          EmbedderExternalView::ViewIdentifier::Hash,
                          EmbedderExternalView::ViewIdentifier::Equal>;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Takes the cached render targets for the pending views of a
+  ///             frame out of the cache.
+  ///
+  /// @return     The render targets found for views, and the views for which
+  ///             a render target of the size returned by `GetRenderTargetSize`
+  ///             must be created.
+  ///
   std::pair<RenderTargets, EmbedderExternalView::ViewIdentifierSet>
   GetExistingTargetsInCache(
       const EmbedderExternalView::PendingViews& pending_views);
 
-  std::set<std::unique_ptr<EmbedderRenderTarget>>
-  ClearAllRenderTargetsInCache();
-
-  void CacheRenderTarget(EmbedderExternalView::ViewIdentifier view_identifier,
-                         std::unique_ptr<EmbedderRenderTarget> target);
+  //----------------------------------------------------------------------------
+  /// @brief      Ends a frame and takes the render targets that went unused for
+  ///             too long, or that do not fit within the budget, out of the
+  ///             cache.
+  ///
+  /// @return     The render targets to collect.
+  ///
+  std::set<std::unique_ptr<EmbedderRenderTarget>> CollectUnusedRenderTargets();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns a render target used by the current frame to the
+  ///             cache.
+  ///
+  void CacheRenderTarget(std::unique_ptr<EmbedderRenderTarget> target);
+
+  //----------------------------------------------------------------------------
+  /// @brief      The size of the render target to create for a view whose
+  ///             render surface has the given size.
+  ///
+  SkISize GetRenderTargetSize(const SkISize& surface_size) const;
 
   size_t GetCachedTargetsCount() const;
 
+  size_t GetCachedTargetsBytes() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the cache statistics of the current frame to the
+  ///             timeline.
+  ///
+  void TraceStatsToTimeline() const;
+
  private:
+  struct CachedRenderTarget {
+    std::unique_ptr<EmbedderRenderTarget> target;
+    size_t last_used_frame;
+  };
+
+  struct SizeHash {
+    std::size_t operator()(const SkISize& size) const;
+  };
+
+  // The render targets of each size, least recently used first.
   using CachedRenderTargets =
-      std::unordered_map<EmbedderExternalView::RenderTargetDescriptor,
-                         std::stack<std::unique_ptr<EmbedderRenderTarget>>,
-                         EmbedderExternalView::RenderTargetDescriptor::Hash,
-                         EmbedderExternalView::RenderTargetDescriptor::Equal>;
+      std::unordered_map<SkISize, std::vector<CachedRenderTarget>, SizeHash>;
 
+  const size_t size_granularity_;
+  const size_t max_unused_bytes_;
   CachedRenderTargets cached_render_targets_;
+  size_t frame_number_ = 0;
+  size_t hits_this_frame_ = 0;
+  size_t misses_this_frame_ = 0;
+  size_t evicted_this_frame_ = 0;
+
+  static size_t EstimateByteSize(const SkISize& size);
 
   FML_DISALLOW_COPY_AND_ASSIGN(EmbedderRenderTargetCache);
 };
@@ -46,7 +46,15 @@ bool EmbedderSurfaceGL::GLContextClearCurrent() {
 
 // |GPUSurfaceGLDelegate|
 bool EmbedderSurfaceGL::GLContextPresent(uint32_t fbo_id) {
-  return gl_dispatch_table_.gl_present_callback(fbo_id);
+  GLPresentInfo present_info;
+  present_info.fbo_id = fbo_id;
+  return gl_dispatch_table_.gl_present_callback(present_info);
+}
+
+// |GPUSurfaceGLDelegate|
+bool EmbedderSurfaceGL::GLContextPresentWithInfo(
+    const GLPresentInfo& present_info) {
+  return gl_dispatch_table_.gl_present_callback(present_info);
 }
 
 // |GPUSurfaceGLDelegate|
@@ -54,6 +62,16 @@ intptr_t EmbedderSurfaceGL::GLContextFBO(GLFrameInfo frame_info) const {
   return gl_dispatch_table_.gl_fbo_callback(frame_info);
 }
 
+// |GPUSurfaceGLDelegate|
+std::optional<SkIRect> EmbedderSurfaceGL::GLContextFBOExistingDamage(
+    uint32_t fbo_id) const {
+  auto callback = gl_dispatch_table_.gl_populate_existing_damage;
+  if (!callback) {
+    return std::nullopt;
+  }
+  return callback(fbo_id);
+}
+
 // |GPUSurfaceGLDelegate|
 bool EmbedderSurfaceGL::GLContextFBOResetAfterPresent() const {
   return fbo_reset_after_present_;
@@ -386,6 +386,48 @@ void can_composite_platform_views_with_known_scene() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void can_composite_platform_views_with_non_overlapping_layers() {
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    // Opaque, so that the expected image does not depend on blending.
+    Color red = Color.fromARGB(255, 255, 0, 0);
+    Color blue = Color.fromARGB(255, 0, 0, 255);
+    Color gray = Color.fromARGB(255, 127, 127, 127);
+
+    Size size = Size(50.0, 150.0);
+
+    SceneBuilder builder = SceneBuilder();
+    builder.pushOffset(0.0, 0.0);
+
+    // 10 (Index 0)
+    builder.addPicture(Offset(10.0, 10.0), CreateColoredBox(red, size)); // red - flutter
+
+    builder.pushOffset(20.0, 20.0);
+      // 20 (Index 1)
+      builder.addPlatformView(1, width: size.width, height:size.height); // green - platform
+    builder.pop();
+
+    // 30 (Index 2), next to the platform view below.
+    builder.addPicture(Offset(200.0, 10.0), CreateColoredBox(blue, size)); // blue - flutter
+
+    builder.pushOffset(220.0, 20.0);
+      // 40 (Index 3)
+      builder.addPlatformView(2, width: size.width, height:size.height); // magenta - platform
+    builder.pop();
+
+    // 50  (Index 4), on top of the platform view below.
+    builder.addPicture(Offset(230.0, 30.0), CreateColoredBox(gray, size)); // gray - flutter
+
+    builder.pop();
+
+    PlatformDispatcher.instance.views.first.render(builder.build());
+
+    signalNativeTest(); // Signal 2
+  };
+  signalNativeTest(); // Signal 1
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void can_composite_platform_views_with_root_layer_only() {
   PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
@@ -554,6 +596,27 @@ void render_gradient() {
   PlatformDispatcher.instance.scheduleFrame();
 }
 
+@pragma('vm:entry-point')
+void render_gradient_retained() {
+  // Every frame shows the same picture in a retained layer, so all frames but
+  // the first one are identical to the previous frame.
+  Picture gradient = CreateGradientBox(Size(800.0, 600.0));
+  OffsetEngineLayer? offsetLayer;
+  PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
+    SceneBuilder builder = SceneBuilder();
+
+    offsetLayer = builder.pushOffset(0.0, 0.0, oldLayer: offsetLayer);
+
+    builder.addPicture(Offset(0.0, 0.0), gradient); // gradient - flutter
+
+    builder.pop();
+
+    PlatformDispatcher.instance.views.first.render(builder.build());
+    PlatformDispatcher.instance.scheduleFrame();
+  };
+  PlatformDispatcher.instance.scheduleFrame();
+}
+
 @pragma('vm:entry-point')
 void render_texture() {
   PlatformDispatcher.instance.onBeginFrame = (Duration duration) {
@@ -62,6 +62,11 @@ class EmbedderConfigBuilder {
   // test this behavior.
   void SetOpenGLPresentCallBack();
 
+  // Sets `open_gl.populate_existing_damage`, which enables partial repaint.
+  // The existing damage is reported by the callback set through
+  // `EmbedderTestContextGL::SetGLPopulateExistingDamageCallback`.
+  void SetOpenGLPopulateExistingDamageCallBack();
+
   void SetAssetsPath();
 
   void SetSnapshots();
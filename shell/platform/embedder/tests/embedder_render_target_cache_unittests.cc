@@ -0,0 +1,142 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/embedder/embedder_render_target_cache.h"
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+// Creates a render target that counts its collections in |collected|.
+std::unique_ptr<EmbedderRenderTarget> CreateRenderTarget(const SkISize& size,
+                                                         size_t* collected) {
+  FlutterBackingStore backing_store = {};
+  backing_store.struct_size = sizeof(backing_store);
+  return std::make_unique<EmbedderRenderTarget>(
+      backing_store,
+      SkSurface::MakeRasterN32Premul(size.width(), size.height()),
+      [collected]() { (*collected)++; });
+}
+
+// Creates the pending views of a frame with |platform_view_count| platform
+// views, each with Flutter contents on top.
+EmbedderExternalView::PendingViews CreatePendingViews(
+    const SkISize& frame_size,
+    int platform_view_count) {
+  EmbedderExternalView::PendingViews views;
+  views[EmbedderExternalView::ViewIdentifier{}] =
+      std::make_unique<EmbedderExternalView>(frame_size, SkMatrix{});
+  for (int i = 0; i < platform_view_count; i++) {
+    views[EmbedderExternalView::ViewIdentifier{i}] =
+        std::make_unique<EmbedderExternalView>(
+            frame_size, SkMatrix{}, EmbedderExternalView::ViewIdentifier{i},
+            std::make_unique<EmbeddedViewParams>(),
+            /*record_contents_bounds=*/false);
+  }
+  for (const auto& view : views) {
+    view.second->GetCanvas()->drawColor(SK_ColorRED);
+  }
+  return views;
+}
+
+// Renders a frame as EmbedderExternalViewEmbedder::SubmitFrame does.
+//
+// Returns the number of render targets that had to be created.
+size_t RenderFrame(EmbedderRenderTargetCache& cache,
+                   const EmbedderExternalView::PendingViews& views,
+                   size_t* collected) {
+  auto [render_targets, unmatched] = cache.GetExistingTargetsInCache(views);
+  auto unused_render_targets = cache.CollectUnusedRenderTargets();
+  for (const auto& view_id : unmatched) {
+    render_targets[view_id] = CreateRenderTarget(
+        cache.GetRenderTargetSize(views.at(view_id)->GetRenderSurfaceSize()),
+        collected);
+  }
+  unused_render_targets.clear();
+  for (auto& render_target : render_targets) {
+    cache.CacheRenderTarget(std::move(render_target.second));
+  }
+  return unmatched.size();
+}
+
+}  // namespace
+
+TEST(EmbedderRenderTargetCacheTest, ReusesRenderTargetsAcrossViews) {
+  EmbedderRenderTargetCache cache;
+  size_t collected = 0;
+  const SkISize frame_size = SkISize::Make(800, 600);
+
+  EXPECT_EQ(RenderFrame(cache, CreatePendingViews(frame_size, 2), &collected),
+            3u);
+  EXPECT_EQ(cache.GetCachedTargetsCount(), 3u);
+
+  // Platform views that come and go do not need new render targets.
+  EXPECT_EQ(RenderFrame(cache, CreatePendingViews(frame_size, 0), &collected),
+            0u);
+  EXPECT_EQ(RenderFrame(cache, CreatePendingViews(frame_size, 1), &collected),
+            0u);
+  EXPECT_EQ(RenderFrame(cache, CreatePendingViews(frame_size, 2), &collected),
+            0u);
+  EXPECT_EQ(collected, 0u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, CollectsRenderTargetsUnusedForFrames) {
+  EmbedderRenderTargetCache cache;
+  size_t collected = 0;
+  const SkISize frame_size = SkISize::Make(800, 600);
+
+  RenderFrame(cache, CreatePendingViews(frame_size, 2), &collected);
+  for (size_t i = 1; i < EmbedderRenderTargetCache::kMaxUnusedFrames; i++) {
+    RenderFrame(cache, CreatePendingViews(frame_size, 0), &collected);
+    EXPECT_EQ(collected, 0u);
+  }
+
+  RenderFrame(cache, CreatePendingViews(frame_size, 0), &collected);
+  EXPECT_EQ(collected, 2u);
+  EXPECT_EQ(cache.GetCachedTargetsCount(), 1u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, CollectsRenderTargetsOverBudget) {
+  const SkISize frame_size = SkISize::Make(100, 100);
+  // Leaves room for one unused render target.
+  EmbedderRenderTargetCache cache(0, 100 * 100 * 4);
+  size_t collected = 0;
+
+  RenderFrame(cache, CreatePendingViews(frame_size, 3), &collected);
+  RenderFrame(cache, CreatePendingViews(frame_size, 0), &collected);
+  EXPECT_EQ(collected, 2u);
+  EXPECT_EQ(cache.GetCachedTargetsCount(), 2u);
+}
+
+TEST(EmbedderRenderTargetCacheTest, RoundsRenderTargetSizesToGranularity) {
+  EmbedderRenderTargetCache cache(64);
+  size_t collected = 0;
+
+  EXPECT_EQ(cache.GetRenderTargetSize(SkISize::Make(800, 600)),
+            SkISize::Make(832, 640));
+  EXPECT_EQ(cache.GetRenderTargetSize(SkISize::Make(832, 640)),
+            SkISize::Make(832, 640));
+
+  // Resizing within the granularity keeps the render target.
+  EXPECT_EQ(
+      RenderFrame(cache, CreatePendingViews(SkISize::Make(800, 600), 0),
+                  &collected),
+      1u);
+  EXPECT_EQ(
+      RenderFrame(cache, CreatePendingViews(SkISize::Make(810, 620), 0),
+                  &collected),
+      0u);
+  EXPECT_EQ(
+      RenderFrame(cache, CreatePendingViews(SkISize::Make(900, 620), 0),
+                  &collected),
+      1u);
+}
+
+}  // namespace testing
+}  // namespace flutter
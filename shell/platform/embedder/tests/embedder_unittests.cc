@@ -4,6 +4,7 @@
 
 #define FML_USED_ON_EMBEDDER
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -387,6 +388,122 @@ TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutResponseHandles) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that the engine adopts the buffer of a platform message sent with a
+/// release callback and releases it exactly once when it is done with it.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentWithoutCopying) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  // Large enough to be handed to Dart as external typed data.
+  const std::string message_data(4096, 'a');
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&message, &message_data](Dart_NativeArguments args) {
+            auto received_message = tonic::DartConverter<std::string>::FromDart(
+                Dart_GetNativeArgument(args, 0));
+            ASSERT_EQ(received_message, message_data);
+            message.Signal();
+          })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  struct Captures {
+    std::vector<uint8_t> buffer;
+    std::atomic<size_t> release_count{0};
+  };
+  Captures captures;
+  captures.buffer.assign(message_data.begin(), message_data.end());
+
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message = captures.buffer.data();
+  platform_message.message_size = captures.buffer.size();
+  platform_message.response_handle = nullptr;
+  platform_message.message_release_callback = [](const uint8_t* data,
+                                                 size_t size, void* user_data) {
+    auto captures = reinterpret_cast<Captures*>(user_data);
+    ASSERT_EQ(data, captures->buffer.data());
+    ASSERT_EQ(size, captures->buffer.size());
+    captures->release_count++;
+  };
+  platform_message.message_release_user_data = &captures;
+
+  auto result =
+      FlutterEngineSendPlatformMessage(engine.get(), &platform_message);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+
+  // The buffer is released once the isolate no longer references it, at the
+  // latest when the engine shuts down.
+  engine.reset();
+  ASSERT_EQ(captures.release_count, 1u);
+}
+
+//------------------------------------------------------------------------------
+/// Tests that a batch of platform messages is delivered in order.
+///
+TEST_F(EmbedderTest, PlatformMessagesCanBeSentInBatches) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("platform_messages_no_response");
+
+  const std::vector<std::string> message_data = {"one", "two", "three"};
+
+  fml::AutoResetWaitableEvent ready;
+  fml::CountDownLatch messages_received(message_data.size());
+  std::vector<std::string> received_messages;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(
+          ([&messages_received, &received_messages](Dart_NativeArguments args) {
+            received_messages.push_back(
+                tonic::DartConverter<std::string>::FromDart(
+                    Dart_GetNativeArgument(args, 0)));
+            messages_received.CountDown();
+          })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  std::vector<FlutterPlatformMessage> platform_messages;
+  for (const auto& data : message_data) {
+    FlutterPlatformMessage platform_message = {};
+    platform_message.struct_size = sizeof(FlutterPlatformMessage);
+    platform_message.channel = "test_channel";
+    platform_message.message = reinterpret_cast<const uint8_t*>(data.data());
+    platform_message.message_size = data.size();
+    platform_messages.push_back(platform_message);
+  }
+
+  auto result = FlutterEngineSendPlatformMessages(
+      engine.get(), platform_messages.data(), platform_messages.size());
+  ASSERT_EQ(result, kSuccess);
+  messages_received.Wait();
+  ASSERT_EQ(received_messages, message_data);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message can be sent.
 ///
@@ -428,6 +545,56 @@ TEST_F(EmbedderTest, NullPlatformMessagesCanBeSent) {
   message.Wait();
 }
 
+//------------------------------------------------------------------------------
+/// Tests that an empty platform message sent with a release callback is
+/// received as null, and that its buffer is released.
+///
+TEST_F(EmbedderTest, EmptyPlatformMessagesSentWithoutCopyingAreNull) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+  builder.SetDartEntrypoint("null_platform_messages");
+
+  fml::AutoResetWaitableEvent ready, message;
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&ready](Dart_NativeArguments args) { ready.Signal(); }));
+  context.AddNativeCallback(
+      "SignalNativeMessage",
+      CREATE_NATIVE_ENTRY(([&message](Dart_NativeArguments args) {
+        auto received_message = tonic::DartConverter<std::string>::FromDart(
+            Dart_GetNativeArgument(args, 0));
+        ASSERT_EQ("true", received_message);
+        message.Signal();
+      })));
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+  ready.Wait();
+
+  std::atomic<size_t> release_count{0};
+  FlutterPlatformMessage platform_message = {};
+  platform_message.struct_size = sizeof(FlutterPlatformMessage);
+  platform_message.channel = "test_channel";
+  platform_message.message = nullptr;
+  platform_message.message_size = 0;
+  platform_message.response_handle = nullptr;
+  platform_message.message_release_callback = [](const uint8_t* data,
+                                                 size_t size, void* user_data) {
+    ASSERT_EQ(size, 0u);
+    (*reinterpret_cast<std::atomic<size_t>*>(user_data))++;
+  };
+  platform_message.message_release_user_data = &release_count;
+
+  auto result =
+      FlutterEngineSendPlatformMessage(engine.get(), &platform_message);
+  ASSERT_EQ(result, kSuccess);
+  message.Wait();
+  ASSERT_EQ(release_count, 1u);
+}
+
 //------------------------------------------------------------------------------
 /// Tests that a null platform message cannot be send if the message_size
 /// isn't equals to 0.
@@ -697,6 +864,153 @@ TEST_F(EmbedderTest,
   ASSERT_EQ(context.GetSurfacePresentCount(), 0u);
 }
 
+//------------------------------------------------------------------------------
+/// Test that Flutter contents that do not overlap the platform views below
+/// them are merged into a lower layer when the compositor asks for it.
+///
+TEST_F(EmbedderTest,
+       CompositorMustBeAbleToMergeNonOverlappingLayersWithSoftwareCompositor) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig(SkISize::Make(800, 600));
+  builder.SetCompositor();
+  builder.GetCompositor().merge_overlay_layers = true;
+  builder.SetDartEntrypoint(
+      "can_composite_platform_views_with_non_overlapping_layers");
+
+  builder.SetRenderTargetType(
+      EmbedderTestBackingStoreProducer::RenderTargetType::kSoftwareBuffer);
+
+  fml::CountDownLatch latch(5);
+
+  auto scene_image = context.GetNextSceneImage();
+
+  context.GetCompositor().SetNextPresentCallback(
+      [&](const FlutterLayer** layers, size_t layers_count) {
+        // The blue box is merged into the root layer.
+        ASSERT_EQ(layers_count, 4u);
+
+        // Layer Root
+        {
+          FlutterBackingStore backing_store = *layers[0]->backing_store;
+          backing_store.type = kFlutterBackingStoreTypeSoftware;
+          backing_store.did_update = true;
+          backing_store.software.height = 600;
+
+          FlutterLayer layer = {};
+          layer.struct_size = sizeof(layer);
+          layer.type = kFlutterLayerContentTypeBackingStore;
+          layer.backing_store = &backing_store;
+          layer.size = FlutterSizeMake(800.0, 600.0);
+          layer.offset = FlutterPointMake(0.0, 0.0);
+
+          ASSERT_EQ(*layers[0], layer);
+        }
+
+        // Layer 1
+        {
+          FlutterPlatformView platform_view = *layers[1]->platform_view;
+          platform_view.struct_size = sizeof(platform_view);
+          platform_view.identifier = 1;
+
+          FlutterLayer layer = {};
+          layer.struct_size = sizeof(layer);
+          layer.type = kFlutterLayerContentTypePlatformView;
+          layer.platform_view = &platform_view;
+          layer.size = FlutterSizeMake(50.0, 150.0);
+          layer.offset = FlutterPointMake(20.0, 20.0);
+
+          ASSERT_EQ(*layers[1], layer);
+        }
+
+        // Layer 2
+        {
+          FlutterPlatformView platform_view = *layers[2]->platform_view;
+          platform_view.struct_size = sizeof(platform_view);
+          platform_view.identifier = 2;
+
+          FlutterLayer layer = {};
+          layer.struct_size = sizeof(layer);
+          layer.type = kFlutterLayerContentTypePlatformView;
+          layer.platform_view = &platform_view;
+          layer.size = FlutterSizeMake(50.0, 150.0);
+          layer.offset = FlutterPointMake(220.0, 20.0);
+
+          ASSERT_EQ(*layers[2], layer);
+        }
+
+        // Layer 3
+        {
+          FlutterBackingStore backing_store = *layers[3]->backing_store;
+          backing_store.type = kFlutterBackingStoreTypeSoftware;
+          backing_store.did_update = true;
+          backing_store.software.height = 600;
+
+          FlutterLayer layer = {};
+          layer.struct_size = sizeof(layer);
+          layer.type = kFlutterLayerContentTypeBackingStore;
+          layer.backing_store = &backing_store;
+          layer.size = FlutterSizeMake(800.0, 600.0);
+          layer.offset = FlutterPointMake(0.0, 0.0);
+
+          ASSERT_EQ(*layers[3], layer);
+        }
+
+        latch.CountDown();
+      });
+
+  context.GetCompositor().SetPlatformViewRendererCallback(
+      [&](const FlutterLayer& layer, GrDirectContext*
+          /* don't use because software compositor */) -> sk_sp<SkImage> {
+        auto surface = CreateRenderSurface(
+            layer, nullptr /* null because software compositor */);
+        auto canvas = surface->getCanvas();
+        FML_CHECK(canvas != nullptr);
+
+        SkPaint paint;
+        switch (layer.platform_view->identifier) {
+          case 1:
+            paint.setColor(SK_ColorGREEN);
+            break;
+          case 2:
+            paint.setColor(SK_ColorMAGENTA);
+            break;
+          default:
+            // Asked to render an unknown platform view.
+            FML_CHECK(false)
+                << "Test was asked to composite an unknown platform view.";
+        }
+        canvas->drawRect(SkRect::MakeWH(layer.size.width, layer.size.height),
+                         paint);
+        latch.CountDown();
+        return surface->makeImageSnapshot();
+      });
+
+  context.AddNativeCallback(
+      "SignalNativeTest",
+      CREATE_NATIVE_ENTRY(
+          [&latch](Dart_NativeArguments args) { latch.CountDown(); }));
+
+  auto engine = builder.LaunchEngine();
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+  ASSERT_TRUE(engine.is_valid());
+
+  latch.Wait();
+
+  // Merging the layers must not change what is rendered.
+  ASSERT_TRUE(ImageMatchesFixture("compositor_software_merged_layers.png",
+                                  scene_image));
+}
+
 //------------------------------------------------------------------------------
 /// Test that an engine can be initialized but not run.
 ///
@@ -979,6 +1293,33 @@ TEST_F(EmbedderTest, CanSendLowMemoryNotification) {
   ASSERT_EQ(FlutterEngineNotifyLowMemoryWarning(engine.get()), kSuccess);
 }
 
+TEST_F(EmbedderTest, CanSetFrameLatencyMode) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kSoftwareContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetSoftwareRendererConfig();
+
+  auto engine = builder.LaunchEngine();
+
+  ASSERT_TRUE(engine.is_valid());
+
+  ASSERT_EQ(FlutterEngineSetFrameLatencyMode(
+                engine.get(), kFlutterEngineFrameLatencyModeLowLatency),
+            kSuccess);
+  ASSERT_EQ(FlutterEngineSetFrameLatencyMode(
+                engine.get(), kFlutterEngineFrameLatencyModeThroughput),
+            kSuccess);
+  ASSERT_EQ(FlutterEngineSetFrameLatencyMode(
+                engine.get(), kFlutterEngineFrameLatencyModeDefault),
+            kSuccess);
+  ASSERT_EQ(FlutterEngineSetFrameLatencyMode(
+                engine.get(), static_cast<FlutterEngineFrameLatencyMode>(42)),
+            kInvalidArguments);
+  ASSERT_EQ(FlutterEngineSetFrameLatencyMode(
+                nullptr, kFlutterEngineFrameLatencyModeLowLatency),
+            kInvalidArguments);
+}
+
 TEST_F(EmbedderTest, CanPostTaskToAllNativeThreads) {
   UniqueEngine engine;
   size_t worker_count = 0;
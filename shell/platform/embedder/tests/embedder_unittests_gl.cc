@@ -3118,8 +3118,9 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   const uint32_t window_fbo_id =
       static_cast<EmbedderTestContextGL&>(context).GetWindowFBOId();
   static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
-      [window_fbo_id = window_fbo_id, &frame_latch](uint32_t fbo_id) {
-        ASSERT_EQ(fbo_id, window_fbo_id);
+      [window_fbo_id = window_fbo_id,
+       &frame_latch](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.fbo_id, window_fbo_id);
 
         frame_latch.CountDown();
       });
@@ -3127,6 +3128,176 @@ TEST_F(EmbedderTest, PresentInfoContainsValidFBOId) {
   frame_latch.Wait();
 }
 
+TEST_F(EmbedderTest, PopulateExistingDamageReceivesValidFBOId) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  builder.SetOpenGLPopulateExistingDamageCallBack();
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  fml::CountDownLatch frame_latch(3);
+  const uint32_t window_fbo_id =
+      static_cast<EmbedderTestContextGL&>(context).GetWindowFBOId();
+  static_cast<EmbedderTestContextGL&>(context)
+      .SetGLPopulateExistingDamageCallback(
+          [window_fbo_id = window_fbo_id, &frame_latch](
+              intptr_t fbo_id, FlutterDamage* existing_damage) {
+            ASSERT_EQ(fbo_id, static_cast<intptr_t>(window_fbo_id));
+            ASSERT_EQ(existing_damage->struct_size, sizeof(FlutterDamage));
+            existing_damage->num_rects = 0;
+            frame_latch.CountDown();
+          });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+}
+
+TEST_F(EmbedderTest, PresentInfoReceivesNoDamageWithoutPartialRepaint) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  fml::CountDownLatch frame_latch(3);
+  static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
+      [&frame_latch](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.frame_damage.struct_size,
+                  sizeof(FlutterDamage));
+        ASSERT_EQ(present_info.frame_damage.num_rects, 0u);
+        ASSERT_EQ(present_info.buffer_damage.struct_size,
+                  sizeof(FlutterDamage));
+        ASSERT_EQ(present_info.buffer_damage.num_rects, 0u);
+        frame_latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+}
+
+TEST_F(EmbedderTest, PresentInfoReceivesEmptyDamageForUnchangedFrames) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  builder.SetOpenGLPopulateExistingDamageCallBack();
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  // The fbo always holds the previously presented frame.
+  static_cast<EmbedderTestContextGL&>(context)
+      .SetGLPopulateExistingDamageCallback(
+          [](intptr_t fbo_id, FlutterDamage* existing_damage) {
+            existing_damage->num_rects = 0;
+          });
+
+  fml::CountDownLatch frame_latch(3);
+  size_t present_count = 0;
+  static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
+      [&frame_latch, &present_count](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+        ASSERT_EQ(present_info.buffer_damage.num_rects, 1u);
+        if (present_count++ == 0) {
+          // There is no previous frame to diff the first frame against.
+          const FlutterRect full = FlutterRectMakeLTRB(0, 0, 800, 600);
+          ASSERT_EQ(present_info.frame_damage.damage[0], full);
+          ASSERT_EQ(present_info.buffer_damage.damage[0], full);
+        } else {
+          ASSERT_TRUE(
+              SkRectMake(present_info.frame_damage.damage[0]).isEmpty());
+          ASSERT_TRUE(
+              SkRectMake(present_info.buffer_damage.damage[0]).isEmpty());
+        }
+        frame_latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+}
+
+TEST_F(EmbedderTest,
+       PresentInfoReceivesFullBufferDamageWhenExistingDamageIsWholeScreen) {
+  auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
+
+  EmbedderConfigBuilder builder(context);
+  builder.SetOpenGLRendererConfig(SkISize::Make(800, 600));
+  builder.SetOpenGLPopulateExistingDamageCallBack();
+  builder.SetDartEntrypoint("render_gradient_retained");
+
+  // The content of the fbo is unknown, e.g. because it was just allocated.
+  static FlutterRect existing_damage_rect = FlutterRectMakeLTRB(0, 0, 800, 600);
+  static_cast<EmbedderTestContextGL&>(context)
+      .SetGLPopulateExistingDamageCallback(
+          [](intptr_t fbo_id, FlutterDamage* existing_damage) {
+            existing_damage->num_rects = 1;
+            existing_damage->damage = &existing_damage_rect;
+          });
+
+  fml::CountDownLatch frame_latch(3);
+  size_t present_count = 0;
+  static_cast<EmbedderTestContextGL&>(context).SetGLPresentCallback(
+      [&frame_latch, &present_count](const FlutterPresentInfo& present_info) {
+        ASSERT_EQ(present_info.frame_damage.num_rects, 1u);
+        ASSERT_EQ(present_info.buffer_damage.num_rects, 1u);
+        // The whole fbo is repainted, but only the first frame changed.
+        ASSERT_EQ(present_info.buffer_damage.damage[0], existing_damage_rect);
+        if (present_count++ == 0) {
+          ASSERT_EQ(present_info.frame_damage.damage[0], existing_damage_rect);
+        } else {
+          ASSERT_TRUE(
+              SkRectMake(present_info.frame_damage.damage[0]).isEmpty());
+        }
+        frame_latch.CountDown();
+      });
+
+  auto engine = builder.LaunchEngine();
+  ASSERT_TRUE(engine.is_valid());
+
+  // Send a window metrics events so frames may be scheduled.
+  FlutterWindowMetricsEvent event = {};
+  event.struct_size = sizeof(event);
+  event.width = 800;
+  event.height = 600;
+  event.pixel_ratio = 1.0;
+  ASSERT_EQ(FlutterEngineSendWindowMetricsEvent(engine.get(), &event),
+            kSuccess);
+
+  frame_latch.Wait();
+}
+
 TEST_F(EmbedderTest, SetSingleDisplayConfigurationWithDisplayId) {
   auto& context = GetEmbedderContext(EmbedderTestContextType::kOpenGLContext);
 
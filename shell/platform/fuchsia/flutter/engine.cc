@@ -9,6 +9,7 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 #include "flutter/common/task_runners.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/synchronization/waitable_event.h"
 #include "flutter/fml/task_runner.h"
@@ -57,6 +58,25 @@ fml::RefPtr<flutter::PlatformMessage> MakeLocalizationPlatformMessage(
       nullptr);
 }
 
+// Posts tasks to the low priority lane of the concurrent workers, so that
+// speculative work like shader warm-up never delays work a frame waits on.
+class LowPriorityTaskRunner final : public fml::BasicTaskRunner {
+ public:
+  explicit LowPriorityTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner)
+      : task_runner_(std::move(task_runner)) {}
+
+  void PostTask(const fml::closure& task) override {
+    task_runner_->PostTaskWithPriority(task,
+                                       fml::ConcurrentTaskPriority::kLow);
+  }
+
+ private:
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LowPriorityTaskRunner);
+};
+
 }  // namespace
 
 Engine::Engine(Delegate& delegate,
@@ -285,10 +305,9 @@ Engine::Engine(Delegate& delegate,
 
       if (product_config.enable_shader_warmup()) {
         FML_DCHECK(surface_producer_);
-        WarmupSkps(shell.GetDartVM()
-                       ->GetConcurrentMessageLoop()
-                       ->GetTaskRunner()
-                       .get(),
+        LowPriorityTaskRunner warmup_task_runner(
+            shell.GetDartVM()->GetConcurrentWorkerTaskRunner());
+        WarmupSkps(&warmup_task_runner,
                    shell.GetTaskRunners().GetRasterTaskRunner().get(),
                    surface_producer_.value());
       }
@@ -302,10 +321,9 @@ Engine::Engine(Delegate& delegate,
     } else {
       if (product_config.enable_shader_warmup()) {
         FML_DCHECK(surface_producer_);
-        WarmupSkps(shell.GetDartVM()
-                       ->GetConcurrentMessageLoop()
-                       ->GetTaskRunner()
-                       .get(),
+        LowPriorityTaskRunner warmup_task_runner(
+            shell.GetDartVM()->GetConcurrentWorkerTaskRunner());
+        WarmupSkps(&warmup_task_runner,
                    shell.GetTaskRunners().GetRasterTaskRunner().get(),
                    surface_producer_.value());
       }
@@ -316,10 +334,11 @@ Engine::Engine(Delegate& delegate,
   on_create_rasterizer = [this, &product_config](flutter::Shell& shell) {
     if (product_config.enable_shader_warmup()) {
       FML_DCHECK(surface_producer_);
-      WarmupSkps(
-          shell.GetDartVM()->GetConcurrentMessageLoop()->GetTaskRunner().get(),
-          shell.GetTaskRunners().GetRasterTaskRunner().get(),
-          surface_producer_.value());
+      LowPriorityTaskRunner warmup_task_runner(
+          shell.GetDartVM()->GetConcurrentWorkerTaskRunner());
+      WarmupSkps(&warmup_task_runner,
+                 shell.GetTaskRunners().GetRasterTaskRunner().get(),
+                 surface_producer_.value());
     }
     return std::make_unique<flutter::Rasterizer>(shell);
   };
@@ -78,6 +78,13 @@ class MockPlatformViewDelegate : public flutter::PlatformView::Delegate {
     message_ = std::move(message);
   }
   // |flutter::PlatformView::Delegate|
+  void OnPlatformViewDispatchPlatformMessages(
+      std::vector<fml::RefPtr<flutter::PlatformMessage>> messages) {
+    if (!messages.empty()) {
+      message_ = std::move(messages.back());
+    }
+  }
+  // |flutter::PlatformView::Delegate|
   void OnPlatformViewDispatchPointerDataPacket(
       std::unique_ptr<flutter::PointerDataPacket> packet) {}
   // |flutter::PlatformView::Delegate|
@@ -752,8 +759,9 @@ TEST_F(PlatformViewTests, ViewEventsTest) {
   session_listener->OnScenicEvent(std::move(events));
   RunLoopUntilIdle();
 
-  auto data = delegate.message()->data();
-  auto call = std::string(data.begin(), data.end());
+  const fml::Mapping* data = &delegate.message()->data();
+  auto call = std::string(reinterpret_cast<const char*>(data->GetMapping()),
+                          data->GetSize());
   std::string expected = "{\"method\":\"View.viewConnected\",\"args\":null}";
   EXPECT_EQ(expected, call);
 
@@ -767,8 +775,9 @@ TEST_F(PlatformViewTests, ViewEventsTest) {
   session_listener->OnScenicEvent(std::move(events));
   RunLoopUntilIdle();
 
-  data = delegate.message()->data();
-  call = std::string(data.begin(), data.end());
+  data = &delegate.message()->data();
+  call = std::string(reinterpret_cast<const char*>(data->GetMapping()),
+                     data->GetSize());
   expected = "{\"method\":\"View.viewDisconnected\",\"args\":null}";
   EXPECT_EQ(expected, call);
 
@@ -786,8 +795,9 @@ TEST_F(PlatformViewTests, ViewEventsTest) {
   session_listener->OnScenicEvent(std::move(events));
   RunLoopUntilIdle();
 
-  data = delegate.message()->data();
-  call = std::string(data.begin(), data.end());
+  data = &delegate.message()->data();
+  call = std::string(reinterpret_cast<const char*>(data->GetMapping()),
+                     data->GetSize());
   expected = "{\"method\":\"View.viewStateChanged\",\"args\":{\"state\":true}}";
   EXPECT_EQ(expected, call);
 }
@@ -999,8 +1009,9 @@ TEST_F(PlatformViewTests, OnKeyEvent) {
           key_event_status = status;
         });
     RunLoopUntilIdle();
-    const std::vector<uint8_t> data = delegate.message()->data();
-    const std::string message = std::string(data.begin(), data.end());
+    const fml::Mapping& data = delegate.message()->data();
+    const std::string message = std::string(
+        reinterpret_cast<const char*>(data.GetMapping()), data.GetSize());
 
     EXPECT_EQ(event.expected_platform_message, message);
     EXPECT_EQ(key_event_status, event.expected_key_event_status);
@@ -13,7 +13,7 @@
 #include "flutter/shell/platform/linux/fl_engine_private.h"
 #include "flutter/shell/platform/linux/fl_plugin_registrar_private.h"
 #include "flutter/shell/platform/linux/fl_renderer.h"
-#include "flutter/shell/platform/linux/fl_renderer_headless.h"
+#include "flutter/shell/platform/linux/fl_renderer_headless_private.h"
 #include "flutter/shell/platform/linux/fl_settings_plugin.h"
 #include "flutter/shell/platform/linux/public/flutter_linux/fl_plugin_registry.h"
 
@@ -45,6 +45,11 @@ struct _FlEngine {
   FlEngineUpdateSemanticsNodeHandler update_semantics_node_handler;
   gpointer update_semantics_node_handler_data;
   GDestroyNotify update_semantics_node_handler_destroy_notify;
+
+  // Function to call when the engine waits for vsync.
+  FlEngineVsyncHandler vsync_handler;
+  gpointer vsync_handler_data;
+  GDestroyNotify vsync_handler_destroy_notify;
 };
 
 G_DEFINE_QUARK(fl_engine_error_quark, fl_engine_error)
@@ -66,6 +71,13 @@ typedef struct {
   FlutterTask task;
 } FlutterSource;
 
+// A request for vsync, passed from the engine's UI thread to the GLib main
+// loop.
+typedef struct {
+  FlEngine* engine;
+  intptr_t baton;
+} VsyncRequest;
+
 // Parse a locale into its components.
 static void parse_locale(const gchar* locale,
                          gchar** language,
@@ -216,6 +228,15 @@ static GSourceFuncs flutter_source_funcs = {
 
 // Flutter engine rendering callbacks.
 
+static bool fl_engine_software_present(void* user_data,
+                                       const void* allocation,
+                                       size_t row_bytes,
+                                       size_t height) {
+  // Frames are presented through the compositor, which never renders to the
+  // root surface.
+  return true;
+}
+
 static void* fl_engine_gl_proc_resolver(void* user_data, const char* name) {
   FlEngine* self = static_cast<FlEngine*>(user_data);
   return fl_renderer_get_proc_address(self->renderer, name);
@@ -289,6 +310,35 @@ static void fl_engine_post_task(FlutterTask task,
   g_source_attach(source, nullptr);
 }
 
+// Passes a vsync request to the vsync handler in the GLib main loop.
+static gboolean fl_engine_vsync_dispatch(gpointer user_data) {
+  VsyncRequest* request = static_cast<VsyncRequest*>(user_data);
+  FlEngine* self = request->engine;
+
+  if (self->vsync_handler != nullptr) {
+    self->vsync_handler(self, request->baton, self->vsync_handler_data);
+  }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void vsync_request_free(gpointer user_data) {
+  VsyncRequest* request = static_cast<VsyncRequest*>(user_data);
+  g_object_unref(request->engine);
+  g_free(request);
+}
+
+// Called on the UI thread when the engine waits for vsync.
+static void fl_engine_vsync_cb(void* user_data, intptr_t baton) {
+  FlEngine* self = static_cast<FlEngine*>(user_data);
+
+  VsyncRequest* request = g_new0(VsyncRequest, 1);
+  request->engine = FL_ENGINE(g_object_ref(self));
+  request->baton = baton;
+  g_idle_add_full(G_PRIORITY_DEFAULT, fl_engine_vsync_dispatch, request,
+                  vsync_request_free);
+}
+
 // Called when a platform message is received from the engine.
 static void fl_engine_platform_message_cb(const FlutterPlatformMessage* message,
                                           void* user_data) {
@@ -376,6 +426,12 @@ static void fl_engine_dispose(GObject* object) {
   self->update_semantics_node_handler_data = nullptr;
   self->update_semantics_node_handler_destroy_notify = nullptr;
 
+  if (self->vsync_handler_destroy_notify) {
+    self->vsync_handler_destroy_notify(self->vsync_handler_data);
+  }
+  self->vsync_handler_data = nullptr;
+  self->vsync_handler_destroy_notify = nullptr;
+
   G_OBJECT_CLASS(fl_engine_parent_class)->dispose(object);
 }
 
@@ -407,18 +463,36 @@ G_MODULE_EXPORT FlEngine* fl_engine_new_headless(FlDartProject* project) {
   return fl_engine_new(project, FL_RENDERER(renderer));
 }
 
-gboolean fl_engine_start(FlEngine* self, GError** error) {
+G_MODULE_EXPORT FlRendererHeadless* fl_engine_get_headless_renderer(
+    FlEngine* self) {
+  g_return_val_if_fail(FL_IS_ENGINE(self), nullptr);
+
+  if (!FL_IS_RENDERER_HEADLESS(self->renderer)) {
+    return nullptr;
+  }
+  return FL_RENDERER_HEADLESS(self->renderer);
+}
+
+G_MODULE_EXPORT gboolean fl_engine_start(FlEngine* self, GError** error) {
   g_return_val_if_fail(FL_IS_ENGINE(self), FALSE);
 
   FlutterRendererConfig config = {};
-  config.type = kOpenGL;
-  config.open_gl.struct_size = sizeof(FlutterOpenGLRendererConfig);
-  config.open_gl.gl_proc_resolver = fl_engine_gl_proc_resolver;
-  config.open_gl.make_current = fl_engine_gl_make_current;
-  config.open_gl.clear_current = fl_engine_gl_clear_current;
-  config.open_gl.fbo_callback = fl_engine_gl_get_fbo;
-  config.open_gl.present = fl_engine_gl_present;
-  config.open_gl.make_resource_current = fl_engine_gl_make_resource_current;
+  if (FL_IS_RENDERER_HEADLESS(self->renderer)) {
+    // Without a display there is no GL context, so Flutter renders in software
+    // into the backing stores of the renderer.
+    config.type = kSoftware;
+    config.software.struct_size = sizeof(FlutterSoftwareRendererConfig);
+    config.software.surface_present_callback = fl_engine_software_present;
+  } else {
+    config.type = kOpenGL;
+    config.open_gl.struct_size = sizeof(FlutterOpenGLRendererConfig);
+    config.open_gl.gl_proc_resolver = fl_engine_gl_proc_resolver;
+    config.open_gl.make_current = fl_engine_gl_make_current;
+    config.open_gl.clear_current = fl_engine_gl_clear_current;
+    config.open_gl.fbo_callback = fl_engine_gl_get_fbo;
+    config.open_gl.present = fl_engine_gl_present;
+    config.open_gl.make_resource_current = fl_engine_gl_make_resource_current;
+  }
 
   FlutterTaskRunnerDescription platform_task_runner = {};
   platform_task_runner.struct_size = sizeof(FlutterTaskRunnerDescription);
@@ -458,6 +532,9 @@ gboolean fl_engine_start(FlEngine* self, GError** error) {
       dart_entrypoint_args != nullptr ? g_strv_length(dart_entrypoint_args) : 0;
   args.dart_entrypoint_argv =
       reinterpret_cast<const char* const*>(dart_entrypoint_args);
+  if (self->vsync_handler != nullptr) {
+    args.vsync_callback = fl_engine_vsync_cb;
+  }
 
   FlutterCompositor compositor = {};
   compositor.struct_size = sizeof(FlutterCompositor);
@@ -548,6 +625,22 @@ void fl_engine_set_update_semantics_node_handler(
   self->update_semantics_node_handler_destroy_notify = destroy_notify;
 }
 
+G_MODULE_EXPORT void fl_engine_set_vsync_handler(
+    FlEngine* self,
+    FlEngineVsyncHandler handler,
+    gpointer user_data,
+    GDestroyNotify destroy_notify) {
+  g_return_if_fail(FL_IS_ENGINE(self));
+
+  if (self->vsync_handler_destroy_notify) {
+    self->vsync_handler_destroy_notify(self->vsync_handler_data);
+  }
+
+  self->vsync_handler = handler;
+  self->vsync_handler_data = user_data;
+  self->vsync_handler_destroy_notify = destroy_notify;
+}
+
 gboolean fl_engine_send_platform_message_response(
     FlEngine* self,
     const FlutterPlatformMessageResponseHandle* handle,
@@ -648,10 +741,10 @@ GBytes* fl_engine_send_platform_message_finish(FlEngine* self,
   return static_cast<GBytes*>(g_task_propagate_pointer(G_TASK(result), error));
 }
 
-void fl_engine_send_window_metrics_event(FlEngine* self,
-                                         size_t width,
-                                         size_t height,
-                                         double pixel_ratio) {
+G_MODULE_EXPORT void fl_engine_send_window_metrics_event(FlEngine* self,
+                                                         size_t width,
+                                                         size_t height,
+                                                         double pixel_ratio) {
   g_return_if_fail(FL_IS_ENGINE(self));
 
   if (self->engine == nullptr) {
@@ -717,6 +810,21 @@ void fl_engine_dispatch_semantics_action(FlEngine* self,
                                              action_data, action_data_length);
 }
 
+G_MODULE_EXPORT gboolean fl_engine_on_vsync(FlEngine* self,
+                                            intptr_t baton,
+                                            uint64_t frame_start_time_nanos,
+                                            uint64_t frame_target_time_nanos) {
+  g_return_val_if_fail(FL_IS_ENGINE(self), FALSE);
+
+  if (self->engine == nullptr) {
+    return FALSE;
+  }
+
+  return self->embedder_api.OnVsync(self->engine, baton,
+                                    frame_start_time_nanos,
+                                    frame_target_time_nanos) == kSuccess;
+}
+
 G_MODULE_EXPORT FlBinaryMessenger* fl_engine_get_binary_messenger(
     FlEngine* self) {
   g_return_val_if_fail(FL_IS_ENGINE(self), nullptr);
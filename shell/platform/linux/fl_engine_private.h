@@ -114,32 +114,6 @@ void fl_engine_set_update_semantics_node_handler(
     gpointer user_data,
     GDestroyNotify destroy_notify);
 
-/**
- * fl_engine_start:
- * @engine: an #FlEngine.
- * @error: (allow-none): #GError location to store the error occurring, or %NULL
- * to ignore.
- *
- * Starts the Flutter engine.
- *
- * Returns: %TRUE on success.
- */
-gboolean fl_engine_start(FlEngine* engine, GError** error);
-
-/**
- * fl_engine_send_window_metrics_event:
- * @engine: an #FlEngine.
- * @width: width of the window in pixels.
- * @height: height of the window in pixels.
- * @pixel_ratio: scale factor for window.
- *
- * Sends a window metrics event to the engine.
- */
-void fl_engine_send_window_metrics_event(FlEngine* engine,
-                                         size_t width,
-                                         size_t height,
-                                         double pixel_ratio);
-
 /**
  * fl_engine_send_mouse_pointer_event:
  * @engine: an #FlEngine.
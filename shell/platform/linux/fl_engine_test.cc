@@ -224,3 +224,102 @@ TEST(FlEngineTest, SettingsPlugin) {
 
   EXPECT_TRUE(called);
 }
+
+// Checks headless engines render in software and let the vsync handler produce
+// frames.
+TEST(FlEngineTest, HeadlessVsync) {
+  g_autoptr(FlDartProject) project = fl_dart_project_new();
+  g_autoptr(FlEngine) engine = fl_engine_new_headless(project);
+  FlutterEngineProcTable* embedder_api = fl_engine_get_embedder_api(engine);
+
+  VsyncCallback vsync_callback = nullptr;
+  void* vsync_user_data = nullptr;
+  auto initialize = embedder_api->Initialize;
+  embedder_api->Initialize = MOCK_ENGINE_PROC(
+      Initialize,
+      ([&vsync_callback, &vsync_user_data, initialize](
+           size_t version, const FlutterRendererConfig* config,
+           const FlutterProjectArgs* args, void* user_data, auto engine_out) {
+        EXPECT_EQ(config->type, kSoftware);
+        EXPECT_NE(args->compositor, nullptr);
+        vsync_callback = args->vsync_callback;
+        vsync_user_data = user_data;
+
+        return initialize(version, config, args, user_data, engine_out);
+      }));
+
+  bool called = false;
+  embedder_api->OnVsync = MOCK_ENGINE_PROC(
+      OnVsync, ([&called](auto engine, intptr_t baton,
+                          uint64_t frame_start_time_nanos,
+                          uint64_t frame_target_time_nanos) {
+        EXPECT_EQ(baton, 42);
+        EXPECT_EQ(frame_start_time_nanos, static_cast<uint64_t>(1000));
+        EXPECT_EQ(frame_target_time_nanos, static_cast<uint64_t>(2000));
+        called = true;
+
+        return kSuccess;
+      }));
+
+  intptr_t handled_baton = 0;
+  fl_engine_set_vsync_handler(
+      engine,
+      [](FlEngine* engine, intptr_t baton, gpointer user_data) {
+        *static_cast<intptr_t*>(user_data) = baton;
+        EXPECT_TRUE(fl_engine_on_vsync(engine, baton, 1000, 2000));
+      },
+      &handled_baton, nullptr);
+
+  g_autoptr(GError) error = nullptr;
+  EXPECT_TRUE(fl_engine_start(engine, &error));
+  EXPECT_EQ(error, nullptr);
+  ASSERT_NE(vsync_callback, nullptr);
+
+  // The engine waits for vsync on its UI thread, so the handler is called from
+  // the main loop.
+  vsync_callback(vsync_user_data, 42);
+  EXPECT_EQ(handled_baton, 0);
+  while (handled_baton == 0) {
+    g_main_context_iteration(nullptr, TRUE);
+  }
+
+  EXPECT_EQ(handled_baton, 42);
+  EXPECT_TRUE(called);
+}
+
+TEST(FlEngineTest, HeadlessRenderer) {
+  g_autoptr(FlDartProject) project = fl_dart_project_new();
+  g_autoptr(FlEngine) headless_engine = fl_engine_new_headless(project);
+  FlRendererHeadless* renderer =
+      fl_engine_get_headless_renderer(headless_engine);
+  EXPECT_TRUE(FL_IS_RENDERER_HEADLESS(renderer));
+
+  g_autoptr(FlEngine) engine = make_mock_engine();
+  EXPECT_EQ(fl_engine_get_headless_renderer(engine), nullptr);
+}
+
+// Checks headless engines can be sized with the public API.
+TEST(FlEngineTest, HeadlessWindowMetrics) {
+  g_autoptr(FlDartProject) project = fl_dart_project_new();
+  g_autoptr(FlEngine) engine = fl_engine_new_headless(project);
+
+  // The embedder API is only replaced to observe the event.
+  bool called = false;
+  fl_engine_get_embedder_api(engine)->SendWindowMetricsEvent = MOCK_ENGINE_PROC(
+      SendWindowMetricsEvent,
+      ([&called](auto engine, const FlutterWindowMetricsEvent* event) {
+        called = true;
+        EXPECT_EQ(event->width, static_cast<size_t>(800));
+        EXPECT_EQ(event->height, static_cast<size_t>(600));
+        EXPECT_EQ(event->pixel_ratio, 1.0);
+
+        return kSuccess;
+      }));
+
+  g_autoptr(GError) error = nullptr;
+  EXPECT_TRUE(fl_engine_start(engine, &error));
+  EXPECT_EQ(error, nullptr);
+  fl_engine_send_window_metrics_event(engine, 800, 600, 1.0);
+
+  EXPECT_TRUE(called);
+}
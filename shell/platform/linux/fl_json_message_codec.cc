@@ -239,6 +239,75 @@ struct FlValueHandler {
   }
 };
 
+// Handler to pass JSON parsed by rapidjson in SAX mode to the callbacks of a
+// #FlJsonMessageHandler.
+struct FlJsonMessageHandlerAdapter {
+  const FlJsonMessageHandler* handler;
+  gpointer user_data;
+
+  // The following implements the rapidjson SAX API.
+
+  bool Null() {
+    return handler->null_value == nullptr || handler->null_value(user_data);
+  }
+
+  bool Bool(bool b) {
+    return handler->bool_value == nullptr ||
+           handler->bool_value(b ? TRUE : FALSE, user_data);
+  }
+
+  bool Int(int i) { return Int64(i); }
+
+  bool Uint(unsigned i) { return Int64(i); }
+
+  bool Int64(int64_t i) {
+    return handler->int_value == nullptr || handler->int_value(i, user_data);
+  }
+
+  bool Uint64(uint64_t i) {
+    if (i <= G_MAXINT64) {
+      return Int64(i);
+    } else {
+      return Double(i);
+    }
+  }
+
+  bool Double(double d) {
+    return handler->float_value == nullptr ||
+           handler->float_value(d, user_data);
+  }
+
+  bool RawNumber(const char* str, rapidjson::SizeType length, bool copy) {
+    return false;
+  }
+
+  bool String(const char* str, rapidjson::SizeType length, bool copy) {
+    return handler->string_value == nullptr ||
+           handler->string_value(str, length, user_data);
+  }
+
+  bool StartObject() {
+    return handler->start_map == nullptr || handler->start_map(user_data);
+  }
+
+  bool Key(const char* str, rapidjson::SizeType length, bool copy) {
+    return handler->map_key == nullptr ||
+           handler->map_key(str, length, user_data);
+  }
+
+  bool EndObject(rapidjson::SizeType memberCount) {
+    return handler->end_map == nullptr || handler->end_map(user_data);
+  }
+
+  bool StartArray() {
+    return handler->start_list == nullptr || handler->start_list(user_data);
+  }
+
+  bool EndArray(rapidjson::SizeType elementCount) {
+    return handler->end_list == nullptr || handler->end_list(user_data);
+  }
+};
+
 // Implements FlMessageCodec:encode_message.
 static GBytes* fl_json_message_codec_encode_message(FlMessageCodec* codec,
                                                     FlValue* message,
@@ -337,3 +406,39 @@ G_MODULE_EXPORT FlValue* fl_json_message_codec_decode(FlJsonMessageCodec* codec,
 
   return fl_value_ref(value);
 }
+
+G_MODULE_EXPORT gboolean fl_json_message_codec_decode_streaming(
+    FlJsonMessageCodec* codec,
+    GBytes* message,
+    const FlJsonMessageHandler* handler,
+    gpointer user_data,
+    GError** error) {
+  g_return_val_if_fail(FL_IS_JSON_CODEC(codec), FALSE);
+  g_return_val_if_fail(message != nullptr, FALSE);
+  g_return_val_if_fail(handler != nullptr, FALSE);
+
+  gsize data_length;
+  const gchar* data =
+      static_cast<const char*>(g_bytes_get_data(message, &data_length));
+  if (!g_utf8_validate(data, data_length, nullptr)) {
+    g_set_error(error, FL_JSON_MESSAGE_CODEC_ERROR,
+                FL_JSON_MESSAGE_CODEC_ERROR_INVALID_UTF8,
+                "Message is not valid UTF8");
+    return FALSE;
+  }
+
+  FlJsonMessageHandlerAdapter adapter = {handler, user_data};
+  rapidjson::Reader reader;
+  rapidjson::MemoryStream ss(data, data_length);
+  rapidjson::ParseResult result = reader.Parse(ss, adapter);
+  // A callback returning FALSE terminates parsing, which is not an error.
+  if (result.IsError() &&
+      result.Code() != rapidjson::kParseErrorTermination) {
+    g_set_error(error, FL_JSON_MESSAGE_CODEC_ERROR,
+                FL_JSON_MESSAGE_CODEC_ERROR_INVALID_JSON,
+                "Message is not valid JSON");
+    return FALSE;
+  }
+
+  return TRUE;
+}
@@ -6,6 +6,7 @@
 #include "gtest/gtest.h"
 
 #include <cmath>
+#include <cstring>
 
 // Encodes a message using FlJsonMessageCodec to a UTF-8 string.
 static gchar* encode_message(FlValue* value) {
@@ -782,3 +783,82 @@ TEST(FlJsonMessageCodecTest, EncodeDecode) {
 
   EXPECT_TRUE(fl_value_equal(input, output));
 }
+
+// State for the streaming decoding tests.
+typedef struct {
+  gboolean in_id;
+  int64_t id_sum;
+  int values_seen;
+  int max_values;
+} StreamingState;
+
+static gboolean streaming_map_key(const gchar* key,
+                                  size_t length,
+                                  gpointer user_data) {
+  StreamingState* state = static_cast<StreamingState*>(user_data);
+  state->in_id = length == 2 && strncmp(key, "id", length) == 0;
+  return TRUE;
+}
+
+static gboolean streaming_int_value(int64_t value, gpointer user_data) {
+  StreamingState* state = static_cast<StreamingState*>(user_data);
+  if (state->in_id) {
+    state->id_sum += value;
+  }
+  state->values_seen++;
+  return state->max_values == 0 || state->values_seen < state->max_values;
+}
+
+// Returns a handler summing the "id" fields of a message.
+static FlJsonMessageHandler make_streaming_handler() {
+  FlJsonMessageHandler handler = {};
+  handler.int_value = streaming_int_value;
+  handler.map_key = streaming_map_key;
+  return handler;
+}
+
+TEST(FlJsonMessageCodecTest, DecodeStreaming) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+  const char* text =
+      "[{\"id\":1,\"size\":10,\"name\":\"a\"},{\"id\":2,\"tags\":[\"b\"]}]";
+  g_autoptr(GBytes) message = g_bytes_new_static(text, strlen(text));
+
+  FlJsonMessageHandler handler = make_streaming_handler();
+  StreamingState state = {};
+  g_autoptr(GError) error = nullptr;
+  EXPECT_TRUE(fl_json_message_codec_decode_streaming(
+      codec, message, &handler, &state, &error));
+  EXPECT_EQ(error, nullptr);
+  EXPECT_EQ(state.id_sum, 3);
+  EXPECT_EQ(state.values_seen, 3);
+}
+
+TEST(FlJsonMessageCodecTest, DecodeStreamingStopsEarly) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+  // Truncated, but only after the values that are read.
+  const char* text = "[{\"id\":1},{\"id\":2},{\"id\":";
+  g_autoptr(GBytes) message = g_bytes_new_static(text, strlen(text));
+
+  FlJsonMessageHandler handler = make_streaming_handler();
+  StreamingState state = {};
+  state.max_values = 2;
+  g_autoptr(GError) error = nullptr;
+  EXPECT_TRUE(fl_json_message_codec_decode_streaming(
+      codec, message, &handler, &state, &error));
+  EXPECT_EQ(error, nullptr);
+  EXPECT_EQ(state.id_sum, 3);
+}
+
+TEST(FlJsonMessageCodecTest, DecodeStreamingInvalidJson) {
+  g_autoptr(FlJsonMessageCodec) codec = fl_json_message_codec_new();
+  const char* text = "[{\"id\":1},";
+  g_autoptr(GBytes) message = g_bytes_new_static(text, strlen(text));
+
+  FlJsonMessageHandler handler = make_streaming_handler();
+  StreamingState state = {};
+  g_autoptr(GError) error = nullptr;
+  EXPECT_FALSE(fl_json_message_codec_decode_streaming(
+      codec, message, &handler, &state, &error));
+  EXPECT_TRUE(g_error_matches(error, FL_JSON_MESSAGE_CODEC_ERROR,
+                              FL_JSON_MESSAGE_CODEC_ERROR_INVALID_JSON));
+}
@@ -2,14 +2,70 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include "fl_renderer_headless.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_renderer_headless.h"
+
+#include <gmodule.h>
+
+#include "flutter/shell/platform/linux/fl_renderer_headless_private.h"
+
+// The size of a pixel in the buffers of the software renderer.
+static constexpr size_t kBytesPerPixel = 4;
+
+// A buffer in the pool of the renderer.
+typedef struct {
+  guint8* pixels;
+  size_t row_bytes;
+  size_t height;
+
+  // TRUE if a backing store is using this buffer.
+  gboolean in_use;
+
+  // TRUE if the renderer allocated this buffer and frees it on dispose.
+  gboolean owned;
+} FlRendererHeadlessBuffer;
 
 struct _FlRendererHeadless {
   FlRenderer parent_instance;
+
+  // Buffers backing stores are taken from.
+  GPtrArray* buffers;
+
+  // Function to call when a frame is presented.
+  FlRendererHeadlessFrameHandler frame_handler;
+  gpointer frame_handler_data;
+  GDestroyNotify frame_handler_destroy_notify;
 };
 
 G_DEFINE_TYPE(FlRendererHeadless, fl_renderer_headless, fl_renderer_get_type())
 
+static void buffer_free(gpointer data) {
+  FlRendererHeadlessBuffer* buffer =
+      static_cast<FlRendererHeadlessBuffer*>(data);
+  if (buffer->owned) {
+    g_free(buffer->pixels);
+  }
+  g_free(buffer);
+}
+
+static FlRendererHeadlessBuffer* add_buffer(FlRendererHeadless* self,
+                                            guint8* pixels,
+                                            size_t row_bytes,
+                                            size_t height,
+                                            gboolean owned) {
+  FlRendererHeadlessBuffer* buffer = g_new0(FlRendererHeadlessBuffer, 1);
+  buffer->pixels = pixels;
+  buffer->row_bytes = row_bytes;
+  buffer->height = height;
+  buffer->owned = owned;
+  g_ptr_array_add(self->buffers, buffer);
+  return buffer;
+}
+
+// Called by the engine when it no longer renders into a backing store. The
+// buffer is returned to the pool in collect_backing_store, which the engine
+// calls first.
+static void backing_store_destruction_cb(void* user_data) {}
+
 // Implements FlRenderer::create_contexts.
 static gboolean fl_renderer_headless_create_contexts(FlRenderer* renderer,
                                                      GtkWidget* widget,
@@ -24,24 +80,102 @@ static gboolean fl_renderer_headless_create_backing_store(
     FlRenderer* renderer,
     const FlutterBackingStoreConfig* config,
     FlutterBackingStore* backing_store_out) {
-  return FALSE;
+  FlRendererHeadless* self = FL_RENDERER_HEADLESS(renderer);
+
+  size_t row_bytes = static_cast<size_t>(config->size.width) * kBytesPerPixel;
+  size_t height = static_cast<size_t>(config->size.height);
+
+  FlRendererHeadlessBuffer* buffer = nullptr;
+  for (guint i = 0; i < self->buffers->len; i++) {
+    FlRendererHeadlessBuffer* b = static_cast<FlRendererHeadlessBuffer*>(
+        g_ptr_array_index(self->buffers, i));
+    if (!b->in_use && b->row_bytes >= row_bytes && b->height >= height) {
+      buffer = b;
+      break;
+    }
+  }
+  if (buffer == nullptr) {
+    guint8* pixels = static_cast<guint8*>(g_try_malloc0(row_bytes * height));
+    if (pixels == nullptr) {
+      g_warning("Failed to allocate %zux%zu headless backing store",
+                row_bytes / kBytesPerPixel, height);
+      return FALSE;
+    }
+    buffer = add_buffer(self, pixels, row_bytes, height, TRUE);
+  }
+  buffer->in_use = TRUE;
+
+  backing_store_out->type = kFlutterBackingStoreTypeSoftware;
+  backing_store_out->user_data = buffer;
+  backing_store_out->software.allocation = buffer->pixels;
+  backing_store_out->software.row_bytes = buffer->row_bytes;
+  backing_store_out->software.height = buffer->height;
+  backing_store_out->software.user_data = buffer;
+  backing_store_out->software.destruction_callback =
+      backing_store_destruction_cb;
+
+  return TRUE;
 }
 
 // Implements FlRenderer::collect_backing_store.
 static gboolean fl_renderer_headless_collect_backing_store(
-    FlRenderer* self,
+    FlRenderer* renderer,
     const FlutterBackingStore* backing_store) {
-  return FALSE;
+  if (backing_store->type != kFlutterBackingStoreTypeSoftware) {
+    return FALSE;
+  }
+
+  FlRendererHeadlessBuffer* buffer =
+      static_cast<FlRendererHeadlessBuffer*>(backing_store->software.user_data);
+  buffer->in_use = FALSE;
+  return TRUE;
 }
 
 // Implements FlRenderer::present_layers.
-static gboolean fl_renderer_headless_present_layers(FlRenderer* self,
+static gboolean fl_renderer_headless_present_layers(FlRenderer* renderer,
                                                     const FlutterLayer** layers,
                                                     size_t layers_count) {
-  return FALSE;
+  FlRendererHeadless* self = FL_RENDERER_HEADLESS(renderer);
+
+  // Platform views are not supported, so the frame is the bottom layer that
+  // Flutter rendered.
+  for (size_t i = 0; i < layers_count; ++i) {
+    const FlutterLayer* layer = layers[i];
+    if (layer->type != kFlutterLayerContentTypeBackingStore) {
+      continue;
+    }
+
+    const FlutterSoftwareBackingStore* software =
+        &layer->backing_store->software;
+    if (self->frame_handler != nullptr) {
+      self->frame_handler(
+          self, static_cast<const guint8*>(software->allocation),
+          software->row_bytes, static_cast<size_t>(layer->size.width),
+          static_cast<size_t>(layer->size.height), self->frame_handler_data);
+    }
+    break;
+  }
+
+  return TRUE;
+}
+
+static void fl_renderer_headless_dispose(GObject* object) {
+  FlRendererHeadless* self = FL_RENDERER_HEADLESS(object);
+
+  g_clear_pointer(&self->buffers, g_ptr_array_unref);
+
+  if (self->frame_handler_destroy_notify) {
+    self->frame_handler_destroy_notify(self->frame_handler_data);
+  }
+  self->frame_handler = nullptr;
+  self->frame_handler_data = nullptr;
+  self->frame_handler_destroy_notify = nullptr;
+
+  G_OBJECT_CLASS(fl_renderer_headless_parent_class)->dispose(object);
 }
 
 static void fl_renderer_headless_class_init(FlRendererHeadlessClass* klass) {
+  G_OBJECT_CLASS(klass)->dispose = fl_renderer_headless_dispose;
   FL_RENDERER_CLASS(klass)->create_contexts =
       fl_renderer_headless_create_contexts;
   FL_RENDERER_CLASS(klass)->create_backing_store =
@@ -52,9 +186,37 @@ static void fl_renderer_headless_class_init(FlRendererHeadlessClass* klass) {
       fl_renderer_headless_present_layers;
 }
 
-static void fl_renderer_headless_init(FlRendererHeadless* self) {}
+static void fl_renderer_headless_init(FlRendererHeadless* self) {
+  self->buffers = g_ptr_array_new_with_free_func(buffer_free);
+}
 
 FlRendererHeadless* fl_renderer_headless_new() {
   return FL_RENDERER_HEADLESS(
       g_object_new(fl_renderer_headless_get_type(), nullptr));
 }
+
+G_MODULE_EXPORT void fl_renderer_headless_add_buffer(FlRendererHeadless* self,
+                                                     guint8* pixels,
+                                                     size_t row_bytes,
+                                                     size_t height) {
+  g_return_if_fail(FL_IS_RENDERER_HEADLESS(self));
+  g_return_if_fail(pixels != nullptr);
+
+  add_buffer(self, pixels, row_bytes, height, FALSE);
+}
+
+G_MODULE_EXPORT void fl_renderer_headless_set_frame_handler(
+    FlRendererHeadless* self,
+    FlRendererHeadlessFrameHandler handler,
+    gpointer user_data,
+    GDestroyNotify destroy_notify) {
+  g_return_if_fail(FL_IS_RENDERER_HEADLESS(self));
+
+  if (self->frame_handler_destroy_notify) {
+    self->frame_handler_destroy_notify(self->frame_handler_data);
+  }
+
+  self->frame_handler = handler;
+  self->frame_handler_data = user_data;
+  self->frame_handler_destroy_notify = destroy_notify;
+}
@@ -0,0 +1,33 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_HEADLESS_PRIVATE_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_HEADLESS_PRIVATE_H_
+
+#include "flutter/shell/platform/linux/fl_renderer.h"
+#include "flutter/shell/platform/linux/public/flutter_linux/fl_renderer_headless.h"
+
+G_BEGIN_DECLS
+
+// #FlRendererHeadless is declared without its parent class in the public
+// header, so the class structure is declared here instead of with
+// G_DECLARE_FINAL_TYPE.
+typedef struct {
+  FlRendererClass parent_class;
+} FlRendererHeadlessClass;
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(FlRendererHeadless, g_object_unref)
+
+/**
+ * fl_renderer_headless_new:
+ *
+ * Creates an object that allows Flutter to operate without a display.
+ *
+ * Returns: a new #FlRendererHeadless.
+ */
+FlRendererHeadless* fl_renderer_headless_new();
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_HEADLESS_PRIVATE_H_
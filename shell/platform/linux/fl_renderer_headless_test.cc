@@ -0,0 +1,99 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Included first as it collides with the X11 headers.
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#include "flutter/shell/platform/linux/fl_renderer_headless_private.h"
+
+static FlutterBackingStoreConfig make_config(double width, double height) {
+  FlutterBackingStoreConfig config = {};
+  config.struct_size = sizeof(FlutterBackingStoreConfig);
+  config.size.width = width;
+  config.size.height = height;
+  return config;
+}
+
+// Checks backing stores are taken from the buffers added to the renderer.
+TEST(FlRendererHeadlessTest, BackingStoresUseAddedBuffers) {
+  g_autoptr(FlRendererHeadless) renderer = fl_renderer_headless_new();
+  std::vector<guint8> pixels(800 * 4 * 600);
+  fl_renderer_headless_add_buffer(renderer, pixels.data(), 800 * 4, 600);
+
+  FlutterBackingStoreConfig config = make_config(800, 600);
+  FlutterBackingStore backing_store = {};
+  EXPECT_TRUE(fl_renderer_create_backing_store(FL_RENDERER(renderer), &config,
+                                               &backing_store));
+  EXPECT_EQ(backing_store.type, kFlutterBackingStoreTypeSoftware);
+  EXPECT_EQ(backing_store.software.allocation, pixels.data());
+  EXPECT_EQ(backing_store.software.row_bytes, static_cast<size_t>(800 * 4));
+  EXPECT_EQ(backing_store.software.height, static_cast<size_t>(600));
+
+  // The buffer is in use, so the renderer allocates one.
+  FlutterBackingStore other_backing_store = {};
+  EXPECT_TRUE(fl_renderer_create_backing_store(FL_RENDERER(renderer), &config,
+                                               &other_backing_store));
+  EXPECT_NE(other_backing_store.software.allocation, nullptr);
+  EXPECT_NE(other_backing_store.software.allocation, pixels.data());
+
+  // Collected buffers are used again.
+  EXPECT_TRUE(fl_renderer_collect_backing_store(FL_RENDERER(renderer),
+                                                &backing_store));
+  FlutterBackingStore reused_backing_store = {};
+  EXPECT_TRUE(fl_renderer_create_backing_store(FL_RENDERER(renderer), &config,
+                                               &reused_backing_store));
+  EXPECT_EQ(reused_backing_store.software.allocation, pixels.data());
+}
+
+// Checks buffers that are too small are not used.
+TEST(FlRendererHeadlessTest, SkipsSmallBuffers) {
+  g_autoptr(FlRendererHeadless) renderer = fl_renderer_headless_new();
+  std::vector<guint8> pixels(400 * 4 * 300);
+  fl_renderer_headless_add_buffer(renderer, pixels.data(), 400 * 4, 300);
+
+  FlutterBackingStoreConfig config = make_config(800, 600);
+  FlutterBackingStore backing_store = {};
+  EXPECT_TRUE(fl_renderer_create_backing_store(FL_RENDERER(renderer), &config,
+                                               &backing_store));
+  EXPECT_NE(backing_store.software.allocation, pixels.data());
+  EXPECT_GE(backing_store.software.row_bytes, static_cast<size_t>(800 * 4));
+  EXPECT_GE(backing_store.software.height, static_cast<size_t>(600));
+}
+
+// Checks presented frames are passed to the frame handler without copies.
+TEST(FlRendererHeadlessTest, PresentsFrames) {
+  g_autoptr(FlRendererHeadless) renderer = fl_renderer_headless_new();
+  std::vector<guint8> pixels(800 * 4 * 600);
+  fl_renderer_headless_add_buffer(renderer, pixels.data(), 800 * 4, 600);
+
+  const guint8* frame = nullptr;
+  fl_renderer_headless_set_frame_handler(
+      renderer,
+      [](FlRendererHeadless* renderer, const guint8* pixels, size_t row_bytes,
+         size_t width, size_t height, gpointer user_data) {
+        EXPECT_EQ(row_bytes, static_cast<size_t>(800 * 4));
+        EXPECT_EQ(width, static_cast<size_t>(800));
+        EXPECT_EQ(height, static_cast<size_t>(600));
+        *static_cast<const guint8**>(user_data) = pixels;
+      },
+      &frame, nullptr);
+
+  FlutterBackingStoreConfig config = make_config(800, 600);
+  FlutterBackingStore backing_store = {};
+  EXPECT_TRUE(fl_renderer_create_backing_store(FL_RENDERER(renderer), &config,
+                                               &backing_store));
+
+  FlutterLayer layer = {};
+  layer.struct_size = sizeof(FlutterLayer);
+  layer.type = kFlutterLayerContentTypeBackingStore;
+  layer.backing_store = &backing_store;
+  layer.size.width = 800;
+  layer.size.height = 600;
+  const FlutterLayer* layers[] = {&layer};
+  EXPECT_TRUE(fl_renderer_present_layers(FL_RENDERER(renderer), layers, 1));
+
+  EXPECT_EQ(frame, pixels.data());
+}
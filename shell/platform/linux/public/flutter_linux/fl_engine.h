@@ -10,9 +10,12 @@
 #endif
 
 #include <glib-object.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "fl_binary_messenger.h"
 #include "fl_dart_project.h"
+#include "fl_renderer_headless.h"
 
 G_BEGIN_DECLS
 
@@ -24,6 +27,18 @@ G_DECLARE_FINAL_TYPE(FlEngine, fl_engine, FL, ENGINE, GObject)
  * #FlEngine is an object that contains a running Flutter engine.
  */
 
+/**
+ * FlEngineVsyncHandler:
+ * @engine: an #FlEngine.
+ * @baton: the baton to pass to fl_engine_on_vsync().
+ * @user_data: (closure): data provided when registering this handler.
+ *
+ * Function called when the engine waits for vsync to produce a frame.
+ */
+typedef void (*FlEngineVsyncHandler)(FlEngine* engine,
+                                     intptr_t baton,
+                                     gpointer user_data);
+
 /**
  * fl_engine_new_headless:
  * @project: an #FlDartProject.
@@ -34,6 +49,83 @@ G_DECLARE_FINAL_TYPE(FlEngine, fl_engine, FL, ENGINE, GObject)
  */
 FlEngine* fl_engine_new_headless(FlDartProject* project);
 
+/**
+ * fl_engine_get_headless_renderer:
+ * @engine: an #FlEngine.
+ *
+ * Gets the renderer of an engine created with fl_engine_new_headless(), to
+ * supply the buffers frames are rendered into and receive the frames.
+ *
+ * Returns: (transfer none): an #FlRendererHeadless or %NULL if @engine is not
+ * headless.
+ */
+FlRendererHeadless* fl_engine_get_headless_renderer(FlEngine* engine);
+
+/**
+ * fl_engine_set_vsync_handler:
+ * @engine: an #FlEngine.
+ * @handler: function to call when the engine waits for vsync.
+ * @user_data: (closure): user data to pass to @handler.
+ * @destroy_notify: (allow-none): a function which gets called to free
+ * @user_data, or %NULL.
+ *
+ * Registers the function called when the engine waits for vsync, which must
+ * respond with fl_engine_on_vsync(). This lets headless engines produce frames
+ * on their own schedule, such as faster than real time. Must be called before
+ * fl_engine_start().
+ */
+void fl_engine_set_vsync_handler(FlEngine* engine,
+                                 FlEngineVsyncHandler handler,
+                                 gpointer user_data,
+                                 GDestroyNotify destroy_notify);
+
+/**
+ * fl_engine_start:
+ * @engine: an #FlEngine.
+ * @error: (allow-none): #GError location to store the error occurring, or %NULL
+ * to ignore.
+ *
+ * Starts the Flutter engine. Engines shown in an #FlView are started by the
+ * view, headless engines must be started by the caller.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean fl_engine_start(FlEngine* engine, GError** error);
+
+/**
+ * fl_engine_on_vsync:
+ * @engine: an #FlEngine.
+ * @baton: the baton given to the #FlEngineVsyncHandler.
+ * @frame_start_time_nanos: the time the frame starts, in nanoseconds of the
+ * monotonic clock used by g_get_monotonic_time().
+ * @frame_target_time_nanos: the time the frame should be presented by.
+ *
+ * Lets the engine produce the frame it waits for. The times need not follow
+ * the clock, so that animations can be stepped faster than real time.
+ *
+ * Returns: %TRUE on success.
+ */
+gboolean fl_engine_on_vsync(FlEngine* engine,
+                            intptr_t baton,
+                            uint64_t frame_start_time_nanos,
+                            uint64_t frame_target_time_nanos);
+
+/**
+ * fl_engine_send_window_metrics_event:
+ * @engine: an #FlEngine.
+ * @width: width of the window in pixels.
+ * @height: height of the window in pixels.
+ * @pixel_ratio: scale factor for window.
+ *
+ * Sends a window metrics event to the engine, which sets the size of the
+ * frames it renders. Engines shown in an #FlView are sized by the view,
+ * headless engines render nothing until the caller sizes them.
+ */
+void fl_engine_send_window_metrics_event(FlEngine* engine,
+                                         size_t width,
+                                         size_t height,
+                                         double pixel_ratio);
+
 /**
  * fl_engine_get_binary_messenger:
  * @engine: an #FlEngine.
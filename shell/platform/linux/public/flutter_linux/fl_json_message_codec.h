@@ -91,6 +91,69 @@ FlValue* fl_json_message_codec_decode(FlJsonMessageCodec* codec,
                                       const gchar* text,
                                       GError** error);
 
+/**
+ * FlJsonMessageHandler:
+ * @null_value: called for a null value.
+ * @bool_value: called for a boolean value.
+ * @int_value: called for an integer value. Integers that don't fit in an
+ * #int64_t are passed to @float_value instead.
+ * @float_value: called for a floating point value.
+ * @string_value: called for a string value of @length bytes, which is not
+ * null-terminated.
+ * @start_map: called at the start of a map.
+ * @map_key: called with the key of the next value in a map, which is not
+ * null-terminated.
+ * @end_map: called at the end of a map.
+ * @start_list: called at the start of a list.
+ * @end_list: called at the end of a list.
+ *
+ * Callbacks invoked by fl_json_message_codec_decode_streaming() for each
+ * element of a JSON message, in the manner of #GMarkupParser. Any of the
+ * callbacks can be %NULL to ignore the corresponding elements.
+ *
+ * Each callback returns %TRUE to continue decoding or %FALSE to stop, e.g.
+ * once the fields of interest have been read. Strings are only valid for the
+ * duration of the callback.
+ */
+typedef struct {
+  gboolean (*null_value)(gpointer user_data);
+  gboolean (*bool_value)(gboolean value, gpointer user_data);
+  gboolean (*int_value)(int64_t value, gpointer user_data);
+  gboolean (*float_value)(double value, gpointer user_data);
+  gboolean (*string_value)(const gchar* value,
+                           size_t length,
+                           gpointer user_data);
+  gboolean (*start_map)(gpointer user_data);
+  gboolean (*map_key)(const gchar* key, size_t length, gpointer user_data);
+  gboolean (*end_map)(gpointer user_data);
+  gboolean (*start_list)(gpointer user_data);
+  gboolean (*end_list)(gpointer user_data);
+} FlJsonMessageHandler;
+
+/**
+ * fl_json_message_codec_decode_streaming:
+ * @codec: an #FlJsonMessageCodec.
+ * @message: UTF-8 text in JSON format.
+ * @handler: callbacks to invoke for the elements of @message.
+ * @user_data: (closure): user data to pass to the callbacks.
+ * @error: (allow-none): #GError location to store the error occurring, or
+ * %NULL.
+ *
+ * Decodes a message by passing its elements to @handler as they are parsed,
+ * without building an #FlValue. This is much cheaper than
+ * fl_message_codec_decode_message() for large messages of which only a few
+ * fields are needed.
+ *
+ * Returns: %TRUE if the message was decoded or a callback stopped decoding,
+ * %FALSE on error.
+ */
+gboolean fl_json_message_codec_decode_streaming(
+    FlJsonMessageCodec* codec,
+    GBytes* message,
+    const FlJsonMessageHandler* handler,
+    gpointer user_data,
+    GError** error);
+
 G_END_DECLS
 
 #endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_JSON_MESSAGE_CODEC_H_
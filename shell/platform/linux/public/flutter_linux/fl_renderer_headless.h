@@ -0,0 +1,98 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_HEADLESS_H_
+#define FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_HEADLESS_H_
+
+#if !defined(__FLUTTER_LINUX_INSIDE__) && !defined(FLUTTER_LINUX_COMPILATION)
+#error "Only <flutter_linux/flutter_linux.h> can be included directly."
+#endif
+
+#include <glib-object.h>
+#include <stddef.h>
+
+G_BEGIN_DECLS
+
+/**
+ * FlRendererHeadless:
+ *
+ * #FlRendererHeadless is the renderer of an #FlEngine that runs without a
+ * display, see fl_engine_get_headless_renderer().
+ *
+ * Flutter renders in software into the backing stores of this renderer, which
+ * needs no GL context. Frames are drawn directly into buffers supplied with
+ * fl_renderer_headless_add_buffer() and passed to the handler set with
+ * fl_renderer_headless_set_frame_handler(), without being copied. The size of
+ * the frames is set with fl_engine_send_window_metrics_event().
+ *
+ * Its parent class is private to the engine, so the type is opaque.
+ */
+typedef struct _FlRendererHeadless FlRendererHeadless;
+
+GType fl_renderer_headless_get_type();
+
+#define FL_TYPE_RENDERER_HEADLESS (fl_renderer_headless_get_type())
+#define FL_RENDERER_HEADLESS(obj)                               \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj), FL_TYPE_RENDERER_HEADLESS, \
+                              FlRendererHeadless))
+#define FL_IS_RENDERER_HEADLESS(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj), FL_TYPE_RENDERER_HEADLESS))
+
+/**
+ * FlRendererHeadlessFrameHandler:
+ * @renderer: an #FlRendererHeadless.
+ * @pixels: the frame, in the native 32-bit premultiplied format of the
+ * software renderer.
+ * @row_bytes: the number of bytes in a row of @pixels.
+ * @width: the width of the frame in pixels.
+ * @height: the height of the frame in pixels.
+ * @user_data: (closure): data provided when registering this handler.
+ *
+ * Function called when Flutter presents a frame. @pixels is one of the buffers
+ * of the renderer, which Flutter may draw the next frame into once this
+ * handler returns.
+ */
+typedef void (*FlRendererHeadlessFrameHandler)(FlRendererHeadless* renderer,
+                                               const guint8* pixels,
+                                               size_t row_bytes,
+                                               size_t width,
+                                               size_t height,
+                                               gpointer user_data);
+
+/**
+ * fl_renderer_headless_add_buffer:
+ * @renderer: an #FlRendererHeadless.
+ * @pixels: memory for Flutter to render into, which must stay valid until
+ * @renderer is disposed.
+ * @row_bytes: the number of bytes in a row of @pixels.
+ * @height: the number of rows in @pixels.
+ *
+ * Adds a buffer to the pool that backing stores are taken from. A backing
+ * store uses the first free buffer that is large enough for it, and the
+ * renderer allocates buffers itself when there is none.
+ */
+void fl_renderer_headless_add_buffer(FlRendererHeadless* renderer,
+                                     guint8* pixels,
+                                     size_t row_bytes,
+                                     size_t height);
+
+/**
+ * fl_renderer_headless_set_frame_handler:
+ * @renderer: an #FlRendererHeadless.
+ * @handler: function to call when a frame is presented.
+ * @user_data: (closure): user data to pass to @handler.
+ * @destroy_notify: (allow-none): a function which gets called to free
+ * @user_data, or %NULL.
+ *
+ * Registers the function called when Flutter presents a frame.
+ */
+void fl_renderer_headless_set_frame_handler(
+    FlRendererHeadless* renderer,
+    FlRendererHeadlessFrameHandler handler,
+    gpointer user_data,
+    GDestroyNotify destroy_notify);
+
+G_END_DECLS
+
+#endif  // FLUTTER_SHELL_PLATFORM_LINUX_FL_RENDERER_HEADLESS_H_
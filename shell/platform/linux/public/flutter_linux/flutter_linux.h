@@ -22,6 +22,7 @@
 #include <flutter_linux/fl_method_response.h>
 #include <flutter_linux/fl_plugin_registrar.h>
 #include <flutter_linux/fl_plugin_registry.h>
+#include <flutter_linux/fl_renderer_headless.h>
 #include <flutter_linux/fl_standard_message_codec.h>
 #include <flutter_linux/fl_standard_method_codec.h>
 #include <flutter_linux/fl_string_codec.h>
@@ -167,7 +167,7 @@ FlutterEngineResult FlutterEngineInitialize(size_t version,
 
   EXPECT_NE(user_data, nullptr);
 
-  EXPECT_EQ(config->type, kOpenGL);
+  EXPECT_TRUE(config->type == kOpenGL || config->type == kSoftware);
 
   *engine_out = new _FlutterEngine(
       args->platform_message_callback,
@@ -13,4 +13,6 @@ set -ex
 ./fml_benchmarks --benchmark_format=json > fml_benchmarks.json
 ./shell_benchmarks --benchmark_format=json > shell_benchmarks.json
 ./ui_benchmarks --benchmark_format=json > ui_benchmarks.json
+./client_wrapper_benchmarks --benchmark_format=json > client_wrapper_benchmarks.json
+./common_cpp_benchmarks --benchmark_format=json > common_cpp_benchmarks.json
 
@@ -14,3 +14,5 @@ dart bin/parse_and_send.dart ../../../out/host_release/txt_benchmarks.json
 dart bin/parse_and_send.dart ../../../out/host_release/fml_benchmarks.json
 dart bin/parse_and_send.dart ../../../out/host_release/shell_benchmarks.json
 dart bin/parse_and_send.dart ../../../out/host_release/ui_benchmarks.json
+dart bin/parse_and_send.dart ../../../out/host_release/client_wrapper_benchmarks.json
+dart bin/parse_and_send.dart ../../../out/host_release/common_cpp_benchmarks.json
@@ -279,6 +279,51 @@ void main() {
     expectIterablesEqual(data.data, PlatformDispatcher._unpackPointerDataPacket(testData).data);
   });
 
+  test('onPointerDataPacket receives packed pointer data', () {
+    late PointerDataPacket data;
+    window.onPointerDataPacket = (PointerDataPacket value) {
+      data = value;
+    };
+
+    final ByteData testData = ByteData(52);
+    int offset = 0;
+    void writeUint32(int value) {
+      testData.setUint32(offset, value, Endian.little);
+      offset += 4;
+    }
+    void writeFloat32(double value) {
+      testData.setFloat32(offset, value, Endian.little);
+      offset += 4;
+    }
+    writeUint32(2);
+    // A down event, with a wide time stamp.
+    writeUint32(1 << 1 | 1 << 2 | 1 << 7 | 1 << 8);
+    writeUint32(1 << 1);
+    testData.setInt64(offset, 1 << 40, Endian.little);
+    offset += 8;
+    writeUint32(PointerChange.down.index);
+    writeFloat32(1.5);
+    writeFloat32(2.5);
+    // A move event, which only changes the time stamp and the x position.
+    writeUint32(1 << 1 | 1 << 2 | 1 << 7);
+    writeUint32(0);
+    writeUint32(1000);
+    writeUint32(PointerChange.move.index);
+    writeFloat32(3.5);
+    expectEquals(offset, testData.lengthInBytes);
+
+    _dispatchPackedPointerDataPacket(testData);
+    expectEquals(data.data.length, 2);
+    expectEquals(data.data[0].change, PointerChange.down);
+    expectEquals(data.data[0].timeStamp, const Duration(microseconds: 1 << 40));
+    expectEquals(data.data[0].physicalX, 1.5);
+    expectEquals(data.data[0].physicalY, 2.5);
+    expectEquals(data.data[1].change, PointerChange.move);
+    expectEquals(data.data[1].timeStamp, const Duration(microseconds: (1 << 40) + 1000));
+    expectEquals(data.data[1].physicalX, 3.5);
+    expectEquals(data.data[1].physicalY, 2.5);
+  });
+
   test('onSemanticsEnabledChanged preserves callback zone', () {
     late Zone innerZone;
     late Zone runZone;
@@ -177,6 +177,10 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'ui_benchmarks', filter)
 
+  RunEngineExecutable(build_dir, 'client_wrapper_benchmarks', filter)
+
+  RunEngineExecutable(build_dir, 'common_cpp_benchmarks', filter)
+
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter)
 
@@ -255,7 +255,8 @@ sk_sp<GrDirectContext> TestGLSurface::GetGrContext() {
   return CreateGrContext();
 }
 
-sk_sp<GrDirectContext> TestGLSurface::CreateGrContext() {
+sk_sp<GrDirectContext> TestGLSurface::CreateGrContext(
+    const GrContextOptions& options) {
   if (!MakeCurrent()) {
     return nullptr;
   }
@@ -287,7 +288,7 @@ sk_sp<GrDirectContext> TestGLSurface::CreateGrContext() {
     return nullptr;
   }
 
-  context_ = GrDirectContext::MakeGL(interface);
+  context_ = GrDirectContext::MakeGL(interface, options);
   return context_;
 }
 
@@ -37,7 +37,8 @@ class TestGLSurface {
 
   sk_sp<GrDirectContext> GetGrContext();
 
-  sk_sp<GrDirectContext> CreateGrContext();
+  sk_sp<GrDirectContext> CreateGrContext(
+      const GrContextOptions& options = GrContextOptions());
 
   sk_sp<SkImage> GetRasterSurfaceSnapshot();
 
@@ -0,0 +1,35 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+
+#include "flutter/fml/file.h"
+#include "third_party/benchmark/include/benchmark/benchmark_api.h"
+#include "txt/font_collection.h"
+
+namespace txt {
+
+// Measures setting up the platform fonts, with and without loading the font
+// fallback cache. Loading it lists the platform font families to check that
+// the cache was saved with the same fonts. The engine loads it on the IO
+// thread, so this is the cost moved off the startup path.
+static void BM_FontCollectionSetupDefaultFontManager(benchmark::State& state) {
+  fml::ScopedTemporaryDirectory cache_dir;
+  while (state.KeepRunning()) {
+    auto font_collection = std::make_shared<FontCollection>();
+    if (state.range(0)) {
+      font_collection->SetFallbackCacheDirectory(
+          fml::OpenDirectory(cache_dir.path().c_str(), false,
+                             fml::FilePermission::kReadWrite),
+          nullptr);
+    }
+    font_collection->SetupDefaultFontManager();
+  }
+}
+BENCHMARK(BM_FontCollectionSetupDefaultFontManager)
+    ->ArgName("fallback_cache")
+    ->Arg(0)
+    ->Arg(1);
+
+}  // namespace txt
@@ -16,9 +16,12 @@
 
 #include <minikin/Layout.h>
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
 #include "flutter/fml/command_line.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
 #include "flutter/third_party/txt/tests/txt_test_utils.h"
 #include "minikin/LayoutUtils.h"
@@ -184,6 +187,169 @@ BENCHMARK_F(ParagraphFixture, ManyStylesLayout)(benchmark::State& state) {
   }
 }
 
+// Lays out the same long paragraph on several threads at once, to measure how
+// well layout scales when the threads share the font collection and caches.
+static void BM_ParagraphLongLayoutConcurrent(benchmark::State& state) {
+  static const std::shared_ptr<FontCollection> font_collection =
+      GetTestFontCollection();
+
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+}
+BENCHMARK(BM_ParagraphLongLayoutConcurrent)->ThreadRange(1, 8)->UseRealTime();
+
+// Lays out the same paragraph at a sweep of widths, as during a window resize
+// animation. The paragraph is only marked dirty, which measures the text
+// again, when the "dirty" argument is 1.
+BENCHMARK_DEFINE_F(ParagraphFixture, ResizeSweepLayout)
+(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur. Excepteur sint "
+      "occaecat cupidatat non proident, sunt in culpa qui officia deserunt "
+      "mollit anim id est laborum.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  const bool dirty = state.range(0) != 0;
+  while (state.KeepRunning()) {
+    for (int width = 200; width < 600; width += 10) {
+      if (dirty) {
+        paragraph->SetDirty();
+      }
+      paragraph->Layout(width);
+    }
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ResizeSweepLayout)
+    ->ArgName("dirty")
+    ->Arg(0)
+    ->Arg(1);
+
+// Lays out a paragraph at an unbounded width to find its intrinsic width, and
+// then at that width, as the framework does for intrinsically sized text.
+BENCHMARK_F(ParagraphFixture, IntrinsicWidthLayout)(benchmark::State& state) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(std::numeric_limits<double>::infinity());
+    paragraph->Layout(std::min(paragraph->GetMaxIntrinsicWidth(), 300.0));
+  }
+}
+
+// Lays out a document-sized paragraph with many styles. Its runs are measured
+// on four worker threads when the "parallel" argument is 1.
+BENCHMARK_DEFINE_F(ParagraphFixture, VeryLongParagraphLayout)
+(benchmark::State& state) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  std::shared_ptr<fml::ConcurrentMessageLoop> loop;
+  if (state.range(0) != 0) {
+    loop = fml::ConcurrentMessageLoop::Create(4);
+    font_collection_->SetParallelShapingTaskRunner(loop->GetTaskRunner());
+  }
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+
+  for (int i = 0; i < 400; ++i) {
+    text_style.font_size = 12 + i % 4;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+  }
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+  font_collection_->SetParallelShapingTaskRunner(nullptr);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, VeryLongParagraphLayout)
+    ->ArgName("parallel")
+    ->Arg(0)
+    ->Arg(1);
+
 BENCHMARK_DEFINE_F(ParagraphFixture, TextBigO)(benchmark::State& state) {
   std::vector<uint16_t> text;
   for (uint16_t i = 0; i < state.range(0); ++i) {
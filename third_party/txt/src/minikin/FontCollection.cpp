@@ -299,7 +299,7 @@ uint32_t FontCollection::calcVariantMatchingScore(
 // the detail.
 // 3. Highest score wins, with ties resolved to the first font.
 // This method never returns nullptr.
-const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
+std::shared_ptr<FontFamily> FontCollection::getFamilyForChar(
     uint32_t ch,
     uint32_t vs,
     uint32_t langListId,
@@ -307,7 +307,7 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
   if (ch >= mMaxChar) {
     // libtxt: check if the fallback font provider can match this character
     if (mFallbackFontProvider) {
-      const std::shared_ptr<FontFamily>& fallback =
+      std::shared_ptr<FontFamily> fallback =
           findFallbackFont(ch, vs, langListId);
       if (fallback) {
         return fallback;
@@ -344,7 +344,7 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
   if (bestFamilyIndex == -1) {
     // libtxt: check if the fallback font provider can match this character
     if (mFallbackFontProvider) {
-      const std::shared_ptr<FontFamily>& fallback =
+      std::shared_ptr<FontFamily> fallback =
           findFallbackFont(ch, vs, langListId);
       if (fallback) {
         return fallback;
@@ -369,25 +369,31 @@ const std::shared_ptr<FontFamily>& FontCollection::getFamilyForChar(
                  : mFamilies[bestFamilyIndex];
 }
 
-const std::shared_ptr<FontFamily>& FontCollection::findFallbackFont(
+std::shared_ptr<FontFamily> FontCollection::findFallbackFont(
     uint32_t ch,
     uint32_t vs,
     uint32_t langListId) const {
   std::string locale = GetFontLocale(langListId);
 
-  const auto it = mCachedFallbackFamilies.find(locale);
-  if (it != mCachedFallbackFamilies.end()) {
-    for (const auto& fallbackFamily : it->second) {
-      if (calcCoverageScore(ch, vs, fallbackFamily)) {
-        return fallbackFamily;
+  {
+    std::scoped_lock _l(mCachedFallbackFamiliesMutex);
+    const auto it = mCachedFallbackFamilies.find(locale);
+    if (it != mCachedFallbackFamilies.end()) {
+      for (const auto& fallbackFamily : it->second) {
+        if (calcCoverageScore(ch, vs, fallbackFamily)) {
+          return fallbackFamily;
+        }
       }
     }
   }
 
-  const std::shared_ptr<FontFamily>& fallback =
-      mFallbackFontProvider->matchFallbackFont(ch, GetFontLocale(langListId));
+  // The provider is queried without holding the lock, as matching fallback
+  // fonts may be slow.
+  std::shared_ptr<FontFamily> fallback =
+      mFallbackFontProvider->matchFallbackFont(ch, locale);
 
   if (fallback) {
+    std::scoped_lock _l(mCachedFallbackFamiliesMutex);
     mCachedFallbackFamilies[locale].push_back(fallback);
   }
   return fallback;
@@ -434,8 +440,6 @@ bool FontCollection::hasVariationSelector(uint32_t baseCodepoint,
     return false;
   }
 
-  std::scoped_lock _l(gMinikinLock);
-
   // Currently mRanges can not be used here since it isn't aware of the
   // variation sequence.
   for (size_t i = 0; i < mVSFamilyVec.size(); i++) {
@@ -507,7 +511,7 @@ void FontCollection::itemize(const uint16_t* string,
     }
 
     if (!shouldContinueRun) {
-      const std::shared_ptr<FontFamily>& family = getFamilyForChar(
+      std::shared_ptr<FontFamily> family = getFamilyForChar(
           ch, isVariationSelector(nextCh) ? nextCh : 0, langListId, variant);
       if (utf16Pos == 0 || family.get() != lastFamily) {
         size_t start = utf16Pos;
@@ -19,6 +19,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -40,7 +41,7 @@ class FontCollection {
   class FallbackFontProvider {
    public:
     virtual ~FallbackFontProvider() = default;
-    virtual const std::shared_ptr<FontFamily>& matchFallbackFont(
+    virtual std::shared_ptr<FontFamily> matchFallbackFont(
         uint32_t ch,
         std::string locale) = 0;
   };
@@ -98,13 +99,16 @@ class FontCollection {
   // Initialize the FontCollection.
   bool init(const std::vector<std::shared_ptr<FontFamily>>& typefaces);
 
-  const std::shared_ptr<FontFamily>& getFamilyForChar(uint32_t ch,
-                                                      uint32_t vs,
-                                                      uint32_t langListId,
-                                                      int variant) const;
+  // The families are returned by value, as fallback families may be added
+  // by other threads while the result is in use.
+  std::shared_ptr<FontFamily> getFamilyForChar(uint32_t ch,
+                                               uint32_t vs,
+                                               uint32_t langListId,
+                                               int variant) const;
 
-  const std::shared_ptr<FontFamily>&
-  findFallbackFont(uint32_t ch, uint32_t vs, uint32_t langListId) const;
+  std::shared_ptr<FontFamily> findFallbackFont(uint32_t ch,
+                                               uint32_t vs,
+                                               uint32_t langListId) const;
 
   uint32_t calcFamilyScore(uint32_t ch,
                            uint32_t vs,
@@ -156,7 +160,9 @@ class FontCollection {
   std::unique_ptr<FallbackFontProvider> mFallbackFontProvider;
 
   // libtxt extension: Fallback fonts discovered after this font collection
-  // was constructed.
+  // was constructed. Layouts on several threads may discover fallback fonts at
+  // once, so the cache is guarded by a lock.
+  mutable std::mutex mCachedFallbackFamiliesMutex;
   mutable std::map<std::string, std::vector<std::shared_ptr<FontFamily>>>
       mCachedFallbackFamilies;
 };
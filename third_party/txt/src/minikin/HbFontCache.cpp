@@ -21,6 +21,8 @@
 #include <log/log.h>
 #include <utils/LruCache.h>
 
+#include <mutex>
+
 #include <hb-ot.h>
 #include <hb.h>
 
@@ -54,39 +56,39 @@ class HbFontCache : private android::OnEntryRemoved<int32_t, hb_font_t*> {
   android::LruCache<int32_t, hb_font_t*> mCache;
 };
 
+// The cache is shared by all threads that lay out text. It is guarded by its
+// own lock rather than gMinikinLock, so that layouts can run concurrently.
+static std::mutex gHbFontCacheLock;
+
 HbFontCache* getFontCacheLocked() {
-  assertMinikinLocked();
-  static HbFontCache* cache = nullptr;
-  if (cache == nullptr) {
-    cache = new HbFontCache();
-  }
+  static HbFontCache* cache = new HbFontCache();
   return cache;
 }
 
-void purgeHbFontCacheLocked() {
-  assertMinikinLocked();
+void purgeHbFontCache() {
+  std::scoped_lock _l(gHbFontCacheLock);
   getFontCacheLocked()->clear();
 }
 
-void purgeHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+void purgeHbFont(const MinikinFont* minikinFont) {
   const int32_t fontId = minikinFont->GetUniqueId();
+  std::scoped_lock _l(gHbFontCacheLock);
   getFontCacheLocked()->remove(fontId);
 }
 
 // Returns a new reference to a hb_font_t object, caller is
 // responsible for calling hb_font_destroy() on it.
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont) {
-  assertMinikinLocked();
+//
+// The returned font is shared between threads and must not be modified. Use
+// hb_font_create_sub_font() to get a font whose functions or scale can be set.
+hb_font_t* getHbFont(const MinikinFont* minikinFont) {
   // TODO: get rid of nullFaceFont
-  static hb_font_t* nullFaceFont = nullptr;
+  static hb_font_t* nullFaceFont = hb_font_create(nullptr);
   if (minikinFont == nullptr) {
-    if (nullFaceFont == nullptr) {
-      nullFaceFont = hb_font_create(nullptr);
-    }
     return hb_font_reference(nullFaceFont);
   }
 
+  std::scoped_lock _l(gHbFontCacheLock);
   HbFontCache* fontCache = getFontCacheLocked();
   const int32_t fontId = minikinFont->GetUniqueId();
   hb_font_t* font = fontCache->get(fontId);
@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -108,6 +110,15 @@ class LayoutCacheKey {
                         collection);
   }
 
+  // An estimate of the memory held by a cache entry with this key.
+  size_t getMemoryUsage(const Layout& layout) const {
+    return sizeof(LayoutCacheKey) + sizeof(Layout) +
+           mNchars * sizeof(uint16_t) +
+           layout.mGlyphs.capacity() * sizeof(LayoutGlyph) +
+           layout.mAdvances.capacity() * sizeof(float) +
+           layout.mFaces.capacity() * sizeof(FakedFont);
+  }
+
  private:
   const uint16_t* mChars;
   size_t mNchars;
@@ -129,60 +140,150 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// The layout cache is shared by all threads that lay out text. To keep threads
+// from waiting on each other, it is split into shards that each have their own
+// lock and an equal part of the byte budget, and words are only shaped outside
+// of the locks.
+class LayoutCache {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock _l(shard.mMutex);
+      shard.mCache.clear();
+    }
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  void setMaxBytes(size_t maxBytes) {
+    for (Shard& shard : mShards) {
+      std::scoped_lock _l(shard.mMutex);
+      shard.mMaxBytes = maxBytes / kShardCount;
+      shard.evictLocked();
+    }
+  }
+
+  LayoutCacheStats getStats() {
+    LayoutCacheStats stats;
+    for (Shard& shard : mShards) {
+      std::scoped_lock _l(shard.mMutex);
+      stats.hitCount += shard.mHitCount;
+      stats.missCount += shard.mMissCount;
+      stats.evictionCount += shard.mEvictionCount;
+      stats.bytes += shard.mBytes;
+    }
+    return stats;
+  }
+
+  // Layouts are shared with the cache, so that they stay valid while used even
+  // if another thread evicts them.
+  std::shared_ptr<Layout> get(LayoutCacheKey& key,
+                              LayoutContext* ctx,
+                              const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = getShard(key);
+    {
+      std::scoped_lock _l(shard.mMutex);
+      std::shared_ptr<Layout> layout = shard.mCache.get(key);
+      if (layout != nullptr) {
+        shard.mHitCount++;
+        return layout;
+      }
+      shard.mMissCount++;
+    }
+
+    std::shared_ptr<Layout> layout = std::make_shared<Layout>();
+    key.doLayout(layout.get(), ctx, collection);
+    key.copyText();
+    std::scoped_lock _l(shard.mMutex);
+    if (shard.mCache.put(key, layout)) {
+      shard.mBytes += key.getMemoryUsage(*layout);
+      shard.evictLocked();
+    } else {
+      // Another thread has laid out and cached the same word in the meantime.
+      key.freeText();
     }
     return layout;
   }
 
  private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
-  }
+  class Shard : private android::OnEntryRemoved<LayoutCacheKey,
+                                                 std::shared_ptr<Layout>> {
+   public:
+    Shard()
+        : mCache(android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>>::
+                     kUnlimitedCapacity) {
+      mCache.setOnEntryRemovedListener(this);
+    }
+
+    // Evicts the least recently used layouts until the shard is within its
+    // budget.
+    void evictLocked() {
+      while (mBytes > mMaxBytes && mCache.removeOldest()) {
+        mEvictionCount++;
+      }
+    }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+    std::mutex mMutex;
+    android::LruCache<LayoutCacheKey, std::shared_ptr<Layout>> mCache;
+    size_t mMaxBytes = Layout::kDefaultCacheMaxBytes / kShardCount;
+    size_t mBytes = 0;
+    size_t mHitCount = 0;
+    size_t mMissCount = 0;
+    size_t mEvictionCount = 0;
+
+   private:
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key, std::shared_ptr<Layout>& value) {
+      mBytes -= key.getMemoryUsage(*value);
+      key.freeText();
+    }
+  };
+
+  Shard& getShard(const LayoutCacheKey& key) {
+    // The low bits of the hash pick the bucket within the shard, so the shard
+    // is picked from the high bits.
+    return mShards[(static_cast<uint32_t>(key.hash()) >> 24) % kShardCount];
+  }
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+  static const size_t kShardCount = 16;
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+  Shard mShards[kShardCount];
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
+  // HarfBuzz buffers must not be used by several threads at once, so every
+  // thread shapes text into a buffer of its own.
+  hb_buffer_t* getHbBuffer() {
+    thread_local HbBuffer buffer(unicodeFunctions);
+    return buffer.get();
+  }
+
   static LayoutEngine& getInstance() {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+ private:
+  class HbBuffer {
+   public:
+    explicit HbBuffer(hb_unicode_funcs_t* unicodeFunctions)
+        : mBuffer(hb_buffer_create()) {
+      hb_buffer_set_unicode_funcs(mBuffer, unicodeFunctions);
+    }
+
+    ~HbBuffer() { hb_buffer_destroy(mBuffer); }
+
+    hb_buffer_t* get() const { return mBuffer; }
+
+   private:
+    hb_buffer_t* mBuffer;
+  };
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
@@ -254,34 +355,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(funcs, harfbuzzGetGlyphHorizontalOrigin,
+                                        0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +414,11 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    // The cached font is shared with other threads, so the functions and the
+    // scale of this layout are set on a sub font of its own.
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +427,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +687,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +709,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -720,9 +815,9 @@ float Layout::doLayoutWord(const uint16_t* buf,
     }
     advance = layoutForWord.getAdvance();
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
+    std::shared_ptr<Layout> layoutForWord = cache.get(key, ctx, collection);
     if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
+      layout->appendLayout(layoutForWord.get(), bufStart, wordSpacing);
     }
     if (advances) {
       layoutForWord->getAdvances(advances);
@@ -748,7 +843,7 @@ static void addFeatures(const std::string& str,
   const char* end = start + str.size();
 
   while (start < end) {
-    static hb_feature_t feature;
+    hb_feature_t feature;
     const char* p = strchr(start, ',');
     if (!p)
       p = end;
@@ -919,7 +1014,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getInstance().getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1193,10 +1288,17 @@ void Layout::getBounds(MinikinRect* bounds) const {
 }
 
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
+}
+
+void Layout::setCacheMaxBytes(size_t maxBytes) {
+  LayoutEngine::getInstance().layoutCache.setMaxBytes(maxBytes);
+}
+
+LayoutCacheStats Layout::getCacheStats() {
+  return LayoutEngine::getInstance().layoutCache.getStats();
 }
 
 }  // namespace minikin
@@ -46,6 +46,17 @@ struct LayoutGlyph {
 // Internal state used during layout operation
 struct LayoutContext;
 
+// libtxt extension: statistics of the word layout cache since the process
+// started.
+struct LayoutCacheStats {
+  size_t hitCount = 0;
+  size_t missCount = 0;
+  // The number of layouts evicted to stay within the byte budget.
+  size_t evictionCount = 0;
+  // An estimate of the memory held by the cached layouts.
+  size_t bytes = 0;
+};
+
 enum {
   kBidi_LTR = 0,
   kBidi_RTL = 1,
@@ -117,6 +128,17 @@ class Layout {
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // libtxt extension: the default budget of the word layout cache, which
+  // holds about as many words as the former limit of 5000 entries.
+  static constexpr size_t kDefaultCacheMaxBytes = 2 * 1024 * 1024;
+
+  // libtxt extension: sets the number of bytes the word layout cache may hold,
+  // evicting the least recently used layouts that no longer fit.
+  static void setCacheMaxBytes(size_t maxBytes);
+
+  // libtxt extension
+  static LayoutCacheStats getCacheStats();
+
  private:
   friend class LayoutCacheKey;
 
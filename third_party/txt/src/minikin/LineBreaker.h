@@ -148,6 +148,18 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Like addStyleRun, but takes the widths of the characters in the
+  // range from |widths| instead of measuring the text. The paint is still used
+  // to compute the break penalties. Used to break text that was measured by an
+  // earlier layout at a different width.
+  void addMeasuredStyleRun(MinikinPaint* paint,
+                           const std::shared_ptr<FontCollection>& typeface,
+                           FontStyle style,
+                           size_t start,
+                           size_t end,
+                           bool isRtl,
+                           const float* widths);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -193,6 +205,15 @@ class LineBreaker {
 
   float currentLineWidth() const;
 
+  // Finds the candidate word breaks in the range, whose widths must already be
+  // in the width buffer.
+  void addWordBreaks(MinikinPaint* paint,
+                     const std::shared_ptr<FontCollection>& typeface,
+                     FontStyle style,
+                     size_t start,
+                     size_t end,
+                     bool isRtl);
+
   void addWordBreak(size_t offset,
                     ParaWidth preBreak,
                     ParaWidth postBreak,
@@ -33,8 +33,7 @@ void assertMinikinLocked() {
 }
 
 hb_blob_t* getFontTable(const MinikinFont* minikinFont, uint32_t tag) {
-  assertMinikinLocked();
-  hb_font_t* font = getHbFontLocked(minikinFont);
+  hb_font_t* font = getHbFont(minikinFont);
   hb_face_t* face = hb_font_get_face(font);
   hb_blob_t* blob = hb_face_reference_table(face, tag);
   hb_font_destroy(font);
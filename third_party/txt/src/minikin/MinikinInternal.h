@@ -28,8 +28,10 @@
 namespace minikin {
 
 // All external Minikin interfaces are designed to be thread-safe.
-// Presently, that's implemented by through a global lock, and having
-// all external interfaces take that lock.
+// Font loading is serialized by a global lock, which external interfaces that
+// modify fonts take. Layout does not take it: the caches used during layout
+// have locks of their own, so that text can be laid out on several threads at
+// once.
 
 extern std::recursive_mutex gMinikinLock;
 
@@ -17,14 +17,19 @@
 #include "font_collection.h"
 
 #include <algorithm>
+#include <cstdlib>
 #include <list>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
 #include <vector>
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/trace_event.h"
 #include "font_skia.h"
 #include "minikin/Layout.h"
@@ -35,7 +40,40 @@ namespace txt {
 
 namespace {
 
-const std::shared_ptr<minikin::FontFamily> g_null_family;
+constexpr char kFallbackCacheFileName[] = "io.flutter.font_fallback_cache";
+constexpr char kFallbackCacheHeader[] = "font_fallback_cache 2";
+
+// Fallback decisions are kept for this many code points at most, which is
+// more than the text of an app usually needs.
+constexpr size_t kMaxFallbackCacheEntries = 4096;
+
+// Matches made in a burst, such as while laying out the first frames, are
+// saved together.
+constexpr fml::TimeDelta kFallbackCacheSaveDelay =
+    fml::TimeDelta::FromSeconds(1);
+
+// Identifies the families of a font manager, so that fallback decisions made
+// with other platform fonts are not reused.
+std::string GetFontManagerFingerprint(const SkFontMgr& manager) {
+  // 64-bit FNV-1a, which is stable across runs unlike std::hash.
+  uint64_t hash = 0xcbf29ce484222325ull;
+  auto add_string = [&hash](const std::string& string) {
+    for (char c : string) {
+      hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001b3ull;
+    }
+    hash = (hash ^ '\n') * 0x100000001b3ull;
+  };
+  int family_count = manager.countFamilies();
+  add_string(std::to_string(family_count));
+  for (int i = 0; i < family_count; i++) {
+    SkString family_name;
+    manager.getFamilyName(i, &family_name);
+    add_string(family_name.c_str());
+  }
+  std::ostringstream stream;
+  stream << std::hex << hash;
+  return stream.str();
+}
 
 }  // anonymous namespace
 
@@ -66,14 +104,14 @@ class TxtFallbackFontProvider
   TxtFallbackFontProvider(std::shared_ptr<FontCollection> font_collection)
       : font_collection_(font_collection) {}
 
-  virtual const std::shared_ptr<minikin::FontFamily>& matchFallbackFont(
+  virtual std::shared_ptr<minikin::FontFamily> matchFallbackFont(
       uint32_t ch,
       std::string locale) {
     std::shared_ptr<FontCollection> fc = font_collection_.lock();
     if (fc) {
       return fc->MatchFallbackFont(ch, locale);
     } else {
-      return g_null_family;
+      return nullptr;
     }
   }
 
@@ -99,6 +137,24 @@ size_t FontCollection::GetFontManagersCount() const {
 
 void FontCollection::SetupDefaultFontManager() {
   default_font_manager_ = GetDefaultFontManager();
+
+  fml::RefPtr<fml::TaskRunner> task_runner;
+  {
+    std::scoped_lock lock(cache_mutex_);
+    task_runner = fallback_cache_task_runner_;
+  }
+  if (!task_runner) {
+    LoadFallbackCache(default_font_manager_);
+    return;
+  }
+  // Listing the platform fonts for the fingerprint can take a while, so it is
+  // kept off the startup path. Fallback fonts are queried from the platform
+  // until the cache is loaded.
+  task_runner->PostTask([weak_collection = weak_from_this(),
+                         manager = default_font_manager_]() {
+    if (auto collection = weak_collection.lock())
+      collection->LoadFallbackCache(manager);
+  });
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
@@ -157,12 +213,153 @@ void FontCollection::DisableFontFallback() {
 #endif
 }
 
+void FontCollection::SetParallelShapingTaskRunner(
+    std::shared_ptr<fml::BasicTaskRunner> task_runner) {
+  std::scoped_lock lock(parallel_shaping_mutex_);
+  parallel_shaping_task_runner_ = std::move(task_runner);
+}
+
+std::shared_ptr<fml::BasicTaskRunner>
+FontCollection::GetParallelShapingTaskRunner() const {
+  std::scoped_lock lock(parallel_shaping_mutex_);
+  return parallel_shaping_task_runner_;
+}
+
+void FontCollection::SetFallbackCacheDirectory(
+    fml::UniqueFD directory,
+    fml::RefPtr<fml::TaskRunner> task_runner) {
+  std::scoped_lock lock(cache_mutex_);
+  fallback_cache_directory_ =
+      std::make_shared<fml::UniqueFD>(std::move(directory));
+  fallback_cache_task_runner_ = std::move(task_runner);
+}
+
+void FontCollection::LoadFallbackCache(const sk_sp<SkFontMgr>& manager) {
+  TRACE_EVENT0("flutter", "FontCollection::LoadFallbackCache");
+  std::shared_ptr<fml::UniqueFD> directory;
+  {
+    std::scoped_lock lock(cache_mutex_);
+    directory = fallback_cache_directory_;
+  }
+  if (!directory || !directory->is_valid() || !manager)
+    return;
+
+  const std::string fingerprint = GetFontManagerFingerprint(*manager);
+  std::map<std::pair<std::string, uint32_t>, std::string> loaded_families;
+  std::unique_ptr<fml::FileMapping> mapping =
+      fml::FileMapping::CreateReadOnly(*directory, kFallbackCacheFileName);
+  if (mapping != nullptr) {
+    std::istringstream stream(
+        std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                    mapping->GetSize()));
+    std::string header;
+    std::string file_fingerprint;
+    if (std::getline(stream, header) && header == kFallbackCacheHeader &&
+        std::getline(stream, file_fingerprint) &&
+        file_fingerprint == fingerprint) {
+      // Each line holds a code point, a locale and a family name, separated
+      // by tabs.
+      std::string line;
+      while (std::getline(stream, line)) {
+        size_t locale_start = line.find('\t');
+        if (locale_start == std::string::npos)
+          continue;
+        size_t family_start = line.find('\t', locale_start + 1);
+        if (family_start == std::string::npos)
+          continue;
+        if (loaded_families.size() == kMaxFallbackCacheEntries)
+          break;
+        uint32_t ch = std::strtoul(line.c_str(), nullptr, 10);
+        std::string locale =
+            line.substr(locale_start + 1, family_start - locale_start - 1);
+        loaded_families[std::make_pair(std::move(locale), ch)] =
+            line.substr(family_start + 1);
+      }
+    }
+  }
+
+  std::scoped_lock lock(cache_mutex_);
+  if (fallback_cache_fingerprint_ != fingerprint &&
+      !fallback_cache_fingerprint_.empty()) {
+    // The platform fonts changed since the last load.
+    cached_fallback_families_.clear();
+  }
+  fallback_cache_fingerprint_ = fingerprint;
+  // Families matched while the file was being read are newer than the loaded
+  // ones, so insert doesn't replace them.
+  for (auto& entry : loaded_families) {
+    if (cached_fallback_families_.size() == kMaxFallbackCacheEntries)
+      break;
+    cached_fallback_families_.insert(std::move(entry));
+  }
+  ScheduleFallbackCacheSave();
+}
+
+void FontCollection::CacheFallbackFamily(uint32_t ch,
+                                         const std::string& locale,
+                                         const std::string& family_name) {
+  if (!fallback_cache_directory_ || !fallback_cache_directory_->is_valid())
+    return;
+  if (locale.find_first_of("\t\n") != std::string::npos ||
+      family_name.find_first_of("\t\n") != std::string::npos)
+    return;
+  if (cached_fallback_families_.size() == kMaxFallbackCacheEntries)
+    return;
+  auto inserted = cached_fallback_families_.insert(
+      std::make_pair(std::make_pair(locale, ch), family_name));
+  if (!inserted.second && inserted.first->second == family_name)
+    return;
+  inserted.first->second = family_name;
+  fallback_cache_dirty_ = true;
+  ScheduleFallbackCacheSave();
+}
+
+void FontCollection::ScheduleFallbackCacheSave() {
+  // Nothing is saved until the file was loaded, since the fingerprint to save
+  // with isn't known before.
+  if (!fallback_cache_dirty_ || fallback_cache_save_pending_ ||
+      !fallback_cache_task_runner_ || fallback_cache_fingerprint_.empty())
+    return;
+  fallback_cache_save_pending_ = true;
+  fallback_cache_task_runner_->PostDelayedTask(
+      [weak_collection = weak_from_this()]() {
+        if (auto collection = weak_collection.lock())
+          collection->SaveFallbackCache();
+      },
+      kFallbackCacheSaveDelay);
+}
+
+void FontCollection::SaveFallbackCache() {
+  TRACE_EVENT0("flutter", "FontCollection::SaveFallbackCache");
+  std::shared_ptr<fml::UniqueFD> directory;
+  std::ostringstream stream;
+  {
+    std::scoped_lock lock(cache_mutex_);
+    fallback_cache_save_pending_ = false;
+    fallback_cache_dirty_ = false;
+    directory = fallback_cache_directory_;
+    stream << kFallbackCacheHeader << '\n'
+           << fallback_cache_fingerprint_ << '\n';
+    for (const auto& entry : cached_fallback_families_) {
+      stream << entry.first.second << '\t' << entry.first.first << '\t'
+             << entry.second << '\n';
+    }
+  }
+  if (!directory || !directory->is_valid())
+    return;
+  if (!fml::WriteAtomically(*directory, kFallbackCacheFileName,
+                            fml::DataMapping(stream.str()))) {
+    FML_LOG(WARNING) << "Could not write the font fallback cache.";
+  }
+}
+
 std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
+  std::scoped_lock lock(cache_mutex_);
   auto cached = font_collections_cache_.find(family_key);
   if (cached != font_collections_cache_.end()) {
     return cached->second;
@@ -310,26 +507,49 @@ std::shared_ptr<minikin::FontFamily> FontCollection::CreateMinikinFontFamily(
   return std::make_shared<minikin::FontFamily>(std::move(minikin_fonts));
 }
 
-const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
+std::shared_ptr<minikin::FontFamily> FontCollection::MatchFallbackFont(
     uint32_t ch,
     std::string locale) {
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
+  std::scoped_lock lock(cache_mutex_);
   auto lookup = fallback_match_cache_.find(ch);
   if (lookup != fallback_match_cache_.end()) {
-    return *lookup->second;
+    return lookup->second;
   }
-  const std::shared_ptr<minikin::FontFamily>* match =
-      &DoMatchFallbackFont(ch, locale);
+  std::shared_ptr<minikin::FontFamily> match = DoMatchFallbackFont(ch, locale);
   fallback_match_cache_.insert(std::make_pair(ch, match));
-  return *match;
+  return match;
 }
 
-const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
+std::shared_ptr<minikin::FontFamily> FontCollection::DoMatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  auto add_fallback_font_for_locale = [this,
+                                       &locale](const std::string& family_name) {
+    if (std::find(fallback_fonts_for_locale_[locale].begin(),
+                  fallback_fonts_for_locale_[locale].end(),
+                  family_name) == fallback_fonts_for_locale_[locale].end())
+      fallback_fonts_for_locale_[locale].push_back(family_name);
+  };
+
   for (const sk_sp<SkFontMgr>& manager : GetFontManagerOrder()) {
+    // Use the family the platform matched for ch in an earlier run, which
+    // avoids querying the platform fonts again.
+    const bool is_default_manager = manager == default_font_manager_;
+    if (is_default_manager) {
+      auto cached = cached_fallback_families_.find(std::make_pair(locale, ch));
+      if (cached != cached_fallback_families_.end()) {
+        std::shared_ptr<minikin::FontFamily> family =
+            GetFallbackFontFamily(manager, cached->second);
+        if (family && family->getCoverage().get(ch)) {
+          add_fallback_font_for_locale(cached->second);
+          return family;
+        }
+      }
+    }
+
     std::vector<const char*> bcp47;
     if (!locale.empty())
       bcp47.push_back(locale.c_str());
@@ -342,19 +562,20 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
     typeface->getFamilyName(&sk_family_name);
     std::string family_name(sk_family_name.c_str());
 
-    if (std::find(fallback_fonts_for_locale_[locale].begin(),
-                  fallback_fonts_for_locale_[locale].end(),
-                  family_name) == fallback_fonts_for_locale_[locale].end())
-      fallback_fonts_for_locale_[locale].push_back(family_name);
+    add_fallback_font_for_locale(family_name);
 
-    return GetFallbackFontFamily(manager, family_name);
+    std::shared_ptr<minikin::FontFamily> family =
+        GetFallbackFontFamily(manager, family_name);
+    if (is_default_manager && family)
+      CacheFallbackFamily(ch, locale, family_name);
+    return family;
   }
-  return g_null_family;
+  return nullptr;
 }
 
-const std::shared_ptr<minikin::FontFamily>&
-FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
-                                      const std::string& family_name) {
+std::shared_ptr<minikin::FontFamily> FontCollection::GetFallbackFontFamily(
+    const sk_sp<SkFontMgr>& manager,
+    const std::string& family_name) {
   TRACE_EVENT0("flutter", "FontCollection::GetFallbackFontFamily");
   auto fallback_it = fallback_fonts_.find(family_name);
   if (fallback_it != fallback_fonts_.end()) {
@@ -364,7 +585,7 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
   std::shared_ptr<minikin::FontFamily> minikin_family =
       CreateMinikinFontFamily(manager, family_name);
   if (!minikin_family)
-    return g_null_family;
+    return nullptr;
 
   auto insert_it =
       fallback_fonts_.insert(std::make_pair(family_name, minikin_family));
@@ -377,7 +598,10 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
-  font_collections_cache_.clear();
+  {
+    std::scoped_lock lock(cache_mutex_);
+    font_collections_cache_.clear();
+  }
 
 #if FLUTTER_ENABLE_SKSHAPER
   if (skt_collection_) {
@@ -17,12 +17,17 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/task_runner.h"
+#include "flutter/fml/unique_fd.h"
 #include "minikin/FontCollection.h"
 #include "minikin/FontFamily.h"
 #include "third_party/googletest/googletest/include/gtest/gtest_prod.h"  // nogncheck
@@ -37,6 +42,8 @@
 
 namespace txt {
 
+// The font managers must be set up before text is laid out. Once they are,
+// paragraphs using the collection can be laid out on several threads at once.
 class FontCollection : public std::enable_shared_from_this<FontCollection> {
  public:
   FontCollection();
@@ -45,6 +52,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 
   size_t GetFontManagersCount() const;
 
+  // Sets up the platform font manager, and loads the fallback cache if it was
+  // saved with the same set of platform fonts.
   void SetupDefaultFontManager();
   void SetDefaultFontManager(sk_sp<SkFontMgr> font_manager);
   void SetAssetFontManager(sk_sp<SkFontMgr> font_manager);
@@ -57,9 +66,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 
   // Provides a FontFamily that contains glyphs for ch. This caches previously
   // matched fonts. Also see FontCollection::DoMatchFallbackFont.
-  const std::shared_ptr<minikin::FontFamily>& MatchFallbackFont(
-      uint32_t ch,
-      std::string locale);
+  std::shared_ptr<minikin::FontFamily> MatchFallbackFont(uint32_t ch,
+                                                         std::string locale);
 
   // Do not provide alternative fonts that can match characters which are
   // missing from the requested font family.
@@ -68,6 +76,29 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Saves the fallback fonts matched by the default font manager to a file in
+  // the given directory, so that later runs can use them without querying the
+  // platform again. SetupDefaultFontManager loads the file, and new matches
+  // are saved in batches, both on the given task runner. Without a task
+  // runner, the file is loaded on the calling thread and never saved. Must be
+  // called before SetupDefaultFontManager.
+  void SetFallbackCacheDirectory(fml::UniqueFD directory,
+                                 fml::RefPtr<fml::TaskRunner> task_runner);
+
+  // Measures the text runs of long paragraphs using this collection in
+  // parallel on the given task runner before breaking them into lines. The
+  // calling thread measures batches of runs alongside the task runner, and
+  // only waits for the batches the task runner has already started. Pass
+  // nullptr to measure every paragraph on the calling thread, which is the
+  // default.
+  //
+  // The setting applies to every user of the collection, so it should be
+  // made by whoever owns the collection.
+  void SetParallelShapingTaskRunner(
+      std::shared_ptr<fml::BasicTaskRunner> task_runner);
+
+  std::shared_ptr<fml::BasicTaskRunner> GetParallelShapingTaskRunner() const;
+
 #if FLUTTER_ENABLE_SKSHAPER
 
   // Construct a Skia text layout FontCollection based on this collection.
@@ -94,19 +125,36 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
   sk_sp<SkFontMgr> test_font_manager_;
+  // Guards the caches below, which are used by every paragraph layout.
+  std::mutex cache_mutex_;
   std::unordered_map<FamilyKey,
                      std::shared_ptr<minikin::FontCollection>,
                      FamilyKey::Hasher>
       font_collections_cache_;
   // Cache that stores the results of MatchFallbackFont to ensure lag-free emoji
   // font fallback matching.
-  std::unordered_map<uint32_t, const std::shared_ptr<minikin::FontFamily>*>
+  std::unordered_map<uint32_t, std::shared_ptr<minikin::FontFamily>>
       fallback_match_cache_;
   std::unordered_map<std::string, std::shared_ptr<minikin::FontFamily>>
       fallback_fonts_;
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  // The family that the default font manager matched for fallback, keyed by
+  // locale and code point. Only the code points the platform was queried for
+  // are cached, so a cached family is always the one the platform would pick.
+  // Guarded by cache_mutex_.
+  std::shared_ptr<fml::UniqueFD> fallback_cache_directory_;
+  fml::RefPtr<fml::TaskRunner> fallback_cache_task_runner_;
+  // Empty until the file was loaded.
+  std::string fallback_cache_fingerprint_;
+  std::map<std::pair<std::string, uint32_t>, std::string>
+      cached_fallback_families_;
+  // Whether families were matched since the file was last saved.
+  bool fallback_cache_dirty_ = false;
+  bool fallback_cache_save_pending_ = false;
+  mutable std::mutex parallel_shaping_mutex_;
+  std::shared_ptr<fml::BasicTaskRunner> parallel_shaping_task_runner_;
 
 #if FLUTTER_ENABLE_SKSHAPER
   // An equivalent font collection usable by the Skia text shaper library.
@@ -114,10 +162,26 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 #endif
 
   // Performs the actual work of MatchFallbackFont. The result is cached in
-  // fallback_match_cache_.
-  const std::shared_ptr<minikin::FontFamily>& DoMatchFallbackFont(
-      uint32_t ch,
-      std::string locale);
+  // fallback_match_cache_. Must be called with cache_mutex_ held.
+  std::shared_ptr<minikin::FontFamily> DoMatchFallbackFont(uint32_t ch,
+                                                           std::string locale);
+
+  // Reads the fallback cache saved for the fonts of manager. Entries saved
+  // with a different set of platform fonts are discarded.
+  void LoadFallbackCache(const sk_sp<SkFontMgr>& manager);
+
+  // Records that the default font manager matched family_name for ch, and
+  // schedules a save of the fallback cache. Must be called with cache_mutex_
+  // held.
+  void CacheFallbackFamily(uint32_t ch,
+                           const std::string& locale,
+                           const std::string& family_name);
+
+  // Must be called with cache_mutex_ held.
+  void ScheduleFallbackCacheSave();
+
+  // Writes the fallback cache to its file.
+  void SaveFallbackCache();
 
   std::vector<sk_sp<SkFontMgr>> GetFontManagerOrder() const;
 
@@ -131,9 +195,12 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Sorts in-place a group of SkTypeface from an SkTypefaceSet into a
   // reasonable order for future queries.
   FRIEND_TEST(FontCollectionTest, CheckSkTypefacesSorting);
+  FRIEND_TEST(FontCollectionTest, FallbackCacheIsReloaded);
+  FRIEND_TEST(FontCollectionTest, FallbackCacheIsDiscardedForOtherFonts);
   static void SortSkTypefaces(std::vector<sk_sp<SkTypeface>>& sk_typefaces);
 
-  const std::shared_ptr<minikin::FontFamily>& GetFallbackFontFamily(
+  // Must be called with cache_mutex_ held.
+  std::shared_ptr<minikin::FontFamily> GetFallbackFontFamily(
       const sk_sp<SkFontMgr>& manager,
       const std::string& family_name);
 
@@ -20,7 +20,9 @@
 #include <minikin/Layout.h>
 
 #include <algorithm>
+#include <atomic>
 #include <cstring>
+#include <functional>
 #include <limits>
 #include <map>
 #include <numeric>
@@ -28,6 +30,7 @@
 #include <vector>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
 #include "font_collection.h"
 #include "font_skia.h"
 #include "minikin/FontLanguageListCache.h"
@@ -191,6 +194,13 @@ void FindWords(const std::vector<uint16_t>& text,
 
 static const float kDoubleDecorationSpacing = 3.0f;
 
+// Paragraphs shorter than this are always measured on the calling thread, as
+// posting the work to other threads would cost more than it saves.
+static const size_t kParallelShapingMinTextLength = 4096;
+
+// The number of code units each task measures when measuring in parallel.
+static const size_t kParallelShapingBatchLength = 1024;
+
 ParagraphTxt::GlyphPosition::GlyphPosition(double x_start,
                                            double x_advance,
                                            size_t code_unit_index,
@@ -266,6 +276,19 @@ bool ParagraphTxt::ComputeLineBreaks() {
   // Break at the end of the paragraph.
   newline_positions.push_back(text_.size());
 
+  bool measure_runs = !has_measured_runs_;
+  if (measure_runs) {
+    measured_char_widths_.assign(text_.size(), 0);
+    measured_run_widths_.clear();
+    std::shared_ptr<fml::BasicTaskRunner> task_runner =
+        font_collection_->GetParallelShapingTaskRunner();
+    if (task_runner && text_.size() >= kParallelShapingMinTextLength &&
+        MeasureRunsInParallel(newline_positions, *task_runner)) {
+      measure_runs = false;
+    }
+  }
+  size_t measured_run_index = 0;
+
   // Calculate and add any breaks due to a line being too long.
   size_t run_index = 0;
   size_t inline_placeholder_index = 0;
@@ -324,10 +347,7 @@ bool ParagraphTxt::ComputeLineBreaks() {
 
       // Check if the run is an object replacement character-only run. We should
       // leave space for inline placeholder and break around it if appropriate.
-      if (run.end - run.start == 1 &&
-          obj_replacement_char_indexes_.count(run.start) != 0 &&
-          text_[run.start] == objReplacementChar &&
-          inline_placeholder_index < inline_placeholders_.size()) {
+      if (IsInlinePlaceholderRun(run, inline_placeholder_index)) {
         // Is a inline placeholder run.
         PlaceholderRun placeholder_run =
             inline_placeholders_[inline_placeholder_index];
@@ -344,9 +364,18 @@ bool ParagraphTxt::ComputeLineBreaks() {
         inline_placeholder_index++;
       } else {
         // Is a regular text run.
-        double run_width = breaker_.addStyleRun(&paint, collection, font,
-                                                run_start, run_end, isRtl);
-        block_total_width += run_width;
+        float* run_char_widths =
+            measured_char_widths_.data() + block_start + run_start;
+        if (measure_runs) {
+          measured_run_widths_.push_back(breaker_.addStyleRun(
+              &paint, collection, font, run_start, run_end, isRtl));
+          std::copy(breaker_.charWidths() + run_start,
+                    breaker_.charWidths() + run_end, run_char_widths);
+        } else {
+          breaker_.addMeasuredStyleRun(&paint, collection, font, run_start,
+                                       run_end, isRtl, run_char_widths);
+        }
+        block_total_width += measured_run_widths_[measured_run_index++];
       }
 
       if (run.end > block_end)
@@ -382,6 +411,137 @@ bool ParagraphTxt::ComputeLineBreaks() {
   return true;
 }
 
+bool ParagraphTxt::MeasureRunsInParallel(
+    const std::vector<size_t>& newline_positions,
+    fml::BasicTaskRunner& task_runner) {
+  // A text run clipped to a block between hard line breaks. It is measured in
+  // the context of its block, as LineBreaker::addStyleRun does.
+  struct RunMeasurement {
+    size_t block_start;
+    size_t block_size;
+    size_t run_start;
+    size_t run_end;
+    minikin::FontStyle font;
+    minikin::MinikinPaint paint;
+    std::shared_ptr<minikin::FontCollection> collection;
+  };
+  std::vector<RunMeasurement> measurements;
+
+  size_t run_index = 0;
+  size_t inline_placeholder_index = 0;
+  for (size_t newline_index = 0; newline_index < newline_positions.size();
+       ++newline_index) {
+    size_t block_start =
+        (newline_index > 0) ? newline_positions[newline_index - 1] + 1 : 0;
+    size_t block_end = newline_positions[newline_index];
+    if (block_end == block_start)
+      continue;
+
+    while (run_index < runs_.size()) {
+      StyledRuns::Run run = runs_.GetRun(run_index);
+      if (run.start >= block_end)
+        break;
+      if (run.end < block_start) {
+        run_index++;
+        continue;
+      }
+
+      RunMeasurement measurement;
+      measurement.collection = GetMinikinFontCollectionForStyle(run.style);
+      if (measurement.collection == nullptr)
+        return false;
+      if (IsInlinePlaceholderRun(run, inline_placeholder_index)) {
+        inline_placeholder_index++;
+      } else {
+        measurement.block_start = block_start;
+        measurement.block_size = block_end - block_start;
+        measurement.run_start = std::max(run.start, block_start) - block_start;
+        measurement.run_end = std::min(run.end, block_end) - block_start;
+        GetFontAndMinikinPaint(run.style, &measurement.font,
+                               &measurement.paint);
+        measurements.push_back(std::move(measurement));
+      }
+
+      if (run.end > block_end)
+        break;
+      run_index++;
+    }
+  }
+
+  // Split the runs into batches of consecutive runs holding at least
+  // kParallelShapingBatchLength code units, except for the last one.
+  std::vector<std::pair<size_t, size_t>> batches;
+  size_t batch_start = 0;
+  size_t batch_length = 0;
+  for (size_t i = 0; i < measurements.size(); ++i) {
+    batch_length += measurements[i].run_end - measurements[i].run_start;
+    if (batch_length >= kParallelShapingBatchLength ||
+        i + 1 == measurements.size()) {
+      batches.emplace_back(batch_start, i + 1);
+      batch_start = i + 1;
+      batch_length = 0;
+    }
+  }
+  if (batches.size() < 2)
+    return false;
+
+  measured_run_widths_.resize(measurements.size());
+  bool is_rtl = paragraph_style_.text_direction == TextDirection::rtl;
+  auto measure_batch = [this, &measurements, is_rtl](
+                           const std::pair<size_t, size_t>& batch) {
+    for (size_t i = batch.first; i < batch.second; ++i) {
+      const RunMeasurement& measurement = measurements[i];
+      measured_run_widths_[i] = minikin::Layout::measureText(
+          text_.data() + measurement.block_start, measurement.run_start,
+          measurement.run_end - measurement.run_start, measurement.block_size,
+          is_rtl, measurement.font, measurement.paint, measurement.collection,
+          measured_char_widths_.data() + measurement.block_start +
+              measurement.run_start);
+    }
+  };
+
+  // Batches are claimed from a shared index by this thread as well as by the
+  // workers, so this thread never waits on a batch that no worker has
+  // started. Workers that run after every batch was claimed do nothing, and
+  // only touch the shared state.
+  struct SharedState {
+    explicit SharedState(size_t batch_count)
+        : batch_count(batch_count), batches_done(batch_count) {}
+    const size_t batch_count;
+    std::atomic<size_t> next_batch{0};
+    fml::CountDownLatch batches_done;
+  };
+  auto state = std::make_shared<SharedState>(batches.size());
+  std::function<void(size_t)> measure_batch_at =
+      [&measure_batch, &batches](size_t i) { measure_batch(batches[i]); };
+  auto measure_claimed_batches =
+      [](SharedState& state, const std::function<void(size_t)>* measure) {
+        for (size_t i = state.next_batch++; i < state.batch_count;
+             i = state.next_batch++) {
+          (*measure)(i);
+          state.batches_done.CountDown();
+        }
+      };
+  for (size_t i = 1; i < batches.size(); ++i) {
+    task_runner.PostTask(
+        [state, measure = &measure_batch_at, measure_claimed_batches]() {
+          measure_claimed_batches(*state, measure);
+        });
+  }
+  measure_claimed_batches(*state, &measure_batch_at);
+  state->batches_done.Wait();
+  return true;
+}
+
+bool ParagraphTxt::IsInlinePlaceholderRun(
+    const StyledRuns::Run& run,
+    size_t inline_placeholder_index) const {
+  return run.end - run.start == 1 &&
+         obj_replacement_char_indexes_.count(run.start) != 0 &&
+         text_[run.start] == objReplacementChar &&
+         inline_placeholder_index < inline_placeholders_.size();
+}
+
 bool ParagraphTxt::ComputeBidiRuns(std::vector<BidiRun>* result) {
   if (text_.empty())
     return true;
@@ -679,6 +839,11 @@ void ParagraphTxt::Layout(double width) {
 
   width_ = rounded_width;
 
+  // Only the width changed since the last layout if it is not dirty, so the
+  // runs it measured can be broken into lines again.
+  if (needs_layout_) {
+    has_measured_runs_ = false;
+  }
   needs_layout_ = false;
 
   records_.clear();
@@ -692,9 +857,12 @@ void ParagraphTxt::Layout(double width) {
   if (!ComputeLineBreaks())
     return;
 
-  std::vector<BidiRun> bidi_runs;
-  if (!ComputeBidiRuns(&bidi_runs))
-    return;
+  if (!has_measured_runs_) {
+    bidi_runs_.clear();
+    if (!ComputeBidiRuns(&bidi_runs_))
+      return;
+    has_measured_runs_ = true;
+  }
 
   SkFont font;
   font.setEdging(SkFont::Edging::kAntiAlias);
@@ -745,7 +913,7 @@ void ParagraphTxt::Layout(double width) {
 
     // Find the runs comprising this line.
     std::vector<BidiRun> line_runs;
-    for (const BidiRun& bidi_run : bidi_runs) {
+    for (const BidiRun& bidi_run : bidi_runs_) {
       // A "ghost" run is a run that does not impact the layout, breaking,
       // alignment, width, etc but is still "visible" through getRectsForRange.
       // For example, trailing whitespace on centered text can be scrolled
@@ -1385,6 +1553,7 @@ void ParagraphTxt::SetParagraphStyle(const ParagraphStyle& style) {
 
 void ParagraphTxt::SetFontCollection(
     std::shared_ptr<FontCollection> font_collection) {
+  needs_layout_ = true;
   font_collection_ = std::move(font_collection);
 }
 
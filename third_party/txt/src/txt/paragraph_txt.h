@@ -122,8 +122,9 @@ class ParagraphTxt : public Paragraph {
   std::vector<LineMetrics>& GetLineMetrics() override;
 
   // Sets the needs_layout_ to dirty. When Layout() is called, a new Layout will
-  // be performed when this is set to true. Can also be used to prevent a new
-  // Layout from being calculated by setting to false.
+  // be performed when this is set to true, measuring the text again. Can also
+  // be used to prevent a new Layout from being calculated by setting to false.
+  // A Layout() at a new width that is not dirty reuses the measured text.
   void SetDirty(bool dirty = true);
 
  private:
@@ -309,6 +310,15 @@ class ParagraphTxt : public Paragraph {
   // Holds the positions of the inline placeholders.
   std::vector<CodeUnitRun> inline_placeholder_code_unit_runs_;
 
+  // The results of the last layout that do not depend on the width: the
+  // measured widths of each code unit and of each text run, and the bidi runs.
+  // They are reused when only the width changes, so that a new width only
+  // breaks and positions the lines again.
+  std::vector<float> measured_char_widths_;
+  std::vector<double> measured_run_widths_;
+  std::vector<BidiRun> bidi_runs_;
+  bool has_measured_runs_ = false;
+
   // The max width of the paragraph as provided in the most recent Layout()
   // call.
   double width_ = -1.0f;
@@ -342,9 +352,21 @@ class ParagraphTxt : public Paragraph {
       std::vector<PlaceholderRun> inline_placeholders,
       std::unordered_set<size_t> obj_replacement_char_indexes);
 
-  // Break the text into lines.
+  // Break the text into lines. Measures the text runs unless they were
+  // measured by an earlier layout.
   bool ComputeLineBreaks();
 
+  // Measures the text runs that ComputeLineBreaks adds to the line breaker, in
+  // the same order, in batches on the task runner. Returns false if the runs
+  // could not be measured in parallel.
+  bool MeasureRunsInParallel(const std::vector<size_t>& newline_positions,
+                             fml::BasicTaskRunner& task_runner);
+
+  // Returns whether the run only holds the object replacement character of
+  // the inline placeholder at the given index.
+  bool IsInlinePlaceholderRun(const StyledRuns::Run& run,
+                              size_t inline_placeholder_index) const;
+
   // Break the text into runs based on LTR/RTL text direction.
   bool ComputeBidiRuns(std::vector<BidiRun>* result);
 
@@ -14,10 +14,19 @@
  * limitations under the License.
  */
 
+#include <atomic>
+#include <thread>
+
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
 #include "gtest/gtest.h"
+#include "minikin/FontCollection.h"
+#include "minikin/FontFamily.h"
 #include "third_party/skia/include/utils/SkCustomTypeface.h"
+#include "txt/asset_font_manager.h"
 #include "txt/font_collection.h"
+#include "txt/font_skia.h"
+#include "txt/typeface_font_asset_provider.h"
 #include "txt_test_utils.h"
 
 namespace txt {
@@ -138,6 +147,142 @@ TEST(FontCollectionTest, CheckSkTypefacesSorting) {
             SkFontStyle::kExpanded_Width);
 }
 
+TEST(FontCollectionTest, FallbackCacheIsReloaded) {
+  fml::ScopedTemporaryDirectory cache_dir;
+  sk_sp<SkFontMgr> font_manager = CreateTestFontManager();
+
+  auto saving_collection = std::make_shared<FontCollection>();
+  saving_collection->SetFallbackCacheDirectory(fml::OpenDirectory(
+      cache_dir.path().c_str(), false, fml::FilePermission::kReadWrite),
+      nullptr);
+  saving_collection->SetDefaultFontManager(font_manager);
+  saving_collection->LoadFallbackCache(font_manager);
+  {
+    std::scoped_lock lock(saving_collection->cache_mutex_);
+    saving_collection->CacheFallbackFamily('a', "en-US", "Roboto");
+    saving_collection->CacheFallbackFamily('b', "en-US", "Homemade Apple");
+  }
+  saving_collection->SaveFallbackCache();
+
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetFallbackCacheDirectory(fml::OpenDirectory(
+      cache_dir.path().c_str(), false, fml::FilePermission::kReadWrite),
+      nullptr);
+  collection->SetDefaultFontManager(font_manager);
+  collection->LoadFallbackCache(font_manager);
+  std::map<std::pair<std::string, uint32_t>, std::string> expected_families = {
+      {{"en-US", 'a'}, "Roboto"},
+      {{"en-US", 'b'}, "Homemade Apple"},
+  };
+  EXPECT_EQ(collection->cached_fallback_families_, expected_families);
+
+  // The test font manager does not match fonts for characters, so only the
+  // cached family can be found.
+  EXPECT_TRUE(collection->MatchFallbackFont('b', "en-US") != nullptr);
+  EXPECT_TRUE(collection->MatchFallbackFont('b', "ja-JP") == nullptr);
+  // Roboto covers 'c', but the platform was never asked which family to use
+  // for it, so the decisions made for its neighbours are not reused.
+  EXPECT_TRUE(collection->MatchFallbackFont('c', "en-US") == nullptr);
+}
+
+TEST(FontCollectionTest, FallbackCacheIsDiscardedForOtherFonts) {
+  fml::ScopedTemporaryDirectory cache_dir;
+
+  auto saving_collection = std::make_shared<FontCollection>();
+  saving_collection->SetFallbackCacheDirectory(fml::OpenDirectory(
+      cache_dir.path().c_str(), false, fml::FilePermission::kReadWrite),
+      nullptr);
+  sk_sp<SkFontMgr> font_manager = CreateTestFontManager();
+  saving_collection->SetDefaultFontManager(font_manager);
+  saving_collection->LoadFallbackCache(font_manager);
+  {
+    std::scoped_lock lock(saving_collection->cache_mutex_);
+    saving_collection->CacheFallbackFamily('a', "en-US", "Roboto");
+  }
+  saving_collection->SaveFallbackCache();
+
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetFallbackCacheDirectory(fml::OpenDirectory(
+      cache_dir.path().c_str(), false, fml::FilePermission::kReadWrite),
+      nullptr);
+  sk_sp<SkFontMgr> other_font_manager = sk_make_sp<AssetFontManager>(
+      std::make_unique<TypefaceFontAssetProvider>());
+  collection->SetDefaultFontManager(other_font_manager);
+  collection->LoadFallbackCache(other_font_manager);
+  EXPECT_TRUE(collection->cached_fallback_families_.empty());
+}
+
+namespace {
+std::shared_ptr<minikin::FontFamily> CreateFamily(sk_sp<SkTypeface> typeface) {
+  std::vector<minikin::Font> fonts;
+  fonts.emplace_back(std::make_shared<FontSkia>(std::move(typeface)),
+                     minikin::FontStyle());
+  return std::make_shared<minikin::FontFamily>(std::move(fonts));
+}
+
+// Returns a new family of the same typeface for every character, like a
+// platform that keeps finding fallback fonts.
+class NewFamilyFallbackFontProvider
+    : public minikin::FontCollection::FallbackFontProvider {
+ public:
+  explicit NewFamilyFallbackFontProvider(sk_sp<SkTypeface> typeface)
+      : typeface_(std::move(typeface)) {}
+
+  std::shared_ptr<minikin::FontFamily> matchFallbackFont(
+      uint32_t ch,
+      std::string locale) override {
+    return CreateFamily(typeface_);
+  }
+
+ private:
+  sk_sp<SkTypeface> typeface_;
+};
+}  // namespace
+
+// Meant to be run with ThreadSanitizer as well.
+TEST(FontCollectionTest, FallbackFontsCanBeMatchedConcurrently) {
+  sk_sp<SkFontMgr> font_manager = CreateTestFontManager();
+  sk_sp<SkTypeface> roboto(
+      font_manager->matchFamilyStyle("Roboto", SkFontStyle()));
+  sk_sp<SkTypeface> arabic(
+      font_manager->matchFamilyStyle("Noto Naskh Arabic", SkFontStyle()));
+  ASSERT_TRUE(roboto);
+  ASSERT_TRUE(arabic);
+  std::shared_ptr<minikin::FontCollection> collection =
+      minikin::FontCollection::Create({CreateFamily(roboto)});
+  collection->set_fallback_font_provider(
+      std::make_unique<NewFamilyFallbackFontProvider>(arabic));
+
+  // The Arabic letter is found in the cached fallback families, while no
+  // family covers the ideograph, so every lookup of it adds a family to the
+  // cache that the other threads are reading.
+  const std::u16string text = u"a\u0628\u4e00\u0628";
+  constexpr size_t kThreadCount = 4;
+  constexpr size_t kIterationCount = 100;
+  std::atomic<size_t> wrong_font_count = 0;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&]() {
+      for (size_t j = 0; j < kIterationCount; j++) {
+        std::vector<minikin::FontCollection::Run> runs;
+        collection->itemize(reinterpret_cast<const uint16_t*>(text.data()),
+                            text.size(), minikin::FontStyle(), &runs);
+        for (const minikin::FontCollection::Run& run : runs) {
+          auto* font = static_cast<FontSkia*>(run.fakedFont.font);
+          const sk_sp<SkTypeface>& expected = run.start == 0 ? roboto : arabic;
+          if (font->GetSkTypeface() != expected) {
+            wrong_font_count++;
+          }
+        }
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(wrong_font_count, 0u);
+}
+
 #if 0
 
 TEST(FontCollection, HasDefaultRegistrations) {
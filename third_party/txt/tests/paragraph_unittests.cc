@@ -16,8 +16,11 @@
 
 #include <cstring>
 #include <iostream>
+#include <thread>
 
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
@@ -7158,4 +7161,222 @@ TEST_F(ParagraphTest, MixedTextHeightBehaviorRectsParagraph) {
 
   ASSERT_TRUE(Snapshot());
 }
+
+TEST_F(ParagraphTest, ConcurrentLayout) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  std::shared_ptr<FontCollection> font_collection = GetTestFontCollection();
+
+  auto layout_paragraph = [&]() {
+    txt::ParagraphStyle paragraph_style;
+    txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.color = SK_ColorBLACK;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+
+    auto paragraph = BuildParagraph(builder);
+    paragraph->Layout(300);
+    return paragraph;
+  };
+
+  auto expected = layout_paragraph();
+  ASSERT_GT(expected->GetLineMetrics().size(), 1ull);
+
+  // Start from empty caches so that the threads shape the words concurrently.
+  minikin::Layout::purgeCaches();
+
+  const size_t kThreadCount = 4;
+  std::vector<std::unique_ptr<ParagraphTxt>> paragraphs(kThreadCount);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < kThreadCount; i++) {
+    threads.emplace_back([&paragraphs, &layout_paragraph, i]() {
+      paragraphs[i] = layout_paragraph();
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& paragraph : paragraphs) {
+    EXPECT_EQ(paragraph->GetLineMetrics().size(),
+              expected->GetLineMetrics().size());
+    EXPECT_DOUBLE_EQ(paragraph->GetHeight(), expected->GetHeight());
+    EXPECT_DOUBLE_EQ(paragraph->GetLongestLine(), expected->GetLongestLine());
+    EXPECT_DOUBLE_EQ(paragraph->GetMaxIntrinsicWidth(),
+                     expected->GetMaxIntrinsicWidth());
+  }
+}
+
+TEST_F(ParagraphTest, LayoutCacheStats) {
+  const char* text = "Hello World Text Dialog";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+
+  auto paragraph = BuildParagraph(builder);
+
+  minikin::Layout::purgeCaches();
+  const minikin::LayoutCacheStats initial_stats =
+      minikin::Layout::getCacheStats();
+  EXPECT_EQ(initial_stats.bytes, 0u);
+
+  paragraph->Layout(GetTestCanvasWidth());
+  const minikin::LayoutCacheStats first_layout_stats =
+      minikin::Layout::getCacheStats();
+  EXPECT_GT(first_layout_stats.missCount, initial_stats.missCount);
+  EXPECT_GT(first_layout_stats.bytes, 0u);
+
+  // Laying out the same text again only hits the cache.
+  paragraph->SetDirty();
+  paragraph->Layout(GetTestCanvasWidth());
+  const minikin::LayoutCacheStats second_layout_stats =
+      minikin::Layout::getCacheStats();
+  EXPECT_EQ(second_layout_stats.missCount, first_layout_stats.missCount);
+  EXPECT_GT(second_layout_stats.hitCount, first_layout_stats.hitCount);
+
+  // Shrinking the budget evicts the cached words.
+  minikin::Layout::setCacheMaxBytes(0);
+  const minikin::LayoutCacheStats evicted_stats =
+      minikin::Layout::getCacheStats();
+  EXPECT_EQ(evicted_stats.bytes, 0u);
+  EXPECT_GT(evicted_stats.evictionCount, second_layout_stats.evictionCount);
+
+  minikin::Layout::setCacheMaxBytes(minikin::Layout::kDefaultCacheMaxBytes);
+}
+
+TEST_F(ParagraphTest, IncrementalRelayoutMatchesFullLayout) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short.\n"
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto build_paragraph = [&u16_text]() {
+    txt::ParagraphStyle paragraph_style;
+    paragraph_style.text_align = TextAlign::justify;
+    txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.color = SK_ColorBLACK;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    text_style.font_size = 20;
+    text_style.letter_spacing = 2;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+    builder.Pop();
+    return BuildParagraph(builder);
+  };
+
+  auto incremental = build_paragraph();
+  auto full = build_paragraph();
+
+  // Only the width changes between the layouts of |incremental|, which breaks
+  // the text it measured the first time into lines again.
+  for (double width : {500.0, 300.0, 150.0, 420.0, 80.0, 500.0}) {
+    incremental->Layout(width);
+    full->SetDirty();
+    full->Layout(width);
+
+    ASSERT_EQ(incremental->GetLineCount(), full->GetLineCount());
+    EXPECT_EQ(incremental->GetHeight(), full->GetHeight());
+    EXPECT_EQ(incremental->GetLongestLine(), full->GetLongestLine());
+    EXPECT_EQ(incremental->GetMinIntrinsicWidth(),
+              full->GetMinIntrinsicWidth());
+    EXPECT_EQ(incremental->GetMaxIntrinsicWidth(),
+              full->GetMaxIntrinsicWidth());
+    for (size_t i = 0; i < full->GetLineCount(); ++i) {
+      EXPECT_EQ(incremental->GetLineMetrics()[i].end_index,
+                full->GetLineMetrics()[i].end_index);
+      EXPECT_EQ(incremental->GetLineMetrics()[i].width,
+                full->GetLineMetrics()[i].width);
+    }
+
+    std::vector<txt::Paragraph::TextBox> incremental_boxes =
+        incremental->GetRectsForRange(0, u16_text.length() * 2,
+                                      Paragraph::RectHeightStyle::kTight,
+                                      Paragraph::RectWidthStyle::kTight);
+    std::vector<txt::Paragraph::TextBox> full_boxes =
+        full->GetRectsForRange(0, u16_text.length() * 2,
+                               Paragraph::RectHeightStyle::kTight,
+                               Paragraph::RectWidthStyle::kTight);
+    ASSERT_EQ(incremental_boxes.size(), full_boxes.size());
+    for (size_t i = 0; i < full_boxes.size(); ++i) {
+      EXPECT_EQ(incremental_boxes[i].rect, full_boxes[i].rect);
+    }
+  }
+}
+
+TEST_F(ParagraphTest, ParallelShapingMatchesSerialShaping) {
+  const char* text =
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua.\n";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  auto build_paragraph = [&u16_text](
+                             std::shared_ptr<txt::FontCollection> collection) {
+    txt::ParagraphStyle paragraph_style;
+    txt::ParagraphBuilderTxt builder(paragraph_style, collection);
+
+    txt::TextStyle text_style;
+    text_style.font_families = std::vector<std::string>(1, "Roboto");
+    text_style.color = SK_ColorBLACK;
+    for (int i = 0; i < 100; ++i) {
+      text_style.font_size = 12 + i % 3;
+      builder.PushStyle(text_style);
+      builder.AddText(u16_text);
+      builder.Pop();
+    }
+    return BuildParagraph(builder);
+  };
+
+  auto serial = build_paragraph(GetTestFontCollection());
+  serial->Layout(GetTestCanvasWidth());
+
+  auto loop = fml::ConcurrentMessageLoop::Create(4);
+  std::shared_ptr<txt::FontCollection> parallel_collection =
+      GetTestFontCollection();
+  parallel_collection->SetParallelShapingTaskRunner(loop->GetTaskRunner());
+  auto parallel = build_paragraph(parallel_collection);
+  parallel->Layout(GetTestCanvasWidth());
+
+  ASSERT_EQ(parallel->GetLineCount(), serial->GetLineCount());
+  EXPECT_EQ(parallel->GetHeight(), serial->GetHeight());
+  EXPECT_EQ(parallel->GetMaxIntrinsicWidth(), serial->GetMaxIntrinsicWidth());
+  for (size_t i = 0; i < serial->GetLineCount(); ++i) {
+    EXPECT_EQ(parallel->GetLineMetrics()[i].end_index,
+              serial->GetLineMetrics()[i].end_index);
+    EXPECT_EQ(parallel->GetLineMetrics()[i].width,
+              serial->GetLineMetrics()[i].width);
+  }
+}
+
 }  // namespace txt
@@ -106,15 +106,17 @@ void RegisterFontsFromPath(TypefaceFontAssetProvider& font_provider,
 #endif
 }
 
-std::shared_ptr<FontCollection> GetTestFontCollection() {
+sk_sp<SkFontMgr> CreateTestFontManager() {
   std::unique_ptr<TypefaceFontAssetProvider> font_provider =
       std::make_unique<TypefaceFontAssetProvider>();
   RegisterFontsFromPath(*font_provider, GetFontDir());
+  return sk_make_sp<AssetFontManager>(std::move(font_provider));
+}
 
+std::shared_ptr<FontCollection> GetTestFontCollection() {
   std::shared_ptr<FontCollection> collection =
       std::make_shared<FontCollection>();
-  collection->SetAssetFontManager(
-      sk_make_sp<AssetFontManager>(std::move(font_provider)));
+  collection->SetAssetFontManager(CreateTestFontManager());
 
   return collection;
 }
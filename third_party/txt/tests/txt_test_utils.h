@@ -31,6 +31,9 @@ const fml::CommandLine& GetCommandLineForProcess();
 
 void SetCommandLine(fml::CommandLine cmd);
 
+// Returns a font manager holding the fonts of the font directory.
+sk_sp<SkFontMgr> CreateTestFontManager();
+
 std::shared_ptr<FontCollection> GetTestFontCollection();
 
 std::unique_ptr<ParagraphTxt> BuildParagraph(ParagraphBuilderTxt& builder);